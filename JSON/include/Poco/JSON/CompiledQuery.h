@@ -0,0 +1,169 @@
+//
+// CompiledQuery.h
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  CompiledQuery
+//
+// Definition of the CompiledQuery class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef JSON_CompiledQuery_INCLUDED
+#define JSON_CompiledQuery_INCLUDED
+
+
+#include <string>
+#include <vector>
+
+#include "Poco/SharedPtr.h"
+#include "Poco/DynamicAny.h"
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/Array.h"
+
+
+namespace Poco
+{
+namespace JSON
+{
+
+class JSON_API CompiledQuery
+	/// A query path that is parsed once into a list of steps.
+	/// Evaluating a compiled query only walks the objects and
+	/// arrays, without splitting the path or using regular
+	/// expressions.
+	///
+	/// A path contains property names separated by dots. Each
+	/// name can be followed by one or more array indexes, for
+	/// example "person.children[0].name". The index [*] is a
+	/// wildcard that selects all elements of an array, for example
+	/// "items[*].id" selects the id of every item.
+	///
+	/// Use compile() to get a compiled query from the process wide
+	/// cache. Query uses this cache for all its lookups.
+{
+public:
+
+	typedef SharedPtr<CompiledQuery> Ptr;
+
+
+	CompiledQuery(const std::string& path);
+		/// Creates and compiles the query
+
+
+	virtual ~CompiledQuery();
+		/// Destructor
+
+
+	static Ptr compile(const std::string& path);
+		/// Returns the compiled query for the path. Compiled queries
+		/// are stored in a thread-safe cache keyed by the path, so
+		/// a path is only parsed the first time it is used.
+
+
+	const std::string& path() const;
+		/// Returns the path of the query
+
+
+	bool hasWildcard() const;
+		/// Returns true when the path contains a [*] wildcard
+
+
+	DynamicAny find(const DynamicAny& source) const;
+		/// Evaluates the query on source and returns the value.
+		/// When the path contains a wildcard, the first match is
+		/// returned. An empty value is returned when nothing is found.
+
+
+	void findAll(const DynamicAny& source, Array::ValueVector& result) const;
+		/// Evaluates the query on source and appends all
+		/// matches to result, in document order.
+
+
+	static const std::size_t CACHE_SIZE = 1024;
+		/// The maximum number of paths in the cache. When a new path
+		/// doesn't fit anymore, the cache is emptied.
+
+
+private:
+
+	struct Step
+	{
+		enum Kind
+		{
+			KEY,
+			INDEX,
+			WILDCARD
+		};
+
+		Kind kind;
+
+		std::string key;
+
+		unsigned int index;
+	};
+
+
+	typedef std::vector<Step> Steps;
+
+
+	void parse();
+
+
+	bool walk(DynamicAny value, Steps::const_iterator step, Array::ValueVector* result, DynamicAny& first) const;
+		/// Evaluates the steps starting at step. Matches are added to
+		/// result, or when result is NULL, the first match is stored in
+		/// first and false is returned to stop the evaluation.
+
+
+	std::string _path;
+
+
+	Steps _steps;
+
+
+	bool _wildcard;
+};
+
+
+inline const std::string& CompiledQuery::path() const
+{
+	return _path;
+}
+
+
+inline bool CompiledQuery::hasWildcard() const
+{
+	return _wildcard;
+}
+
+
+}} // Namespace Poco::JSON
+
+#endif // JSON_CompiledQuery_INCLUDED
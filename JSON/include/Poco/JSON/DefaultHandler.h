@@ -64,6 +64,11 @@ public:
 		/// Destructor
 
 
+	void reset();
+		/// Discards a partially built result.
+		/// The parser calls this before each parse.
+
+
 	void startObject();
 		/// Handles a {, meaning a new object will be read
 
@@ -0,0 +1,320 @@
+//
+// Document.h
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  Document
+//
+// Definition of the Document class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef JSON_Document_INCLUDED
+#define JSON_Document_INCLUDED
+
+
+#include <string>
+#include <cstring>
+
+#include "Poco/SharedPtr.h"
+#include "Poco/Exception.h"
+#include "Poco/JSON/JSON.h"
+
+namespace Poco
+{
+namespace JSON
+{
+
+class DocumentHandler;
+
+
+class JSON_API Document
+	/// A compact, read-only representation of a parsed JSON document.
+	///
+	/// All values are stored as tagged nodes in a flat array. Object
+	/// members are kept as a vector of key/value pairs sorted on the key,
+	/// so a property is found with a binary search. Keys are interned and
+	/// all strings are stored in the same memory block as the nodes. The
+	/// whole document is one allocation, which makes building and destroying
+	/// a document much cheaper than a tree of Object and Array instances.
+	///
+	/// A Document is created with a DocumentHandler:
+	///
+	///     Parser parser;
+	///     DocumentHandler handler;
+	///     parser.setHandler(&handler);
+	///     parser.parse(json);
+	///     Document::Ptr doc = handler.result();
+	///     std::string name = doc->root().get("name").getString();
+{
+public:
+
+	typedef SharedPtr<Document> Ptr;
+
+
+	enum Type
+	{
+		NULL_VALUE,
+		BOOLEAN_VALUE,
+		INTEGER_VALUE,
+		DOUBLE_VALUE,
+		STRING_VALUE,
+		ARRAY_VALUE,
+		OBJECT_VALUE
+	};
+
+
+	class JSON_API Value
+		/// A reference to a value stored in a Document. A Value
+		/// is only valid as long as its Document exists.
+		/// A default constructed Value is null. Lookups of missing
+		/// elements or properties also return a null value.
+	{
+	public:
+
+		Value();
+			/// Creates a null value
+
+
+		Type type() const;
+			/// Returns the type of the value
+
+
+		bool isNull() const;
+			/// Returns true when the value is null or doesn't exist
+
+
+		bool isArray() const;
+			/// Returns true when the value is an array
+
+
+		bool isObject() const;
+			/// Returns true when the value is an object
+
+
+		bool getBoolean() const;
+			/// Returns a boolean value. Throws a BadCastException
+			/// when the value is not a boolean.
+
+
+		Int64 getInteger() const;
+			/// Returns a numeric value as integer. Throws a
+			/// BadCastException when the value is not a number.
+
+
+		double getDouble() const;
+			/// Returns a numeric value as double. Throws a
+			/// BadCastException when the value is not a number.
+
+
+		std::string getString() const;
+			/// Returns a copy of a string value. Throws a
+			/// BadCastException when the value is not a string.
+
+
+		const char* data() const;
+			/// Returns a pointer to the characters of a string value,
+			/// without copying it. The string is not zero terminated,
+			/// use length() to get its size.
+
+
+		std::size_t length() const;
+			/// Returns the length of a string value
+
+
+		std::size_t size() const;
+			/// Returns the number of elements of an array or the
+			/// number of properties of an object. Returns 0 for
+			/// all other values.
+
+
+		Value get(std::size_t index) const;
+			/// Returns an element of an array. A null value is returned
+			/// when the value is not an array or the index is out of range.
+
+
+		Value get(const std::string& key) const;
+			/// Returns a property of an object. A null value is returned
+			/// when the value is not an object or the property doesn't exist.
+
+
+		bool has(const std::string& key) const;
+			/// Returns true when the value is an object with the given property
+
+
+		std::string key(std::size_t index) const;
+			/// Returns the name of the index-th property of an object.
+			/// Properties are ordered on their name.
+
+
+		Value member(std::size_t index) const;
+			/// Returns the value of the index-th property of an object.
+
+
+	private:
+
+		Value(const Document* doc, UInt32 node);
+
+		const Document* _doc;
+
+		UInt32 _node;
+
+		friend class Document;
+	};
+
+
+	~Document();
+		/// Destroys the document with one deallocation
+
+
+	Value root() const;
+		/// Returns the root object or array of the document
+
+
+	std::size_t memoryUsage() const;
+		/// Returns the size in bytes of the memory block
+		/// holding the document.
+
+
+private:
+
+	struct Node
+	{
+		UInt32 type;
+		UInt32 size;   // Length of a string, number of elements or members
+		union
+		{
+			Int64 integer;
+			double number;
+			bool boolean;
+			UInt32 offset; // Index in the strings, elements or members
+		};
+	};
+
+
+	struct Member
+	{
+		UInt32 key;    // Offset of the interned key in the strings
+		UInt32 length; // Length of the key
+		UInt32 node;
+	};
+
+
+	Document(const Node* nodes, std::size_t nodeCount,
+	         const Member* members, std::size_t memberCount,
+	         const UInt32* elements, std::size_t elementCount,
+	         const char* strings, std::size_t stringLength);
+		/// Copies all parts into one memory block
+
+
+	Document(const Document&);
+	Document& operator = (const Document&);
+
+	const Node& node(UInt32 index) const;
+
+	const Member* findMember(const Node& object, const std::string& key) const;
+
+	char* _memory;
+
+	std::size_t _size;
+
+	const Node* _nodes;
+
+	const Member* _members;
+
+	const UInt32* _elements;
+
+	const char* _strings;
+
+	friend class DocumentHandler;
+	friend class Value;
+};
+
+
+inline Document::Value::Value() : _doc(NULL), _node(0)
+{
+}
+
+
+inline Document::Value::Value(const Document* doc, UInt32 node) : _doc(doc), _node(node)
+{
+}
+
+
+inline Document::Type Document::Value::type() const
+{
+	return _doc == NULL ? NULL_VALUE : static_cast<Type>(_doc->node(_node).type);
+}
+
+
+inline bool Document::Value::isNull() const
+{
+	return type() == NULL_VALUE;
+}
+
+
+inline bool Document::Value::isArray() const
+{
+	return type() == ARRAY_VALUE;
+}
+
+
+inline bool Document::Value::isObject() const
+{
+	return type() == OBJECT_VALUE;
+}
+
+
+inline bool Document::Value::has(const std::string& key) const
+{
+	return type() == OBJECT_VALUE && _doc->findMember(_doc->node(_node), key) != NULL;
+}
+
+
+inline Document::Value Document::root() const
+{
+	return Value(this, 0);
+}
+
+
+inline std::size_t Document::memoryUsage() const
+{
+	return _size;
+}
+
+
+inline const Document::Node& Document::node(UInt32 index) const
+{
+	return _nodes[index];
+}
+
+
+}} // Namespace Poco::JSON
+
+#endif // JSON_Document_INCLUDED
@@ -0,0 +1,199 @@
+//
+// DocumentHandler.h
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  DocumentHandler
+//
+// Definition of the DocumentHandler class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef JSON_DocumentHandler_INCLUDED
+#define JSON_DocumentHandler_INCLUDED
+
+
+#include <vector>
+
+#include "Poco/JSON/Handler.h"
+#include "Poco/JSON/Document.h"
+
+namespace Poco
+{
+namespace JSON
+{
+
+class JSON_API DocumentHandler : public Handler
+	/// A handler for the JSON parser that builds a compact,
+	/// read-only Document instead of Object and Array instances.
+	///
+	/// The handler keeps its working buffers between parses,
+	/// so reusing one handler for many documents avoids most
+	/// allocations while building.
+{
+public:
+
+
+	DocumentHandler();
+		/// Default Constructor
+
+
+	virtual ~DocumentHandler();
+		/// Destructor
+
+
+	void reset();
+		/// Discards the result and a partially built document, but keeps
+		/// the memory of the working buffers. The parser calls this before
+		/// each parse, so the handler can be reused after a parse failed.
+
+
+	void startObject();
+		/// Handles a {, meaning a new object will be read
+
+
+	void endObject();
+		/// Handles a }, meaning the object is read
+
+
+	void startArray();
+		/// Handles a [, meaning a new array will be read
+
+
+	void endArray();
+		/// Handles a ], meaning the array is read
+
+
+	void key(const std::string& k);
+		/// A key is read
+
+
+	Document::Ptr result() const;
+		/// Returns the document of the last parse
+
+
+	void value(int v);
+		/// An integer value is read
+
+
+	void value(const std::string& s);
+		/// A string value is read.
+
+
+	void value(double d);
+		/// A double value is read
+
+
+	void value(bool b);
+		/// A boolean value is read
+
+
+	void null();
+		/// A null value is read
+
+
+private:
+
+
+	struct Level
+	{
+		UInt32 node;
+		std::size_t pending;
+	};
+
+
+	struct Key
+	{
+		UInt32 offset;
+		UInt32 length;
+	};
+
+
+	class KeyLess;
+
+
+	UInt32 addNode(const Document::Node& node);
+		/// Adds the node to the document and to the open container
+
+
+	void startContainer(Document::Type type);
+
+
+	void endContainer();
+
+
+	void growKeys();
+		/// Doubles the size of the key table
+
+
+	std::vector<Document::Node> _nodes;
+
+
+	std::vector<Document::Member> _members;
+
+
+	std::vector<UInt32> _elements;
+
+
+	std::string _strings;
+
+
+	std::vector<Level> _stack;
+
+
+	std::vector<Document::Member> _pendingMembers;
+
+
+	std::vector<UInt32> _pendingElements;
+
+
+	std::vector<Key> _keys;
+		/// Open addressing hash table of the keys in _strings.
+		/// Clearing it keeps its memory, unlike clearing a map.
+
+
+	std::size_t _keyCount;
+
+
+	Document::Member _key;
+
+
+	Document::Ptr _result;
+};
+
+
+inline Document::Ptr DocumentHandler::result() const
+{
+	return _result;
+}
+
+
+}} // Namespace Poco::JSON
+
+#endif // JSON_DocumentHandler_INCLUDED
@@ -52,6 +52,12 @@ class JSON_API Handler
 public:
 
 
+	virtual void reset();
+		/// Called by the parser before it parses a new document,
+		/// so state left behind by a failed parse can be discarded.
+		/// The default implementation does nothing.
+
+
 	virtual void startObject() = 0;
 		/// The parser has read a {, meaning a new object will be read
 
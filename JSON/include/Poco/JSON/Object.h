@@ -64,6 +64,9 @@ public:
 	typedef SharedPtr<Object> Ptr;
 
 
+	typedef std::map<std::string, DynamicAny> ValueMap;
+
+
 	Object();
 		/// Default constructor
 
@@ -103,6 +106,14 @@ public:
 		return value.convert<T>();
 	}
 
+	ValueMap::const_iterator begin() const;
+		/// Returns iterator
+
+
+	ValueMap::const_iterator end() const;
+		/// Returns iterator
+
+
 	void getNames(std::vector<std::string>& names) const;
 		/// Returns all property names
 
@@ -166,11 +177,21 @@ public:
 
 private:
 
-	typedef std::map<std::string, DynamicAny> ValueMap;
 	ValueMap _values;
 };
 
 
+inline Object::ValueMap::const_iterator Object::begin() const
+{
+	return _values.begin();
+}
+
+inline Object::ValueMap::const_iterator Object::end() const
+{
+	return _values.end();
+}
+
+
 inline bool Object::has(const std::string& key) const
 {
 	ValueMap::const_iterator it = _values.find(key);
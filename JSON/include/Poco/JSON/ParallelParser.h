@@ -0,0 +1,225 @@
+//
+// ParallelParser.h
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  ParallelParser
+//
+// Definition of the ParallelParser class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef JSON_ParallelParser_INCLUDED
+#define JSON_ParallelParser_INCLUDED
+
+
+#include <string>
+
+#include "Poco/DynamicAny.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/JSON/JSON.h"
+
+namespace Poco
+{
+namespace JSON
+{
+
+class JSON_API ParallelParser
+	/// Parses the records of a newline delimited JSON (NDJSON) document,
+	/// or the elements of a top-level JSON array, on the threads of a
+	/// ThreadPool.
+	///
+	/// The input is split into chunks of about getChunkSize() bytes that
+	/// end on a record boundary. For NDJSON a chunk ends after a newline.
+	/// For an array the elements are found with a scan that only tracks
+	/// string quotes and nesting, which is much faster than parsing;
+	/// chunks are handed to the pool as soon as they are found. Each
+	/// record is parsed with Parser and DefaultHandler (objects and arrays)
+	/// or Reader (scalars).
+	///
+	/// In ordered mode (the default) the callback is called from the
+	/// thread that calls parse(), with the records in the order of the
+	/// document. Otherwise it is called from the pool threads as soon as
+	/// a record is parsed, concurrently and in any order; the callback
+	/// must then be thread-safe.
+	///
+	/// The number of chunks in progress is limited to twice the capacity
+	/// of the pool, which also limits the memory used for the parsed
+	/// records waiting for delivery in ordered mode.
+{
+public:
+
+	class JSON_API Callback
+		/// Receives the parsed records
+	{
+	public:
+		virtual ~Callback();
+
+		virtual void handle(const DynamicAny& value) = 0;
+			/// Called for each record. Objects and arrays are passed
+			/// as Object::Ptr and Array::Ptr.
+	};
+
+
+	enum Format
+	{
+		FORMAT_AUTO,   /// An array when the first character is a [, otherwise NDJSON
+		FORMAT_NDJSON, /// One value per line
+		FORMAT_ARRAY   /// The elements of a top-level array
+	};
+
+
+	enum
+	{
+		DEFAULT_CHUNK_SIZE = 1048576
+	};
+
+
+	ParallelParser(ThreadPool& pool = ThreadPool::defaultPool());
+		/// Creates a parser that uses the threads of the pool
+
+
+	virtual ~ParallelParser();
+		/// Destructor
+
+
+	void setFormat(Format format);
+		/// Sets the format of the input
+
+
+	Format getFormat() const;
+		/// Returns the format of the input
+
+
+	void setOrdered(bool ordered);
+		/// When ordered, the callback receives the records in the
+		/// order of the document from the thread that calls parse().
+
+
+	bool isOrdered() const;
+		/// Returns true when the records are delivered in order
+
+
+	void setChunkSize(std::size_t chunkSize);
+		/// Sets the approximate number of bytes that is parsed in one task
+
+
+	std::size_t getChunkSize() const;
+		/// Returns the chunk size
+
+
+	std::size_t parse(const char* json, std::size_t length, Callback& callback);
+		/// Parses all records of the buffer and returns the number of
+		/// records. The buffer must stay valid until parse() returns. When a
+		/// record is invalid, or the callback throws, no more chunks are
+		/// started and the exception is rethrown when the running chunks
+		/// are done.
+
+
+	std::size_t parse(const std::string& json, Callback& callback);
+		/// Parses all records of the string
+
+
+	std::size_t parseFile(const std::string& path, Callback& callback);
+		/// Maps the file into memory and parses all its records
+
+
+	static const char* findRecordEnd(const char* begin, const char* end);
+		/// Returns the position of the , or ] that ends the array element
+		/// starting at begin, or end when the element doesn't end in the
+		/// buffer. Commas and brackets in strings and nested values are
+		/// skipped.
+
+
+private:
+
+	ParallelParser(const ParallelParser&);
+	ParallelParser& operator = (const ParallelParser&);
+
+
+	ThreadPool& _pool;
+
+
+	Format _format;
+
+
+	bool _ordered;
+
+
+	std::size_t _chunkSize;
+};
+
+
+inline void ParallelParser::setFormat(Format format)
+{
+	_format = format;
+}
+
+
+inline ParallelParser::Format ParallelParser::getFormat() const
+{
+	return _format;
+}
+
+
+inline void ParallelParser::setOrdered(bool ordered)
+{
+	_ordered = ordered;
+}
+
+
+inline bool ParallelParser::isOrdered() const
+{
+	return _ordered;
+}
+
+
+inline void ParallelParser::setChunkSize(std::size_t chunkSize)
+{
+	poco_assert (chunkSize > 0);
+	_chunkSize = chunkSize;
+}
+
+
+inline std::size_t ParallelParser::getChunkSize() const
+{
+	return _chunkSize;
+}
+
+
+inline std::size_t ParallelParser::parse(const std::string& json, Callback& callback)
+{
+	return parse(json.data(), json.size(), callback);
+}
+
+
+}} // Namespace Poco::JSON
+
+
+#endif // JSON_ParallelParser_INCLUDED
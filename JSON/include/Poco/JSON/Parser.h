@@ -69,7 +69,20 @@ public:
 
 
 	void parse(const std::string& source);
-		/// Parses a string
+		/// Parses a string. The string is scanned in place
+		/// (see parse(const char*, std::size_t)).
+
+
+	void parse(const char* json, std::size_t length);
+		/// Parses a JSON document from a contiguous buffer of
+		/// length bytes. The buffer doesn't need to be zero terminated.
+		///
+		/// The buffer is scanned directly, without the StreamTokenizer,
+		/// which avoids creating a Token and a string for each lexeme.
+		/// Whitespace and string contents are skipped 16 bytes at a
+		/// time when SSE2 is available. The same events are sent to the
+		/// handler as with parse(std::istream&). Integers that don't fit
+		/// in an int are passed to the handler as a double.
 
 
 	void parse(std::istream& in);
@@ -110,17 +123,61 @@ private:
 		/// Read all elements of an array
 
 
+	char scanChar();
+		/// Skips whitespace and returns the next character of the buffer
+
+
+	void scanObject();
+		/// Scans an object from the buffer. The { is already read.
+
+
+	void scanArray();
+		/// Scans an array from the buffer. The [ is already read.
+
+
+	void scanValue(char c);
+		/// Scans a value from the buffer. c is the first character of the value.
+
+
+	void scanString(std::string& value);
+		/// Scans a string from the buffer. The opening quote is already read.
+
+
+	void scanEscape(std::string& value);
+		/// Scans an escape sequence. The backslash is already read.
+
+
+	Poco::Int32 scanUnicode();
+		/// Scans the four hexadecimal digits of a \u escape
+
+
+	void scanNumber();
+		/// Scans a number from the buffer
+
+
+	void scanKeyword();
+		/// Scans true, false or null from the buffer
+
+
 	StreamTokenizer _tokenizer;
 
 
+	const char* _pos;
+
+
+	const char* _end;
+
+
+	std::string _scanned;
+
+
 	Handler* _handler;
 };
 
 
 inline void Parser::parse(const std::string& source)
 {
-	std::istringstream is(source);
-	parse(is);
+	parse(source.data(), source.size());
 }
 
 
@@ -75,7 +75,14 @@ public:
 		/// Searches a value
 		/// For example: "person.children[0].name" will return the
 		/// the name of the first child. When the value can't be found
-		/// an empty value is returned.
+		/// an empty value is returned. The path is compiled once and
+		/// cached, see CompiledQuery.
+
+
+	Array::Ptr findAll(const std::string& path) const;
+		/// Searches all values matching a path with [*] wildcards.
+		/// For example: "person.children[*].name" returns an array
+		/// with the names of all children.
 
 
 	template<typename T>
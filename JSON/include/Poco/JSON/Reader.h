@@ -0,0 +1,377 @@
+//
+// Reader.h
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  Reader
+//
+// Definition of the Reader class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef JSON_Reader_INCLUDED
+#define JSON_Reader_INCLUDED
+
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "Poco/DynamicAny.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/JSON/JSON.h"
+
+namespace Poco
+{
+namespace JSON
+{
+
+class DefaultHandler;
+
+class JSON_API Reader
+	/// A pull reader for JSON. Each call to next() returns the next
+	/// event of the document; the value of a key or scalar is available
+	/// with getString(), getInteger(), getDouble() and getBoolean()
+	/// until the next call.
+	///
+	/// The reader works on a buffer of a fixed size. Input is either
+	/// read from a stream when the buffer is empty, or added with
+	/// feed() (for example when data arrives on a non-blocking socket).
+	/// When all data in the buffer is used, next() returns NEED_MORE_INPUT;
+	/// after feeding more data, next() continues where it stopped, even
+	/// in the middle of a string or a number. Memory use doesn't depend on
+	/// the size of the document: only the current key or value and the
+	/// nesting of containers are kept. A skipped value doesn't store its
+	/// strings at all.
+	///
+	/// In NDJSON mode the input may contain any number of top-level values
+	/// separated by whitespace (typically a newline), and nextValue() returns
+	/// them one at a time.
+	///
+	/// Usage:
+	///    Reader reader;
+	///    while ( (n = socket.receiveBytes(data, sizeof(data))) > 0 )
+	///    {
+	///        const char* p = data;
+	///        while ( n > 0 )
+	///        {
+	///            std::size_t accepted = reader.feed(p, n);
+	///            p += accepted; n -= accepted;
+	///            Reader::Event event;
+	///            while ( (event = reader.next()) != Reader::NEED_MORE_INPUT ) ...
+	///        }
+	///    }
+	///    reader.finish();
+{
+public:
+
+	enum Event
+	{
+		NEED_MORE_INPUT, /// All data is used, call feed() or finish()
+		END_OF_INPUT,    /// The document (or all NDJSON values) is read
+		START_OBJECT,
+		END_OBJECT,
+		START_ARRAY,
+		END_ARRAY,
+		KEY,
+		NULL_VALUE,
+		BOOLEAN_VALUE,
+		INTEGER_VALUE,   /// An integer that fits an Int64
+		DOUBLE_VALUE,
+		STRING_VALUE
+	};
+
+
+	enum
+	{
+		DEFAULT_BUFFER_SIZE = 65536
+	};
+
+
+	Reader(std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+		/// Creates a reader for input passed with feed()
+
+
+	Reader(std::istream& in, std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+		/// Creates a reader that reads the input from the stream.
+		/// next() never returns NEED_MORE_INPUT.
+
+
+	virtual ~Reader();
+		/// Destructor
+
+
+	void setNDJSON(bool ndjson);
+		/// Allows multiple top-level values
+
+
+	bool isNDJSON() const;
+		/// Returns true when multiple top-level values are allowed
+
+
+	std::size_t feed(const char* data, std::size_t length);
+		/// Adds data to the buffer and returns the number of bytes that
+		/// were stored, which can be less than length when the buffer is
+		/// full. The remaining bytes must be fed again after next()
+		/// returned NEED_MORE_INPUT.
+
+
+	void finish();
+		/// Tells the reader that no more input will be fed
+
+
+	Event next();
+		/// Returns the next event. Throws a JSONException when the
+		/// input isn't valid JSON.
+
+
+	bool skipValue();
+		/// Skips the value that belongs to the last event: the rest of
+		/// the object or array after START_OBJECT or START_ARRAY, or the
+		/// value of a KEY. Nothing is skipped after a scalar value.
+		/// Returns false when more input is needed; call skipValue()
+		/// again after feeding more data to continue skipping.
+
+
+	bool nextValue(DynamicAny& value);
+		/// Reads the next complete value at the current depth, an element of
+		/// an array or a top-level value, into value. Objects and arrays are
+		/// returned as Object::Ptr and Array::Ptr. Returns false when more
+		/// input is needed (call again after feeding, the partial value is
+		/// kept), at the end of the input or at the end of the array.
+
+
+	Event event() const;
+		/// Returns the last event
+
+
+	std::size_t currentDepth() const;
+		/// Returns the number of open objects and arrays
+
+
+	const std::string& getString() const;
+		/// Returns the key or the string value
+
+
+	Int64 getInteger() const;
+		/// Returns the integer value
+
+
+	double getDouble() const;
+		/// Returns the double value. Also valid for an integer value.
+
+
+	bool getBoolean() const;
+		/// Returns the boolean value
+
+
+private:
+
+	enum State
+	{
+		STATE_VALUE,
+		STATE_VALUE_OR_END,
+		STATE_KEY,
+		STATE_KEY_OR_END,
+		STATE_COLON,
+		STATE_COMMA_OR_END,
+		STATE_DONE
+	};
+
+	enum Lexeme
+	{
+		LEX_NONE,
+		LEX_STRING,
+		LEX_NUMBER,
+		LEX_KEYWORD
+	};
+
+
+	Reader(const Reader&);
+	Reader& operator = (const Reader&);
+
+
+	bool fill();
+		/// Makes data available in the buffer. Returns false when
+		/// there is no more data for now.
+
+
+	Event scan();
+		/// Continues the current lexeme. Returns NEED_MORE_INPUT
+		/// when the buffer is used before the lexeme is complete.
+
+
+	Event scanString();
+
+
+	Event scanNumber();
+
+
+	Event scanKeyword();
+
+
+	Event startContainer(char type);
+
+
+	Event endContainer(char type);
+
+
+	void endValue();
+
+
+	void decodeString(const char* begin, const char* end);
+		/// Decodes the escapes of the string into _string
+
+
+	Event decodeNumber(const char* begin, const char* end);
+
+
+	Event decodeKeyword(const char* begin, const char* end);
+
+
+	std::istream* _in;
+
+
+	std::vector<char> _buffer;
+
+
+	std::size_t _begin;
+
+
+	std::size_t _end;
+
+
+	bool _finished;
+
+
+	bool _ndjson;
+
+
+	std::vector<char> _stack;
+
+
+	State _state;
+
+
+	Lexeme _lexeme;
+
+
+	bool _isKey;
+
+
+	bool _escaped;
+
+
+	std::string _raw;
+		/// The part of a lexeme that was read before the buffer was used
+
+
+	Event _event;
+
+
+	std::string _string;
+
+
+	Int64 _integer;
+
+
+	double _double;
+
+
+	std::size_t _skipDepth;
+
+
+	bool _skipping;
+
+
+	SharedPtr<DefaultHandler> _builder;
+
+
+	std::size_t _valueDepth;
+};
+
+
+inline void Reader::setNDJSON(bool ndjson)
+{
+	_ndjson = ndjson;
+}
+
+
+inline bool Reader::isNDJSON() const
+{
+	return _ndjson;
+}
+
+
+inline void Reader::finish()
+{
+	_finished = true;
+}
+
+
+inline Reader::Event Reader::event() const
+{
+	return _event;
+}
+
+
+inline std::size_t Reader::currentDepth() const
+{
+	return _stack.size();
+}
+
+
+inline const std::string& Reader::getString() const
+{
+	return _string;
+}
+
+
+inline Int64 Reader::getInteger() const
+{
+	return _integer;
+}
+
+
+inline double Reader::getDouble() const
+{
+	return _double;
+}
+
+
+inline bool Reader::getBoolean() const
+{
+	return _integer != 0;
+}
+
+
+}} // Namespace Poco::JSON
+
+
+#endif // JSON_Reader_INCLUDED
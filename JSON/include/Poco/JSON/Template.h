@@ -55,6 +55,7 @@ namespace JSON
 {
 
 class MultiPart;
+class TemplateProgram;
 
 POCO_DECLARE_EXCEPTION(JSON_API, JSONTemplateException, Poco::Exception)
 
@@ -92,6 +93,13 @@ class JSON_API Template
 	///     is used.
 	///
 	///  A query is passed to Poco::JSON::Query to get the value.
+	///
+	/// After parsing, a template can be compiled into a flat list of
+	/// instructions with compile(). Queries are compiled only once and
+	/// text is copied from one block. The output of a compiled template,
+	/// including compiled templates it includes, is collected in a buffer
+	/// that is written to the output stream in large chunks.
+	/// TemplateCache compiles the templates it loads.
 {
 public:
 	typedef SharedPtr<Template> Ptr;
@@ -125,13 +133,35 @@ public:
 		/// Returns the time when the template was parsed
 
 
+	void compile();
+		/// Compiles the parsed template into a list of instructions
+		/// which will be used by render(). Parsing the template again
+		/// discards the compiled instructions.
+
+
+	bool isCompiled() const;
+		/// Returns true when the template is compiled
+
+
 	void render(const DynamicAny& data, std::ostream& out) const;
 		/// Renders the template and send the output to the stream
 
 
+	enum
+	{
+		RENDER_CHUNK_SIZE = 16384
+			/// A compiled template writes its output in chunks of this size
+	};
+
+
 private:
 
 
+	void execute(const DynamicAny& data, std::string& buffer, std::ostream& out) const;
+		/// Runs the compiled instructions. Output is added to buffer,
+		/// which is written to out when it reaches RENDER_CHUNK_SIZE.
+
+
 	std::string readText(std::istream& in);
 
 
@@ -163,6 +193,10 @@ private:
 
 
 	Timestamp _parseTime;
+
+
+	TemplateProgram* _program;
+
 };
 
 inline void Template::parse(const std::string& source)
@@ -177,6 +211,12 @@ inline Timestamp Template::parseTime() const
 	return _parseTime;
 }
 
+
+inline bool Template::isCompiled() const
+{
+	return _program != NULL;
+}
+
 }} // Namespace Poco::JSON
 
 #endif // JSON_JSONTemplate_INCLUDED
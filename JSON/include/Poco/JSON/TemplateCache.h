@@ -43,8 +43,15 @@
 #include <map>
 
 #include "Poco/Path.h"
+#include "Poco/File.h"
 #include "Poco/SharedPtr.h"
 #include "Poco/Logger.h"
+#include "Poco/RWLock.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include "Poco/RunnableAdapter.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Timestamp.h"
 
 #include "Poco/JSON/Template.h"
 
@@ -55,16 +62,37 @@ namespace JSON
 
 class JSON_API TemplateCache
 	/// Use to cache parsed templates. Templates are
-	/// stored in a map with the full path as key.
-	/// When a template file has changed, the cache
-	/// will remove the old template from the cache
-	/// and load a new one.
+	/// stored in a map with the path as key.
+	///
+	/// The cache can be used from multiple threads. A lookup
+	/// of a cached template only takes a read lock; loading
+	/// and removing templates take the write lock.
+	///
+	/// The number of templates is limited by the capacity.
+	/// When a template is loaded into a full cache, the least
+	/// recently used template is removed.
+	///
+	/// Template files are not checked on each lookup. A
+	/// background thread watches the files: on Linux it uses
+	/// inotify on the directories of the templates, elsewhere (or
+	/// when inotify is not available) it checks the modification
+	/// time and size of the files at the poll interval. A changed
+	/// template is reloaded on the next lookup.
 {
 public:
 
-	TemplateCache();
+	enum
+	{
+		DEFAULT_CAPACITY = 256,
+		DEFAULT_POLL_INTERVAL = 1000 // milliseconds
+	};
+
+
+	TemplateCache(std::size_t capacity = DEFAULT_CAPACITY, long pollInterval = DEFAULT_POLL_INTERVAL, bool notify = true);
 		/// Constructor. The cache must be created
 		/// and not destroyed as long as it is used.
+		/// A capacity of 0 means no limit. When notify is false,
+		/// polling is used even when inotify is available.
 
 
 	virtual ~TemplateCache();
@@ -83,7 +111,42 @@ public:
 		/// will be (re)loaded and parsed. A shared pointer
 		/// is returned, so it is safe to use this template
 		/// even when the template isn't stored anymore in
-		/// the cache.
+		/// the cache. When reloading a changed template fails,
+		/// the previous template is kept.
+
+
+	void setCapacity(std::size_t capacity);
+		/// Sets the maximum number of templates. When the cache
+		/// contains more templates, the least recently used
+		/// templates are removed.
+
+
+	std::size_t capacity() const;
+		/// Returns the maximum number of templates
+
+
+	std::size_t size() const;
+		/// Returns the number of templates in the cache
+
+
+	void clear();
+		/// Removes all templates from the cache
+
+
+	bool isNotifying() const;
+		/// Returns true when changes are detected with inotify
+
+
+	int hits() const;
+		/// Returns the number of lookups that found a valid template
+
+
+	int misses() const;
+		/// Returns the number of lookups that had to load a template
+
+
+	int reloads() const;
+		/// Returns the number of lookups that reloaded a changed template
 
 
 	static TemplateCache* instance();
@@ -96,28 +159,142 @@ public:
 
 private:
 
+	struct Entry
+	{
+		Template::Ptr tpl;
+
+		std::string pathname;
+
+		Timestamp modified;
+
+		File::FileSize size;
+
+		AtomicCounter lastUsed;
+
+		bool watched;
+
+		bool stale;
+	};
+
+	typedef std::map<std::string, Entry> EntryMap;
+
+
 	static TemplateCache* _instance;
 
 
 	std::vector<Path> _includePaths;
 
 
-	std::map<std::string, Template::Ptr> _cache;
+	EntryMap _cache;
+
+
+	mutable RWLock _lock;
+
+
+	std::size_t _capacity;
+
+
+	long _pollInterval;
+
+
+	AtomicCounter _clock;
+
+
+	AtomicCounter _hits;
+
+
+	AtomicCounter _misses;
+
+
+	AtomicCounter _reloads;
 
 
 	Logger* _logger;
 
 
+	int _notifyFd;
+
+
+	int _wakeFd[2];
+
+
+	std::map<int, std::string> _watches;
+
+
+	Event _stop;
+
+
+	RunnableAdapter<TemplateCache> _watcher;
+
+
+	Thread _thread;
+
+
 	void setup();
 
 
 	Path resolvePath(const Path& path) const;
+
+
+	void evict();
+		/// Removes least recently used templates until the
+		/// size is within the capacity. Must hold the write lock.
+
+
+	void renumber();
+		/// Restarts the use clock before it overflows.
+		/// Must hold the write lock.
+
+
+	bool watch(const std::string& pathname);
+		/// Adds an inotify watch for the directory of the file.
+		/// Must hold the write lock.
+
+
+	void invalidate(const std::string& pathname);
+		/// Marks all templates of the file as stale.
+		/// Must hold the write lock.
+
+
+	void run();
+		/// The watcher thread
+
+
+	void readEvents();
+
+
+	void poll();
+		/// Checks the files that are not watched with inotify
 };
 
 
-inline void TemplateCache::addPath(const Path& path)
+inline std::size_t TemplateCache::capacity() const
+{
+	return _capacity;
+}
+
+
+inline int TemplateCache::hits() const
+{
+	return _hits.value();
+}
+
+
+inline int TemplateCache::misses() const
+{
+	return _misses.value();
+}
+
+
+inline int TemplateCache::reloads() const
+{
+	return _reloads.value();
+}
+
+
+inline bool TemplateCache::isNotifying() const
 {
-	_includePaths.push_back(path);
+	return _notifyFd != -1;
 }
 
 
@@ -0,0 +1,277 @@
+//
+// Writer.h
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  Writer
+//
+// Definition of the Writer class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef JSON_Writer_INCLUDED
+#define JSON_Writer_INCLUDED
+
+
+#include <ostream>
+#include <string>
+
+#include "Poco/DynamicAny.h"
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/Handler.h"
+
+namespace Poco
+{
+namespace JSON
+{
+
+class JSON_API Writer : public Handler
+	/// Writes JSON text into a growable character buffer.
+	///
+	/// A Writer can be used as a SAX-style emitter by calling
+	/// startObject(), key(), value(), ... directly, which never
+	/// builds Object or Array instances. It can also serialize
+	/// a DynamicAny holding an Object::Ptr, an Array::Ptr or a
+	/// scalar with stringify(). Because a Writer is a Handler, it
+	/// can be set on a Parser to reformat a document.
+	///
+	/// Strings are escaped by copying runs of characters that need
+	/// no escaping at once. Numbers are formatted without iostreams;
+	/// doubles use the shortest form that reads back to the same value.
+	///
+	/// When a Writer is created for an output stream, the buffer is
+	/// written to the stream each time it holds chunkSize bytes and
+	/// when the Writer is destroyed. To send the chunks somewhere else,
+	/// like a socket, subclass Writer and override writeChunk().
+	///
+	/// The Writer doesn't validate the structure of the document:
+	/// calls must be made in a valid order.
+{
+public:
+
+	enum
+	{
+		DEFAULT_CHUNK_SIZE = 8192
+	};
+
+
+	Writer();
+		/// Creates a Writer that keeps all output in its buffer.
+		/// Use str() to get the result.
+
+
+	Writer(std::ostream& out, std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+		/// Creates a Writer that writes the output to out,
+		/// in chunks of about chunkSize bytes.
+
+
+	virtual ~Writer();
+		/// Destructor. Writes all buffered output.
+
+
+	void setIndent(unsigned int indent);
+		/// Sets the number of spaces used for each level of indentation.
+		/// When indent is 0 (the default), no whitespace is written at all.
+
+
+	void startObject();
+		/// Writes a {
+
+
+	void endObject();
+		/// Writes a }
+
+
+	void startArray();
+		/// Writes a [
+
+
+	void endArray();
+		/// Writes a ]
+
+
+	void key(const std::string& k);
+		/// Writes the key of a property. The next call
+		/// must write the value of the property.
+
+
+	void key(const char* k, std::size_t length);
+		/// Writes a key of length bytes.
+
+
+	void null();
+		/// Writes a null value
+
+
+	void value(int v);
+		/// Writes an integer value
+
+
+	void value(Int64 v);
+		/// Writes an integer value
+
+
+	void value(UInt64 v);
+		/// Writes an unsigned integer value
+
+
+	void value(double d);
+		/// Writes a double value. NaN and infinity can't be
+		/// represented in JSON and are written as null. Integral
+		/// values get a ".0", so they are read back as a double.
+
+
+	void value(bool b);
+		/// Writes a boolean value
+
+
+	void value(const std::string& s);
+		/// Writes a string value
+
+
+	void value(const char* s);
+		/// Writes a zero terminated string value
+
+
+	void value(const char* s, std::size_t length);
+		/// Writes a string value of length bytes
+
+
+	void stringify(const DynamicAny& any);
+		/// Writes a value. When any contains an Object::Ptr
+		/// or an Array::Ptr, the complete object or array is written.
+
+
+	void flush();
+		/// Writes the buffered output. Does nothing for
+		/// a Writer that keeps all output in its buffer.
+
+
+	const std::string& str() const;
+		/// Returns the buffered output
+
+
+	void clear();
+		/// Clears the buffer so the Writer can be reused.
+		/// The memory of the buffer is kept.
+
+
+protected:
+
+	Writer(std::size_t chunkSize);
+		/// Creates a Writer for a subclass that
+		/// overrides writeChunk().
+
+
+	virtual void writeChunk(const char* data, std::size_t length);
+		/// Writes a chunk of output. The default
+		/// implementation writes it to the output stream.
+
+
+private:
+
+	Writer(const Writer&);
+	Writer& operator = (const Writer&);
+
+	void prefix();
+		/// Writes the comma and indentation in front of a value
+
+
+	void close(char c);
+		/// Ends an object or array
+
+
+	void writeString(const char* s, std::size_t length);
+		/// Writes an escaped, quoted string
+
+
+	void writeNewLine();
+
+
+	void checkFlush();
+
+
+	std::string _buffer;
+
+
+	std::ostream* _pOut;
+
+
+	std::size_t _chunkSize;
+
+
+	unsigned int _indent;
+
+
+	unsigned int _depth;
+
+
+	bool _needComma;
+
+
+	bool _afterKey;
+};
+
+
+inline void Writer::setIndent(unsigned int indent)
+{
+	_indent = indent;
+}
+
+
+inline const std::string& Writer::str() const
+{
+	return _buffer;
+}
+
+
+inline void Writer::checkFlush()
+{
+	if ( _chunkSize > 0 && _buffer.size() >= _chunkSize )
+	{
+		flush();
+	}
+}
+
+
+inline void Writer::key(const std::string& k)
+{
+	key(k.data(), k.length());
+}
+
+
+inline void Writer::value(const std::string& s)
+{
+	value(s.data(), s.length());
+}
+
+
+}} // Namespace Poco::JSON
+
+#endif // JSON_Writer_INCLUDED
@@ -0,0 +1,252 @@
+//
+// CompiledQuery.cpp
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  CompiledQuery
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include <map>
+
+#include "Poco/Ascii.h"
+#include "Poco/RWLock.h"
+#include "Poco/SingletonHolder.h"
+
+#include "Poco/JSON/CompiledQuery.h"
+#include "Poco/JSON/Object.h"
+
+namespace Poco
+{
+namespace JSON
+{
+
+
+namespace
+{
+	class QueryCache
+		/// The process wide cache of compiled queries.
+		/// Lookups only take a read lock, so threads
+		/// evaluating known paths don't block each other.
+	{
+	public:
+		CompiledQuery::Ptr find(const std::string& path)
+		{
+			ScopedRWLock lock(_lock, false);
+
+			std::map<std::string, CompiledQuery::Ptr>::const_iterator it = _queries.find(path);
+			if ( it != _queries.end() )
+			{
+				return it->second;
+			}
+			return CompiledQuery::Ptr();
+		}
+
+		void add(const CompiledQuery::Ptr& query)
+		{
+			ScopedRWLock lock(_lock, true);
+
+			if ( _queries.size() >= CompiledQuery::CACHE_SIZE )
+			{
+				_queries.clear();
+			}
+			_queries[query->path()] = query;
+		}
+
+	private:
+		std::map<std::string, CompiledQuery::Ptr> _queries;
+
+		RWLock _lock;
+	};
+
+
+	static SingletonHolder<QueryCache> sh;
+}
+
+
+CompiledQuery::CompiledQuery(const std::string& path) : _path(path), _wildcard(false)
+{
+	parse();
+}
+
+
+CompiledQuery::~CompiledQuery()
+{
+}
+
+
+CompiledQuery::Ptr CompiledQuery::compile(const std::string& path)
+{
+	QueryCache* cache = sh.get();
+
+	Ptr query = cache->find(path);
+	if ( query.isNull() )
+	{
+		query = new CompiledQuery(path);
+		cache->add(query);
+	}
+	return query;
+}
+
+
+void CompiledQuery::parse()
+{
+	// Each part between dots is a property name followed by indexes
+	// like [0] or [*]. Characters between or after the indexes are
+	// ignored, as Query always did.
+	std::string::size_type start = 0;
+	while ( start <= _path.length() )
+	{
+		std::string::size_type end = _path.find('.', start);
+		if ( end == std::string::npos )
+		{
+			end = _path.length();
+		}
+
+		std::string::size_type nameEnd = end;
+		std::vector<Step> indexes;
+		std::string::size_type pos = _path.find('[', start);
+		while ( pos < end )
+		{
+			std::string::size_type digits = pos + 1;
+			std::string::size_type close = digits;
+			while ( close < end && Ascii::isDigit(_path[close]) ) ++close;
+
+			Step step;
+			step.index = 0;
+			if ( close > digits && close < end && _path[close] == ']' )
+			{
+				step.kind = Step::INDEX;
+				for(std::string::size_type i = digits; i < close; i++)
+				{
+					step.index = step.index * 10 + (_path[i] - '0');
+				}
+			}
+			else if ( close == digits && close + 1 < end && _path[close] == '*' && _path[close + 1] == ']' )
+			{
+				step.kind = Step::WILDCARD;
+				++close;
+				_wildcard = true;
+			}
+			else
+			{
+				pos = _path.find('[', pos + 1);
+				continue;
+			}
+
+			if ( indexes.empty() )
+			{
+				nameEnd = pos;
+			}
+			indexes.push_back(step);
+			pos = _path.find('[', close + 1);
+		}
+
+		if ( nameEnd > start )
+		{
+			Step step;
+			step.kind = Step::KEY;
+			step.key.assign(_path, start, nameEnd - start);
+			step.index = 0;
+			_steps.push_back(step);
+		}
+		_steps.insert(_steps.end(), indexes.begin(), indexes.end());
+
+		start = end + 1;
+	}
+}
+
+
+DynamicAny CompiledQuery::find(const DynamicAny& source) const
+{
+	DynamicAny first;
+	walk(source, _steps.begin(), NULL, first);
+	return first;
+}
+
+
+void CompiledQuery::findAll(const DynamicAny& source, Array::ValueVector& result) const
+{
+	DynamicAny first;
+	walk(source, _steps.begin(), &result, first);
+}
+
+
+bool CompiledQuery::walk(DynamicAny value, Steps::const_iterator step, Array::ValueVector* result, DynamicAny& first) const
+{
+	// A step that doesn't match the type of the value leaves
+	// the value unchanged, as Query always did.
+	for(; step != _steps.end() && !value.isEmpty(); ++step)
+	{
+		switch(step->kind)
+		{
+		case Step::KEY:
+			if ( value.type() == typeid(Object::Ptr) )
+			{
+				Object::Ptr object = value.extract<Object::Ptr>();
+				value = object->get(step->key);
+			}
+			break;
+		case Step::INDEX:
+			if ( value.type() == typeid(Array::Ptr) )
+			{
+				Array::Ptr array = value.extract<Array::Ptr>();
+				value = array->get(step->index);
+			}
+			break;
+		case Step::WILDCARD:
+			if ( value.type() == typeid(Array::Ptr) )
+			{
+				Array::Ptr array = value.extract<Array::Ptr>();
+				for(Array::ValueVector::const_iterator it = array->begin(); it != array->end(); ++it)
+				{
+					if ( !walk(*it, step + 1, result, first) )
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+	}
+
+	if ( result == NULL )
+	{
+		first = value;
+		return value.isEmpty(); // Continue with the next wildcard element when nothing is found
+	}
+	if ( !value.isEmpty() )
+	{
+		result->push_back(value);
+	}
+	return true;
+}
+
+
+}} // Namespace Poco::JSON
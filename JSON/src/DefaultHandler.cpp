@@ -50,6 +50,13 @@ DefaultHandler::~DefaultHandler()
 }
 
 
+void DefaultHandler::reset()
+{
+	_stack = std::stack<DynamicAny>();
+	_key.clear();
+}
+
+
 void DefaultHandler::startObject()
 {
 	Object::Ptr newObj = new Object();
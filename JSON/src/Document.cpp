@@ -0,0 +1,207 @@
+//
+// Document.cpp
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  Document
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "Poco/JSON/Document.h"
+
+namespace Poco
+{
+namespace JSON
+{
+
+
+Document::Document(const Node* nodes, std::size_t nodeCount,
+                   const Member* members, std::size_t memberCount,
+                   const UInt32* elements, std::size_t elementCount,
+                   const char* strings, std::size_t stringLength)
+{
+	// The parts are ordered from the largest to the smallest
+	// alignment, so each part is properly aligned in the block.
+	std::size_t nodeBytes = nodeCount * sizeof(Node);
+	std::size_t memberBytes = memberCount * sizeof(Member);
+	std::size_t elementBytes = elementCount * sizeof(UInt32);
+
+	_size = nodeBytes + memberBytes + elementBytes + stringLength;
+	_memory = new char[_size];
+
+	char* p = _memory;
+	if ( nodeBytes > 0 ) std::memcpy(p, nodes, nodeBytes);
+	_nodes = reinterpret_cast<const Node*>(p);
+	p += nodeBytes;
+	if ( memberBytes > 0 ) std::memcpy(p, members, memberBytes);
+	_members = reinterpret_cast<const Member*>(p);
+	p += memberBytes;
+	if ( elementBytes > 0 ) std::memcpy(p, elements, elementBytes);
+	_elements = reinterpret_cast<const UInt32*>(p);
+	p += elementBytes;
+	if ( stringLength > 0 ) std::memcpy(p, strings, stringLength);
+	_strings = p;
+}
+
+
+Document::~Document()
+{
+	delete [] _memory;
+}
+
+
+const Document::Member* Document::findMember(const Node& object, const std::string& key) const
+{
+	const Member* first = _members + object.offset;
+	std::size_t count = object.size;
+	while ( count > 0 )
+	{
+		std::size_t half = count / 2;
+		const Member* middle = first + half;
+
+		int cmp = std::memcmp(_strings + middle->key, key.data(), middle->length < key.length() ? middle->length : key.length());
+		if ( cmp == 0 )
+		{
+			if ( middle->length == key.length() ) return middle;
+			cmp = middle->length < key.length() ? -1 : 1;
+		}
+
+		if ( cmp < 0 )
+		{
+			first = middle + 1;
+			count -= half + 1;
+		}
+		else
+		{
+			count = half;
+		}
+	}
+	return NULL;
+}
+
+
+bool Document::Value::getBoolean() const
+{
+	if ( type() != BOOLEAN_VALUE ) throw BadCastException("Value is not a boolean");
+	return _doc->node(_node).boolean;
+}
+
+
+Int64 Document::Value::getInteger() const
+{
+	Type t = type();
+	if ( t == INTEGER_VALUE ) return _doc->node(_node).integer;
+	if ( t == DOUBLE_VALUE ) return static_cast<Int64>(_doc->node(_node).number);
+	throw BadCastException("Value is not a number");
+}
+
+
+double Document::Value::getDouble() const
+{
+	Type t = type();
+	if ( t == DOUBLE_VALUE ) return _doc->node(_node).number;
+	if ( t == INTEGER_VALUE ) return static_cast<double>(_doc->node(_node).integer);
+	throw BadCastException("Value is not a number");
+}
+
+
+std::string Document::Value::getString() const
+{
+	if ( type() != STRING_VALUE ) throw BadCastException("Value is not a string");
+	const Node& n = _doc->node(_node);
+	return std::string(_doc->_strings + n.offset, n.size);
+}
+
+
+const char* Document::Value::data() const
+{
+	if ( type() != STRING_VALUE ) throw BadCastException("Value is not a string");
+	return _doc->_strings + _doc->node(_node).offset;
+}
+
+
+std::size_t Document::Value::length() const
+{
+	if ( type() != STRING_VALUE ) throw BadCastException("Value is not a string");
+	return _doc->node(_node).size;
+}
+
+
+std::size_t Document::Value::size() const
+{
+	Type t = type();
+	if ( t == ARRAY_VALUE || t == OBJECT_VALUE ) return _doc->node(_node).size;
+	return 0;
+}
+
+
+Document::Value Document::Value::get(std::size_t index) const
+{
+	if ( type() == ARRAY_VALUE )
+	{
+		const Node& n = _doc->node(_node);
+		if ( index < n.size )
+		{
+			return Value(_doc, _doc->_elements[n.offset + index]);
+		}
+	}
+	return Value();
+}
+
+
+Document::Value Document::Value::get(const std::string& key) const
+{
+	if ( type() == OBJECT_VALUE )
+	{
+		const Member* m = _doc->findMember(_doc->node(_node), key);
+		if ( m != NULL )
+		{
+			return Value(_doc, m->node);
+		}
+	}
+	return Value();
+}
+
+
+std::string Document::Value::key(std::size_t index) const
+{
+	if ( index >= size() || type() != OBJECT_VALUE ) throw RangeException("Property index out of range");
+	const Member& m = _doc->_members[_doc->node(_node).offset + index];
+	return std::string(_doc->_strings + m.key, m.length);
+}
+
+
+Document::Value Document::Value::member(std::size_t index) const
+{
+	if ( index >= size() || type() != OBJECT_VALUE ) throw RangeException("Property index out of range");
+	return Value(_doc, _doc->_members[_doc->node(_node).offset + index].node);
+}
+
+
+}} // Namespace Poco::JSON
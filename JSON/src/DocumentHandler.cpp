@@ -0,0 +1,327 @@
+//
+// DocumentHandler.cpp
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  DocumentHandler
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "Poco/JSON/DocumentHandler.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Poco
+{
+namespace JSON
+{
+
+
+namespace
+{
+	const UInt32 NO_KEY = 0xFFFFFFFF;
+
+
+	std::size_t hashKey(const char* key, std::size_t length)
+		/// FNV-1a hash of the key
+	{
+		UInt32 hash = 2166136261U;
+		for(std::size_t i = 0; i < length; ++i)
+		{
+			hash ^= static_cast<unsigned char>(key[i]);
+			hash *= 16777619U;
+		}
+		return hash;
+	}
+}
+
+
+class DocumentHandler::KeyLess
+	/// Orders object members on their key. Members with the same
+	/// key are ordered on their node, which is the parse order.
+	/// This makes std::sort stable without the temporary buffer
+	/// of std::stable_sort.
+{
+public:
+	KeyLess(const std::string& strings) : _strings(strings.data())
+	{
+	}
+
+	bool operator () (const Document::Member& m1, const Document::Member& m2) const
+	{
+		int cmp = std::memcmp(_strings + m1.key, _strings + m2.key, m1.length < m2.length ? m1.length : m2.length);
+		if ( cmp == 0 )
+		{
+			if ( m1.length == m2.length ) return m1.node < m2.node;
+			return m1.length < m2.length;
+		}
+		return cmp < 0;
+	}
+
+private:
+	const char* _strings;
+};
+
+
+DocumentHandler::DocumentHandler() : Handler(), _keyCount(0)
+{
+	_key.key = 0;
+	_key.length = 0;
+	_key.node = 0;
+}
+
+
+DocumentHandler::~DocumentHandler()
+{
+}
+
+
+void DocumentHandler::reset()
+{
+	_nodes.clear();
+	_members.clear();
+	_elements.clear();
+	_strings.clear();
+	_stack.clear();
+	_pendingMembers.clear();
+	_pendingElements.clear();
+	if ( _keyCount > 0 )
+	{
+		Key none = { NO_KEY, 0 };
+		std::fill(_keys.begin(), _keys.end(), none);
+		_keyCount = 0;
+	}
+	_result = 0;
+}
+
+
+UInt32 DocumentHandler::addNode(const Document::Node& node)
+{
+	UInt32 index = static_cast<UInt32>(_nodes.size());
+	_nodes.push_back(node);
+
+	if ( !_stack.empty() )
+	{
+		if ( _nodes[_stack.back().node].type == Document::ARRAY_VALUE )
+		{
+			_pendingElements.push_back(index);
+		}
+		else
+		{
+			Document::Member member = _key;
+			member.node = index;
+			_pendingMembers.push_back(member);
+		}
+	}
+	return index;
+}
+
+
+void DocumentHandler::startContainer(Document::Type type)
+{
+	if ( _stack.empty() ) // The first object or array
+	{
+		reset();
+	}
+
+	Document::Node node;
+	node.type = type;
+	node.size = 0;
+	node.integer = 0;
+
+	Level level;
+	level.node = addNode(node);
+	level.pending = type == Document::OBJECT_VALUE ? _pendingMembers.size() : _pendingElements.size();
+	_stack.push_back(level);
+}
+
+
+void DocumentHandler::endContainer()
+{
+	Level level = _stack.back();
+	_stack.pop_back();
+
+	Document::Node& node = _nodes[level.node];
+	if ( node.type == Document::OBJECT_VALUE )
+	{
+		std::vector<Document::Member>::iterator first = _pendingMembers.begin() + level.pending;
+		std::sort(first, _pendingMembers.end(), KeyLess(_strings));
+
+		// Keys are interned, so duplicates have the same offset.
+		// Like Object::set, the last value of a duplicate key wins.
+		node.offset = static_cast<UInt32>(_members.size());
+		for(std::vector<Document::Member>::iterator it = first; it != _pendingMembers.end(); ++it)
+		{
+			if ( it + 1 == _pendingMembers.end() || (it + 1)->key != it->key )
+			{
+				_members.push_back(*it);
+			}
+		}
+		node.size = static_cast<UInt32>(_members.size() - node.offset);
+		_pendingMembers.erase(first, _pendingMembers.end());
+	}
+	else
+	{
+		std::vector<UInt32>::iterator first = _pendingElements.begin() + level.pending;
+		node.offset = static_cast<UInt32>(_elements.size());
+		node.size = static_cast<UInt32>(_pendingElements.end() - first);
+		_elements.insert(_elements.end(), first, _pendingElements.end());
+		_pendingElements.erase(first, _pendingElements.end());
+	}
+
+	if ( _stack.empty() ) // The document is complete
+	{
+		_result = new Document(&_nodes[0], _nodes.size(),
+		                       _members.empty() ? NULL : &_members[0], _members.size(),
+		                       _elements.empty() ? NULL : &_elements[0], _elements.size(),
+		                       _strings.data(), _strings.size());
+	}
+}
+
+
+void DocumentHandler::startObject()
+{
+	startContainer(Document::OBJECT_VALUE);
+}
+
+
+void DocumentHandler::endObject()
+{
+	endContainer();
+}
+
+
+void DocumentHandler::startArray()
+{
+	startContainer(Document::ARRAY_VALUE);
+}
+
+
+void DocumentHandler::endArray()
+{
+	endContainer();
+}
+
+
+void DocumentHandler::key(const std::string& k)
+{
+	// The table is at most half full, so probing ends at an empty slot.
+	if ( 2*(_keyCount + 1) > _keys.size() ) growKeys();
+
+	std::size_t mask = _keys.size() - 1;
+	std::size_t i = hashKey(k.data(), k.length()) & mask;
+	while ( _keys[i].offset != NO_KEY )
+	{
+		if ( _keys[i].length == k.length() && std::memcmp(_strings.data() + _keys[i].offset, k.data(), k.length()) == 0 ) break;
+		i = (i + 1) & mask;
+	}
+	if ( _keys[i].offset == NO_KEY )
+	{
+		_keys[i].offset = static_cast<UInt32>(_strings.size());
+		_keys[i].length = static_cast<UInt32>(k.length());
+		_strings.append(k);
+		++_keyCount;
+	}
+	_key.key = _keys[i].offset;
+	_key.length = _keys[i].length;
+}
+
+
+void DocumentHandler::growKeys()
+{
+	Key none = { NO_KEY, 0 };
+	std::vector<Key> keys(_keys.empty() ? 64 : 2*_keys.size(), none);
+	std::size_t mask = keys.size() - 1;
+	for(std::vector<Key>::const_iterator it = _keys.begin(); it != _keys.end(); ++it)
+	{
+		if ( it->offset == NO_KEY ) continue;
+
+		std::size_t i = hashKey(_strings.data() + it->offset, it->length) & mask;
+		while ( keys[i].offset != NO_KEY ) i = (i + 1) & mask;
+		keys[i] = *it;
+	}
+	_keys.swap(keys);
+}
+
+
+void DocumentHandler::value(int v)
+{
+	Document::Node node;
+	node.type = Document::INTEGER_VALUE;
+	node.size = 0;
+	node.integer = v;
+	addNode(node);
+}
+
+
+void DocumentHandler::value(const std::string& s)
+{
+	Document::Node node;
+	node.type = Document::STRING_VALUE;
+	node.size = static_cast<UInt32>(s.length());
+	node.integer = 0;
+	node.offset = static_cast<UInt32>(_strings.size());
+	_strings.append(s);
+	addNode(node);
+}
+
+
+void DocumentHandler::value(double d)
+{
+	Document::Node node;
+	node.type = Document::DOUBLE_VALUE;
+	node.size = 0;
+	node.number = d;
+	addNode(node);
+}
+
+
+void DocumentHandler::value(bool b)
+{
+	Document::Node node;
+	node.type = Document::BOOLEAN_VALUE;
+	node.size = 0;
+	node.integer = 0;
+	node.boolean = b;
+	addNode(node);
+}
+
+
+void DocumentHandler::null()
+{
+	Document::Node node;
+	node.type = Document::NULL_VALUE;
+	node.size = 0;
+	node.integer = 0;
+	addNode(node);
+}
+
+
+}} // Namespace Poco::JSON
@@ -45,4 +45,9 @@ Handler::~Handler()
 {
 }
 
+
+void Handler::reset()
+{
+}
+
 }} // Namespace Poco::JSON
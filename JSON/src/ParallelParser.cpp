@@ -0,0 +1,498 @@
+//
+// ParallelParser.cpp
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  ParallelParser
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include "Poco/Ascii.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Event.h"
+#include "Poco/Exception.h"
+#include "Poco/File.h"
+#include "Poco/Format.h"
+#include "Poco/Runnable.h"
+#include "Poco/Semaphore.h"
+#include "Poco/SharedMemory.h"
+#include "Poco/JSON/ParallelParser.h"
+#include "Poco/JSON/Parser.h"
+#include "Poco/JSON/DefaultHandler.h"
+#include "Poco/JSON/Reader.h"
+#include "Poco/JSON/JSONException.h"
+
+namespace Poco
+{
+namespace JSON
+{
+
+
+namespace
+{
+	const char* skipSpace(const char* pos, const char* end)
+	{
+		while ( pos != end && Ascii::isSpace(*pos) ) ++pos;
+		return pos;
+	}
+
+
+	const char* trimSpace(const char* begin, const char* end)
+	{
+		while ( end != begin && Ascii::isSpace(end[-1]) ) --end;
+		return end;
+	}
+
+
+	class ParseChunk : public Runnable
+		/// Parses the records of one chunk
+	{
+	public:
+		typedef std::pair<const char*, const char*> Record;
+
+		ParseChunk(const char* begin, const char* end, ParallelParser::Callback* callback, AtomicCounter& cancelled, Semaphore* completed)
+			: _begin(begin)
+			, _end(end)
+			, _callback(callback)
+			, _cancelled(cancelled)
+			, _completed(completed)
+			, _exception(NULL)
+			, count(0)
+		{
+		}
+
+		~ParseChunk()
+		{
+			delete _exception;
+		}
+
+		void run()
+		{
+			try
+			{
+				if ( records.empty() )
+				{
+					parseLines();
+				}
+				else
+				{
+					for(std::vector<Record>::iterator it = records.begin(); it != records.end() && _cancelled.value() == 0; ++it)
+					{
+						parseRecord(it->first, it->second);
+					}
+				}
+			}
+			catch(Exception& exc)
+			{
+				_exception = exc.clone();
+			}
+			catch(std::exception& exc)
+			{
+				_exception = new JSONException(exc.what());
+			}
+
+			if ( _exception != NULL )
+			{
+				++_cancelled;
+			}
+
+			// The parser may delete this chunk as soon as done is set,
+			// so no member may be touched after that.
+			Semaphore* completed = _completed;
+			done.set();
+			if ( completed != NULL )
+			{
+				completed->set();
+			}
+		}
+
+		const Exception* exception() const
+		{
+			return _exception;
+		}
+
+		std::vector<Record> records;
+			/// The elements of an array. Empty for NDJSON.
+
+		std::vector<DynamicAny> values;
+			/// The parsed records in ordered mode
+
+		std::size_t count;
+
+		Poco::Event done;
+
+	private:
+
+		void parseLines()
+		{
+			const char* pos = _begin;
+			while ( pos != _end && _cancelled.value() == 0 )
+			{
+				const char* eol = static_cast<const char*>(std::memchr(pos, '\n', _end - pos));
+				if ( eol == NULL )
+				{
+					eol = _end;
+				}
+
+				const char* begin = skipSpace(pos, eol);
+				if ( begin != eol )
+				{
+					parseRecord(begin, trimSpace(begin, eol));
+				}
+				pos = eol == _end ? _end : eol + 1;
+			}
+		}
+
+		void parseRecord(const char* begin, const char* end)
+		{
+			DynamicAny value;
+			try
+			{
+				if ( *begin == '{' || *begin == '[' )
+				{
+					DefaultHandler handler;
+					_parser.setHandler(&handler);
+					_parser.parse(begin, end - begin);
+					value = handler.result();
+				}
+				else
+				{
+					// DefaultHandler can't handle a scalar value
+					Reader reader(end - begin);
+					reader.feed(begin, end - begin);
+					reader.finish();
+					reader.nextValue(value);
+					if ( reader.next() != Reader::END_OF_INPUT )
+					{
+						throw JSONException("Unexpected characters after the JSON value");
+					}
+				}
+			}
+			catch(JSONException& exc)
+			{
+				throw JSONException(format("Invalid record '%s'", std::string(begin, std::min<std::size_t>(end - begin, 40))), exc);
+			}
+
+			++count;
+			if ( _callback == NULL )
+			{
+				values.push_back(value);
+			}
+			else
+			{
+				_callback->handle(value);
+			}
+		}
+
+		const char* _begin;
+
+		const char* _end;
+
+		ParallelParser::Callback* _callback;
+
+		AtomicCounter& _cancelled;
+
+		Semaphore* _completed;
+
+		Exception* _exception;
+
+		Parser _parser;
+	};
+}
+
+
+ParallelParser::Callback::~Callback()
+{
+}
+
+
+ParallelParser::ParallelParser(ThreadPool& pool)
+	: _pool(pool)
+	, _format(FORMAT_AUTO)
+	, _ordered(true)
+	, _chunkSize(DEFAULT_CHUNK_SIZE)
+{
+}
+
+
+ParallelParser::~ParallelParser()
+{
+}
+
+
+const char* ParallelParser::findRecordEnd(const char* begin, const char* end)
+{
+	int depth = 0;
+	const char* pos = begin;
+	while ( pos != end )
+	{
+		switch(*pos)
+		{
+		case '"':
+		{
+			// Jump to the closing quote; a quote preceded by an odd
+			// number of backslashes is escaped.
+			const char* start = ++pos;
+			while(true)
+			{
+				pos = static_cast<const char*>(std::memchr(pos, '"', end - pos));
+				if ( pos == NULL )
+				{
+					return end;
+				}
+				const char* backslash = pos;
+				while ( backslash != start && backslash[-1] == '\\' ) --backslash;
+				if ( ((pos - backslash) & 1) == 0 )
+				{
+					break;
+				}
+				++pos;
+			}
+			break;
+		}
+		case '{':
+		case '[':
+			++depth;
+			break;
+		case '}':
+		case ']':
+			if ( depth == 0 )
+			{
+				return pos;
+			}
+			--depth;
+			break;
+		case ',':
+			if ( depth == 0 )
+			{
+				return pos;
+			}
+			break;
+		}
+		++pos;
+	}
+	return end;
+}
+
+
+std::size_t ParallelParser::parse(const char* json, std::size_t length, Callback& callback)
+{
+	const char* end = json + length;
+	const char* pos = skipSpace(json, end);
+
+	bool isArray = _format == FORMAT_ARRAY || (_format == FORMAT_AUTO && pos != end && *pos == '[');
+	bool more = pos != end;
+	if ( isArray )
+	{
+		if ( pos == end || *pos != '[' )
+		{
+			throw JSONException("Expected a JSON array");
+		}
+		pos = skipSpace(pos + 1, end);
+		if ( pos != end && *pos == ']' )
+		{
+			if ( skipSpace(pos + 1, end) != end )
+			{
+				throw JSONException("Unexpected characters after the JSON array");
+			}
+			more = false;
+		}
+	}
+
+	std::size_t window = 2 * (_pool.capacity() > 0 ? _pool.capacity() : 1);
+	AtomicCounter cancelled;
+	Semaphore completed(0, static_cast<int>(window));
+	std::deque<ParseChunk*> pending;
+	std::size_t count = 0;
+	Exception* error = NULL;
+
+	try
+	{
+		while ( more || !pending.empty() )
+		{
+			// Start chunks until the window is full
+			while ( more && pending.size() < window && cancelled.value() == 0 )
+			{
+				const char* chunkBegin = pos;
+				const char* chunkEnd;
+				std::vector<ParseChunk::Record> records;
+				if ( isArray )
+				{
+					// Take elements until the chunk is large enough
+					do
+					{
+						const char* recordBegin = skipSpace(pos, end);
+						const char* recordEnd = findRecordEnd(recordBegin, end);
+						if ( recordEnd == end )
+						{
+							throw JSONException("Unterminated JSON array");
+						}
+						if ( recordBegin == recordEnd || trimSpace(recordBegin, recordEnd) == recordBegin )
+						{
+							throw JSONException("Missing array element");
+						}
+						records.push_back(ParseChunk::Record(recordBegin, trimSpace(recordBegin, recordEnd)));
+						pos = recordEnd + 1;
+						if ( *recordEnd == ']' )
+						{
+							if ( skipSpace(pos, end) != end )
+							{
+								throw JSONException("Unexpected characters after the JSON array");
+							}
+							more = false;
+						}
+					}
+					while ( more && static_cast<std::size_t>(pos - chunkBegin) < _chunkSize );
+					chunkEnd = pos;
+				}
+				else
+				{
+					if ( static_cast<std::size_t>(end - pos) <= _chunkSize )
+					{
+						chunkEnd = end;
+					}
+					else
+					{
+						chunkEnd = static_cast<const char*>(std::memchr(pos + _chunkSize, '\n', end - pos - _chunkSize));
+						chunkEnd = chunkEnd == NULL ? end : chunkEnd + 1;
+					}
+					pos = chunkEnd;
+					more = pos != end;
+				}
+
+				ParseChunk* chunk = new ParseChunk(chunkBegin, chunkEnd, _ordered ? NULL : &callback, cancelled, _ordered ? NULL : &completed);
+				chunk->records.swap(records);
+				pending.push_back(chunk);
+				try
+				{
+					_pool.start(*chunk);
+				}
+				catch(NoThreadAvailableException&)
+				{
+					chunk->run();
+				}
+			}
+
+			if ( pending.empty() )
+				break;
+
+			// Wait for a chunk: the oldest in ordered mode, any otherwise
+			ParseChunk* chunk = NULL;
+			if ( _ordered )
+			{
+				chunk = pending.front();
+				chunk->done.wait();
+				pending.pop_front();
+			}
+			else
+			{
+				completed.wait();
+				for(std::deque<ParseChunk*>::iterator it = pending.begin(); it != pending.end(); ++it)
+				{
+					if ( (*it)->done.tryWait(0) )
+					{
+						chunk = *it;
+						pending.erase(it);
+						break;
+					}
+				}
+				poco_check_ptr (chunk);
+			}
+
+			if ( chunk->exception() != NULL )
+			{
+				if ( error == NULL )
+				{
+					error = chunk->exception()->clone();
+				}
+				more = false;
+			}
+			else if ( error == NULL )
+			{
+				count += chunk->count;
+				for(std::vector<DynamicAny>::const_iterator it = chunk->values.begin(); it != chunk->values.end(); ++it)
+				{
+					callback.handle(*it);
+				}
+			}
+			delete chunk;
+		}
+	}
+	catch(...)
+	{
+		// The chunks use the buffer and the counters on this stack
+		++cancelled;
+		for(std::deque<ParseChunk*>::iterator it = pending.begin(); it != pending.end(); ++it)
+		{
+			(*it)->done.wait();
+			delete *it;
+			if ( !_ordered )
+			{
+				// wait until the chunk has signalled the semaphore, too
+				completed.wait();
+			}
+		}
+		delete error;
+		throw;
+	}
+
+	if ( error != NULL )
+	{
+		try
+		{
+			error->rethrow();
+		}
+		catch(...)
+		{
+			delete error;
+			throw;
+		}
+	}
+	return count;
+}
+
+
+std::size_t ParallelParser::parseFile(const std::string& path, Callback& callback)
+{
+	File file(path);
+	if ( file.getSize() == 0 )
+	{
+		return parse(NULL, 0, callback);
+	}
+
+	SharedMemory memory(file, SharedMemory::AM_READ);
+	return parse(memory.begin(), static_cast<std::size_t>(file.getSize()), callback);
+}
+
+
+}} // Namespace Poco::JSON
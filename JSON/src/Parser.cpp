@@ -39,6 +39,128 @@
 #include "Poco/JSON/Parser.h"
 #include "Poco/JSON/JSONException.h"
 
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define POCO_JSON_HAVE_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace
+{
+
+inline bool isSpace(char c)
+{
+	return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+
+#if defined(POCO_JSON_HAVE_SSE2)
+
+inline int firstBit(int mask)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+#endif
+
+
+const char* skipSpace(const char* it, const char* end)
+	/// Returns the first non whitespace character starting from it
+{
+	// Tokens are mostly separated by no or a single space. Only
+	// indentation of pretty printed JSON is worth the vector loop.
+	if ( it == end || !isSpace(*it) ) return it;
+	++it;
+#if defined(POCO_JSON_HAVE_SSE2)
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i newline = _mm_set1_epi8('\n');
+	const __m128i cr = _mm_set1_epi8('\r');
+	const __m128i tab = _mm_set1_epi8('\t');
+	while ( end - it >= 16 )
+	{
+		__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+		__m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, newline)),
+		                          _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, tab)));
+		int mask = _mm_movemask_epi8(ws) ^ 0xFFFF;
+		if ( mask != 0 ) return it + firstBit(mask);
+		it += 16;
+	}
+#endif
+	while ( it != end && isSpace(*it) ) ++it;
+	return it;
+}
+
+
+const char* findSpecial(const char* it, const char* end)
+	/// Returns the first quote, backslash or control character
+	/// starting from it. Everything before can be copied as is.
+{
+#if defined(POCO_JSON_HAVE_SSE2)
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i control = _mm_set1_epi8(0x1F);
+	while ( end - it >= 16 )
+	{
+		__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+		__m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+		                               _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));
+		int mask = _mm_movemask_epi8(special);
+		if ( mask != 0 ) return it + firstBit(mask);
+		it += 16;
+	}
+#endif
+	while (    it != end
+	        && *it != '"'
+	        && *it != '\\'
+	        && static_cast<unsigned char>(*it) > 0x1F )
+	{
+		++it;
+	}
+	return it;
+}
+
+
+void appendUTF8(std::string& value, Poco::Int32 unicode)
+{
+	if ( unicode < 0x80 )
+	{
+		value += static_cast<char>(unicode);
+	}
+	else if ( unicode < 0x800 )
+	{
+		value += static_cast<char>(0xC0 | (unicode >> 6));
+		value += static_cast<char>(0x80 | (unicode & 0x3F));
+	}
+	else if ( unicode < 0x10000 )
+	{
+		value += static_cast<char>(0xE0 | (unicode >> 12));
+		value += static_cast<char>(0x80 | ((unicode >> 6) & 0x3F));
+		value += static_cast<char>(0x80 | (unicode & 0x3F));
+	}
+	else
+	{
+		value += static_cast<char>(0xF0 | (unicode >> 18));
+		value += static_cast<char>(0x80 | ((unicode >> 12) & 0x3F));
+		value += static_cast<char>(0x80 | ((unicode >> 6) & 0x3F));
+		value += static_cast<char>(0x80 | (unicode & 0x3F));
+	}
+}
+
+} // namespace
+
+
 namespace Poco
 {
 namespace JSON
@@ -421,7 +543,7 @@ private:
 };
 
 
-Parser::Parser() : _tokenizer(), _handler(NULL)
+Parser::Parser() : _tokenizer(), _pos(NULL), _end(NULL), _handler(NULL)
 {
 	_tokenizer.addToken(new WhitespaceToken());
 	_tokenizer.addToken(new InvalidToken());
@@ -451,6 +573,11 @@ const Token* Parser::nextToken()
 
 void Parser::parse(std::istream& in)
 {
+	if ( _handler != NULL )
+	{
+		_handler->reset();
+	}
+
 	_tokenizer.attachToStream(in);
 	const Token* token = nextToken();
 
@@ -675,4 +802,421 @@ bool Parser::readElements(bool firstCall)
 	throw JSONException(format("Invalid token '%s' found.", token->asString()));
 }
 
-}}
+
+
+void Parser::parse(const char* json, std::size_t length)
+{
+	if ( _handler != NULL )
+	{
+		_handler->reset();
+	}
+
+	_pos = json;
+	_end = json + length;
+
+	char c = scanChar();
+	if ( c == '{' )
+	{
+		scanObject();
+	}
+	else if ( c == '[' )
+	{
+		scanArray();
+	}
+	else
+	{
+		throw JSONException(format("Invalid token '%c' found. Expecting { or [", c));
+	}
+
+	_pos = skipSpace(_pos, _end);
+	if ( _pos != _end )
+	{
+		throw JSONException(format("EOF expected but found '%c'", *_pos));
+	}
+}
+
+
+char Parser::scanChar()
+{
+	_pos = skipSpace(_pos, _end);
+	if ( _pos == _end )
+	{
+		throw JSONException("Unexpected EOF found");
+	}
+	return *_pos++;
+}
+
+
+void Parser::scanObject()
+{
+	if ( _handler != NULL )
+	{
+		_handler->startObject();
+	}
+
+	char c = scanChar();
+	if ( c != '}' ) // Check for an empty object
+	{
+		while(true)
+		{
+			if ( c != '"' )
+			{
+				throw JSONException(format("Invalid token '%c' found. Expecting key", c));
+			}
+			scanString(_scanned);
+			if ( _handler != NULL )
+			{
+				_handler->key(_scanned);
+			}
+
+			c = scanChar();
+			if ( c != ':' )
+			{
+				throw JSONException(format("Invalid token '%c' found. Expecting :", c));
+			}
+			scanValue(scanChar());
+
+			c = scanChar();
+			if ( c == '}' )
+			{
+				break; // End of object
+			}
+			if ( c != ',' )
+			{
+				throw JSONException(format("Invalid separator '%c' found. Expecting , or }", c));
+			}
+			c = scanChar();
+		}
+	}
+
+	if ( _handler != NULL )
+	{
+		_handler->endObject();
+	}
+}
+
+
+void Parser::scanArray()
+{
+	if ( _handler != NULL )
+	{
+		_handler->startArray();
+	}
+
+	char c = scanChar();
+	if ( c != ']' ) // Check for an empty array
+	{
+		while(true)
+		{
+			scanValue(c);
+
+			c = scanChar();
+			if ( c == ']' )
+			{
+				break; // End of array
+			}
+			if ( c != ',' )
+			{
+				throw JSONException(format("Invalid separator '%c' found. Expecting , or ]", c));
+			}
+			c = scanChar();
+		}
+	}
+
+	if ( _handler != NULL )
+	{
+		_handler->endArray();
+	}
+}
+
+
+void Parser::scanValue(char c)
+{
+	switch(c)
+	{
+	case '{':
+		scanObject();
+		break;
+	case '[':
+		scanArray();
+		break;
+	case '"':
+		scanString(_scanned);
+		if ( _handler != NULL )
+		{
+			_handler->value(_scanned);
+		}
+		break;
+	case '-':
+	case '0': case '1': case '2': case '3': case '4':
+	case '5': case '6': case '7': case '8': case '9':
+		--_pos;
+		scanNumber();
+		break;
+	default:
+		if ( !Ascii::isAlpha(c) )
+		{
+			throw JSONException(format("Invalid token '%c' found", c));
+		}
+		--_pos;
+		scanKeyword();
+		break;
+	}
+}
+
+
+void Parser::scanString(std::string& value)
+{
+	value.clear();
+	while(true)
+	{
+		// Copy the run of characters that don't need any processing at once
+		const char* run = _pos;
+		_pos = findSpecial(_pos, _end);
+		value.append(run, _pos - run);
+
+		if ( _pos == _end )
+		{
+			throw JSONException("Unterminated string found");
+		}
+
+		char c = *_pos++;
+		if ( c == '"' )
+		{
+			return;
+		}
+		else if ( c == '\\' )
+		{
+			scanEscape(value);
+		}
+		else if ( c == 0 )
+		{
+			throw JSONException("Null byte not allowed");
+		}
+		else
+		{
+			throw JSONException(format("Control character 0x%x not allowed", (unsigned int) c));
+		}
+	}
+}
+
+
+void Parser::scanEscape(std::string& value)
+{
+	if ( _pos == _end )
+	{
+		throw JSONException("Unterminated string found");
+	}
+
+	char c = *_pos++;
+	switch(c)
+	{
+	case '"' :
+		value += '"';
+		break;
+	case '\\' :
+		value += '\\';
+		break;
+	case '/' :
+		value += '/';
+		break;
+	case 'b' :
+		value += '\b';
+		break;
+	case 'f' :
+		value += '\f';
+		break;
+	case 'n' :
+		value += '\n';
+		break;
+	case 'r' :
+		value += '\r';
+		break;
+	case 't' :
+		value += '\t';
+		break;
+	case 'u' : // Unicode
+	{
+		Poco::Int32 unicode = scanUnicode();
+		if ( unicode == 0 )
+		{
+			throw JSONException("\\u0000 is not allowed");
+		}
+		if ( unicode >= 0xD800 && unicode <= 0xDBFF )
+		{
+			if ( _end - _pos < 2 || _pos[0] != '\\' || _pos[1] != 'u' )
+			{
+				throw JSONException("Invalid unicode surrogate pair");
+			}
+			_pos += 2;
+			Poco::Int32 surrogatePair = scanUnicode();
+			if ( 0xDC00 <= surrogatePair && surrogatePair <= 0xDFFF )
+			{
+				unicode = 0x10000 + ((unicode & 0x3FF) << 10) + (surrogatePair & 0x3FF);
+			}
+			else
+			{
+				throw JSONException("Invalid unicode surrogate pair");
+			}
+		}
+		else if ( 0xDC00 <= unicode && unicode <= 0xDFFF )
+		{
+			throw JSONException("Invalid unicode");
+		}
+		appendUTF8(value, unicode);
+		break;
+	}
+	default:
+		throw JSONException(format("Invalid escape '%c' character used", c));
+	}
+}
+
+
+Poco::Int32 Parser::scanUnicode()
+{
+	if ( _end - _pos < 4 )
+	{
+		throw JSONException("Invalid unicode sequence");
+	}
+
+	Poco::Int32 value = 0;
+	for(int i = 0; i < 4; i++)
+	{
+		char nc = *_pos++;
+		value <<= 4;
+		if (nc >= '0' && nc <= '9')
+			value += nc - '0';
+		else if (nc >= 'A' && nc <= 'F')
+			value += 10 + nc - 'A';
+		else if (nc >= 'a' && nc <= 'f')
+			value += 10 + nc - 'a';
+		else
+			throw JSONException("Invalid unicode sequence. Hexadecimal digit expected");
+	}
+	return value;
+}
+
+
+void Parser::scanNumber()
+{
+	const char* start = _pos;
+	if ( *_pos == '-' )
+	{
+		++_pos;
+	}
+
+	const char* digits = _pos;
+	if ( _pos == _end || !Ascii::isDigit(*_pos) )
+	{
+		throw JSONException("Invalid number found");
+	}
+	if ( *_pos == '0' )
+	{
+		++_pos;
+		if ( _pos != _end && Ascii::isDigit(*_pos) ) // A digit after a zero is not allowed
+		{
+			throw JSONException("Number can't start with a zero");
+		}
+	}
+	while ( _pos != _end && Ascii::isDigit(*_pos) ) ++_pos;
+	std::size_t intDigits = _pos - digits;
+
+	bool isInteger = true;
+	if ( _pos != _end && *_pos == '.' )
+	{
+		isInteger = false;
+		++_pos;
+		if ( _pos == _end || !Ascii::isDigit(*_pos) ) // After a . we need a digit
+		{
+			throw JSONException("Invalid float value");
+		}
+		while ( _pos != _end && Ascii::isDigit(*_pos) ) ++_pos;
+	}
+	if ( _pos != _end && (*_pos == 'e' || *_pos == 'E') )
+	{
+		isInteger = false;
+		++_pos;
+		if ( _pos != _end && (*_pos == '-' || *_pos == '+') ) ++_pos;
+		if ( _pos == _end || !Ascii::isDigit(*_pos) )
+		{
+			throw JSONException("Invalid double value");
+		}
+		while ( _pos != _end && Ascii::isDigit(*_pos) ) ++_pos;
+	}
+
+	if ( isInteger && intDigits <= 10 ) // Ten digits always fit in an Int64
+	{
+		Poco::Int64 value = 0;
+		for(const char* it = digits; it != _pos; ++it)
+		{
+			value = value * 10 + (*it - '0');
+		}
+		if ( digits != start ) value = -value;
+
+		if ( value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max() )
+		{
+			if ( _handler != NULL )
+			{
+				_handler->value(static_cast<int>(value));
+			}
+			return;
+		}
+	}
+
+	// strtod needs a terminated string, so copy the number first
+	std::size_t length = _pos - start;
+	double value;
+	if ( length < 64 )
+	{
+		char number[64];
+		std::memcpy(number, start, length);
+		number[length] = '\0';
+		value = std::strtod(number, NULL);
+	}
+	else
+	{
+		std::string number(start, length);
+		value = std::strtod(number.c_str(), NULL);
+	}
+	if ( _handler != NULL )
+	{
+		_handler->value(value);
+	}
+}
+
+
+void Parser::scanKeyword()
+{
+	const char* start = _pos;
+	while ( _pos != _end && Ascii::isAlpha(*_pos) ) ++_pos;
+	std::size_t length = _pos - start;
+
+	if ( length == 4 && std::memcmp(start, "null", 4) == 0 )
+	{
+		if ( _handler != NULL )
+		{
+			_handler->null();
+		}
+	}
+	else if ( length == 4 && std::memcmp(start, "true", 4) == 0 )
+	{
+		if ( _handler != NULL )
+		{
+			_handler->value(true);
+		}
+	}
+	else if ( length == 5 && std::memcmp(start, "false", 5) == 0 )
+	{
+		if ( _handler != NULL )
+		{
+			_handler->value(false);
+		}
+	}
+	else
+	{
+		throw JSONException(format("Invalid keyword '%s' found", std::string(start, length)));
+	}
+}
+
+
+}} // Namespace Poco::JSON
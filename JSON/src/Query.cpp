@@ -33,13 +33,8 @@
 // DEALINGS IN THE SOFTWARE.
 //
 
-#include <sstream>
-
-#include "Poco/StringTokenizer.h"
-#include "Poco/RegularExpression.h"
-#include "Poco/NumberParser.h"
-
 #include "Poco/JSON/Query.h"
+#include "Poco/JSON/CompiledQuery.h"
 
 namespace Poco
 {
@@ -80,60 +75,18 @@ Array::Ptr Query::findArray(const std::string& path) const
 
 DynamicAny Query::find(const std::string& path) const
 {
-	DynamicAny result = _source;
-	StringTokenizer tokenizer(path, ".");
-	for(StringTokenizer::Iterator token = tokenizer.begin(); token != tokenizer.end(); token++)
-	{
-		if ( !result.isEmpty() )
-		{
-			std::vector<int> indexes;
-			RegularExpression::MatchVec matches;
-			int firstOffset = -1;
-			int offset = 0;
-			RegularExpression regex("\\[([0-9]+)\\]");
-			while(regex.match(*token, offset, matches) > 0 )
-			{
-				if ( firstOffset == -1 )
-				{
-					firstOffset = matches[0].offset;
-				}
-				std::string num = token->substr(matches[1].offset, matches[1].length);
-				indexes.push_back(NumberParser::parse(num));
-				offset = matches[0].offset + matches[0].length;
-			}
-
-			std::string name(*token);
-			if ( firstOffset != -1 )
-			{
-				name = name.substr(0, firstOffset);
-			}
+	return CompiledQuery::compile(path)->find(_source);
+}
 
-			if ( name.length() > 0 )
-			{
-				if ( result.type() == typeid(Object::Ptr) )
-				{
-					Object::Ptr o = result.extract<Object::Ptr>();
-					result = o->get(name);
-				}
-			}
 
-			if (    !result.isEmpty()
-			        && !indexes.empty() )
-			{
-				for(std::vector<int>::iterator it = indexes.begin(); it != indexes.end(); ++it )
-				{
-					if ( result.type() == typeid(Array::Ptr) )
-					{
-						Array::Ptr array = result.extract<Array::Ptr>();
-						result = array->get(*it);
-						if ( result.isEmpty() )
-						{
-							break;
-						}
-					}
-				}
-			}
-		}
+Array::Ptr Query::findAll(const std::string& path) const
+{
+	Array::Ptr result = new Array();
+	Array::ValueVector values;
+	CompiledQuery::compile(path)->findAll(_source, values);
+	for(Array::ValueVector::const_iterator it = values.begin(); it != values.end(); ++it)
+	{
+		result->add(*it);
 	}
 	return result;
 }
@@ -0,0 +1,843 @@
+//
+// Reader.cpp
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  Reader
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "Poco/Ascii.h"
+#include "Poco/Format.h"
+#include "Poco/JSON/Reader.h"
+#include "Poco/JSON/DefaultHandler.h"
+#include "Poco/JSON/JSONException.h"
+
+namespace Poco
+{
+namespace JSON
+{
+
+
+namespace
+{
+	inline bool isNumberChar(char c)
+	{
+		return Ascii::isDigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+	}
+
+
+	void appendUTF8(std::string& value, Poco::Int32 unicode)
+	{
+		if ( unicode < 0x80 )
+		{
+			value += static_cast<char>(unicode);
+		}
+		else if ( unicode < 0x800 )
+		{
+			value += static_cast<char>(0xC0 | (unicode >> 6));
+			value += static_cast<char>(0x80 | (unicode & 0x3F));
+		}
+		else if ( unicode < 0x10000 )
+		{
+			value += static_cast<char>(0xE0 | (unicode >> 12));
+			value += static_cast<char>(0x80 | ((unicode >> 6) & 0x3F));
+			value += static_cast<char>(0x80 | (unicode & 0x3F));
+		}
+		else
+		{
+			value += static_cast<char>(0xF0 | (unicode >> 18));
+			value += static_cast<char>(0x80 | ((unicode >> 12) & 0x3F));
+			value += static_cast<char>(0x80 | ((unicode >> 6) & 0x3F));
+			value += static_cast<char>(0x80 | (unicode & 0x3F));
+		}
+	}
+
+
+	Poco::Int32 decodeUnicode(const char*& pos, const char* end)
+	{
+		if ( end - pos < 4 )
+		{
+			throw JSONException("Invalid unicode sequence");
+		}
+
+		Poco::Int32 value = 0;
+		for(int i = 0; i < 4; i++)
+		{
+			char nc = *pos++;
+			value <<= 4;
+			if (nc >= '0' && nc <= '9')
+				value += nc - '0';
+			else if (nc >= 'A' && nc <= 'F')
+				value += 10 + nc - 'A';
+			else if (nc >= 'a' && nc <= 'f')
+				value += 10 + nc - 'a';
+			else
+				throw JSONException("Invalid unicode sequence. Hexadecimal digit expected");
+		}
+		return value;
+	}
+}
+
+
+Reader::Reader(std::size_t bufferSize)
+	: _in(NULL)
+	, _buffer(bufferSize)
+	, _begin(0)
+	, _end(0)
+	, _finished(false)
+	, _ndjson(false)
+	, _state(STATE_VALUE)
+	, _lexeme(LEX_NONE)
+	, _isKey(false)
+	, _escaped(false)
+	, _event(NEED_MORE_INPUT)
+	, _integer(0)
+	, _double(0)
+	, _skipDepth(0)
+	, _skipping(false)
+	, _valueDepth(0)
+{
+	poco_assert (bufferSize > 0);
+}
+
+
+Reader::Reader(std::istream& in, std::size_t bufferSize)
+	: _in(&in)
+	, _buffer(bufferSize)
+	, _begin(0)
+	, _end(0)
+	, _finished(false)
+	, _ndjson(false)
+	, _state(STATE_VALUE)
+	, _lexeme(LEX_NONE)
+	, _isKey(false)
+	, _escaped(false)
+	, _event(NEED_MORE_INPUT)
+	, _integer(0)
+	, _double(0)
+	, _skipDepth(0)
+	, _skipping(false)
+	, _valueDepth(0)
+{
+	poco_assert (bufferSize > 0);
+}
+
+
+Reader::~Reader()
+{
+}
+
+
+std::size_t Reader::feed(const char* data, std::size_t length)
+{
+	poco_assert (_in == NULL && !_finished);
+
+	if ( _begin == _end )
+	{
+		_begin = _end = 0;
+	}
+	else if ( _buffer.size() - _end < length && _begin > 0 )
+	{
+		// Slide the unread data to the start of the buffer
+		std::memmove(&_buffer[0], &_buffer[_begin], _end - _begin);
+		_end -= _begin;
+		_begin = 0;
+	}
+
+	std::size_t n = std::min(length, _buffer.size() - _end);
+	if ( n > 0 )
+	{
+		std::memcpy(&_buffer[_end], data, n);
+		_end += n;
+	}
+	return n;
+}
+
+
+bool Reader::fill()
+{
+	if ( _begin < _end )
+		return true;
+
+	_begin = _end = 0;
+	if ( _in == NULL || _finished )
+		return false;
+
+	_in->read(&_buffer[0], _buffer.size());
+	_end = static_cast<std::size_t>(_in->gcount());
+	if ( _end < _buffer.size() )
+	{
+		_finished = true; // End of the stream (or an error)
+	}
+	return _end > 0;
+}
+
+
+Reader::Event Reader::next()
+{
+	while(true)
+	{
+		if ( _lexeme != LEX_NONE )
+		{
+			Event event = scan();
+			if ( event != NEED_MORE_INPUT )
+			{
+				_event = event;
+			}
+			return event;
+		}
+
+		while ( _begin < _end && Ascii::isSpace(_buffer[_begin]) ) ++_begin;
+		if ( _begin == _end )
+		{
+			if ( fill() )
+				continue;
+
+			if ( ! _finished )
+				return NEED_MORE_INPUT;
+
+			if ( _state == STATE_DONE || (_ndjson && _state == STATE_VALUE && _stack.empty()) )
+			{
+				return _event = END_OF_INPUT;
+			}
+			throw JSONException("Unexpected end of JSON input");
+		}
+
+		char c = _buffer[_begin];
+		switch(_state)
+		{
+		case STATE_DONE:
+			if ( ! _ndjson )
+			{
+				throw JSONException(format("Unexpected character '%c' after the JSON value", c));
+			}
+			_state = STATE_VALUE;
+			continue;
+
+		case STATE_COLON:
+			if ( c != ':' )
+			{
+				throw JSONException(format("Expected ':' but found '%c'", c));
+			}
+			++_begin;
+			_state = STATE_VALUE;
+			continue;
+
+		case STATE_COMMA_OR_END:
+			++_begin;
+			if ( c == ',' )
+			{
+				_state = _stack.back() == '{' ? STATE_KEY : STATE_VALUE;
+				continue;
+			}
+			if ( c == '}' || c == ']' )
+			{
+				return _event = endContainer(c);
+			}
+			throw JSONException(format("Expected ',' or the end of an object or array but found '%c'", c));
+
+		case STATE_KEY_OR_END:
+			if ( c == '}' )
+			{
+				++_begin;
+				return _event = endContainer(c);
+			}
+			// Fall through
+		case STATE_KEY:
+			if ( c != '"' )
+			{
+				throw JSONException(format("Expected a key but found '%c'", c));
+			}
+			++_begin;
+			_lexeme = LEX_STRING;
+			_isKey = true;
+			continue;
+
+		case STATE_VALUE_OR_END:
+			if ( c == ']' )
+			{
+				++_begin;
+				return _event = endContainer(c);
+			}
+			// Fall through
+		case STATE_VALUE:
+			if ( c == '{' || c == '[' )
+			{
+				++_begin;
+				return _event = startContainer(c);
+			}
+			else if ( c == '"' )
+			{
+				++_begin;
+				_lexeme = LEX_STRING;
+				_isKey = false;
+			}
+			else if ( c == '-' || Ascii::isDigit(c) )
+			{
+				_lexeme = LEX_NUMBER;
+			}
+			else if ( c == 't' || c == 'f' || c == 'n' )
+			{
+				_lexeme = LEX_KEYWORD;
+			}
+			else
+			{
+				throw JSONException(format("Unexpected character '%c' found", c));
+			}
+			continue;
+		}
+	}
+}
+
+
+Reader::Event Reader::scan()
+{
+	switch(_lexeme)
+	{
+	case LEX_STRING:
+		return scanString();
+	case LEX_NUMBER:
+		return scanNumber();
+	default:
+		return scanKeyword();
+	}
+}
+
+
+Reader::Event Reader::scanString()
+{
+	while(true)
+	{
+		const char* start = &_buffer[0] + _begin;
+		const char* end = &_buffer[0] + _end;
+		const char* p = start;
+
+		bool escaped = _escaped;
+		for(; p != end; ++p)
+		{
+			if ( escaped )
+			{
+				escaped = false;
+			}
+			else if ( *p == '\\' )
+			{
+				escaped = true;
+			}
+			else if ( *p == '"' )
+			{
+				break;
+			}
+		}
+
+		if ( p != end )
+		{
+			_begin = p + 1 - &_buffer[0];
+			_lexeme = LEX_NONE;
+			_escaped = false;
+
+			if ( _skipping )
+			{
+				_string.clear();
+			}
+			else if ( _raw.empty() )
+			{
+				decodeString(start, p);
+			}
+			else
+			{
+				_raw.append(start, p - start);
+				decodeString(_raw.data(), _raw.data() + _raw.size());
+			}
+			_raw.clear();
+
+			if ( _isKey )
+			{
+				_state = STATE_COLON;
+				return KEY;
+			}
+			endValue();
+			return STRING_VALUE;
+		}
+
+		// The string continues after the buffer
+		if ( ! _skipping )
+		{
+			_raw.append(start, p - start);
+		}
+		_escaped = escaped;
+		_begin = _end;
+		if ( ! fill() )
+		{
+			if ( _finished )
+			{
+				throw JSONException("Unterminated string found");
+			}
+			return NEED_MORE_INPUT;
+		}
+	}
+}
+
+
+Reader::Event Reader::scanNumber()
+{
+	while(true)
+	{
+		const char* start = &_buffer[0] + _begin;
+		const char* end = &_buffer[0] + _end;
+		const char* p = start;
+		while ( p != end && isNumberChar(*p) ) ++p;
+
+		if ( p != end )
+		{
+			_begin = p - &_buffer[0];
+			_lexeme = LEX_NONE;
+			if ( _raw.empty() )
+			{
+				return decodeNumber(start, p);
+			}
+			_raw.append(start, p - start);
+		}
+		else
+		{
+			_raw.append(start, p - start);
+			_begin = _end;
+			if ( fill() )
+				continue;
+			if ( ! _finished )
+				return NEED_MORE_INPUT;
+			_lexeme = LEX_NONE;
+		}
+
+		Event event = decodeNumber(_raw.data(), _raw.data() + _raw.size());
+		_raw.clear();
+		return event;
+	}
+}
+
+
+Reader::Event Reader::scanKeyword()
+{
+	while(true)
+	{
+		const char* start = &_buffer[0] + _begin;
+		const char* end = &_buffer[0] + _end;
+		const char* p = start;
+		while ( p != end && Ascii::isAlpha(*p) ) ++p;
+
+		if ( p != end )
+		{
+			_begin = p - &_buffer[0];
+			_lexeme = LEX_NONE;
+			if ( _raw.empty() )
+			{
+				return decodeKeyword(start, p);
+			}
+			_raw.append(start, p - start);
+		}
+		else
+		{
+			_raw.append(start, p - start);
+			_begin = _end;
+			if ( fill() )
+				continue;
+			if ( ! _finished )
+				return NEED_MORE_INPUT;
+			_lexeme = LEX_NONE;
+		}
+
+		Event event = decodeKeyword(_raw.data(), _raw.data() + _raw.size());
+		_raw.clear();
+		return event;
+	}
+}
+
+
+Reader::Event Reader::startContainer(char type)
+{
+	_stack.push_back(type);
+	if ( type == '{' )
+	{
+		_state = STATE_KEY_OR_END;
+		return START_OBJECT;
+	}
+	_state = STATE_VALUE_OR_END;
+	return START_ARRAY;
+}
+
+
+Reader::Event Reader::endContainer(char type)
+{
+	char open = type == '}' ? '{' : '[';
+	if ( _stack.back() != open )
+	{
+		throw JSONException(format("Unexpected '%c' found", type));
+	}
+	_stack.pop_back();
+	endValue();
+	return type == '}' ? END_OBJECT : END_ARRAY;
+}
+
+
+void Reader::endValue()
+{
+	_state = _stack.empty() ? STATE_DONE : STATE_COMMA_OR_END;
+}
+
+
+void Reader::decodeString(const char* begin, const char* end)
+{
+	_string.clear();
+	const char* pos = begin;
+	while ( pos != end )
+	{
+		const char* run = pos;
+		while ( pos != end && *pos != '\\' && static_cast<unsigned char>(*pos) >= 0x20 ) ++pos;
+		_string.append(run, pos - run);
+		if ( pos == end )
+			break;
+
+		char c = *pos++;
+		if ( c != '\\' )
+		{
+			throw JSONException(format("Control character 0x%x not allowed", (unsigned int) c));
+		}
+
+		c = *pos++; // The scanner guarantees a character after a backslash
+		switch(c)
+		{
+		case '"' :
+			_string += '"';
+			break;
+		case '\\' :
+			_string += '\\';
+			break;
+		case '/' :
+			_string += '/';
+			break;
+		case 'b' :
+			_string += '\b';
+			break;
+		case 'f' :
+			_string += '\f';
+			break;
+		case 'n' :
+			_string += '\n';
+			break;
+		case 'r' :
+			_string += '\r';
+			break;
+		case 't' :
+			_string += '\t';
+			break;
+		case 'u' :
+		{
+			Poco::Int32 unicode = decodeUnicode(pos, end);
+			if ( unicode == 0 )
+			{
+				throw JSONException("\\u0000 is not allowed");
+			}
+			if ( unicode >= 0xD800 && unicode <= 0xDBFF )
+			{
+				if ( end - pos < 2 || pos[0] != '\\' || pos[1] != 'u' )
+				{
+					throw JSONException("Invalid unicode surrogate pair");
+				}
+				pos += 2;
+				Poco::Int32 surrogatePair = decodeUnicode(pos, end);
+				if ( 0xDC00 <= surrogatePair && surrogatePair <= 0xDFFF )
+				{
+					unicode = 0x10000 + ((unicode & 0x3FF) << 10) + (surrogatePair & 0x3FF);
+				}
+				else
+				{
+					throw JSONException("Invalid unicode surrogate pair");
+				}
+			}
+			else if ( 0xDC00 <= unicode && unicode <= 0xDFFF )
+			{
+				throw JSONException("Invalid unicode");
+			}
+			appendUTF8(_string, unicode);
+			break;
+		}
+		default:
+			throw JSONException(format("Invalid escape '%c' character used", c));
+		}
+	}
+}
+
+
+Reader::Event Reader::decodeNumber(const char* begin, const char* end)
+{
+	const char* pos = begin;
+	bool negative = false;
+	if ( pos != end && *pos == '-' )
+	{
+		negative = true;
+		++pos;
+	}
+
+	const char* digits = pos;
+	if ( pos == end || !Ascii::isDigit(*pos) )
+	{
+		throw JSONException("Invalid number found");
+	}
+	if ( *pos == '0' && pos + 1 != end && Ascii::isDigit(pos[1]) )
+	{
+		throw JSONException("Number can't start with a zero");
+	}
+	while ( pos != end && Ascii::isDigit(*pos) ) ++pos;
+	std::size_t intDigits = pos - digits;
+
+	bool isInteger = true;
+	if ( pos != end && *pos == '.' )
+	{
+		isInteger = false;
+		++pos;
+		if ( pos == end || !Ascii::isDigit(*pos) )
+		{
+			throw JSONException("Invalid float value");
+		}
+		while ( pos != end && Ascii::isDigit(*pos) ) ++pos;
+	}
+	if ( pos != end && (*pos == 'e' || *pos == 'E') )
+	{
+		isInteger = false;
+		++pos;
+		if ( pos != end && (*pos == '-' || *pos == '+') ) ++pos;
+		if ( pos == end || !Ascii::isDigit(*pos) )
+		{
+			throw JSONException("Invalid double value");
+		}
+		while ( pos != end && Ascii::isDigit(*pos) ) ++pos;
+	}
+	if ( pos != end )
+	{
+		throw JSONException("Invalid number found");
+	}
+
+	endValue();
+
+	if ( isInteger && intDigits <= 19 )
+	{
+		UInt64 value = 0;
+		for(const char* it = digits; it != digits + intDigits; ++it)
+		{
+			value = value * 10 + (*it - '0');
+		}
+		UInt64 limit = static_cast<UInt64>(std::numeric_limits<Int64>::max()) + (negative ? 1 : 0);
+		if ( intDigits < 19 || value <= limit )
+		{
+			_integer = negative ? static_cast<Int64>(0 - value) : static_cast<Int64>(value);
+			_double = static_cast<double>(_integer);
+			return INTEGER_VALUE;
+		}
+	}
+
+	// strtod needs a terminated string
+	std::size_t length = end - begin;
+	if ( length < 64 )
+	{
+		char number[64];
+		std::memcpy(number, begin, length);
+		number[length] = '\0';
+		_double = std::strtod(number, NULL);
+	}
+	else
+	{
+		std::string number(begin, length);
+		_double = std::strtod(number.c_str(), NULL);
+	}
+	return DOUBLE_VALUE;
+}
+
+
+Reader::Event Reader::decodeKeyword(const char* begin, const char* end)
+{
+	std::size_t length = end - begin;
+	Event event;
+	if ( length == 4 && std::memcmp(begin, "null", 4) == 0 )
+	{
+		event = NULL_VALUE;
+	}
+	else if ( length == 4 && std::memcmp(begin, "true", 4) == 0 )
+	{
+		_integer = 1;
+		event = BOOLEAN_VALUE;
+	}
+	else if ( length == 5 && std::memcmp(begin, "false", 5) == 0 )
+	{
+		_integer = 0;
+		event = BOOLEAN_VALUE;
+	}
+	else
+	{
+		throw JSONException(format("Invalid token '%s' found", std::string(begin, length)));
+	}
+	endValue();
+	return event;
+}
+
+
+bool Reader::skipValue()
+{
+	if ( ! _skipping )
+	{
+		if ( _event == START_OBJECT || _event == START_ARRAY )
+		{
+			_skipDepth = _stack.size() - 1;
+		}
+		else if ( _event == KEY )
+		{
+			_skipDepth = _stack.size();
+		}
+		else
+		{
+			return true;
+		}
+		_skipping = true;
+	}
+
+	while(true)
+	{
+		Event event = next();
+		if ( event == NEED_MORE_INPUT )
+			return false;
+
+		if (    _stack.size() == _skipDepth
+		     && event != KEY
+		     && event != START_OBJECT
+		     && event != START_ARRAY )
+		{
+			_skipping = false;
+			return true;
+		}
+	}
+}
+
+
+bool Reader::nextValue(DynamicAny& value)
+{
+	while(true)
+	{
+		if ( _builder.isNull() )
+		{
+			_valueDepth = _stack.size();
+		}
+
+		Event event = next();
+		switch(event)
+		{
+		case NEED_MORE_INPUT:
+		case END_OF_INPUT:
+			return false;
+		case START_OBJECT:
+			if ( _builder.isNull() ) _builder = new DefaultHandler();
+			_builder->startObject();
+			break;
+		case START_ARRAY:
+			if ( _builder.isNull() ) _builder = new DefaultHandler();
+			_builder->startArray();
+			break;
+		case END_OBJECT:
+			if ( _builder.isNull() ) return false; // End of the enclosing object
+			_builder->endObject();
+			break;
+		case END_ARRAY:
+			if ( _builder.isNull() ) return false; // End of the enclosing array
+			_builder->endArray();
+			break;
+		case KEY:
+			if ( _builder.isNull() ) continue; // Read the value of the key
+			_builder->key(_string);
+			break;
+		case NULL_VALUE:
+			if ( _builder.isNull() )
+			{
+				value = DynamicAny();
+				return true;
+			}
+			_builder->null();
+			break;
+		case BOOLEAN_VALUE:
+			if ( _builder.isNull() )
+			{
+				value = getBoolean();
+				return true;
+			}
+			_builder->value(getBoolean());
+			break;
+		case INTEGER_VALUE:
+			// Like Parser, integers that don't fit in an int are doubles
+			if ( _integer >= std::numeric_limits<int>::min() && _integer <= std::numeric_limits<int>::max() )
+			{
+				if ( _builder.isNull() )
+				{
+					value = static_cast<int>(_integer);
+					return true;
+				}
+				_builder->value(static_cast<int>(_integer));
+				break;
+			}
+			// Fall through
+		case DOUBLE_VALUE:
+			if ( _builder.isNull() )
+			{
+				value = _double;
+				return true;
+			}
+			_builder->value(_double);
+			break;
+		case STRING_VALUE:
+			if ( _builder.isNull() )
+			{
+				value = _string;
+				return true;
+			}
+			_builder->value(_string);
+			break;
+		}
+
+		if ( _stack.size() == _valueDepth && (event == END_OBJECT || event == END_ARRAY) )
+		{
+			value = _builder->result();
+			_builder = NULL;
+			return true;
+		}
+	}
+}
+
+
+}} // Namespace Poco::JSON
@@ -37,6 +37,7 @@
 #include "Poco/JSON/Template.h"
 #include "Poco/JSON/TemplateCache.h"
 #include "Poco/JSON/Query.h"
+#include "Poco/JSON/CompiledQuery.h"
 
 namespace Poco
 {
@@ -45,6 +46,131 @@ namespace JSON
 
 POCO_IMPLEMENT_EXCEPTION(JSONTemplateException, Exception, "Template Exception")
 
+
+struct Instruction
+{
+	enum OpCode
+	{
+		TEXT,     // Write length characters of the text, starting at offset
+		ECHO,     // Write the value of the query
+		IF,       // Jump to target when the query is false
+		IF_EXIST, // Jump to target when the query returns nothing
+		JUMP,     // Jump to target
+		LOOP,     // Start looping over the array of the query, or jump to target
+		NEXT,     // Jump to target for the next element of the loop
+		INCLUDE   // Render the template of path
+	};
+
+	Instruction(OpCode o) : op(o), offset(0), length(0), target(0)
+	{
+	}
+
+	OpCode op;
+
+	std::size_t offset;
+
+	std::size_t length;
+
+	std::size_t target;
+
+	CompiledQuery::Ptr query;
+
+	std::string name;
+
+	Path path;
+};
+
+
+struct LoopState
+{
+	Object::Ptr object;
+
+	Array::Ptr array;
+
+	std::size_t index;
+};
+
+
+class TemplateProgram
+	/// The compiled form of a template: a flat list of
+	/// instructions and all literal text in one block.
+{
+public:
+
+	TemplateProgram() : _label(0)
+	{
+	}
+
+	void addText(const std::string& text)
+	{
+		// Text following text is merged into one instruction,
+		// unless the last instruction is the target of a jump.
+		if (    !_instructions.empty()
+		     && _instructions.back().op == Instruction::TEXT
+		     && _label != _instructions.size() )
+		{
+			_instructions.back().length += text.length();
+		}
+		else
+		{
+			Instruction instruction(Instruction::TEXT);
+			instruction.offset = _text.length();
+			instruction.length = text.length();
+			_instructions.push_back(instruction);
+		}
+		_text.append(text);
+	}
+
+	std::size_t add(const Instruction& instruction)
+	{
+		_instructions.push_back(instruction);
+		return _instructions.size() - 1;
+	}
+
+	std::size_t label()
+		/// Returns the index of the next instruction, to use as jump target
+	{
+		_label = _instructions.size();
+		return _label;
+	}
+
+	Instruction& operator [] (std::size_t index)
+	{
+		return _instructions[index];
+	}
+
+	const Instruction& operator [] (std::size_t index) const
+	{
+		return _instructions[index];
+	}
+
+	std::size_t size() const
+	{
+		return _instructions.size();
+	}
+
+	const std::string& text() const
+	{
+		return _text;
+	}
+
+	void shrink()
+		/// Releases the memory that was reserved while compiling
+	{
+		std::vector<Instruction>(_instructions).swap(_instructions);
+		std::string(_text).swap(_text);
+	}
+
+private:
+
+	std::vector<Instruction> _instructions;
+
+	std::string _text;
+
+	std::size_t _label;
+};
+
+
 class Part
 {
 public:
@@ -60,6 +186,8 @@ public:
 
 	virtual void render(const DynamicAny& data, std::ostream& out) const = 0;
 
+	virtual void compile(TemplateProgram& program) const = 0;
+
 	typedef std::vector<SharedPtr<Part> > VectorParts;
 };
 
@@ -87,6 +215,12 @@ public:
 	}
 
 
+	void compile(TemplateProgram& program) const
+	{
+		program.addText(_content);
+	}
+
+
 	void setContent(const std::string& content)
 	{
 		_content = content;
@@ -133,6 +267,15 @@ public:
 		}
 	}
 
+
+	void compile(TemplateProgram& program) const
+	{
+		for(VectorParts::const_iterator it = _parts.begin(); it != _parts.end(); ++it)
+		{
+			(*it)->compile(program);
+		}
+	}
+
 protected:
 
 	VectorParts _parts;
@@ -162,6 +305,14 @@ public:
 		}
 	}
 
+
+	void compile(TemplateProgram& program) const
+	{
+		Instruction instruction(Instruction::ECHO);
+		instruction.query = CompiledQuery::compile(_query);
+		program.add(instruction);
+	}
+
 private:
 
 	std::string _query;
@@ -180,10 +331,22 @@ public:
 
 	virtual bool apply(const DynamicAny& data) const
 	{
-		bool logic = false;
-
 		Query query(data);
-		DynamicAny value = query.find(_queryString);
+		return isTrue(query.find(_queryString));
+	}
+
+	virtual std::size_t compile(TemplateProgram& program) const
+		/// Adds the instruction that jumps over the part when
+		/// the query is false. Returns the index of the instruction.
+	{
+		Instruction instruction(Instruction::IF);
+		instruction.query = CompiledQuery::compile(_queryString);
+		return program.add(instruction);
+	}
+
+	static bool isTrue(const DynamicAny& value)
+	{
+		bool logic = false;
 
 		if ( ! value.isEmpty() ) // When empty, logic will be false
 		{
@@ -228,6 +391,13 @@ public:
 
 		return !value.isEmpty();
 	}
+
+	virtual std::size_t compile(TemplateProgram& program) const
+	{
+		Instruction instruction(Instruction::IF_EXIST);
+		instruction.query = CompiledQuery::compile(_queryString);
+		return program.add(instruction);
+	}
 };
 
 
@@ -246,6 +416,11 @@ public:
 	{
 		return true;
 	}
+
+	virtual std::size_t compile(TemplateProgram& program) const
+	{
+		return std::string::npos; // Else is always true
+	}
 };
 
 
@@ -286,6 +461,27 @@ public:
 		}
 	}
 
+	void compile(TemplateProgram& program) const
+	{
+		std::vector<std::size_t> jumps;
+		for(std::size_t i = 0; i < _queries.size() && i < _parts.size(); i++)
+		{
+			std::size_t condition = _queries[i]->compile(program);
+			_parts[i]->compile(program);
+			jumps.push_back(program.add(Instruction(Instruction::JUMP)));
+			if ( condition != std::string::npos )
+			{
+				program[condition].target = program.label();
+			}
+		}
+
+		std::size_t end = program.label();
+		for(std::vector<std::size_t>::iterator it = jumps.begin(); it != jumps.end(); ++it)
+		{
+			program[*it].target = end;
+		}
+	}
+
 private:
 
 	std::vector<SharedPtr<LogicQuery> > _queries;
@@ -325,6 +521,24 @@ public:
 		}
 	}
 
+	void compile(TemplateProgram& program) const
+	{
+		Instruction loop(Instruction::LOOP);
+		loop.query = CompiledQuery::compile(_query);
+		loop.name = _name;
+		std::size_t start = program.add(loop);
+
+		std::size_t body = program.label();
+		MultiPart::compile(program);
+
+		Instruction next(Instruction::NEXT);
+		next.name = _name;
+		next.target = body;
+		program.add(next);
+
+		program[start].target = program.label();
+	}
+
 private:
 
 	std::string _name;
@@ -377,6 +591,15 @@ public:
 		}
 	}
 
+	void compile(TemplateProgram& program) const
+	{
+		// The template is looked up when rendering, so changes
+		// to the included template are picked up by the cache.
+		Instruction include(Instruction::INCLUDE);
+		include.path = _path;
+		program.add(include);
+	}
+
 private:
 
 	Path _path;
@@ -386,21 +609,21 @@ private:
 Template::Template(const Path& templatePath)
 	: _parts(NULL)
 	, _templatePath(templatePath)
+	, _program(NULL)
 {
 }
 
 Template::Template()
 	: _parts(NULL)
+	, _program(NULL)
 {
 }
 
 
 Template::~Template()
 {
-	if ( _parts != NULL )
-	{
-		delete _parts;
-	}
+	delete _parts;
+	delete _program;
 }
 
 
@@ -419,6 +642,9 @@ void Template::parse(std::istream& in)
 {
 	_parseTime.update();
 
+	delete _program;
+	_program = NULL;
+	delete _parts;
 	_parts = new MultiPart();
 	_currentPart = _parts;
 
@@ -728,9 +954,164 @@ std::string Template::readString(std::istream& in)
 	return str;
 }
 
+void Template::compile()
+{
+	poco_check_ptr (_parts);
+
+	TemplateProgram* program = new TemplateProgram();
+	try
+	{
+		_parts->compile(*program);
+	}
+	catch(...)
+	{
+		delete program;
+		throw;
+	}
+	program->shrink();
+
+	delete _program;
+	_program = program;
+}
+
+
 void Template::render(const DynamicAny& data, std::ostream& out) const
 {
-	_parts->render(data, out);
+	if ( _program == NULL )
+	{
+		_parts->render(data, out);
+		return;
+	}
+
+	std::string buffer;
+	buffer.reserve(RENDER_CHUNK_SIZE + RENDER_CHUNK_SIZE / 4);
+	execute(data, buffer, out);
+	out.write(buffer.data(), buffer.size());
+}
+
+
+void Template::execute(const DynamicAny& data, std::string& buffer, std::ostream& out) const
+{
+	const TemplateProgram& program = *_program;
+	const std::string& text = program.text();
+	std::vector<LoopState> loops;
+
+	std::size_t pc = 0;
+	while ( pc < program.size() )
+	{
+		const Instruction& instruction = program[pc];
+		switch(instruction.op)
+		{
+		case Instruction::TEXT:
+			buffer.append(text, instruction.offset, instruction.length);
+			break;
+		case Instruction::ECHO:
+		{
+			DynamicAny value = instruction.query->find(data);
+			if ( value.type() == typeid(std::string) )
+			{
+				buffer.append(value.extract<std::string>());
+			}
+			else if ( ! value.isEmpty() )
+			{
+				buffer.append(value.convert<std::string>());
+			}
+			break;
+		}
+		case Instruction::IF:
+			if ( ! LogicQuery::isTrue(instruction.query->find(data)) )
+			{
+				pc = instruction.target;
+				continue;
+			}
+			break;
+		case Instruction::IF_EXIST:
+			if ( instruction.query->find(data).isEmpty() )
+			{
+				pc = instruction.target;
+				continue;
+			}
+			break;
+		case Instruction::JUMP:
+			pc = instruction.target;
+			continue;
+		case Instruction::LOOP:
+		{
+			// Like LoopPart, the element is stored in the data object
+			if ( data.type() != typeid(Object::Ptr) )
+			{
+				pc = instruction.target;
+				continue;
+			}
+			DynamicAny value = instruction.query->find(data);
+			if ( value.type() != typeid(Array::Ptr) )
+			{
+				pc = instruction.target;
+				continue;
+			}
+
+			LoopState loop;
+			loop.object = data.extract<Object::Ptr>();
+			loop.array = value.extract<Array::Ptr>();
+			loop.index = 0;
+			if ( loop.array->size() == 0 )
+			{
+				loop.object->remove(instruction.name);
+				pc = instruction.target;
+				continue;
+			}
+			loop.object->set(instruction.name, loop.array->get(0));
+			loops.push_back(loop);
+			break;
+		}
+		case Instruction::NEXT:
+		{
+			LoopState& loop = loops.back();
+			if ( ++loop.index < loop.array->size() )
+			{
+				loop.object->set(instruction.name, loop.array->get(loop.index));
+				pc = instruction.target;
+				continue;
+			}
+			loop.object->remove(instruction.name);
+			loops.pop_back();
+			break;
+		}
+		case Instruction::INCLUDE:
+		{
+			Template::Ptr tpl;
+			TemplateCache* cache = TemplateCache::instance();
+			if ( cache == NULL )
+			{
+				tpl = new Template(instruction.path);
+				tpl->parse();
+			}
+			else
+			{
+				tpl = cache->getTemplate(instruction.path);
+			}
+
+			if ( tpl->isCompiled() )
+			{
+				tpl->execute(data, buffer, out);
+			}
+			else
+			{
+				out.write(buffer.data(), buffer.size());
+				buffer.clear();
+				tpl->render(data, out);
+			}
+			break;
+		}
+		}
+
+		if ( buffer.size() >= RENDER_CHUNK_SIZE )
+		{
+			out.write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+		++pc;
+	}
 }
 
 }} // Namespace Poco::JSON
@@ -36,6 +36,18 @@
 #include "Poco/File.h"
 #include "Poco/JSON/TemplateCache.h"
 
+#include <algorithm>
+#include <limits>
+
+#if POCO_OS == POCO_OS_LINUX
+#define POCO_JSON_HAVE_INOTIFY
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#endif
+
 namespace Poco
 {
 namespace JSON
@@ -43,14 +55,63 @@ namespace JSON
 
 TemplateCache* TemplateCache::_instance = NULL;
 
-TemplateCache::TemplateCache() : _logger(NULL)
+static const int CLOCK_LIMIT = std::numeric_limits<int>::max() / 2;
+	/// The use clock is restarted when it reaches this value
+
+TemplateCache::TemplateCache(std::size_t capacity, long pollInterval, bool notify)
+	: _capacity(capacity)
+	, _pollInterval(pollInterval)
+	, _logger(NULL)
+	, _notifyFd(-1)
+	, _watcher(*this, &TemplateCache::run)
 {
+	_wakeFd[0] = _wakeFd[1] = -1;
+
+#if defined(POCO_JSON_HAVE_INOTIFY)
+	if ( notify )
+	{
+		_notifyFd = inotify_init();
+		if ( _notifyFd != -1 )
+		{
+			if ( pipe(_wakeFd) != 0 )
+			{
+				close(_notifyFd);
+				_notifyFd = -1;
+			}
+			else
+			{
+				fcntl(_notifyFd, F_SETFL, O_NONBLOCK);
+			}
+		}
+	}
+#endif
+
 	setup();
+	_thread.setName("TemplateCache");
+	_thread.start(_watcher);
 }
 
 
 TemplateCache::~TemplateCache()
 {
+	_stop.set();
+#if defined(POCO_JSON_HAVE_INOTIFY)
+	if ( _wakeFd[1] != -1 )
+	{
+		char c = 0;
+		while ( write(_wakeFd[1], &c, 1) == -1 && errno == EINTR ) ;
+	}
+#endif
+	_thread.join();
+
+#if defined(POCO_JSON_HAVE_INOTIFY)
+	if ( _notifyFd != -1 )
+	{
+		close(_notifyFd);
+		close(_wakeFd[0]);
+		close(_wakeFd[1]);
+	}
+#endif
 	_instance = NULL;
 }
 
@@ -61,84 +122,399 @@ void TemplateCache::setup()
 }
 
 
+void TemplateCache::addPath(const Path& path)
+{
+	ScopedRWLock lock(_lock, true);
+	_includePaths.push_back(path);
+}
+
+
 Template::Ptr TemplateCache::getTemplate(const Path& path)
 {
+	std::string key = path.toString();
+
+	Template::Ptr previous;
+	bool hit = false;
+	{
+		ScopedRWLock lock(_lock, false);
+
+		EntryMap::iterator it = _cache.find(key);
+		if ( it != _cache.end() )
+		{
+			previous = it->second.tpl;
+			if ( ! it->second.stale )
+			{
+				it->second.lastUsed = ++_clock;
+				++_hits;
+				hit = true;
+			}
+		}
+	}
+
+	if ( hit )
+	{
+		if ( _clock.value() >= CLOCK_LIMIT )
+		{
+			ScopedRWLock lock(_lock, true);
+			renumber();
+		}
+		return previous;
+	}
+
 	if ( _logger )
 	{
-		poco_trace_f1(*_logger, "Trying to load %s", path.toString());
+		poco_trace_f1(*_logger, "Trying to load %s", key);
 	}
-	Path templatePath = resolvePath(path);
+
+	// The template is loaded without holding the lock, so other
+	// templates can still be used while this one is parsed.
+	Path templatePath;
+	try
+	{
+		templatePath = resolvePath(path);
+	}
+	catch(FileNotFoundException&)
+	{
+		if ( _logger )
+		{
+			poco_error_f1(*_logger, "Template file %s doesn't exist", key);
+		}
+		if ( !previous.isNull() )
+		{
+			ScopedRWLock lock(_lock, true);
+			_cache.erase(key);
+		}
+		throw;
+	}
+
 	std::string templatePathname = templatePath.toString();
 	if ( _logger )
 	{
 		poco_trace_f1(*_logger, "Path resolved to %s", templatePathname);
 	}
+
+	// Watch before reading, so a change during parsing isn't missed
+	bool watched;
+	{
+		ScopedRWLock lock(_lock, true);
+		watched = watch(templatePathname);
+	}
+
 	File templateFile(templatePathname);
+	Timestamp modified = templateFile.getLastModified();
+	File::FileSize size = templateFile.getSize();
 
-	Template::Ptr tpl;
+	if ( _logger )
+	{
+		if ( previous.isNull() )
+		{
+			poco_information_f1(*_logger, "Loading template %s", templatePathname);
+		}
+		else
+		{
+			poco_information_f1(*_logger, "Reloading template %s", templatePathname);
+		}
+	}
 
-	std::map<std::string, Template::Ptr>::iterator it = _cache.find(templatePathname);
-	if ( it == _cache.end() )
+	Template::Ptr tpl = new Template(templatePath);
+	bool valid = true;
+	try
 	{
-		if ( templateFile.exists() )
+		tpl->parse();
+		tpl->compile();
+	}
+	catch(JSONTemplateException& jte)
+	{
+		if ( _logger )
 		{
-			if ( _logger )
-			{
-				poco_information_f1(*_logger, "Loading template %s", templatePath.toString());
-			}
+			poco_error_f2(*_logger, "Template %s contains an error: %s", templatePathname, jte.message());
+		}
+		valid = false;
+	}
 
-			tpl = new Template(templatePath);
+	ScopedRWLock lock(_lock, true);
 
-			try
-			{
-				tpl->parse();
-				_cache[templatePathname] = tpl;
-			}
-			catch(JSONTemplateException jte)
+	if ( previous.isNull() )
+	{
+		++_misses;
+		if ( ! valid )
+		{
+			return tpl;
+		}
+	}
+	else
+	{
+		++_reloads;
+		if ( ! valid )
+		{
+			// Keep the previous template until the file changes again
+			tpl = previous;
+		}
+	}
+
+	Entry& entry = _cache[key];
+	entry.tpl = tpl;
+	entry.pathname = templatePathname;
+	entry.modified = modified;
+	entry.size = size;
+	entry.lastUsed = ++_clock;
+	entry.watched = watched;
+	entry.stale = false;
+
+	evict();
+
+	return tpl;
+}
+
+
+void TemplateCache::setCapacity(std::size_t capacity)
+{
+	ScopedRWLock lock(_lock, true);
+	_capacity = capacity;
+	evict();
+}
+
+
+std::size_t TemplateCache::size() const
+{
+	ScopedRWLock lock(_lock, false);
+	return _cache.size();
+}
+
+
+void TemplateCache::clear()
+{
+	ScopedRWLock lock(_lock, true);
+	_cache.clear();
+}
+
+
+void TemplateCache::evict()
+{
+	if ( _capacity == 0 )
+		return;
+
+	while ( _cache.size() > _capacity )
+	{
+		EntryMap::iterator oldest = _cache.begin();
+		for(EntryMap::iterator it = _cache.begin(); it != _cache.end(); ++it)
+		{
+			if ( it->second.lastUsed.value() < oldest->second.lastUsed.value() )
 			{
-				if ( _logger )
-				{
-					poco_error_f2(*_logger, "Template %s contains an error: %s", templatePath.toString(), jte.message());
-				}
+				oldest = it;
 			}
 		}
-		else
+
+		if ( _logger )
+		{
+			poco_trace_f1(*_logger, "Removing template %s from the cache", oldest->first);
+		}
+		_cache.erase(oldest);
+	}
+}
+
+
+namespace
+{
+	struct UseLess
+	{
+		bool operator () (const std::pair<int, AtomicCounter*>& a, const std::pair<int, AtomicCounter*>& b) const
+		{
+			return a.first < b.first;
+		}
+	};
+}
+
+
+void TemplateCache::renumber()
+{
+	if ( _clock.value() < CLOCK_LIMIT )
+		return; // Another thread was first
+
+	std::vector<std::pair<int, AtomicCounter*> > order;
+	order.reserve(_cache.size());
+	for(EntryMap::iterator it = _cache.begin(); it != _cache.end(); ++it)
+	{
+		order.push_back(std::make_pair(it->second.lastUsed.value(), &it->second.lastUsed));
+	}
+	std::sort(order.begin(), order.end(), UseLess());
+
+	int tick = 0;
+	for(std::vector<std::pair<int, AtomicCounter*> >::iterator it = order.begin(); it != order.end(); ++it)
+	{
+		*it->second = ++tick;
+	}
+	_clock = tick;
+}
+
+
+bool TemplateCache::watch(const std::string& pathname)
+{
+#if defined(POCO_JSON_HAVE_INOTIFY)
+	if ( _notifyFd == -1 )
+		return false;
+
+	Path path(pathname);
+	std::string directory = path.parent().toString();
+	int wd = inotify_add_watch(_notifyFd,
+	                           directory.empty() ? "." : directory.c_str(),
+	                           IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CREATE);
+	if ( wd == -1 )
+	{
+		if ( _logger )
+		{
+			poco_warning_f1(*_logger, "Can't watch %s, polling for changes", directory);
+		}
+		return false;
+	}
+	_watches[wd] = directory; // Watching a directory again returns the same descriptor
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+void TemplateCache::invalidate(const std::string& pathname)
+{
+	for(EntryMap::iterator it = _cache.begin(); it != _cache.end(); ++it)
+	{
+		if ( it->second.pathname == pathname && ! it->second.stale )
 		{
 			if ( _logger )
 			{
-				poco_error_f1(*_logger, "Template file %s doesn't exist", templatePath.toString());
+				poco_trace_f1(*_logger, "Template %s has changed", pathname);
 			}
-			throw FileNotFoundException(templatePathname);
+			it->second.stale = true;
 		}
 	}
-	else
+}
+
+
+void TemplateCache::run()
+{
+#if defined(POCO_JSON_HAVE_INOTIFY)
+	if ( _notifyFd != -1 )
 	{
-		tpl = it->second;
-		if ( tpl->parseTime() < templateFile.getLastModified() )
+		Timestamp lastPoll;
+		for(;;)
 		{
-			if ( _logger )
+			struct pollfd fds[2];
+			fds[0].fd = _notifyFd;
+			fds[0].events = POLLIN;
+			fds[0].revents = 0;
+			fds[1].fd = _wakeFd[0];
+			fds[1].events = POLLIN;
+			fds[1].revents = 0;
+
+			int rc = ::poll(fds, 2, _pollInterval);
+			if ( fds[1].revents != 0 || _stop.tryWait(0) )
+				break;
+
+			if ( rc > 0 && (fds[0].revents & POLLIN) )
 			{
-				poco_information_f1(*_logger, "Reloading template %s", templatePath.toString());
+				readEvents();
 			}
 
-			tpl = new Template(templatePath);
-
-			try
+			// Files that couldn't be watched are still polled
+			if ( lastPoll.isElapsed(_pollInterval * Timestamp::TimeDiff(1000)) )
 			{
-				tpl->parse();
-				_cache[templatePathname] = tpl;
+				poll();
+				lastPoll.update();
 			}
-			catch(JSONTemplateException jte)
+		}
+		return;
+	}
+#endif
+
+	while ( ! _stop.tryWait(_pollInterval) )
+	{
+		poll();
+	}
+}
+
+
+void TemplateCache::readEvents()
+{
+#if defined(POCO_JSON_HAVE_INOTIFY)
+	char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+	for(;;)
+	{
+		ssize_t n = read(_notifyFd, buffer, sizeof(buffer));
+		if ( n <= 0 )
+			break;
+
+		ScopedRWLock lock(_lock, true);
+		for(char* p = buffer; p < buffer + n; )
+		{
+			const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(p);
+			std::map<int, std::string>::iterator it = _watches.find(event->wd);
+			if ( it != _watches.end() )
 			{
-				if ( _logger )
+				if ( event->mask & IN_IGNORED )
+				{
+					// The directory is gone, the files will be polled
+					for(EntryMap::iterator entry = _cache.begin(); entry != _cache.end(); ++entry)
+					{
+						if ( Path(entry->second.pathname).parent().toString() == it->second )
+						{
+							entry->second.watched = false;
+						}
+					}
+					_watches.erase(it);
+				}
+				else if ( event->len > 0 )
 				{
-					poco_error_f2(*_logger, "Template %s contains an error: %s", templatePath.toString(), jte.message());
+					invalidate(it->second + event->name);
 				}
 			}
+			p += sizeof(struct inotify_event) + event->len;
 		}
 	}
+#endif
+}
 
-	return tpl;
+
+void TemplateCache::poll()
+{
+	std::vector<std::pair<std::string, std::pair<Timestamp, File::FileSize> > > files;
+	{
+		ScopedRWLock lock(_lock, false);
+		for(EntryMap::const_iterator it = _cache.begin(); it != _cache.end(); ++it)
+		{
+			if ( ! it->second.watched && ! it->second.stale )
+			{
+				files.push_back(std::make_pair(it->second.pathname, std::make_pair(it->second.modified, it->second.size)));
+			}
+		}
+	}
+
+	std::vector<std::string> changed;
+	for(std::vector<std::pair<std::string, std::pair<Timestamp, File::FileSize> > >::iterator it = files.begin(); it != files.end(); ++it)
+	{
+		try
+		{
+			File file(it->first);
+			if (    file.getLastModified() != it->second.first
+			     || file.getSize() != it->second.second )
+			{
+				changed.push_back(it->first);
+			}
+		}
+		catch(FileException&)
+		{
+			changed.push_back(it->first);
+		}
+	}
+
+	if ( ! changed.empty() )
+	{
+		ScopedRWLock lock(_lock, true);
+		for(std::vector<std::string>::iterator it = changed.begin(); it != changed.end(); ++it)
+		{
+			invalidate(*it);
+		}
+	}
 }
 
 
@@ -147,7 +523,13 @@ Path TemplateCache::resolvePath(const Path& path) const
 	if ( path.isAbsolute() )
 		return path;
 
-	for(std::vector<Path>::const_iterator it = _includePaths.begin(); it != _includePaths.end(); ++it)
+	std::vector<Path> includePaths;
+	{
+		ScopedRWLock lock(_lock, false);
+		includePaths = _includePaths;
+	}
+
+	for(std::vector<Path>::const_iterator it = includePaths.begin(); it != includePaths.end(); ++it)
 	{
 		Path templatePath(*it, path);
 
@@ -0,0 +1,465 @@
+//
+// Writer.cpp
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  Writer
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Poco/JSON/Writer.h"
+#include "Poco/JSON/Array.h"
+#include "Poco/JSON/Object.h"
+
+namespace Poco
+{
+namespace JSON
+{
+
+
+namespace
+{
+	const char hexDigits[] = "0123456789ABCDEF";
+
+
+	char* formatUnsigned(UInt64 value, char* end)
+		/// Formats value into the characters before end and
+		/// returns a pointer to the first character.
+	{
+		do
+		{
+			*--end = static_cast<char>('0' + value % 10);
+			value /= 10;
+		}
+		while ( value != 0 );
+		return end;
+	}
+}
+
+
+Writer::Writer()
+	: _pOut(NULL)
+	, _chunkSize(0)
+	, _indent(0)
+	, _depth(0)
+	, _needComma(false)
+	, _afterKey(false)
+{
+}
+
+
+Writer::Writer(std::ostream& out, std::size_t chunkSize)
+	: _pOut(&out)
+	, _chunkSize(chunkSize > 0 ? chunkSize : DEFAULT_CHUNK_SIZE)
+	, _indent(0)
+	, _depth(0)
+	, _needComma(false)
+	, _afterKey(false)
+{
+	// Leave room for the value that crosses the chunk size
+	_buffer.reserve(_chunkSize + _chunkSize / 4);
+}
+
+
+Writer::Writer(std::size_t chunkSize)
+	: _pOut(NULL)
+	, _chunkSize(chunkSize > 0 ? chunkSize : DEFAULT_CHUNK_SIZE)
+	, _indent(0)
+	, _depth(0)
+	, _needComma(false)
+	, _afterKey(false)
+{
+	_buffer.reserve(_chunkSize + _chunkSize / 4);
+}
+
+
+Writer::~Writer()
+{
+	try
+	{
+		flush();
+	}
+	catch(...)
+	{
+		// A destructor must not throw
+	}
+}
+
+
+void Writer::flush()
+{
+	if ( _chunkSize > 0 && !_buffer.empty() )
+	{
+		writeChunk(_buffer.data(), _buffer.size());
+		_buffer.clear();
+	}
+}
+
+
+void Writer::writeChunk(const char* data, std::size_t length)
+{
+	if ( _pOut != NULL )
+	{
+		_pOut->write(data, static_cast<std::streamsize>(length));
+	}
+}
+
+
+void Writer::clear()
+{
+	_buffer.clear();
+	_depth = 0;
+	_needComma = false;
+	_afterKey = false;
+}
+
+
+void Writer::writeNewLine()
+{
+	_buffer += '\n';
+	_buffer.append(_depth * _indent, ' ');
+}
+
+
+void Writer::prefix()
+{
+	if ( _afterKey )
+	{
+		_afterKey = false;
+		return;
+	}
+
+	if ( _needComma )
+	{
+		_buffer += ',';
+	}
+
+	if ( _indent > 0 && _depth > 0 )
+	{
+		writeNewLine();
+	}
+}
+
+
+void Writer::close(char c)
+{
+	--_depth;
+	if ( _indent > 0 && _needComma ) // Empty containers stay on one line
+	{
+		writeNewLine();
+	}
+	_buffer += c;
+	_needComma = true;
+	checkFlush();
+}
+
+
+void Writer::startObject()
+{
+	prefix();
+	_buffer += '{';
+	++_depth;
+	_needComma = false;
+}
+
+
+void Writer::endObject()
+{
+	close('}');
+}
+
+
+void Writer::startArray()
+{
+	prefix();
+	_buffer += '[';
+	++_depth;
+	_needComma = false;
+}
+
+
+void Writer::endArray()
+{
+	close(']');
+}
+
+
+void Writer::key(const char* k, std::size_t length)
+{
+	prefix();
+	writeString(k, length);
+	if ( _indent > 0 )
+	{
+		_buffer.append(" : ", 3);
+	}
+	else
+	{
+		_buffer += ':';
+	}
+	_afterKey = true;
+}
+
+
+void Writer::null()
+{
+	prefix();
+	_buffer.append("null", 4);
+	_needComma = true;
+	checkFlush();
+}
+
+
+void Writer::value(int v)
+{
+	value(static_cast<Int64>(v));
+}
+
+
+void Writer::value(Int64 v)
+{
+	prefix();
+	char buffer[24];
+	char* end = buffer + sizeof(buffer);
+	char* begin;
+	if ( v < 0 )
+	{
+		begin = formatUnsigned(0 - static_cast<UInt64>(v), end);
+		*--begin = '-';
+	}
+	else
+	{
+		begin = formatUnsigned(static_cast<UInt64>(v), end);
+	}
+	_buffer.append(begin, end - begin);
+	_needComma = true;
+	checkFlush();
+}
+
+
+void Writer::value(UInt64 v)
+{
+	prefix();
+	char buffer[24];
+	char* end = buffer + sizeof(buffer);
+	char* begin = formatUnsigned(v, end);
+	_buffer.append(begin, end - begin);
+	_needComma = true;
+	checkFlush();
+}
+
+
+void Writer::value(double d)
+{
+	if ( d != d || d - d != 0 ) // NaN or infinity
+	{
+		null();
+		return;
+	}
+
+	prefix();
+
+	// Use the shortest precision that reads back to the same value.
+	// Most values are found with 15 digits, 17 digits always work.
+	char buffer[32];
+	int length = std::sprintf(buffer, "%.15g", d);
+	if ( std::strtod(buffer, NULL) != d )
+	{
+		length = std::sprintf(buffer, "%.16g", d);
+		if ( std::strtod(buffer, NULL) != d )
+		{
+			length = std::sprintf(buffer, "%.17g", d);
+		}
+	}
+	_buffer.append(buffer, length);
+	if ( std::strpbrk(buffer, ".e") == NULL )
+	{
+		_buffer.append(".0", 2);
+	}
+	_needComma = true;
+	checkFlush();
+}
+
+
+void Writer::value(bool b)
+{
+	prefix();
+	if ( b )
+	{
+		_buffer.append("true", 4);
+	}
+	else
+	{
+		_buffer.append("false", 5);
+	}
+	_needComma = true;
+	checkFlush();
+}
+
+
+void Writer::value(const char* s)
+{
+	value(s, std::strlen(s));
+}
+
+
+void Writer::value(const char* s, std::size_t length)
+{
+	prefix();
+	writeString(s, length);
+	_needComma = true;
+	checkFlush();
+}
+
+
+void Writer::writeString(const char* s, std::size_t length)
+{
+	_buffer += '"';
+
+	const char* end = s + length;
+	const char* run = s;
+	for(const char* it = s; it != end; ++it)
+	{
+		unsigned char c = static_cast<unsigned char>(*it);
+		if ( c >= 0x20 && c != '"' && c != '\\' )
+		{
+			continue;
+		}
+
+		// Copy the characters that need no escaping at once
+		_buffer.append(run, it - run);
+		run = it + 1;
+
+		switch(c)
+		{
+		case '"':
+			_buffer.append("\\\"", 2);
+			break;
+		case '\\':
+			_buffer.append("\\\\", 2);
+			break;
+		case '\b':
+			_buffer.append("\\b", 2);
+			break;
+		case '\f':
+			_buffer.append("\\f", 2);
+			break;
+		case '\n':
+			_buffer.append("\\n", 2);
+			break;
+		case '\r':
+			_buffer.append("\\r", 2);
+			break;
+		case '\t':
+			_buffer.append("\\t", 2);
+			break;
+		default:
+		{
+			char escape[6] = { '\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0xF] };
+			_buffer.append(escape, 6);
+			break;
+		}
+		}
+	}
+	_buffer.append(run, end - run);
+
+	_buffer += '"';
+}
+
+
+void Writer::stringify(const DynamicAny& any)
+{
+	const std::type_info& type = any.type();
+	if ( type == typeid(Object::Ptr) )
+	{
+		const Object::Ptr& o = any.extract<Object::Ptr>();
+		startObject();
+		for(Object::ValueMap::const_iterator it = o->begin(); it != o->end(); ++it)
+		{
+			key(it->first);
+			stringify(it->second);
+		}
+		endObject();
+	}
+	else if ( type == typeid(Array::Ptr) )
+	{
+		const Array::Ptr& a = any.extract<Array::Ptr>();
+		startArray();
+		for(Array::ValueVector::const_iterator it = a->begin(); it != a->end(); ++it)
+		{
+			stringify(*it);
+		}
+		endArray();
+	}
+	else if ( any.isEmpty() )
+	{
+		null();
+	}
+	else if ( type == typeid(std::string) )
+	{
+		value(any.extract<std::string>());
+	}
+	else if ( type == typeid(int) )
+	{
+		value(any.extract<int>());
+	}
+	else if ( type == typeid(double) )
+	{
+		value(any.extract<double>());
+	}
+	else if ( type == typeid(bool) )
+	{
+		value(any.extract<bool>());
+	}
+	else if ( any.isNumeric() )
+	{
+		if ( !any.isInteger() )
+		{
+			value(any.convert<double>());
+		}
+		else if ( any.isSigned() )
+		{
+			value(any.convert<Int64>());
+		}
+		else
+		{
+			value(any.convert<UInt64>());
+		}
+	}
+	else
+	{
+		value(any.convert<std::string>());
+	}
+}
+
+
+}} // Namespace Poco::JSON
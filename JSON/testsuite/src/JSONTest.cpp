@@ -1,24 +1,128 @@
 #include <set>
+#include <algorithm>
+#include <cstring>
 
 #include "Poco/JSON/Object.h"
 #include "Poco/JSON/Parser.h"
 #include "Poco/JSON/Query.h"
+#include "Poco/JSON/CompiledQuery.h"
 #include "Poco/JSON/JSONException.h"
 #include "Poco/JSON/Stringifier.h"
+#include "Poco/JSON/Writer.h"
+#include "Poco/JSON/Reader.h"
+#include "Poco/JSON/ParallelParser.h"
 #include "Poco/JSON/DefaultHandler.h"
+#include "Poco/JSON/DocumentHandler.h"
 //#include "Poco/Util/JSONConfiguration.h"
 #include "Poco/JSON/Template.h"
+#include "Poco/JSON/TemplateCache.h"
 
 #include "Poco/Path.h"
 #include "Poco/File.h"
 #include "Poco/FileStream.h"
 #include "Poco/Glob.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/Mutex.h"
 
 #include "CppUnit/TestCase.h"
 #include "CppUnit/TestCaller.h"
 #include "CppUnit/TestSuite.h"
 #include "CppUnit/TestRunner.h"
 
+#include <cstdlib>
+#include <new>
+
+
+namespace
+{
+  // Allocation statistics for the memory comparison benchmarks
+  bool countAllocations = false;
+  std::size_t allocatedBytes = 0;
+  std::size_t allocationCount = 0;
+}
+
+
+void* operator new(std::size_t size) throw(std::bad_alloc)
+{
+  if ( countAllocations )
+  {
+    allocatedBytes += size;
+    ++allocationCount;
+  }
+  void* p = std::malloc(size > 0 ? size : 1);
+  if ( p == NULL )
+  {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+
+void operator delete(void* p) throw()
+{
+  std::free(p);
+}
+
+
+class TemplateCacheReader : public Poco::Runnable
+  /// Renders templates from the cache in a separate thread
+{
+public:
+  TemplateCacheReader() : errors(0)
+  {
+  }
+
+  void run()
+  {
+    Poco::JSON::Object::Ptr data = new Poco::JSON::Object();
+    data->set("name", std::string("thread"));
+    for(int i = 0; i < 2000; i++)
+    {
+      try
+      {
+        std::ostringstream out;
+        Poco::JSON::TemplateCache::instance()->getTemplate(i % 2 == 0 ? "a.tpl" : "b.tpl")->render(data, out);
+        if ( out.str().empty() )
+          ++errors;
+      }
+      catch(Poco::Exception&)
+      {
+        ++errors;
+      }
+    }
+  }
+
+  int errors;
+};
+
+class RecordCollector : public Poco::JSON::ParallelParser::Callback
+  /// Collects the ids of the records passed by ParallelParser
+{
+public:
+  void handle(const Poco::DynamicAny& value)
+  {
+    int id = -1;
+    if ( value.type() == typeid(Poco::JSON::Object::Ptr) )
+    {
+      id = value.extract<Poco::JSON::Object::Ptr>()->getValue<int>("id");
+    }
+    else if ( value.isNumeric() )
+    {
+      id = value.convert<int>();
+    }
+    Poco::FastMutex::ScopedLock lock(mutex);
+    ids.push_back(id);
+  }
+
+  std::vector<int> ids;
+
+  Poco::FastMutex mutex;
+};
+
+
 class JSONTest : public CppUnit::TestCase
 {
 public:
@@ -611,6 +715,875 @@ protected:
     assert(firstChild.compare("Jonas") == 0);
   }
 
+  void testCompiledQuery()
+  {
+    std::string json = "{ \"name\" : \"Franky\", \"matrix\" : [ [ 1, 2 ], [ 3, 4 ] ], "
+                       "\"items\" : [ { \"id\" : 1, \"tags\" : [ \"a\" ] }, { \"id\" : 2 }, { \"name\" : \"x\" }, { \"id\" : 3, \"tags\" : [ \"b\", \"c\" ] } ] }";
+    Poco::JSON::Parser parser;
+    Poco::JSON::DefaultHandler handler;
+    parser.setHandler(&handler);
+    parser.parse(json);
+    Poco::DynamicAny result = handler.result();
+
+    Poco::JSON::CompiledQuery::Ptr query = Poco::JSON::CompiledQuery::compile("matrix[1][0]");
+    assert(query->find(result).convert<int>() == 3);
+    assert(!query->hasWildcard());
+    assert(Poco::JSON::CompiledQuery::compile("matrix[1][0]").get() == query.get());
+
+    Poco::JSON::Query q(result);
+    assert(q.findValue("items[3].tags[1]", "") == "c");
+    assert(q.findValue("name", "") == "Franky");
+    assert(q.find("items[7].id").isEmpty());
+    assert(q.find("unknown.name").isEmpty());
+
+    Poco::JSON::CompiledQuery ids("items[*].id");
+    assert(ids.hasWildcard());
+    Poco::JSON::Array::ValueVector values;
+    ids.findAll(result, values);
+    assert(values.size() == 3);
+    assert(values[0].convert<int>() == 1);
+    assert(values[2].convert<int>() == 3);
+    assert(ids.find(result).convert<int>() == 1);
+
+    Poco::JSON::Array::Ptr tags = q.findAll("items[*].tags[*]");
+    assert(tags->size() == 3);
+    assert(tags->getElement<std::string>(2) == "c");
+
+    Poco::JSON::Array::Ptr names = q.findAll("items[*].name");
+    assert(names->size() == 1);
+    assert(names->getElement<std::string>(0) == "x");
+
+    assert(q.findAll("matrix[*][1]")->size() == 2);
+    assert(q.findAll("name[*]")->size() == 0);
+  }
+
+  void testWriter()
+  {
+    Poco::JSON::Writer writer;
+    writer.startObject();
+    writer.key("name");
+    writer.value("Fra\"nky\n\x01");
+    writer.key("age");
+    writer.value(-42);
+    writer.key("big");
+    writer.value(Poco::UInt64(18446744073709551615ULL));
+    writer.key("height");
+    writer.value(1.85);
+    writer.key("third");
+    writer.value(1.0 / 3);
+    writer.key("weight");
+    writer.value(80.0);
+    writer.key("alive");
+    writer.value(true);
+    writer.key("spouse");
+    writer.null();
+    writer.key("children");
+    writer.startArray();
+    writer.value(std::string("Jonas"));
+    writer.startObject();
+    writer.endObject();
+    writer.startArray();
+    writer.endArray();
+    writer.endArray();
+    writer.endObject();
+
+    assert(writer.str() == "{\"name\":\"Fra\\\"nky\\n\\u0001\",\"age\":-42,\"big\":18446744073709551615,"
+                           "\"height\":1.85,\"third\":0.3333333333333333,\"weight\":80.0,\"alive\":true,\"spouse\":null,"
+                           "\"children\":[\"Jonas\",{},[]]}");
+
+    // Round trip a parsed document through the writer
+    std::string json = "{\"a\":[1,2.5,\"x\\ty\",{\"b\":null,\"c\":false}],\"d\":\"\\u00e9\"}";
+    Poco::JSON::Parser parser;
+    Poco::JSON::DefaultHandler handler;
+    parser.setHandler(&handler);
+    parser.parse(json);
+
+    Poco::JSON::Writer domWriter;
+    domWriter.stringify(handler.result());
+    assert(domWriter.str() == "{\"a\":[1,2.5,\"x\\ty\",{\"b\":null,\"c\":false}],\"d\":\"\xC3\xA9\"}");
+
+    // The writer is a handler, so it can reformat a document
+    Poco::JSON::Writer indentWriter;
+    indentWriter.setIndent(2);
+    parser.setHandler(&indentWriter);
+    parser.parse("{ \"a\" : [ 1, { } ], \"b\" : { \"c\" : [] } }");
+    assert(indentWriter.str() == "{\n  \"a\" : [\n    1,\n    {}\n  ],\n  \"b\" : {\n    \"c\" : []\n  }\n}");
+
+    // Chunks are written to the stream
+    std::ostringstream out;
+    {
+      Poco::JSON::Writer streamWriter(out, 16);
+      streamWriter.startArray();
+      for(int i = 0; i < 100; i++)
+      {
+        streamWriter.value(i);
+      }
+      assert(out.str().size() > 0);
+      streamWriter.endArray();
+    }
+    Poco::JSON::DefaultHandler arrayHandler;
+    parser.setHandler(&arrayHandler);
+    parser.parse(out.str());
+    Poco::JSON::Array::Ptr arr = arrayHandler.result().extract<Poco::JSON::Array::Ptr>();
+    assert(arr->size() == 100);
+    assert(arr->getElement<int>(99) == 99);
+  }
+
+  void testWriterBenchmark()
+  {
+    Poco::JSON::Array::Ptr items = new Poco::JSON::Array();
+    for(int i = 0; i < 1000; i++)
+    {
+      Poco::JSON::Object::Ptr item = new Poco::JSON::Object();
+      item->set("id", i);
+      item->set("name", std::string("item number with a \"quoted\" description"));
+      item->set("price", i + 0.25);
+      item->set("active", true);
+      items->add(item);
+    }
+    Poco::DynamicAny data(items);
+
+    const int iterations = 50;
+    Poco::Stopwatch sw;
+
+    sw.start();
+    std::size_t stringifySize = 0;
+    for(int i = 0; i < iterations; i++)
+    {
+      std::ostringstream out;
+      Poco::JSON::Stringifier::stringify(data, out);
+      stringifySize = out.str().size();
+    }
+    sw.stop();
+    Poco::Timestamp::TimeDiff stringifyTime = sw.elapsed();
+
+    sw.restart();
+    std::size_t writerSize = 0;
+    for(int i = 0; i < iterations; i++)
+    {
+      std::ostringstream out;
+      Poco::JSON::Writer writer(out);
+      writer.stringify(data);
+      writer.flush();
+      writerSize = out.str().size();
+    }
+    sw.stop();
+    Poco::Timestamp::TimeDiff writerTime = sw.elapsed();
+
+    sw.restart();
+    for(int i = 0; i < iterations; i++)
+    {
+      // SAX-style, without building the objects
+      std::ostringstream out;
+      Poco::JSON::Writer writer(out);
+      writer.startArray();
+      for(int j = 0; j < 1000; j++)
+      {
+        writer.startObject();
+        writer.key("active");
+        writer.value(true);
+        writer.key("id");
+        writer.value(j);
+        writer.key("name");
+        writer.value("item number with a \"quoted\" description");
+        writer.key("price");
+        writer.value(j + 0.25);
+        writer.endObject();
+      }
+      writer.endArray();
+    }
+    sw.stop();
+    Poco::Timestamp::TimeDiff emitTime = sw.elapsed();
+
+    std::cout << std::endl << iterations << " x 1000 objects: "
+              << "Stringifier " << stringifyTime / 1000 << " ms (" << stringifySize << " bytes), "
+              << "Writer " << writerTime / 1000 << " ms (" << writerSize << " bytes), "
+              << "Writer without DOM " << emitTime / 1000 << " ms" << std::endl;
+  }
+
+  void testBufferParser()
+  {
+    std::string json = "{ \"name\" : \"Fra\\\"nky\\u00e9\", \"age\" : 42, \"height\" : 1.85, "
+                       "\"big\" : 12345678901, \"neg\" : -7, \"alive\" : true, \"spouse\" : null, "
+                       "\"children\" : [ \"Jonas\", \"Ellen\", {} ] }";
+    Poco::JSON::Parser parser;
+    Poco::DynamicAny result;
+
+    try
+    {
+      Poco::JSON::DefaultHandler handler;
+      parser.setHandler(&handler);
+      parser.parse(json.data(), json.size());
+      result = handler.result();
+    }
+    catch(Poco::JSON::JSONException jsone)
+    {
+      std::cout << jsone.message() << std::endl;
+      assert(false);
+    }
+
+    assert(result.type() == typeid(Poco::JSON::Object::Ptr));
+
+    Poco::JSON::Object::Ptr object = result.extract<Poco::JSON::Object::Ptr>();
+    assert(object->getValue<std::string>("name") == "Fra\"nky\xC3\xA9");
+    assert(object->get("age").type() == typeid(int));
+    assert(object->getValue<int>("age") == 42);
+    assert(object->getValue<double>("height") == 1.85);
+    assert(object->get("big").type() == typeid(double));
+    assert(object->getValue<int>("neg") == -7);
+    assert(object->getValue<bool>("alive"));
+    assert(object->isNull("spouse"));
+
+    Poco::JSON::Array::Ptr children = object->getArray("children");
+    assert(!children.isNull());
+    assert(children->size() == 3);
+    assert(children->getElement<std::string>(1) == "Ellen");
+    assert(children->isObject(2));
+
+    // The buffer doesn't need to be terminated
+    std::string padded = "[ 1, 2 ]garbage";
+    Poco::JSON::DefaultHandler handler;
+    parser.setHandler(&handler);
+    parser.parse(padded.data(), 8);
+    Poco::JSON::Array::Ptr arr = handler.result().extract<Poco::JSON::Array::Ptr>();
+    assert(arr->size() == 2);
+
+    const char* invalid[] = { "{ \"a\" : 1, }", "[ 1 2 ]", "{ \"a\" 1 }", "[ 01 ]", "[ 1. ]",
+                              "[ \"abc ]", "[ tru ]", "[ \"\\x\" ]", "[ 1 ] x", "\"a\"", "[ \"\\ud800\" ]" };
+    for(int i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+    {
+      try
+      {
+        Poco::JSON::DefaultHandler h;
+        parser.setHandler(&h);
+        parser.parse(invalid[i], std::strlen(invalid[i]));
+        assert(false);
+      }
+      catch(Poco::JSON::JSONException&)
+      {
+      }
+    }
+  }
+
+  void testDocument()
+  {
+    std::string json = "{ \"name\" : \"Franky\", \"age\" : 42, \"height\" : 1.85, \"alive\" : true, "
+                       "\"spouse\" : null, \"name\" : \"Frank\", \"\" : 1, "
+                       "\"children\" : [ { \"name\" : \"Jonas\" }, { \"name\" : \"Ellen\", \"age\" : 7 } ] }";
+    Poco::JSON::Parser parser;
+    Poco::JSON::DocumentHandler handler;
+    parser.setHandler(&handler);
+    parser.parse(json);
+
+    Poco::JSON::Document::Ptr doc = handler.result();
+    assert(!doc.isNull());
+    Poco::JSON::Document::Value root = doc->root();
+    assert(root.isObject());
+    assert(root.size() == 7);
+    assert(root.get("name").getString() == "Frank");
+    assert(std::string(root.get("name").data(), root.get("name").length()) == "Frank");
+    assert(root.get("age").type() == Poco::JSON::Document::INTEGER_VALUE);
+    assert(root.get("age").getInteger() == 42);
+    assert(root.get("height").getDouble() == 1.85);
+    assert(root.get("alive").getBoolean());
+    assert(root.has("spouse"));
+    assert(root.get("spouse").isNull());
+    assert(root.get("").getInteger() == 1);
+    assert(!root.has("unknown"));
+    assert(root.get("unknown").isNull());
+
+    // Properties are sorted on their name
+    assert(root.key(0) == "");
+    assert(root.key(1) == "age");
+    assert(root.key(6) == "spouse");
+    assert(root.member(1).getInteger() == 42);
+
+    Poco::JSON::Document::Value children = root.get("children");
+    assert(children.isArray());
+    assert(children.size() == 2);
+    assert(children.get(0).get("name").getString() == "Jonas");
+    assert(children.get(1).get("age").getInteger() == 7);
+    assert(children.get(2).isNull());
+
+    try
+    {
+      root.get("name").getInteger();
+      assert(false);
+    }
+    catch(Poco::BadCastException&)
+    {
+    }
+
+    // The handler can be reused, the first document stays valid
+    parser.parse("[ 1, [ ], \"x\" ]");
+    Poco::JSON::Document::Ptr doc2 = handler.result();
+    assert(doc2->root().isArray());
+    assert(doc2->root().size() == 3);
+    assert(doc2->root().get(1).isArray());
+    assert(doc2->root().get(1).size() == 0);
+    assert(doc2->root().get(2).getString() == "x");
+    assert(root.get("children").get(0).get("name").getString() == "Jonas");
+
+    // Many distinct keys, and the same keys in a later parse
+    std::ostringstream keys;
+    keys << "{";
+    for(int i = 0; i < 1000; i++)
+    {
+      keys << (i > 0 ? ", " : " ") << "\"k" << i << "\" : " << i;
+    }
+    keys << " }";
+    for(int i = 0; i < 2; i++)
+    {
+      parser.parse(keys.str());
+      Poco::JSON::Document::Value object = handler.result()->root();
+      assert(object.size() == 1000);
+      assert(object.get("k0").getInteger() == 0);
+      assert(object.get("k500").getInteger() == 500);
+      assert(object.get("k999").getInteger() == 999);
+    }
+  }
+
+  void testHandlerReuseAfterError()
+  {
+    Poco::JSON::Parser parser;
+    Poco::JSON::DocumentHandler documentHandler;
+    parser.setHandler(&documentHandler);
+    try
+    {
+      parser.parse("{ \"a\" : [ 1, 2, { \"b\" : ");
+      assert(false);
+    }
+    catch(Poco::JSON::JSONException&)
+    {
+    }
+    parser.parse("{ \"c\" : [ 3 ] }");
+    Poco::JSON::Document::Ptr doc = documentHandler.result();
+    assert(!doc.isNull());
+    assert(doc->root().isObject());
+    assert(doc->root().size() == 1);
+    assert(doc->root().get("c").get(0).getInteger() == 3);
+
+    // A failed parse leaves no result, the previous document stays valid
+    try
+    {
+      parser.parse("{ \"c\" : [ 4, ");
+      assert(false);
+    }
+    catch(Poco::JSON::JSONException&)
+    {
+    }
+    assert(documentHandler.result().isNull());
+    assert(doc->root().get("c").get(0).getInteger() == 3);
+
+    Poco::JSON::DefaultHandler defaultHandler;
+    parser.setHandler(&defaultHandler);
+    try
+    {
+      parser.parse("[ { \"a\" : [ 1, ");
+      assert(false);
+    }
+    catch(Poco::JSON::JSONException&)
+    {
+    }
+    parser.parse("{ \"c\" : 3 }");
+    Poco::DynamicAny result = defaultHandler.result();
+    assert(result.type() == typeid(Poco::JSON::Object::Ptr));
+    Poco::JSON::Object::Ptr object = result.extract<Poco::JSON::Object::Ptr>();
+    assert(object->getValue<int>("c") == 3);
+  }
+
+  void testDocumentBenchmark()
+  {
+    std::ostringstream oss;
+    oss << "[";
+    for(int i = 0; i < 10000; i++)
+    {
+      if ( i > 0 ) oss << ",";
+      oss << "{ \"id\" : " << i << ", \"name\" : \"item" << i << "\", \"price\" : " << i << ".5, \"active\" : true }";
+    }
+    oss << "]";
+    std::string json = oss.str();
+
+    const int iterations = 20;
+    Poco::JSON::Parser parser;
+    Poco::Stopwatch sw;
+
+    Poco::JSON::DefaultHandler defaultHandler;
+    parser.setHandler(&defaultHandler);
+    allocatedBytes = 0;
+    allocationCount = 0;
+    countAllocations = true;
+    parser.parse(json);
+    countAllocations = false;
+    std::size_t treeBytes = allocatedBytes;
+    std::size_t treeCount = allocationCount;
+
+    sw.start();
+    for(int i = 0; i < iterations; i++)
+    {
+      Poco::JSON::DefaultHandler handler;
+      parser.setHandler(&handler);
+      parser.parse(json);
+    }
+    sw.stop();
+    Poco::Timestamp::TimeDiff treeTime = sw.elapsed();
+
+    Poco::JSON::DocumentHandler documentHandler;
+    parser.setHandler(&documentHandler);
+    parser.parse(json); // Let the handler grow its buffers
+    allocatedBytes = 0;
+    allocationCount = 0;
+    countAllocations = true;
+    parser.parse(json);
+    countAllocations = false;
+    std::size_t documentCount = allocationCount;
+    std::size_t documentBytes = documentHandler.result()->memoryUsage();
+    Poco::JSON::Document::Value root = documentHandler.result()->root();
+    assert(root.size() == 10000);
+    assert(root.get(9999).get("name").getString() == "item9999");
+
+    sw.restart();
+    for(int i = 0; i < iterations; i++)
+    {
+      parser.parse(json);
+    }
+    sw.stop();
+    Poco::Timestamp::TimeDiff documentTime = sw.elapsed();
+
+    std::cout << std::endl << "10000 objects: "
+              << "Object/Array " << treeBytes << " bytes in " << treeCount << " allocations, "
+              << treeTime / iterations / 1000 << " ms per parse" << std::endl
+              << "               Document " << documentBytes << " bytes in " << documentCount << " allocations, "
+              << documentTime / iterations / 1000 << " ms per parse" << std::endl;
+  }
+
+  void testParserBenchmark()
+  {
+    std::ostringstream oss;
+    oss << "{ \"items\" : [";
+    for(int i = 0; i < 100; i++)
+    {
+      if ( i > 0 ) oss << ",";
+      oss << "\n    { \"id\" : " << i << ", \"name\" : \"item number " << i << " with a longer description\", "
+          << "\"price\" : " << i << ".25, \"tags\" : [ \"a\", \"b\\n\" ], \"active\" : true }";
+    }
+    oss << "\n] }";
+    std::string json = oss.str();
+
+    const int iterations = 1000;
+    Poco::JSON::Parser parser;
+    Poco::Stopwatch sw;
+
+    sw.start();
+    for(int i = 0; i < iterations; i++)
+    {
+      Poco::JSON::DefaultHandler handler;
+      parser.setHandler(&handler);
+      std::istringstream istr(json);
+      parser.parse(istr);
+    }
+    sw.stop();
+    Poco::Timestamp::TimeDiff streamTime = sw.elapsed();
+
+    sw.restart();
+    for(int i = 0; i < iterations; i++)
+    {
+      Poco::JSON::DefaultHandler handler;
+      parser.setHandler(&handler);
+      parser.parse(json.data(), json.size());
+    }
+    sw.stop();
+    Poco::Timestamp::TimeDiff bufferTime = sw.elapsed();
+
+    // Without a handler only the scanning itself is measured
+    parser.setHandler(NULL);
+    sw.restart();
+    for(int i = 0; i < iterations; i++)
+    {
+      std::istringstream istr(json);
+      parser.parse(istr);
+    }
+    sw.stop();
+    Poco::Timestamp::TimeDiff streamScanTime = sw.elapsed();
+
+    sw.restart();
+    for(int i = 0; i < iterations; i++)
+    {
+      parser.parse(json.data(), json.size());
+    }
+    sw.stop();
+    Poco::Timestamp::TimeDiff bufferScanTime = sw.elapsed();
+
+    std::cout << std::endl << iterations << " x " << json.size() << " bytes: "
+              << "tokenizer " << streamTime / 1000 << " ms (scan only " << streamScanTime / 1000 << " ms), "
+              << "buffer " << bufferTime / 1000 << " ms (scan only " << bufferScanTime / 1000 << " ms)" << std::endl;
+  }
+
+  static std::string describe(Poco::JSON::Reader& reader, Poco::JSON::Reader::Event event)
+  {
+    std::ostringstream out;
+    switch(event)
+    {
+    case Poco::JSON::Reader::START_OBJECT: out << "{"; break;
+    case Poco::JSON::Reader::END_OBJECT: out << "}"; break;
+    case Poco::JSON::Reader::START_ARRAY: out << "["; break;
+    case Poco::JSON::Reader::END_ARRAY: out << "]"; break;
+    case Poco::JSON::Reader::KEY: out << "K:" << reader.getString(); break;
+    case Poco::JSON::Reader::NULL_VALUE: out << "null"; break;
+    case Poco::JSON::Reader::BOOLEAN_VALUE: out << (reader.getBoolean() ? "true" : "false"); break;
+    case Poco::JSON::Reader::INTEGER_VALUE: out << "I:" << reader.getInteger(); break;
+    case Poco::JSON::Reader::DOUBLE_VALUE: out << "D:" << reader.getDouble(); break;
+    case Poco::JSON::Reader::STRING_VALUE: out << "S:" << reader.getString(); break;
+    default: out << "?"; break;
+    }
+    out << "@" << reader.currentDepth() << " ";
+    return out.str();
+  }
+
+  static std::string readAll(const std::string& json, std::size_t bufferSize, std::size_t chunkSize)
+    /// Feeds the json in chunks and describes all events
+  {
+    Poco::JSON::Reader reader(bufferSize);
+    std::string events;
+    std::size_t pos = 0;
+    while(true)
+    {
+      Poco::JSON::Reader::Event event = reader.next();
+      if ( event == Poco::JSON::Reader::END_OF_INPUT )
+        break;
+      if ( event == Poco::JSON::Reader::NEED_MORE_INPUT )
+      {
+        if ( pos == json.size() )
+        {
+          reader.finish();
+        }
+        else
+        {
+          pos += reader.feed(json.data() + pos, std::min(chunkSize, json.size() - pos));
+        }
+        continue;
+      }
+      events += describe(reader, event);
+    }
+    return events;
+  }
+
+  void testReader()
+  {
+    std::string json = "{ \"name\" : \"Fr\\u00e4nky \\\"the \\\\ \\ud834\\udd1e\", \"age\" : -42, \"big\" : 9223372036854775807,"
+                       " \"bigger\" : 9223372036854775808, \"pi\" : 3.25e1, \"ok\" : true, \"no\" : false,"
+                       " \"nothing\" : null, \"list\" : [ 1, [], {}, [ \"a\" ] ] }";
+    std::string expected = "{@1 K:name@1 S:Fr\xc3\xa4nky \"the \\ \xf0\x9d\x84\x9e@1 K:age@1 I:-42@1 K:big@1 I:9223372036854775807@1 "
+                           "K:bigger@1 D:9.22337e+18@1 K:pi@1 D:32.5@1 K:ok@1 true@1 K:no@1 false@1 K:nothing@1 null@1 "
+                           "K:list@1 [@2 I:1@2 [@3 ]@2 {@3 }@2 [@3 S:a@3 ]@2 ]@1 }@0 ";
+
+    // All at once, and one byte at a time through a buffer of a few bytes
+    assert(readAll(json, 65536, json.size()) == expected);
+    assert(readAll(json, 4, 1) == expected);
+    assert(readAll(json, 3, 7) == expected);
+    assert(readAll(" 12 ", 1, 1) == "I:12@0 ");
+    assert(readAll("\"\\\\\"", 1, 1) == "S:\\@0 ");
+
+    // From a stream
+    {
+      std::istringstream in(json);
+      Poco::JSON::Reader reader(in, 5);
+      std::string events;
+      Poco::JSON::Reader::Event event;
+      while ( (event = reader.next()) != Poco::JSON::Reader::END_OF_INPUT )
+      {
+        assert(event != Poco::JSON::Reader::NEED_MORE_INPUT);
+        events += describe(reader, event);
+      }
+      assert(events == expected);
+    }
+
+    // Skipping
+    {
+      std::istringstream in("{ \"skip\" : { \"a\" : [ 1, \"x\\\"]\" ] }, \"keep\" : 1, \"list\" : [ [ 2 ], 3 ], \"s\" : \"v\" }");
+      Poco::JSON::Reader reader(in, 2);
+      assert(reader.next() == Poco::JSON::Reader::START_OBJECT);
+      assert(reader.next() == Poco::JSON::Reader::KEY);
+      assert(reader.skipValue());
+      assert(reader.currentDepth() == 1);
+      assert(reader.next() == Poco::JSON::Reader::KEY);
+      assert(reader.getString() == "keep");
+      assert(reader.next() == Poco::JSON::Reader::INTEGER_VALUE);
+      assert(reader.skipValue()); // Nothing to skip
+      assert(reader.next() == Poco::JSON::Reader::KEY);
+      assert(reader.next() == Poco::JSON::Reader::START_ARRAY);
+      assert(reader.next() == Poco::JSON::Reader::START_ARRAY);
+      assert(reader.skipValue());
+      assert(reader.currentDepth() == 2);
+      assert(reader.next() == Poco::JSON::Reader::INTEGER_VALUE);
+      assert(reader.getInteger() == 3);
+      assert(reader.next() == Poco::JSON::Reader::END_ARRAY);
+      assert(reader.next() == Poco::JSON::Reader::KEY);
+      assert(reader.skipValue());
+      assert(reader.next() == Poco::JSON::Reader::END_OBJECT);
+      assert(reader.next() == Poco::JSON::Reader::END_OF_INPUT);
+    }
+
+    // Skipping while feeding
+    {
+      std::string skip = "[ { \"a\" : [ \"long string to skip\", { \"b\" : null } ] }, 7 ]";
+      Poco::JSON::Reader reader(8);
+      std::size_t pos = reader.feed(skip.data(), 3);
+      assert(reader.next() == Poco::JSON::Reader::START_ARRAY);
+      assert(reader.next() == Poco::JSON::Reader::START_OBJECT);
+      int calls = 1;
+      while ( !reader.skipValue() )
+      {
+        pos += reader.feed(skip.data() + pos, std::min<std::size_t>(3, skip.size() - pos));
+        ++calls;
+      }
+      assert(calls > 1);
+      assert(reader.currentDepth() == 1);
+      Poco::JSON::Reader::Event event;
+      while ( (event = reader.next()) == Poco::JSON::Reader::NEED_MORE_INPUT )
+      {
+        pos += reader.feed(skip.data() + pos, std::min<std::size_t>(3, skip.size() - pos));
+      }
+      assert(event == Poco::JSON::Reader::INTEGER_VALUE);
+      assert(reader.getInteger() == 7);
+    }
+
+    // NDJSON
+    {
+      std::istringstream in("{\"id\":1,\"tags\":[\"a\",\"b\"]}\n[1,2]\n\"text\"\n42\n\n{\"id\":2}\n");
+      Poco::JSON::Reader reader(in, 16);
+      reader.setNDJSON(true);
+      Poco::DynamicAny value;
+      assert(reader.nextValue(value));
+      Poco::JSON::Object::Ptr object = value.extract<Poco::JSON::Object::Ptr>();
+      assert(object->getValue<int>("id") == 1);
+      assert(object->getArray("tags")->size() == 2);
+      assert(reader.nextValue(value));
+      assert(value.extract<Poco::JSON::Array::Ptr>()->size() == 2);
+      assert(reader.nextValue(value));
+      assert(value.convert<std::string>() == "text");
+      assert(reader.nextValue(value));
+      assert(value.convert<int>() == 42);
+      assert(reader.nextValue(value));
+      assert(value.extract<Poco::JSON::Object::Ptr>()->getValue<int>("id") == 2);
+      assert(!reader.nextValue(value));
+      assert(reader.event() == Poco::JSON::Reader::END_OF_INPUT);
+    }
+
+    // The elements of an array, one at a time
+    {
+      std::istringstream in("[ {\"id\":1}, [ 2 ], 3 ]");
+      Poco::JSON::Reader reader(in, 4);
+      assert(reader.next() == Poco::JSON::Reader::START_ARRAY);
+      std::vector<Poco::DynamicAny> values;
+      Poco::DynamicAny value;
+      while ( reader.nextValue(value) )
+      {
+        values.push_back(value);
+      }
+      assert(values.size() == 3);
+      assert(values[0].extract<Poco::JSON::Object::Ptr>()->getValue<int>("id") == 1);
+      assert(values[2].convert<int>() == 3);
+      assert(reader.event() == Poco::JSON::Reader::END_ARRAY);
+      assert(reader.currentDepth() == 0);
+    }
+
+    // Errors
+    const char* invalid[] = { "{ \"a\" : 1 } x", "[ 1, ]", "{ \"a\" 1 }", "[ 1 }", "\"open", "[ tru ]", "[ 01 ]", "{ \"a\" : 1, }", "[", "" };
+    for(std::size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+    {
+      try
+      {
+        readAll(invalid[i], 16, 16);
+        fail(std::string("Invalid JSON accepted: ") + invalid[i]);
+      }
+      catch(Poco::JSON::JSONException&)
+      {
+      }
+    }
+  }
+
+  void testReaderBenchmark()
+  {
+    std::ostringstream os;
+    os << "[";
+    for(int i = 0; i < 100000; i++)
+    {
+      if ( i > 0 ) os << ",\n";
+      os << "{ \"id\" : " << i << ", \"name\" : \"item number " << i << "\", \"price\" : " << i << ".25, \"tags\" : [ \"a\", \"b\" ] }";
+    }
+    os << "]";
+    std::string json = os.str();
+
+    Poco::Stopwatch sw;
+    Poco::JSON::Parser parser;
+
+    allocatedBytes = allocationCount = 0;
+    countAllocations = true;
+    sw.start();
+    {
+      Poco::JSON::DefaultHandler handler;
+      parser.setHandler(&handler);
+      parser.parse(json);
+      assert(handler.result().extract<Poco::JSON::Array::Ptr>()->size() == 100000);
+    }
+    sw.stop();
+    countAllocations = false;
+    std::size_t domBytes = allocatedBytes;
+    std::size_t domCount = allocationCount;
+    Poco::Timestamp::TimeDiff domTime = sw.elapsed();
+
+    std::istringstream in(json);
+    allocatedBytes = allocationCount = 0;
+    countAllocations = true;
+    sw.restart();
+    int ids = 0;
+    {
+      Poco::JSON::Reader reader(in, 16384);
+      Poco::JSON::Reader::Event event;
+      while ( (event = reader.next()) != Poco::JSON::Reader::END_OF_INPUT )
+      {
+        if ( event == Poco::JSON::Reader::KEY && reader.getString() == "id" )
+        {
+          ++ids;
+        }
+        else if ( event == Poco::JSON::Reader::KEY && reader.getString() == "tags" )
+        {
+          reader.next();
+          reader.skipValue();
+        }
+      }
+    }
+    sw.stop();
+    countAllocations = false;
+    assert(ids == 100000);
+    Poco::Timestamp::TimeDiff readerTime = sw.elapsed();
+
+    std::cout << std::endl << json.size() << " bytes: "
+              << "Parser/DefaultHandler " << domTime / 1000 << " ms (" << domBytes << " bytes in " << domCount << " allocations), "
+              << "Reader " << readerTime / 1000 << " ms (" << allocatedBytes << " bytes in " << allocationCount << " allocations)" << std::endl;
+  }
+
+  static std::string makeRecords(int count, bool array)
+  {
+    std::ostringstream os;
+    if ( array ) os << "[ ";
+    for(int i = 0; i < count; i++)
+    {
+      if ( i > 0 ) os << (array ? ",\n  " : "\n");
+      if ( i % 10 == 9 )
+      {
+        os << i; // A scalar record
+      }
+      else
+      {
+        os << "{ \"id\" : " << i << ", \"text\" : \"a, \\\"quoted\\\" ], } [ { \\\\\", \"list\" : [ { \"x\" : [ 1, 2 ] }, \"]\" ] }";
+      }
+    }
+    if ( array ) os << " ]";
+    os << "\n";
+    return os.str();
+  }
+
+  void testParallelParser()
+  {
+    const char* record = "{ \"a\" : \"x,]\\\"}\", \"b\" : [ 1, { \"c\" : \"\\\\\" } ] }, 2 ]";
+    const char* recordEnd = Poco::JSON::ParallelParser::findRecordEnd(record, record + std::strlen(record));
+    assert(std::string(record, recordEnd) == "{ \"a\" : \"x,]\\\"}\", \"b\" : [ 1, { \"c\" : \"\\\\\" } ] }");
+    const char* last = Poco::JSON::ParallelParser::findRecordEnd(recordEnd + 1, record + std::strlen(record));
+    assert(*last == ']');
+
+    Poco::ThreadPool pool(2, 4);
+    for(int array = 0; array < 2; array++)
+    {
+      std::string json = makeRecords(1000, array == 1);
+
+      Poco::JSON::ParallelParser parser(pool);
+      parser.setChunkSize(256);
+
+      RecordCollector ordered;
+      assert(parser.parse(json, ordered) == 1000);
+      assert(ordered.ids.size() == 1000);
+      for(int i = 0; i < 1000; i++)
+      {
+        assert(ordered.ids[i] == i);
+      }
+
+      parser.setOrdered(false);
+      RecordCollector unordered;
+      assert(parser.parse(json, unordered) == 1000);
+      std::sort(unordered.ids.begin(), unordered.ids.end());
+      assert(unordered.ids == ordered.ids);
+
+      // From a file
+      Poco::Path path(Poco::Path::temp(), "JSONParallelParser.json");
+      {
+        Poco::FileOutputStream fos(path.toString());
+        fos << json;
+      }
+      parser.setOrdered(true);
+      parser.setChunkSize(Poco::JSON::ParallelParser::DEFAULT_CHUNK_SIZE);
+      RecordCollector mapped;
+      assert(parser.parseFile(path.toString(), mapped) == 1000);
+      assert(mapped.ids == ordered.ids);
+      Poco::File(path).remove();
+    }
+
+    Poco::JSON::ParallelParser parser(pool);
+    RecordCollector empty;
+    assert(parser.parse("", empty) == 0);
+    assert(parser.parse(" [ ] ", empty) == 0);
+    assert(parser.parse("\n\n", empty) == 0);
+
+    parser.setChunkSize(1);
+    const char* invalid[] = { "[ 1, , 2 ]", "[ 1, 2", "[ 1 ] 2", "{\"id\":1}\n{\"id\":\n", "[ {\"id\" : 1}, {\"id\" 2} ]", "1 2" };
+    for(std::size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+    {
+      try
+      {
+        RecordCollector collector;
+        parser.parse(invalid[i], collector);
+        fail(std::string("Invalid JSON accepted: ") + invalid[i]);
+      }
+      catch(Poco::JSON::JSONException&)
+      {
+      }
+    }
+    pool.joinAll();
+  }
+
+  void testParallelParserBenchmark()
+  {
+    std::string ndjson = makeRecords(200000, false);
+    std::string array = makeRecords(200000, true);
+
+    std::cout << std::endl << ndjson.size() << " bytes:";
+    int threads[] = { 1, 2, 4, 8 };
+    for(int i = 0; i < 4; i++)
+    {
+      Poco::ThreadPool pool(threads[i], threads[i]);
+      Poco::JSON::ParallelParser parser(pool);
+
+      Poco::Stopwatch sw;
+      sw.start();
+      RecordCollector ndjsonRecords;
+      parser.parse(ndjson, ndjsonRecords);
+      sw.stop();
+      Poco::Timestamp::TimeDiff ndjsonTime = sw.elapsed();
+
+      sw.restart();
+      RecordCollector arrayRecords;
+      parser.parse(array, arrayRecords);
+      sw.stop();
+      Poco::Timestamp::TimeDiff arrayTime = sw.elapsed();
+
+      assert(ndjsonRecords.ids.size() == 200000 && arrayRecords.ids.size() == 200000);
+      std::cout << std::endl << "  " << threads[i] << " threads: NDJSON " << ndjsonTime / 1000 << " ms, array " << arrayTime / 1000 << " ms";
+      pool.joinAll();
+    }
+    std::cout << std::endl;
+  }
+
   void testValidJanssonFiles()
   {
     Poco::Path pathPattern("/home/bronx/Development/mqweb/JSON/testsuite/testfiles/valid/*");
@@ -750,6 +1723,249 @@ protected:
     tpl.render(data, std::cout);
   }
 
+  std::string renderTemplate(Poco::JSON::Template& tpl, const Poco::DynamicAny& data)
+  {
+    std::ostringstream out;
+    tpl.render(data, out);
+    return out.str();
+  }
+
+  void testTemplateCompile()
+  {
+    std::string source = "<?for p persons?>"
+                         "<?= p.name ?>:"
+                         "<?if p.age?>age <?= p.age?><?elsif p.nickname?>nick <?= p.nickname?><?else?>none<?endif?>"
+                         "<?ifexist p.pets?> pets<?for pet p.pets?> <?= pet?><?endfor?><?endif?>;"
+                         "<?endfor?>"
+                         "<?for x missing?>never<?endfor?>"
+                         "<?for e empty?>never<?endfor?>"
+                         "<?if title?><?= title?><?else?>untitled<?endif?>";
+
+    Poco::JSON::Parser parser;
+    Poco::JSON::DefaultHandler handler;
+    parser.setHandler(&handler);
+    parser.parse("{ \"persons\" : [ "
+                 "{ \"name\" : \"Franky\", \"age\" : 42, \"pets\" : [ \"cat\", \"dog\" ] },"
+                 "{ \"name\" : \"Fred\", \"age\" : 0, \"nickname\" : \"Freddy\" },"
+                 "{ \"name\" : \"Zoe\", \"nickname\" : \"\", \"pets\" : [] } ],"
+                 " \"empty\" : [], \"title\" : \"\" }");
+    Poco::DynamicAny data = handler.result();
+
+    Poco::JSON::Template tpl;
+    tpl.parse(source);
+    assert(!tpl.isCompiled());
+    std::string interpreted = renderTemplate(tpl, data);
+
+    tpl.compile();
+    assert(tpl.isCompiled());
+    std::string compiled = renderTemplate(tpl, data);
+
+    assert(interpreted == "Franky:age 42 pets cat dog;Fred:nick Freddy;Zoe:none pets;untitled");
+    assert(compiled == interpreted);
+
+    // The loop variables are removed after rendering
+    Poco::JSON::Object::Ptr object = data.extract<Poco::JSON::Object::Ptr>();
+    assert(!object->has("p"));
+    assert(!object->has("pet"));
+
+    // Parsing again discards the compiled template
+    tpl.parse("Hello <?= persons[0].name ?>");
+    assert(!tpl.isCompiled());
+    tpl.compile();
+    assert(renderTemplate(tpl, data) == "Hello Franky");
+
+    // Output larger than a chunk
+    Poco::JSON::Array::Ptr lines = new Poco::JSON::Array();
+    for(int i = 0; i < 5000; i++)
+    {
+      lines->add(i);
+    }
+    Poco::JSON::Object::Ptr large = new Poco::JSON::Object();
+    large->set("lines", lines);
+    tpl.parse("<?for l lines?>line <?= l ?>\n<?endfor?>");
+    std::string largeInterpreted = renderTemplate(tpl, large);
+    tpl.compile();
+    std::string largeCompiled = renderTemplate(tpl, large);
+    assert(largeCompiled.size() > Poco::JSON::Template::RENDER_CHUNK_SIZE);
+    assert(largeCompiled == largeInterpreted);
+  }
+
+  void testTemplateBenchmark()
+  {
+    Poco::JSON::Array::Ptr items = new Poco::JSON::Array();
+    for(int i = 0; i < 200; i++)
+    {
+      Poco::JSON::Object::Ptr item = new Poco::JSON::Object();
+      item->set("id", i);
+      item->set("name", std::string("item"));
+      item->set("active", i % 2 == 0);
+      items->add(item);
+    }
+    Poco::JSON::Object::Ptr data = new Poco::JSON::Object();
+    data->set("items", items);
+    data->set("title", std::string("Items"));
+
+    Poco::JSON::Template tpl;
+    tpl.parse("<html><head><title><?= title ?></title></head><body><ul>\n"
+              "<?for item items?>"
+              "<li id=\"<?= item.id ?>\"><?= item.name ?> <?if item.active?>active<?else?>inactive<?endif?></li>\n"
+              "<?endfor?>"
+              "</ul></body></html>\n");
+
+    const int iterations = 200;
+    Poco::Stopwatch sw;
+
+    sw.start();
+    for(int i = 0; i < iterations; i++)
+    {
+      std::ostringstream out;
+      tpl.render(data, out);
+    }
+    sw.stop();
+    Poco::Timestamp::TimeDiff interpretedTime = sw.elapsed();
+
+    tpl.compile();
+    sw.restart();
+    std::size_t size = 0;
+    for(int i = 0; i < iterations; i++)
+    {
+      std::ostringstream out;
+      tpl.render(data, out);
+      size = out.str().size();
+    }
+    sw.stop();
+    Poco::Timestamp::TimeDiff compiledTime = sw.elapsed();
+
+    std::cout << std::endl << iterations << " x " << size << " bytes: "
+              << "interpreted " << interpretedTime / 1000 << " ms, "
+              << "compiled " << compiledTime / 1000 << " ms" << std::endl;
+  }
+
+  static void writeFile(const Poco::Path& path, const std::string& content)
+  {
+    Poco::FileOutputStream fos(path.toString());
+    fos << content;
+  }
+
+  static std::string renderCached(const std::string& name)
+  {
+    Poco::JSON::Object::Ptr data = new Poco::JSON::Object();
+    data->set("name", std::string("cache"));
+    std::ostringstream out;
+    Poco::JSON::TemplateCache::instance()->getTemplate(name)->render(data, out);
+    return out.str();
+  }
+
+  static bool waitForContent(const std::string& name, const std::string& content)
+  {
+    for(int i = 0; i < 200; i++)
+    {
+      if ( renderCached(name) == content )
+        return true;
+      Poco::Thread::sleep(20);
+    }
+    return false;
+  }
+
+  void checkTemplateCache(bool notify)
+  {
+    Poco::Path dir(Poco::Path::temp());
+    dir.pushDirectory(notify ? "JSONTemplateCacheNotify" : "JSONTemplateCachePoll");
+    Poco::File(dir).createDirectories();
+
+    Poco::Path a(dir, "a.tpl");
+    Poco::Path b(dir, "b.tpl");
+    Poco::Path c(dir, "c.tpl");
+    writeFile(a, "A <?= name ?>");
+    writeFile(b, "B <?= name ?>");
+    writeFile(c, "C <?= name ?>");
+
+    {
+      Poco::JSON::TemplateCache cache(2, 20, notify);
+      cache.addPath(dir);
+      assert(cache.isNotifying() == (notify && POCO_OS == POCO_OS_LINUX));
+
+      assert(renderCached("a.tpl") == "A cache");
+      assert(cache.misses() == 1);
+      assert(cache.hits() == 0);
+      Poco::JSON::Template::Ptr tpl = cache.getTemplate("a.tpl");
+      assert(cache.hits() == 1);
+      assert(tpl.get() == cache.getTemplate("a.tpl").get());
+
+      // A changed file is reloaded; the size differs so polling
+      // notices it within the same second.
+      writeFile(a, "AA <?= name ?>");
+      assert(waitForContent("a.tpl", "AA cache"));
+      assert(cache.reloads() == 1);
+      assert(tpl.get() != cache.getTemplate("a.tpl").get());
+
+      // b is the least recently used when c is loaded
+      assert(renderCached("b.tpl") == "B cache");
+      cache.getTemplate("a.tpl");
+      assert(renderCached("c.tpl") == "C cache");
+      assert(cache.size() == 2);
+      int misses = cache.misses();
+      cache.getTemplate("a.tpl");
+      assert(cache.misses() == misses);
+      cache.getTemplate("b.tpl");
+      assert(cache.misses() == misses + 1);
+
+      // An invalid change keeps the previous template
+      writeFile(b, "B <?for?>");
+      for(int i = 0; i < 200 && cache.reloads() < 2; i++)
+      {
+        cache.getTemplate("b.tpl");
+        Poco::Thread::sleep(20);
+      }
+      assert(cache.reloads() == 2);
+      assert(renderCached("b.tpl") == "B cache");
+
+      // A removed file is not found anymore
+      Poco::File(b).remove();
+      bool removed = false;
+      for(int i = 0; i < 200 && !removed; i++)
+      {
+        try
+        {
+          cache.getTemplate("b.tpl");
+          Poco::Thread::sleep(20);
+        }
+        catch(Poco::FileNotFoundException&)
+        {
+          removed = true;
+        }
+      }
+      assert(removed);
+
+      writeFile(b, "B <?= name ?>");
+      cache.setCapacity(0);
+      TemplateCacheReader readers[4];
+      Poco::Thread threads[4];
+      for(int i = 0; i < 4; i++)
+      {
+        threads[i].start(readers[i]);
+      }
+      for(int i = 0; i < 4; i++)
+      {
+        threads[i].join();
+        assert(readers[i].errors == 0);
+      }
+      assert(cache.size() == 2);
+
+      cache.clear();
+      assert(cache.size() == 0);
+    }
+    assert(Poco::JSON::TemplateCache::instance() == NULL);
+
+    Poco::File(dir).remove(true);
+  }
+
+  void testTemplateCache()
+  {
+    checkTemplateCache(true);
+    checkTemplateCache(false);
+  }
+
   void testItunes()
   {
     Poco::FileInputStream fis("/home/bronx/Development/search.json");
@@ -792,11 +2008,26 @@ public:
     CppUnit_addTest(pSuite, JSONTest, testDoubleElement);
     CppUnit_addTest(pSuite, JSONTest, testOptValue);
     CppUnit_addTest(pSuite, JSONTest, testQuery);
+    CppUnit_addTest(pSuite, JSONTest, testCompiledQuery);
+    CppUnit_addTest(pSuite, JSONTest, testBufferParser);
+    CppUnit_addTest(pSuite, JSONTest, testParserBenchmark);
+    CppUnit_addTest(pSuite, JSONTest, testDocument);
+    CppUnit_addTest(pSuite, JSONTest, testHandlerReuseAfterError);
+    CppUnit_addTest(pSuite, JSONTest, testDocumentBenchmark);
+    CppUnit_addTest(pSuite, JSONTest, testWriter);
+    CppUnit_addTest(pSuite, JSONTest, testWriterBenchmark);
+    CppUnit_addTest(pSuite, JSONTest, testReader);
+    CppUnit_addTest(pSuite, JSONTest, testReaderBenchmark);
+    CppUnit_addTest(pSuite, JSONTest, testParallelParser);
+    CppUnit_addTest(pSuite, JSONTest, testParallelParserBenchmark);
     //CppUnit_addTest(pSuite, JSONTest, testValidJanssonFiles);
     //CppUnit_addTest(pSuite, JSONTest, testInvalidJanssonFiles);
 
     //CppUnit_addTest(pSuite, JSONTest, testConfiguration);
     CppUnit_addTest(pSuite, JSONTest, testTemplate);
+    CppUnit_addTest(pSuite, JSONTest, testTemplateCompile);
+    CppUnit_addTest(pSuite, JSONTest, testTemplateBenchmark);
+    CppUnit_addTest(pSuite, JSONTest, testTemplateCache);
 
     //CppUnit_addTest(pSuite, JSONTest, testItunes);
 
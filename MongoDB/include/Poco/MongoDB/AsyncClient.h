@@ -0,0 +1,141 @@
+//
+// AsyncClient.h
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  AsyncClient
+//
+// Definition of the AsyncClient class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _MongoDB_AsyncClient_included
+#define _MongoDB_AsyncClient_included
+
+#include "Poco/MongoDB/MongoDB.h"
+#include "Poco/MongoDB/AsyncConnection.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Mutex.h"
+
+#include <vector>
+
+namespace Poco
+{
+namespace MongoDB
+{
+
+
+class MongoDB_API AsyncClient
+	/// Runs event loop threads that multiplex non-blocking
+	/// AsyncConnections to MongoDB servers, so thousands of requests
+	/// can be in flight with a handful of threads.
+	///
+	/// Every connection is assigned to one event loop, round robin.
+	/// An event loop waits for its sockets with epoll on Linux and with
+	/// poll() on other platforms that define POCO_HAVE_FD_POLL. It reads
+	/// replies as bytes arrive, completes the AsyncResponses and calls
+	/// the ResponseHandlers of their requests, and writes output the
+	/// sockets couldn't take immediately.
+	///
+	/// Usage:
+	///     AsyncClient client(2);
+	///     AsyncConnection::Ptr pConnection = client.connect("localhost:27017");
+	///     QueryRequest request("db.collection");
+	///     AsyncConnection::AsyncResponse result = pConnection->sendRequestAsync(request);
+	///     ...
+	///     result.wait();
+	///     ResponseMessage& response = result.data();
+{
+public:
+	AsyncClient(int threads = 1);
+		/// Creates the AsyncClient and starts the given number of
+		/// event loop threads.
+
+
+	~AsyncClient();
+		/// Closes all connections, which fails their outstanding
+		/// requests, and stops the event loops. Connections must
+		/// not be used after the AsyncClient is destroyed.
+
+
+	AsyncConnection::Ptr connect(const Net::SocketAddress& address);
+		/// Starts connecting to the MongoDB server at address and returns
+		/// the connection. Requests can be sent right away; they are
+		/// written once the connection is established. If it can't be
+		/// established, they fail with a ConnectionRefusedException,
+		/// or throw it when the failure is already known.
+
+
+	AsyncConnection::Ptr connect(const std::string& hostAndPort);
+		/// Starts connecting to the given MongoDB host/port. The host
+		/// and port must be separated with a colon.
+
+
+	int threads() const;
+		/// Returns the number of event loop threads.
+
+
+	std::size_t connections() const;
+		/// Returns the number of open connections.
+
+
+private:
+	class Loop;
+
+
+	void update(int loop, AsyncConnection* pConnection);
+		/// Tells the event loop that the connection must be written,
+		/// or has been closed.
+
+
+	std::vector<Loop*> _loops;
+
+
+	int _next;
+
+
+	Poco::FastMutex _mutex;
+
+
+	AsyncClient(const AsyncClient&);
+	AsyncClient& operator = (const AsyncClient&);
+
+	friend class AsyncConnection;
+};
+
+
+inline int AsyncClient::threads() const
+{
+	return static_cast<int>(_loops.size());
+}
+
+
+}} // Poco::MongoDB
+
+#endif //_MongoDB_AsyncClient_included
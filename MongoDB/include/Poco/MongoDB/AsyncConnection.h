@@ -0,0 +1,286 @@
+//
+// AsyncConnection.h
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  AsyncConnection
+//
+// Definition of the AsyncConnection class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _MongoDB_AsyncConnection_included
+#define _MongoDB_AsyncConnection_included
+
+#include "Poco/MongoDB/MongoDB.h"
+#include "Poco/MongoDB/Connection.h"
+#include "Poco/MongoDB/BSONOutputStream.h"
+#include "Poco/MongoDB/RequestMessage.h"
+#include "Poco/MongoDB/ResponseMessage.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Mutex.h"
+
+#include <map>
+#include <vector>
+
+namespace Poco
+{
+namespace MongoDB
+{
+
+
+class AsyncClient;
+
+
+class MongoDB_API AsyncConnection
+	/// A non-blocking connection to a MongoDB server, driven by the
+	/// event loop of an AsyncClient. AsyncConnections are created with
+	/// AsyncClient::connect().
+	///
+	/// Requests can be sent from any thread without blocking. A request
+	/// is written directly to the socket when possible; what the socket
+	/// doesn't accept is written by the event loop when the socket becomes
+	/// writable. Replies are read by the event loop as bytes arrive and
+	/// are handed to their requests by responseTo id, either by completing
+	/// an AsyncResponse or by calling a ResponseHandler.
+	///
+	/// The connection stays open until close() is called, the server
+	/// closes it, or the AsyncClient is destroyed. When it fails, all
+	/// outstanding requests fail with the exception.
+{
+public:
+	typedef Poco::SharedPtr<AsyncConnection> Ptr;
+
+
+	typedef Connection::AsyncResponse AsyncResponse;
+		/// The result of sendRequestAsync(). The ResponseMessage is
+		/// available with data() once wait() returns.
+
+
+	class MongoDB_API ResponseHandler
+		/// Receives the reply to a request sent with sendRequest(request, handler).
+		/// Both methods are called on the event loop thread, so they
+		/// must not block.
+	{
+	public:
+		virtual ~ResponseHandler();
+
+
+		virtual void onResponse(ResponseMessage& response) = 0;
+			/// Called with the reply. The response is reused for the next
+			/// reply on this connection, so it and its views are only valid
+			/// during the call.
+
+
+		virtual void onError(const Exception& exc) = 0;
+			/// Called when the connection failed before the reply was received.
+	};
+
+
+	virtual ~AsyncConnection();
+		/// Destroys the AsyncConnection.
+
+
+	const Net::SocketAddress& address() const;
+		/// Returns the address of the MongoDB server.
+
+
+	AsyncResponse sendRequestAsync(RequestMessage& request, bool readViews = false);
+		/// Sends a query or getmore request and returns the result that
+		/// is completed with the reply. When readViews is true, the reply
+		/// is read with ResponseMessage::readViews() enabled.
+
+
+	void sendRequest(RequestMessage& request, ResponseHandler& handler, bool readViews = false);
+		/// Sends a query or getmore request. handler is called with the
+		/// reply, or with the error when the connection fails, and must
+		/// stay valid until then.
+
+
+	void sendRequest(RequestMessage& request);
+		/// Sends a request that has no reply, like an insert.
+
+
+	std::size_t pendingRequests() const;
+		/// Returns the number of requests waiting for a reply.
+
+
+	bool isConnected() const;
+		/// Returns false once the connection has failed or has been closed.
+		/// A connection that is still being established counts as connected.
+
+
+	void close();
+		/// Closes the connection. Outstanding requests fail with an IOException.
+
+
+private:
+
+	typedef ActiveResultHolder<ResponseMessage> ResultHolder;
+
+
+	struct Pending
+	{
+		AutoPtr<ResultHolder> pResult;
+			/// Null for a request with a ResponseHandler.
+		ResponseHandler*      pHandler;
+		bool                  readViews;
+	};
+
+	typedef std::map<Int32, Pending> PendingMap;
+
+
+	AsyncConnection(AsyncClient& client, int loop, const Net::SocketAddress& address);
+		/// Starts a non-blocking connect to address.
+
+
+	void queue(RequestMessage& request, Pending* pPending);
+		/// Appends the request to the output and registers its reply.
+
+
+	bool flushOutput();
+		/// Writes as much of the output as the socket accepts. Returns
+		/// true when everything has been written. Must be called with
+		/// _mutex locked.
+
+
+	void onWritable();
+		/// Called by the event loop when the socket is writable.
+
+
+	void onReadable();
+		/// Called by the event loop when the socket is readable.
+
+
+	void dispatch(const char* message, std::size_t length);
+		/// Reads one reply and hands it to its request.
+
+
+	void fail(const Exception& exc);
+		/// Closes the socket and fails all outstanding requests.
+
+
+	bool wantsWrite() const;
+		/// Returns true if the event loop must wait for the socket to
+		/// become writable.
+
+
+	bool isClosed() const;
+
+
+	poco_socket_t sockfd() const;
+
+
+	AsyncClient& _client;
+
+
+	int _loop;
+
+
+	Net::SocketAddress _address;
+
+
+	Net::StreamSocket _socket;
+
+
+	poco_socket_t _sockfd;
+
+
+	mutable Poco::FastMutex _mutex;
+
+
+	Int32 _lastRequestID;
+
+
+	bool _connecting;
+
+
+	bool _writeScheduled;
+		/// True while the event loop writes the output.
+
+
+	Exception* _pError;
+
+
+	PendingMap _pending;
+
+
+	BSONOutputStream _buffers[2];
+		/// Requests are appended to one buffer while the other one is written.
+
+
+	BSONOutputStream* _pQueued;
+
+
+	BSONOutputStream* _pWriting;
+
+
+	std::size_t _written;
+		/// Number of bytes of *_pWriting already sent.
+
+
+	std::vector<char> _input;
+		/// Received bytes, only used by the event loop thread.
+
+
+	std::size_t _inputStart;
+
+
+	std::size_t _inputEnd;
+
+
+	ResponseMessage _response;
+		/// Reused for replies to requests with a ResponseHandler.
+
+
+	AsyncConnection(const AsyncConnection&);
+	AsyncConnection& operator = (const AsyncConnection&);
+
+	friend class AsyncClient;
+};
+
+
+inline const Net::SocketAddress& AsyncConnection::address() const
+{
+	return _address;
+}
+
+
+inline poco_socket_t AsyncConnection::sockfd() const
+{
+	return _sockfd;
+}
+
+
+}} // Poco::MongoDB
+
+#endif //_MongoDB_AsyncConnection_included
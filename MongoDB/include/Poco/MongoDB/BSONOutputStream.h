@@ -0,0 +1,183 @@
+//
+// BSONOutputStream.h
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  BSONOutputStream
+//
+// Definition of the BSONOutputStream class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _MongoDB_BSONOutputStream_included
+#define _MongoDB_BSONOutputStream_included
+
+#include "Poco/MongoDB/MongoDB.h"
+#include "Poco/StreamUtil.h"
+
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+namespace Poco {
+namespace MongoDB {
+
+
+class MongoDB_API BSONStreamBuf : public std::streambuf
+	/// A stream buffer that writes into a single growable, contiguous
+	/// block of memory. Already written bytes can be overwritten in place,
+	/// which is used to back-patch BSON length prefixes once the size of
+	/// a document or message is known.
+{
+public:
+	BSONStreamBuf(std::size_t initialCapacity);
+		/// Creates the BSONStreamBuf.
+
+	~BSONStreamBuf();
+		/// Destroys the BSONStreamBuf.
+
+	const char* data() const;
+		/// Returns a pointer to the written bytes.
+
+	std::size_t size() const;
+		/// Returns the number of written bytes.
+
+	void reset();
+		/// Discards the written bytes but keeps the memory.
+
+	void patch(std::size_t offset, const char* bytes, std::size_t length);
+		/// Overwrites already written bytes at the given offset.
+
+protected:
+	int_type overflow(int_type c);
+	std::streamsize xsputn(const char* s, std::streamsize n);
+
+private:
+	void grow(std::size_t minCapacity);
+
+	std::vector<char> _buffer;
+
+	BSONStreamBuf(const BSONStreamBuf&);
+	BSONStreamBuf& operator = (const BSONStreamBuf&);
+};
+
+
+class MongoDB_API BSONIOS : public virtual std::ios
+	/// The base class for BSONOutputStream.
+	///
+	/// This class is needed to ensure the correct initialization
+	/// order of the stream buffer and base classes.
+{
+public:
+	BSONIOS(std::size_t initialCapacity);
+		/// Creates the basic stream.
+
+	~BSONIOS();
+		/// Destroys the stream.
+
+	BSONStreamBuf* rdbuf();
+		/// Returns a pointer to the underlying streambuf.
+
+protected:
+	BSONStreamBuf _buf;
+};
+
+
+class MongoDB_API BSONOutputStream : public BSONIOS, public std::ostream
+	/// An output stream collecting a BSON document or a complete wire
+	/// protocol message in one contiguous buffer.
+	///
+	/// Document::write() recognizes a BinaryWriter on a BSONOutputStream
+	/// and writes its length prefix as a placeholder that is patched once
+	/// the document is complete, so nested documents are never copied.
+{
+public:
+	enum
+	{
+		DEFAULT_CAPACITY = 4096
+	};
+
+	BSONOutputStream(std::size_t initialCapacity = DEFAULT_CAPACITY);
+		/// Creates the BSONOutputStream.
+
+	~BSONOutputStream();
+		/// Destroys the BSONOutputStream.
+
+	const char* data() const;
+		/// Returns a pointer to the written bytes.
+
+	std::size_t size() const;
+		/// Returns the number of written bytes.
+
+	void reset();
+		/// Discards the written bytes but keeps the memory,
+		/// so the stream can be reused for the next message.
+
+	void patch(std::size_t offset, Int32 value);
+		/// Overwrites the 32-bit integer at the given offset
+		/// with value in little-endian byte order.
+};
+
+
+//
+// inlines
+//
+inline const char* BSONStreamBuf::data() const
+{
+	return pbase();
+}
+
+
+inline std::size_t BSONStreamBuf::size() const
+{
+	return static_cast<std::size_t>(pptr() - pbase());
+}
+
+
+inline BSONStreamBuf* BSONIOS::rdbuf()
+{
+	return &_buf;
+}
+
+
+inline const char* BSONOutputStream::data() const
+{
+	return _buf.data();
+}
+
+
+inline std::size_t BSONOutputStream::size() const
+{
+	return _buf.size();
+}
+
+
+}} // Namespace Poco::MongoDB
+
+#endif //  _MongoDB_BSONOutputStream_included
@@ -0,0 +1,128 @@
+//
+// BSONToJSON.h
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  BSONToJSON
+//
+// Definition of the BSONToJSON class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _MongoDB_BSONToJSON_included
+#define _MongoDB_BSONToJSON_included
+
+#include "Poco/MongoDB/MongoDB.h"
+#include "Poco/MongoDB/DocumentView.h"
+#include "Poco/JSON/Writer.h"
+
+#include <string>
+
+namespace Poco
+{
+namespace MongoDB
+{
+
+
+class MongoDB_API BSONToJSON
+	/// Writes BSON documents as JSON text without reading them into a
+	/// Document. The raw bytes are walked once and every element is
+	/// handed to a JSON::Writer, which appends the text to its buffer
+	/// or writes it to its stream in chunks.
+	///
+	/// Types that have no JSON notation are written as MongoDB extended
+	/// JSON (strict mode):
+	///     ObjectId         { "$oid" : "<24 hex digits>" }
+	///     UTC datetime     { "$date" : <milliseconds since the epoch> }
+	///     Binary           { "$binary" : "<base64>", "$type" : "<2 hex digits>" }
+	///     64-bit integer   { "$numberLong" : "<decimal>" }
+	///     Regex            { "$regex" : "<pattern>", "$options" : "<options>" }
+	///     JavaScript code  { "$code" : "<code>" }
+	///     Timestamp        { "$timestamp" : { "t" : <seconds>, "i" : <increment> } }
+	///     MinKey, MaxKey   { "$minKey" : 1 }, { "$maxKey" : 1 }
+	/// JSONToBSON converts these back to the original types. Undefined
+	/// values are written as null and symbols as strings.
+	///
+	/// Usage:
+	///     JSON::Writer writer(ostr);
+	///     BSONToJSON bsonToJSON(writer);
+	///     writer.startArray();
+	///     for (DocumentView::Vector::iterator it = response.views().begin(); it != response.views().end(); ++it)
+	///         bsonToJSON.write(*it);
+	///     writer.endArray();
+{
+public:
+	BSONToJSON(JSON::Writer& writer);
+		/// Creates the BSONToJSON for the given writer.
+
+
+	~BSONToJSON();
+		/// Destroys the BSONToJSON.
+
+
+	std::size_t write(const char* data, std::size_t available);
+		/// Writes the BSON document at data as a JSON object and returns
+		/// its size, so a sequence of documents can be written one after
+		/// the other. Throws a DataFormatException if the document is
+		/// malformed or longer than available bytes.
+
+
+	void write(const DocumentView& view);
+		/// Writes the document of view as a JSON object.
+
+
+private:
+
+	const char* writeDocument(const char* pos, const char* end, bool isArray);
+		/// Writes the document or array at pos and returns its end.
+
+
+	const char* writeValue(unsigned char type, const char* pos, const char* end);
+		/// Writes the value of an element at pos and returns its end.
+
+
+	void writeWrapper(const char* key, const char* text, std::size_t length);
+		/// Writes { key : text }
+
+
+	JSON::Writer& _writer;
+
+
+	std::string _scratch;
+		/// Reused for formatted values.
+
+
+	BSONToJSON(const BSONToJSON&);
+	BSONToJSON& operator = (const BSONToJSON&);
+};
+
+
+}} // Poco::MongoDB
+
+#endif //_MongoDB_BSONToJSON_included
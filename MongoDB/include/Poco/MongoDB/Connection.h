@@ -41,10 +41,16 @@
 #include "Poco/Net/SocketAddress.h"
 #include "Poco/Net/StreamSocket.h"
 #include "Poco/Mutex.h"
+#include "Poco/Thread.h"
+#include "Poco/RunnableAdapter.h"
+#include "Poco/ActiveResult.h"
 
 #include "Poco/MongoDB/RequestMessage.h"
 #include "Poco/MongoDB/ResponseMessage.h"
 
+#include <map>
+#include <vector>
+
 namespace Poco
 {
 namespace MongoDB
@@ -52,12 +58,26 @@ namespace MongoDB
 
 class MongoDB_API Connection
 	/// Represents a connection to a MongoDB server
+	///
+	/// Every request sent over a connection gets a new, monotonically
+	/// increasing request id. By default, sendRequest() waits for the
+	/// reply before the next request can be sent. The first call to
+	/// sendRequestAsync() switches the connection to pipelined mode:
+	/// requests are written back-to-back without waiting and a reader
+	/// thread dispatches the replies, which the server may send in any
+	/// order, to the waiting callers by their responseTo id. In pipelined
+	/// mode the connection can be shared by several threads.
 {
 public:
 
 	typedef Poco::SharedPtr<Connection> Ptr;
 
 
+	typedef Poco::ActiveResult<ResponseMessage> AsyncResponse;
+		/// The result of sendRequestAsync(). The ResponseMessage is
+		/// available with data() once wait() returns.
+
+
 	Connection();
 		/// Default constructor. Use this when you want to
 		/// connect later on.
@@ -112,8 +132,78 @@ public:
 		/// request will return a response.
 
 
+	AsyncResponse sendRequestAsync(RequestMessage& request, bool readViews = false);
+		/// Sends a query or getmore request to the MongoDB server without
+		/// waiting for the reply and switches the connection to pipelined
+		/// mode. When readViews is true, the reply is read with
+		/// ResponseMessage::readViews() enabled.
+		///
+		/// If the connection fails, all outstanding results fail with
+		/// the exception and the connection must be reconnected.
+
+
+	void sendRequestsAsync(const std::vector<RequestMessage*>& requests, std::vector<AsyncResponse>& responses, bool readViews = false);
+		/// Writes all query or getmore requests with a single sendBytes()
+		/// call and appends their results to responses, in request order.
+
+
+	bool isPipelined() const;
+		/// Returns true if the connection is in pipelined mode.
+
+
+	std::size_t pendingRequests() const;
+		/// Returns the number of requests still waiting for a reply.
+
+
+	bool isConnected() const;
+		/// Returns false if the connection is known to be unusable:
+		/// it was never connected or has been disconnected, the server
+		/// closed it, or the pipelined reader has failed. An idle,
+		/// non-pipelined connection that is readable has either been
+		/// closed by the server or holds a stray reply, and is reported
+		/// as not connected as well.
+		///
+		/// Only a zero-timeout poll() is done; no request is sent.
+
+
 private:
 
+	struct PendingResponse
+	{
+		PendingResponse(ResponseMessage* pResp, const AsyncResponse& res) : pResponse(pResp), result(res)
+		{
+		}
+
+		ResponseMessage* pResponse;
+		AsyncResponse    result;
+	};
+
+	typedef std::map<Int32, PendingResponse> PendingMap;
+
+
+	AsyncResponse sendPipelined(RequestMessage& request, ResponseMessage& response);
+		/// Sends request in pipelined mode; the reply is read into response.
+
+
+	void addPending(Int32 requestID, const PendingResponse& pending);
+		/// Registers a reply. Throws if the reader thread has failed.
+
+
+	void sendBytes(const char* data, std::size_t length);
+
+
+	void startReader();
+
+
+	void stopReader();
+
+
+	void readResponses();
+		/// Reader thread: reads replies and hands them to their requests.
+
+
+	void failPending(const Exception& exc);
+
 	Net::SocketAddress _address;
 
 
@@ -122,6 +212,34 @@ private:
 	
 	void connect();
 		/// Connects to the MongoDB server
+
+
+	Int32 _lastRequestID;
+
+
+	Poco::FastMutex _writeMutex;
+
+
+	mutable Poco::FastMutex _pendingMutex;
+
+
+	PendingMap _pending;
+
+
+	bool _pipelined;
+
+
+	Exception* _pReaderError;
+
+
+	Poco::Thread _reader;
+
+
+	Poco::RunnableAdapter<Connection> _readerAdapter;
+
+
+	Connection(const Connection&);
+	Connection& operator = (const Connection&);
 };
 
 inline Net::SocketAddress Connection::address() const
@@ -129,6 +247,12 @@ inline Net::SocketAddress Connection::address() const
 	return _address;
 }
 
+
+inline bool Connection::isPipelined() const
+{
+	return _pipelined;
+}
+
 }} // Poco::MongoDB
 
 #endif //_MongoDB_Connection_h
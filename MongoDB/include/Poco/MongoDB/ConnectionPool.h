@@ -0,0 +1,285 @@
+//
+// ConnectionPool.h
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  ConnectionPool
+//
+// Definition of the ConnectionPool class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _MongoDB_ConnectionPool_included
+#define _MongoDB_ConnectionPool_included
+
+#include "Poco/MongoDB/MongoDB.h"
+#include "Poco/MongoDB/Connection.h"
+#include "Poco/MongoDB/Document.h"
+#include "Poco/MongoDB/PoolableConnectionFactory.h"
+#include "Poco/Mutex.h"
+#include "Poco/Condition.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Timespan.h"
+
+#include <vector>
+
+namespace Poco
+{
+namespace MongoDB
+{
+
+
+class MongoDB_API ConnectionPool
+	/// A pool of connections to a single MongoDB server.
+	///
+	/// The pool holds between minSize() and maxSize() connections.
+	/// Borrowing takes the most recently returned idle connection and
+	/// only checks it locally with Connection::isConnected(), so it
+	/// does no network I/O as long as an idle connection is available.
+	/// The network work is left to maintain(), which is meant to be
+	/// called periodically from a background thread (ReplicaSet does
+	/// this from its topology monitor): it closes connections that
+	/// have been idle for longer than idleTimeout() while more than
+	/// minSize() are open, validates the remaining idle connections
+	/// with an isMaster ping and opens new connections until minSize()
+	/// are available again.
+	///
+	/// Usage:
+	///     ConnectionPool::Ptr pPool = new ConnectionPool(address, 2, 16);
+	///     pPool->maintain();
+	///     {
+	///         PooledConnection connection(pPool);
+	///         connection->sendRequest(request, response);
+	///     }
+{
+public:
+	typedef SharedPtr<ConnectionPool> Ptr;
+
+
+	ConnectionPool(const Net::SocketAddress& address, std::size_t minSize = 1, std::size_t maxSize = 16, int idleTimeout = 60);
+		/// Creates the pool. No connection is opened before the first
+		/// call to borrowConnection() or maintain(). idleTimeout is
+		/// given in seconds.
+
+
+	virtual ~ConnectionPool();
+		/// Destroys the pool and closes all idle connections.
+
+
+	Connection::Ptr borrowConnection(long timeout = 0);
+		/// Returns an idle connection. If there is none and fewer than
+		/// maxSize() connections are open, a new connection is opened.
+		/// Otherwise waits up to timeout milliseconds for a connection
+		/// to be returned and throws a TimeoutException if none is.
+		///
+		/// The connection must be given back with returnConnection().
+
+
+	void returnConnection(Connection::Ptr pConnection);
+		/// Returns a connection to the pool. A connection that is no
+		/// longer connected or still has pipelined requests in flight
+		/// is closed instead of being kept.
+
+
+	void maintain();
+		/// Reaps connections that have been idle for too long, pings
+		/// the remaining idle connections and opens new ones until
+		/// minSize() connections are open. Connection errors while
+		/// opening new connections are propagated.
+
+
+	static Document::Ptr ping(Connection& connection);
+		/// Sends the isMaster command, the cheapest command every server
+		/// answers, over the connection and returns the reply document.
+		/// Throws an IOException if the server does not answer.
+
+
+	const Net::SocketAddress& address() const;
+		/// Returns the address of the server.
+
+
+	std::size_t minSize() const;
+		/// Returns the number of connections maintain() keeps open.
+
+
+	std::size_t maxSize() const;
+		/// Returns the maximum number of open connections.
+
+
+	int idleTimeout() const;
+		/// Returns the idle timeout in seconds.
+
+
+	std::size_t size() const;
+		/// Returns the number of open connections, borrowed or idle.
+
+
+	std::size_t idle() const;
+		/// Returns the number of idle connections.
+
+
+private:
+
+	typedef PoolableObjectFactory<Connection, Connection::Ptr> Factory;
+
+
+	struct IdleConnection
+	{
+		IdleConnection(Connection::Ptr pConn, const Timestamp& used, const Timestamp& checked) : pConnection(pConn), lastUsed(used), lastChecked(checked)
+		{
+		}
+
+		Connection::Ptr pConnection;
+		Timestamp       lastUsed;
+		Timestamp       lastChecked;
+	};
+
+	typedef std::vector<IdleConnection> IdleVector;
+
+
+	Connection::Ptr newConnection();
+		/// Opens a connection for a slot already counted in _size.
+
+
+	void addIdle(const IdleConnection& idle);
+		/// Inserts idle, keeping _idle ordered by last use. Must be
+		/// called with _mutex locked.
+
+
+	Factory _factory;
+
+
+	std::size_t _minSize;
+
+
+	std::size_t _maxSize;
+
+
+	Timespan _idleTimeout;
+
+
+	IdleVector _idle;
+		/// Ordered by last use; borrowing takes from the back.
+
+
+	std::size_t _size;
+
+
+	mutable FastMutex _mutex;
+
+
+	Condition _available;
+
+
+	ConnectionPool(const ConnectionPool&);
+	ConnectionPool& operator = (const ConnectionPool&);
+};
+
+
+class MongoDB_API PooledConnection
+	/// Borrows a connection from a ConnectionPool for the lifetime of
+	/// the PooledConnection and returns it when destroyed.
+{
+public:
+	PooledConnection(ConnectionPool::Ptr pPool, long timeout = 0);
+		/// Borrows a connection, see ConnectionPool::borrowConnection().
+
+
+	~PooledConnection();
+		/// Returns the connection to the pool.
+
+
+	Connection& operator * ();
+
+
+	Connection* operator -> ();
+
+
+	Connection::Ptr connection() const;
+		/// Returns the borrowed connection.
+
+
+private:
+
+	ConnectionPool::Ptr _pPool;
+
+
+	Connection::Ptr _pConnection;
+
+
+	PooledConnection(const PooledConnection&);
+	PooledConnection& operator = (const PooledConnection&);
+};
+
+
+inline const Net::SocketAddress& ConnectionPool::address() const
+{
+	return _factory.address();
+}
+
+
+inline std::size_t ConnectionPool::minSize() const
+{
+	return _minSize;
+}
+
+
+inline std::size_t ConnectionPool::maxSize() const
+{
+	return _maxSize;
+}
+
+
+inline int ConnectionPool::idleTimeout() const
+{
+	return _idleTimeout.totalSeconds();
+}
+
+
+inline Connection& PooledConnection::operator * ()
+{
+	return *_pConnection;
+}
+
+
+inline Connection* PooledConnection::operator -> ()
+{
+	return _pConnection.get();
+}
+
+
+inline Connection::Ptr PooledConnection::connection() const
+{
+	return _pConnection;
+}
+
+
+}} // Poco::MongoDB
+
+#endif //_MongoDB_ConnectionPool_included
@@ -0,0 +1,251 @@
+//
+// Cursor.h
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  Cursor
+//
+// Definition of the Cursor class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _MongoDB_Cursor_included
+#define _MongoDB_Cursor_included
+
+#include "Poco/MongoDB/MongoDB.h"
+#include "Poco/MongoDB/Connection.h"
+#include "Poco/MongoDB/QueryRequest.h"
+#include "Poco/MongoDB/ResponseMessage.h"
+
+#include <deque>
+
+namespace Poco
+{
+namespace MongoDB
+{
+
+
+class MongoDB_API Cursor
+	/// Iterates over the result of a query, across batches.
+	///
+	/// The cursor keeps up to prefetch() GetMoreRequests in flight on
+	/// the (pipelined) Connection, so the next batches are already on
+	/// their way while the current one is being consumed. Batches are
+	/// only requested once the server has returned the cursor id with
+	/// the first reply. A cursor that is still open on the server is
+	/// killed when the Cursor is closed or destroyed.
+	///
+	/// Usage:
+	///     Cursor cursor(connection, "team.players");
+	///     cursor.query().add("active", true);
+	///     cursor.batchSize(1000);
+	///     while (cursor.next())
+	///     {
+	///         Document::Ptr doc = cursor.document();
+	///         ...
+	///     }
+{
+public:
+	enum
+	{
+		DEFAULT_PREFETCH = 1
+	};
+
+
+	Cursor(Connection& connection, const std::string& collectionName, QueryRequest::Flags flags = QueryRequest::QUERY_NONE);
+		/// Creates a Cursor for the given full collection name.
+		/// The query is sent with the first call to next().
+
+
+	virtual ~Cursor();
+		/// Destroys the Cursor. Kills the server-side cursor if it is still open.
+
+
+	Document& query();
+		/// Returns the query document. Set it up before the first next().
+
+
+	QueryRequest& request();
+		/// Returns the query request, e.g. to set a field selector or
+		/// the number of documents to skip before the first next().
+
+
+	void batchSize(Int32 n);
+		/// Sets the number of documents requested per batch.
+		/// 0 lets the server decide.
+
+
+	Int32 batchSize() const;
+		/// Returns the number of documents requested per batch.
+
+
+	void prefetch(int depth);
+		/// Sets the number of GetMoreRequests to keep in flight while the
+		/// current batch is consumed. With 0, the next batch is only
+		/// requested when the current batch has been consumed.
+
+
+	int prefetch() const;
+		/// Returns the prefetch depth.
+
+
+	void readViews(bool flag);
+		/// When flag is true, batches are read as DocumentViews (see
+		/// ResponseMessage::readViews()) and view() must be used instead
+		/// of document(). A view stays valid until the cursor moves past
+		/// the batch it belongs to.
+
+
+	bool next();
+		/// Moves to the next document and returns true, or returns
+		/// false when the query has no more documents. Throws an
+		/// exception when the query fails or the cursor has been
+		/// removed on the server.
+
+
+	Document::Ptr document() const;
+		/// Returns the current document.
+
+
+	const DocumentView& view() const;
+		/// Returns the current document when readViews is enabled.
+
+
+	Int64 cursorID() const;
+		/// Returns the server-side cursor id, or 0 if it is exhausted.
+
+
+	void close();
+		/// Stops iterating and kills the server-side cursor if it is still open.
+
+
+private:
+
+	void requestMore();
+		/// Sends a GetMoreRequest and queues its result.
+
+
+	void fill();
+		/// Tops up the GetMoreRequests in flight to the prefetch depth.
+
+
+	std::size_t batchCount(ResponseMessage& response) const;
+
+
+	Connection& _connection;
+
+
+	std::string _collectionName;
+
+
+	QueryRequest _query;
+
+
+	Int32 _batchSize;
+
+
+	int _prefetch;
+
+
+	bool _readViews;
+
+
+	bool _started;
+
+
+	Int64 _cursorID;
+
+
+	std::deque<Connection::AsyncResponse> _batches;
+		/// The front is the current batch once _current is set;
+		/// the others are still in flight.
+
+
+	bool _current;
+
+
+	std::size_t _position;
+
+
+	Cursor(const Cursor&);
+	Cursor& operator = (const Cursor&);
+};
+
+
+inline Document& Cursor::query()
+{
+	return _query.query();
+}
+
+
+inline QueryRequest& Cursor::request()
+{
+	return _query;
+}
+
+
+inline void Cursor::batchSize(Int32 n)
+{
+	_batchSize = n;
+}
+
+
+inline Int32 Cursor::batchSize() const
+{
+	return _batchSize;
+}
+
+
+inline void Cursor::prefetch(int depth)
+{
+	_prefetch = depth;
+}
+
+
+inline int Cursor::prefetch() const
+{
+	return _prefetch;
+}
+
+
+inline void Cursor::readViews(bool flag)
+{
+	_readViews = flag;
+}
+
+
+inline Int64 Cursor::cursorID() const
+{
+	return _cursorID;
+}
+
+
+}} // Namespace Poco::MongoDB
+
+#endif //_MongoDB_Cursor_included
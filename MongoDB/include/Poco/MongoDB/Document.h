@@ -39,6 +39,7 @@
 #define _MongoDB_Document_included
 
 #include <algorithm>
+#include <vector>
 
 #include "Poco/BinaryReader.h"
 #include "Poco/BinaryWriter.h"
@@ -67,7 +68,98 @@ private:
 	std::string _name;
 };
 
+
+struct DocumentField
+	/// A field of a Document. Values of the scalar types double, Int32,
+	/// Int64, bool and Timestamp are stored inline; all other values are
+	/// held by a ConcreteElement.
+{
+	DocumentField(const std::string& n, int t) : name(n), type(t), element()
+	{
+		value.i64 = 0;
+	}
+
+	std::string name;
+	int type;
+	union
+	{
+		double d;
+		Int32  i32;
+		Int64  i64;
+		bool   b;
+	} value;
+	Element::Ptr element;
+};
+
+
+template<typename T>
+struct FieldStorage
+	/// Stores a value of type T in a DocumentField.
+{
+	static T get(const DocumentField& field)
+	{
+		const ConcreteElement<T>* concrete = dynamic_cast<const ConcreteElement<T>* >(field.element.get());
+		return concrete->value();
+	}
+
+	static void set(DocumentField& field, const T& value)
+	{
+		field.element = new ConcreteElement<T>(field.name, value);
+	}
+};
+
+
+template<>
+struct FieldStorage<double>
+{
+	static double get(const DocumentField& field) { return field.value.d; }
+	static void set(DocumentField& field, const double& value) { field.value.d = value; }
+};
+
+
+template<>
+struct FieldStorage<Int32>
+{
+	static Int32 get(const DocumentField& field) { return field.value.i32; }
+	static void set(DocumentField& field, const Int32& value) { field.value.i32 = value; }
+};
+
+
+template<>
+struct FieldStorage<Int64>
+{
+	static Int64 get(const DocumentField& field) { return field.value.i64; }
+	static void set(DocumentField& field, const Int64& value) { field.value.i64 = value; }
+};
+
+
+template<>
+struct FieldStorage<bool>
+{
+	static bool get(const DocumentField& field) { return field.value.b; }
+	static void set(DocumentField& field, const bool& value) { field.value.b = value; }
+};
+
+
+template<>
+struct FieldStorage<Timestamp>
+{
+	static Timestamp get(const DocumentField& field) { return Timestamp(field.value.i64); }
+	static void set(DocumentField& field, const Timestamp& value) { field.value.i64 = value.epochMicroseconds(); }
+};
+
+
 class MongoDB_API Document
+	/// A BSON document. The fields are kept in insertion order in a
+	/// single vector, so a document is written exactly as it was built,
+	/// which matters for commands. Scalar values are stored inline and
+	/// need no allocation of their own.
+	///
+	/// Looking up a field by name is a linear scan. Once a document has
+	/// INDEX_THRESHOLD or more fields, an open-addressing hash index of
+	/// the field positions is built on the first lookup and kept up to
+	/// date by add(). Because of this lazily built index, even const
+	/// lookups must not be made from several threads at the same time.
 {
 public:
 
@@ -77,6 +169,12 @@ public:
 	typedef std::vector<Document::Ptr> Vector;
 
 
+	enum
+	{
+		INDEX_THRESHOLD = 16
+	};
+
+
 	Document();
 
 
@@ -90,19 +188,18 @@ public:
 
 	
 	template<typename T>
-	T get(const std::string& name)
+	T get(const std::string& name) const
 	{
-		Element::Ptr element = get(name);
-		if ( element.isNull() )
+		const DocumentField* pField = find(name);
+		if ( pField == 0 )
 		{
 			throw Poco::NotFoundException(name);
 		}
 		else
 		{
-			if ( ElementTraits<T>::TypeId == element->type() )
+			if ( ElementTraits<T>::TypeId == pField->type )
 			{
-				ConcreteElement<T>* concrete = dynamic_cast<ConcreteElement<T>* >(element.get());
-				return concrete->value();
+				return FieldStorage<T>::get(*pField);
 			}
 			else
 			{
@@ -111,35 +208,29 @@ public:
 		}
 	}
 
-	Element::Ptr get(const std::string& name)
-	{
-		Element::Ptr element;
 
-		ElementSet::iterator it = std::find_if(_elements.begin(), _elements.end(), ElementFindByName(name));
-		if ( it != _elements.end() )
-		{
-			return *it;
-		}
+	Element::Ptr get(const std::string& name) const;
+		/// Returns the field as an Element, or a null pointer if there is
+		/// no such field. An Element is created for inline scalar values,
+		/// so prefer get<T>() where the type is known.
 
-		return element;
-	}
 
-	bool exists(const std::string& name)
+	bool exists(const std::string& name) const
 	{
-		return std::find_if(_elements.begin(), _elements.end(), ElementFindByName(name)) != _elements.end();
+		return find(name) != 0;
 	}
 
 
 	template<typename T>
-	bool isType(const std::string& name)
+	bool isType(const std::string& name) const
 	{
-		Element::Ptr element = get(name);
-		if ( element.isNull() )
+		const DocumentField* pField = find(name);
+		if ( pField == 0 )
 		{
 			return false;
 		}
 
-		return ElementTraits<T>::TypeId == element->type();
+		return ElementTraits<T>::TypeId == pField->type;
 	}
 
 
@@ -149,10 +240,16 @@ public:
 	template<typename T>
 	void add(const std::string& name, T value)
 	{
-		addElement(new ConcreteElement<T>(name, value));
+		_fields.push_back(DocumentField(name, ElementTraits<T>::TypeId));
+		FieldStorage<T>::set(_fields.back(), value);
+		indexLast();
 	}
 
 
+	std::size_t size() const;
+		/// Returns the number of fields.
+
+
 	bool empty() const;
 
 
@@ -164,21 +261,69 @@ public:
 
 private:
 
-	ElementSet _elements;
+	typedef std::vector<DocumentField> FieldVector;
+
+
+	const DocumentField* find(const std::string& name) const;
+		/// Returns the first field with the given name, or 0.
+
+
+	void buildIndex() const;
+
+
+	void insertIndex(std::size_t pos) const;
+		/// Adds _fields[pos] to the index unless a field with the same
+		/// name is already there.
+
+
+	void indexLast();
+		/// Adds the last field to the index, if there is one.
+
+
+	FieldVector _fields;
+
+
+	mutable std::vector<Int32> _index;
+		/// The positions of the fields, -1 for an empty slot. The
+		/// size is a power of two and at least twice the field count.
 };
 
 
+inline std::size_t Document::size() const
+{
+	return _fields.size();
+}
+
+
 inline bool Document::empty() const
 {
-	return _elements.empty();
+	return _fields.empty();
 }
 
 
 inline void Document::clear()
 {
-	_elements.clear();
+	_fields.clear();
+	_index.clear();
+}
+
+
+inline void Document::indexLast()
+{
+	if ( ! _index.empty() )
+	{
+		if ( 2*_fields.size() > _index.size() )
+		{
+			buildIndex();
+		}
+		else
+		{
+			insertIndex(_fields.size() - 1);
+		}
+	}
 }
 
+
 // BSON Embedded Document
 // spec: document
 template<>
@@ -0,0 +1,440 @@
+//
+// DocumentView.h
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  DocumentView
+//
+// Definition of the DocumentView class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _MongoDB_DocumentView_included
+#define _MongoDB_DocumentView_included
+
+#include "Poco/MongoDB/MongoDB.h"
+#include "Poco/MongoDB/Document.h"
+#include "Poco/Timestamp.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Poco {
+namespace MongoDB {
+
+
+class StringView
+	/// A non-owning reference to a sequence of characters inside
+	/// a BSON buffer. The referenced characters are not copied, so a
+	/// StringView is only valid as long as the buffer it points into.
+{
+public:
+	StringView() : _data(""), _size(0)
+		/// Creates an empty StringView.
+	{
+	}
+
+	StringView(const char* data, std::size_t size) : _data(data), _size(size)
+		/// Creates a StringView for the given characters.
+	{
+	}
+
+	const char* data() const
+		/// Returns a pointer to the first character. The characters
+		/// are not guaranteed to be followed by a 0x00.
+	{
+		return _data;
+	}
+
+	std::size_t size() const
+		/// Returns the number of characters.
+	{
+		return _size;
+	}
+
+	bool empty() const
+		/// Returns true if the view has no characters.
+	{
+		return _size == 0;
+	}
+
+	std::string toString() const
+		/// Returns a copy of the characters.
+	{
+		return std::string(_data, _size);
+	}
+
+	bool operator == (const StringView& other) const
+	{
+		return _size == other._size && std::memcmp(_data, other._data, _size) == 0;
+	}
+
+	bool operator != (const StringView& other) const
+	{
+		return !(*this == other);
+	}
+
+	bool operator == (const std::string& str) const
+	{
+		return _size == str.size() && std::memcmp(_data, str.data(), _size) == 0;
+	}
+
+	bool operator != (const std::string& str) const
+	{
+		return !(*this == str);
+	}
+
+private:
+	const char* _data;
+	std::size_t _size;
+};
+
+
+class MongoDB_API DocumentView
+	/// A read-only view on a BSON document that is stored in a buffer
+	/// owned by someone else (usually a ResponseMessage).
+	///
+	/// Unlike Document, a DocumentView does not decode anything up front:
+	/// fields are located by walking the raw bytes when they are requested
+	/// and values are decoded on access. Strings are returned as StringView
+	/// and embedded documents and arrays as nested DocumentViews, so
+	/// neither accessing nor iterating fields allocates memory.
+	///
+	/// A DocumentView (and everything obtained from it) is only valid as
+	/// long as the underlying buffer is. Use toDocument() to get a copy
+	/// that outlives the buffer.
+{
+public:
+	typedef std::vector<DocumentView> Vector;
+
+
+	class MongoDB_API Field
+		/// A single field of a DocumentView.
+	{
+	public:
+		Field();
+			/// Creates an empty Field.
+
+		StringView name() const;
+			/// Returns the name of the field.
+
+		int type() const;
+			/// Returns the BSON type id of the field.
+
+		const char* value() const;
+			/// Returns a pointer to the raw (little-endian) value.
+
+		std::size_t valueSize() const;
+			/// Returns the size of the raw value in bytes.
+
+		bool isNull() const;
+			/// Returns true if the field is a BSON null.
+
+		Int32 asInt32() const;
+			/// Returns the value of a 32-bit integer field.
+			/// Throws a BadCastException if the field has a different type.
+
+		Int64 asInt64() const;
+			/// Returns the value of a 64-bit integer field.
+			/// Throws a BadCastException if the field has a different type.
+
+		double asDouble() const;
+			/// Returns the value of a double field.
+			/// Throws a BadCastException if the field has a different type.
+
+		bool asBool() const;
+			/// Returns the value of a boolean field.
+			/// Throws a BadCastException if the field has a different type.
+
+		StringView asString() const;
+			/// Returns the value of a string field without the
+			/// terminating 0x00. Throws a BadCastException if the field
+			/// has a different type.
+
+		Timestamp asTimestamp() const;
+			/// Returns the value of a UTC datetime field.
+			/// Throws a BadCastException if the field has a different type.
+
+		DocumentView asDocument() const;
+			/// Returns the value of an embedded document or array field.
+			/// Throws a BadCastException if the field has a different type.
+
+	private:
+		void checkType(int type) const;
+
+		const char* _name;
+		std::size_t _nameLength;
+		int         _type;
+		const char* _value;
+		std::size_t _valueSize;
+
+		friend class DocumentView;
+	};
+
+
+	class MongoDB_API Iterator
+		/// A forward iterator over the fields of a DocumentView.
+	{
+	public:
+		Iterator();
+			/// Creates an end iterator.
+
+		const Field& operator * () const;
+
+		const Field* operator -> () const;
+
+		Iterator& operator ++ ();
+			/// Moves to the next field. Throws a DataFormatException
+			/// if the field is malformed.
+
+		bool operator == (const Iterator& other) const;
+
+		bool operator != (const Iterator& other) const;
+
+	private:
+		Iterator(const char* pos, const char* end);
+
+		void parse();
+
+		const char* _pos;
+		const char* _end;
+		Field       _field;
+
+		friend class DocumentView;
+	};
+
+
+	DocumentView();
+		/// Creates a null DocumentView.
+
+
+	DocumentView(const char* data, std::size_t available);
+		/// Creates a DocumentView for the BSON document starting at data.
+		/// The size of the document is taken from its length prefix and
+		/// must not exceed available. Throws a DataFormatException if the
+		/// document is truncated or not terminated.
+
+
+	virtual ~DocumentView();
+		/// Destructor
+
+
+	Iterator begin() const;
+		/// Returns an iterator to the first field.
+
+
+	Iterator end() const;
+		/// Returns the end iterator.
+
+
+	Iterator find(const std::string& name) const;
+		/// Returns an iterator to the first field with the given name
+		/// or end() when there is no such field.
+
+
+	bool exists(const std::string& name) const;
+		/// Returns true if the document has a field with the given name.
+
+
+	bool isNull(const std::string& name) const;
+		/// Returns true if the given field is a BSON null.
+		/// Throws a NotFoundException if there is no such field.
+
+
+	int type(const std::string& name) const;
+		/// Returns the BSON type id of the given field.
+		/// Throws a NotFoundException if there is no such field.
+
+
+	Int32 getInt32(const std::string& name) const;
+		/// Returns the value of the given 32-bit integer field.
+
+
+	Int64 getInt64(const std::string& name) const;
+		/// Returns the value of the given 64-bit integer field.
+
+
+	double getDouble(const std::string& name) const;
+		/// Returns the value of the given double field.
+
+
+	bool getBool(const std::string& name) const;
+		/// Returns the value of the given boolean field.
+
+
+	StringView getString(const std::string& name) const;
+		/// Returns the value of the given string field.
+
+
+	Timestamp getTimestamp(const std::string& name) const;
+		/// Returns the value of the given UTC datetime field.
+
+
+	DocumentView getDocument(const std::string& name) const;
+		/// Returns the given embedded document.
+
+
+	DocumentView getArray(const std::string& name) const;
+		/// Returns the given array. The fields of an array view are
+		/// named "0", "1", ... in order.
+		///
+		/// All get methods throw a NotFoundException if there is no
+		/// field with the given name and a BadCastException if the
+		/// field has a different type.
+
+
+	std::size_t fieldCount() const;
+		/// Returns the number of fields. This walks the whole document.
+
+
+	bool isNull() const;
+		/// Returns true if the view does not refer to a document.
+
+
+	bool empty() const;
+		/// Returns true if the document has no fields.
+
+
+	const char* data() const;
+		/// Returns a pointer to the raw document, including its length prefix.
+
+
+	std::size_t size() const;
+		/// Returns the size of the raw document in bytes.
+
+
+	Document::Ptr toDocument() const;
+		/// Decodes the view into a newly allocated Document.
+
+
+private:
+	Field field(const std::string& name) const;
+
+	const char* _data;
+	std::size_t _size;
+};
+
+
+//
+// inlines
+//
+inline StringView DocumentView::Field::name() const
+{
+	return StringView(_name, _nameLength);
+}
+
+
+inline int DocumentView::Field::type() const
+{
+	return _type;
+}
+
+
+inline const char* DocumentView::Field::value() const
+{
+	return _value;
+}
+
+
+inline std::size_t DocumentView::Field::valueSize() const
+{
+	return _valueSize;
+}
+
+
+inline bool DocumentView::Field::isNull() const
+{
+	return _type == ElementTraits<NullValue>::TypeId;
+}
+
+
+inline const DocumentView::Field& DocumentView::Iterator::operator * () const
+{
+	return _field;
+}
+
+
+inline const DocumentView::Field* DocumentView::Iterator::operator -> () const
+{
+	return &_field;
+}
+
+
+inline bool DocumentView::Iterator::operator == (const Iterator& other) const
+{
+	return _pos == other._pos;
+}
+
+
+inline bool DocumentView::Iterator::operator != (const Iterator& other) const
+{
+	return _pos != other._pos;
+}
+
+
+inline DocumentView::Iterator DocumentView::end() const
+{
+	return Iterator();
+}
+
+
+inline bool DocumentView::exists(const std::string& name) const
+{
+	return find(name) != end();
+}
+
+
+inline bool DocumentView::isNull() const
+{
+	return _data == 0;
+}
+
+
+inline bool DocumentView::empty() const
+{
+	return _size <= 5;
+}
+
+
+inline const char* DocumentView::data() const
+{
+	return _data;
+}
+
+
+inline std::size_t DocumentView::size() const
+{
+	return _size;
+}
+
+
+}} // Namespace Poco::MongoDB
+
+#endif //  _MongoDB_DocumentView_included
@@ -175,7 +175,7 @@ struct ElementTraits<bool>
 template<>
 inline void BSONReader::read<bool>(bool& to)
 {
-	Int32 b;
+	unsigned char b;
 	_reader >> b;
 	to = b != 0;
 }
@@ -183,7 +183,7 @@ inline void BSONReader::read<bool>(bool& to)
 template<>
 inline void BSONWriter::write<bool>(bool& from)
 {
-	_writer << (from ? 0x01 : 0x00);
+	_writer << (unsigned char) (from ? 0x01 : 0x00);
 }
 
 // BSON 32-bit integer
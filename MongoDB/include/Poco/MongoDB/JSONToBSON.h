@@ -0,0 +1,240 @@
+//
+// JSONToBSON.h
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  JSONToBSON
+//
+// Definition of the JSONToBSON class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _MongoDB_JSONToBSON_included
+#define _MongoDB_JSONToBSON_included
+
+#include "Poco/MongoDB/MongoDB.h"
+#include "Poco/MongoDB/BSONOutputStream.h"
+#include "Poco/JSON/Handler.h"
+#include "Poco/BinaryWriter.h"
+
+#include <string>
+#include <vector>
+
+namespace Poco
+{
+namespace MongoDB
+{
+
+
+class MongoDB_API JSONToBSON : public JSON::Handler
+	/// A JSON::Handler that writes the events of a JSON::Parser as BSON
+	/// into a BSONOutputStream, without building a Document. Length
+	/// prefixes are written as placeholders and patched when an object
+	/// or array is complete.
+	///
+	/// Every top-level object becomes one BSON document. A top-level
+	/// array must contain objects and gives one document per object,
+	/// so the stream can be used as the documents of an insert.
+	///
+	/// Objects in the extended JSON notation written by BSONToJSON, like
+	/// { "$oid" : "..." } or { "$date" : ... }, are converted back to the
+	/// BSON type. { "$date" : { "$numberLong" : "..." } } is accepted as
+	/// well. Other objects with keys starting with '$', like the operators
+	/// of a query, are written as documents.
+	///
+	/// Usage:
+	///     BSONOutputStream bson;
+	///     JSONToBSON handler(bson);
+	///     JSON::Parser parser;
+	///     parser.setHandler(&handler);
+	///     parser.parse(json);
+{
+public:
+	JSONToBSON(BSONOutputStream& bson);
+		/// Creates the JSONToBSON for the given stream.
+
+
+	~JSONToBSON();
+		/// Destroys the JSONToBSON.
+
+
+	std::size_t documents() const;
+		/// Returns the number of documents written so far.
+
+
+	void reset();
+		/// Forgets an incomplete document, after a parse error. The bytes
+		/// already written for it stay in the stream.
+
+
+	void startObject();
+
+
+	void endObject();
+
+
+	void startArray();
+
+
+	void endArray();
+
+
+	void key(const std::string& k);
+
+
+	void null();
+
+
+	void value(int v);
+
+
+	void value(const std::string& value);
+
+
+	void value(double d);
+
+
+	void value(bool b);
+
+
+private:
+
+	enum Extended
+	{
+		EXT_NONE,
+		EXT_OID,
+		EXT_DATE,
+		EXT_BINARY,
+		EXT_LONG,
+		EXT_REGEX,
+		EXT_CODE,
+		EXT_TIMESTAMP,
+		EXT_MINKEY,
+		EXT_MAXKEY
+	};
+
+
+	struct Level
+	{
+		std::size_t start;
+			/// Offset of the length prefix.
+		bool isArray;
+		bool isSequence;
+			/// A top-level array of documents.
+		bool pending;
+			/// An embedded object that isn't written yet, because it
+			/// might turn out to be extended JSON.
+		int index;
+			/// Next element name in an array.
+		std::string name;
+			/// Element name of a pending object.
+	};
+
+
+	struct Captured
+		/// A value inside an extended JSON object.
+	{
+		std::string key;
+		std::string text;
+		double number;
+		bool isNumber;
+	};
+
+
+	static Extended extended(const std::string& k);
+
+
+	void beginElement(unsigned char type);
+		/// Writes the type and name of the next element.
+
+
+	void writeHeader(unsigned char type, const std::string& name);
+
+
+	void flushPending();
+		/// Writes the embedded document header of a pending object.
+
+
+	void openDocument();
+		/// Writes a length placeholder and pushes a Level for it.
+
+
+	void closeDocument();
+		/// Writes the terminating 0x00 and patches the length.
+
+
+	void capture(const std::string& text, double number, bool isNumber);
+
+
+	const Captured* captured(const char* key) const;
+
+
+	void writeExtended(const std::string& name);
+		/// Writes the element for the captured extended JSON object.
+
+
+	BSONOutputStream& _bson;
+
+
+	BinaryWriter _writer;
+
+
+	std::vector<Level> _levels;
+
+
+	std::string _key;
+
+
+	std::size_t _documents;
+
+
+	Extended _extended;
+		/// EXT_NONE unless an extended JSON object is being read.
+
+
+	int _captureDepth;
+
+
+	std::vector<Captured> _captured;
+
+
+	JSONToBSON(const JSONToBSON&);
+	JSONToBSON& operator = (const JSONToBSON&);
+};
+
+
+inline std::size_t JSONToBSON::documents() const
+{
+	return _documents;
+}
+
+
+}} // Poco::MongoDB
+
+#endif //_MongoDB_JSONToBSON_included
@@ -6,59 +6,76 @@
 
 namespace Poco
 {
-namespace MongoDB
-{
-	
-	
+
+
 template<>
-class PoolableObjectFactory<Connection, Connection::Ptr>
+class PoolableObjectFactory<MongoDB::Connection, MongoDB::Connection::Ptr>
+	/// PoolableObjectFactory specialisation for Connection. New connections are
+	/// connected to the given server address.
+	///
+	/// Validation is done without network I/O, with Connection::isConnected(). A
+	/// connection that was left in pipelined mode with requests in flight is not
+	/// returned to a pool.
 {
 public:
-	PoolableObjectFactory(Net::SocketAddress& address)
+	PoolableObjectFactory(const Net::SocketAddress& address)
 		: _address(address)
 	{
 	}
 
-	
+
 	PoolableObjectFactory(const std::string& address)
 		: _address(address)
 	{
 	}
 
 
-	Connection::Ptr createObject()
+	MongoDB::Connection::Ptr createObject()
+	{
+		return new MongoDB::Connection(_address);
+	}
+
+
+	bool validateObject(MongoDB::Connection::Ptr pObject)
 	{
-		return new Connection(_address);
+		return pObject->isConnected() && pObject->pendingRequests() == 0;
 	}
-	
-	
-	bool validateObject(Connection::Ptr pObject)
+
+
+	void activateObject(MongoDB::Connection::Ptr pObject)
 	{
-		return true;
 	}
-	
 
-	void activateObject(Connection::Ptr pObject)
+
+	void deactivateObject(MongoDB::Connection::Ptr pObject)
 	{
 	}
-	
 
-	void deactivateObject(Connection::Ptr pObject)
+
+	void destroyObject(MongoDB::Connection::Ptr pObject)
 	{
+		try
+		{
+			pObject->disconnect();
+		}
+		catch (...)
+		{
+		}
 	}
-	
 
-	void destroyObject(Connection::Ptr pObject)
+
+	const Net::SocketAddress& address() const
 	{
+		return _address;
 	}
-	
+
 
 private:
 
 	Net::SocketAddress _address;
 };
-	
-	
-}} // Poco::MongoDB
+
+
+} // Poco
 
 #endif //_MongoDB_PoolableConnectionFactory_included
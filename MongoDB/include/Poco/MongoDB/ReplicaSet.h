@@ -38,9 +38,16 @@
 #ifndef _MongoDB_ReplicaSet_h
 #define _MongoDB_ReplicaSet_h
 
+#include <map>
 #include <vector>
 #include "Poco/Net/SocketAddress.h"
 #include "Poco/MongoDB/Connection.h"
+#include "Poco/MongoDB/ConnectionPool.h"
+#include "Poco/MongoDB/QueryRequest.h"
+#include "Poco/RWLock.h"
+#include "Poco/Event.h"
+#include "Poco/Thread.h"
+#include "Poco/RunnableAdapter.h"
 
 namespace Poco
 {
@@ -48,23 +55,165 @@ namespace MongoDB
 {
 
 class MongoDB_API ReplicaSet
+	/// Tracks the members of a replica set and keeps a ConnectionPool
+	/// for each of them.
+	///
+	/// refresh() sends isMaster to every known member over a dedicated
+	/// monitor connection, records whether the member is the primary or
+	/// a secondary, smooths the measured round-trip time and adds the
+	/// members reported in the "hosts" field. It then maintains the
+	/// pools of the reachable members. start() runs refresh() once and
+	/// then periodically from a background thread.
+	///
+	/// primary(), secondary() and pool() only look at the cached
+	/// topology, so together with ConnectionPool::borrowConnection()
+	/// acquiring a connection does no network I/O.
+	///
+	/// Usage:
+	///     ReplicaSet rs(seeds);
+	///     rs.start();
+	///     PooledConnection connection(rs.pool(query));
+	///     connection->sendRequest(query, response);
 {
 public:
+	struct Member
+		/// A replica set member as last seen by the monitor.
+	{
+		Net::SocketAddress address;
+		bool reachable;
+		bool primary;
+		bool secondary;
+		Timestamp::TimeDiff roundTripTime;
+			/// Smoothed round-trip time of isMaster in microseconds,
+			/// or -1 if it has not been measured yet.
+	};
+
+
+	enum
+	{
+		DEFAULT_MONITOR_INTERVAL = 10000
+	};
+
+
 	ReplicaSet(const std::vector<Net::SocketAddress>& addresses);
+		/// Creates the ReplicaSet with the given seed addresses. No
+		/// connection is made before refresh() or start().
 
 
 	virtual ~ReplicaSet();
+		/// Stops the monitor.
+
+
+	void setPoolSize(std::size_t minSize, std::size_t maxSize);
+		/// Sets the size of the pools created for newly found members.
+		/// The default is 1 to 16 connections.
+
+
+	void setIdleTimeout(int seconds);
+		/// Sets the idle timeout of the pools created for newly found
+		/// members. The default is 60 seconds.
+
+
+	void setMonitorInterval(long milliseconds);
+		/// Sets the interval between two runs of refresh() once the
+		/// monitor has been started.
+
+
+	void start();
+		/// Runs refresh() and starts the monitor thread.
+
+
+	void stop();
+		/// Stops the monitor thread.
+
+
+	void refresh();
+		/// Updates the topology and maintains the pools, see above.
+
+
+	ConnectionPool::Ptr primary() const;
+		/// Returns the pool of the primary. Throws a NotFoundException
+		/// if no primary is known.
+
+
+	ConnectionPool::Ptr secondary() const;
+		/// Returns the pool of the reachable secondary with the lowest
+		/// round-trip time, or the pool of the primary if there is no
+		/// reachable secondary.
+
+
+	ConnectionPool::Ptr pool(const QueryRequest& request) const;
+		/// Returns secondary() for a query with QUERY_SLAVE_OK set and
+		/// primary() otherwise.
+
+
+	std::vector<Member> members() const;
+		/// Returns the known members.
 
 
 	Connection::Ptr findMaster();
+		/// Returns a new connection to the primary, or a null pointer
+		/// if there is none. The topology is refreshed first if no
+		/// primary is known.
 
 private:
 
-	Connection::Ptr isMaster(const Net::SocketAddress& host);
+	struct MemberState
+	{
+		Member              member;
+		Connection::Ptr     pMonitor;
+		ConnectionPool::Ptr pPool;
+	};
+
+	typedef std::map<std::string, MemberState> MemberMap;
+
+
+	bool addMember(const Net::SocketAddress& address);
+		/// Adds a member unless it is already known. Must be called
+		/// with _lock locked for writing.
+
+
+	void monitor();
+		/// Monitor thread: runs refresh() every _monitorInterval.
 
 
 	std::vector<Net::SocketAddress> _addresses;
+
+
+	MemberMap _members;
+
+
+	std::string _primary;
+
+
+	mutable RWLock _lock;
+
+
+	std::size_t _minPoolSize;
+
+
+	std::size_t _maxPoolSize;
+
+
+	int _idleTimeout;
+
+
+	long _monitorInterval;
+
+
+	Event _stopMonitor;
+
+
+	Thread _monitorThread;
+
+
+	RunnableAdapter<ReplicaSet> _monitorAdapter;
+
+
+	ReplicaSet(const ReplicaSet&);
+	ReplicaSet& operator = (const ReplicaSet&);
 };
 
-#endif // _MongoDB_ReplicaSet_h
 }} // Poco::MongoDB
+
+#endif // _MongoDB_ReplicaSet_h
@@ -40,6 +40,8 @@
 
 #include "Poco/MongoDB/MongoDB.h"
 #include "Poco/MongoDB/Message.h"
+#include "Poco/MongoDB/BSONOutputStream.h"
+#include "Poco/Net/StreamSocket.h"
 
 #include <ostream>
 
@@ -63,7 +65,17 @@ public:
 
 	void send(std::ostream& ostr);
 		/// Sends the request to stream
-		
+
+
+	void send(Net::StreamSocket& socket);
+		/// Sends the request to the socket with a single sendBytes() call.
+
+
+	void build(BSONOutputStream& bson);
+		/// Appends the complete message (header and body) to bson.
+		/// The body is written in a single pass; the message length
+		/// in the header is patched last.
+
 
 protected:
 
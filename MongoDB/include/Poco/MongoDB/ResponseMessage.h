@@ -41,6 +41,8 @@
 #include "Poco/MongoDB/MongoDB.h"
 #include "Poco/MongoDB/Message.h"
 #include "Poco/MongoDB/Document.h"
+#include "Poco/MongoDB/DocumentView.h"
+#include "Poco/Buffer.h"
 
 #include <istream>
 
@@ -54,6 +56,15 @@ class MongoDB_API ResponseMessage : public Message
 	/// Class that represents a response (OP_REPLY) from MongoDB
 {
 public:
+	enum ResponseFlags
+	{
+		RESPONSE_CURSOR_NOT_FOUND = 1,
+		RESPONSE_QUERY_FAILURE = 2,
+		RESPONSE_SHARD_CONFIG_STALE = 4,
+		RESPONSE_AWAIT_CAPABLE = 8
+	};
+
+
 	ResponseMessage();
 		/// Constructor
 	
@@ -64,19 +75,61 @@ public:
 
 	void read(std::istream& istr);
 		/// Reads the response from the stream
+
+
+	void readBody(std::istream& istr);
+		/// Reads the response from the stream when its header has
+		/// already been read into header(). This is used to dispatch
+		/// replies on a pipelined Connection by their responseTo id.
 		
 
 	Document::Vector& documents();
-		/// Returns the retrieved documents
-		
+		/// Returns the retrieved documents. This is empty when
+		/// the response was read with readViews enabled.
+
+
+	DocumentView::Vector& views();
+		/// Returns views on the retrieved documents. This is only
+		/// filled when the response was read with readViews enabled.
+		/// The views refer to a buffer owned by this ResponseMessage
+		/// and are invalidated by the next read() or clear().
+
+
+	void readViews(bool flag);
+		/// When flag is true, read() keeps the raw documents in a single
+		/// buffer and returns DocumentViews on it instead of decoding
+		/// every document into a Document. The buffer is reused for
+		/// subsequent reads, so iterating a cursor with the same
+		/// ResponseMessage does not allocate once the buffer is large enough.
+
+
+	bool readViews() const;
+		/// Returns true if read() returns views.
+
 
 	Int64 cursorID() const;
 		/// Returns the cursor id
 
+
+	Int32 responseFlags() const;
+		/// Returns the response flags (see ResponseFlags)
+
+
+	Int32 startingFrom() const;
+		/// Returns the position of the first returned document in the cursor
+
+
+	Int32 numberReturned() const;
+		/// Returns the number of returned documents
+
 	void clear();
 		/// Clears the response
 
 private:
+
+	void readViewBody(std::istream& istr);
+		/// Reads the documents into _buffer and creates the views.
+
 	
 	Int32 _responseFlags;
 	
@@ -91,6 +144,15 @@ private:
 
 
 	Document::Vector _documents;
+
+
+	bool _readViews;
+
+
+	Buffer<char> _buffer;
+
+
+	DocumentView::Vector _views;
 };
 
 
@@ -100,12 +162,48 @@ inline Document::Vector& ResponseMessage::documents()
 }
 
 
+inline DocumentView::Vector& ResponseMessage::views()
+{
+	return _views;
+}
+
+
+inline void ResponseMessage::readViews(bool flag)
+{
+	_readViews = flag;
+}
+
+
+inline bool ResponseMessage::readViews() const
+{
+	return _readViews;
+}
+
+
 inline Int64 ResponseMessage::cursorID() const
 {
 	return _cursorID;
 }
 
 
+inline Int32 ResponseMessage::responseFlags() const
+{
+	return _responseFlags;
+}
+
+
+inline Int32 ResponseMessage::startingFrom() const
+{
+	return _startingFrom;
+}
+
+
+inline Int32 ResponseMessage::numberReturned() const
+{
+	return _numberReturned;
+}
+
+
 }} // Namespace Poco::MongoDB
 
 #endif //_MongoDB_ResponseMessage_included
@@ -0,0 +1,535 @@
+//
+// AsyncClient.cpp
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  AsyncClient
+//
+// Implementation of the AsyncClient class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "Poco/MongoDB/AsyncClient.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
+#include "Poco/Exception.h"
+
+#include <map>
+
+#if POCO_OS == POCO_OS_LINUX
+#define MONGODB_ASYNC_EPOLL
+#include <sys/epoll.h>
+#elif defined(POCO_HAVE_FD_POLL)
+#include <poll.h>
+#endif
+
+#if defined(POCO_OS_FAMILY_UNIX)
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+namespace Poco
+{
+namespace MongoDB
+{
+
+
+class AsyncClient::Loop: public Runnable
+	/// An event loop thread. Its connections and their registration
+	/// with the poller are only touched by the loop thread; other
+	/// threads hand over new and changed connections through _added
+	/// and _changes and wake the loop up with a byte on a pipe.
+{
+public:
+	Loop();
+	~Loop();
+	void add(const AsyncConnection::Ptr& pConnection);
+	void update(AsyncConnection* pConnection);
+	std::size_t connections() const;
+	void run();
+
+private:
+	struct Entry
+	{
+		AsyncConnection::Ptr pConnection;
+		bool registered;
+		bool writing;
+	};
+
+	typedef std::map<AsyncConnection*, Entry> EntryMap;
+
+	void wakeUp();
+	void applyChanges();
+	void watch(EntryMap::iterator it);
+	void handle(EntryMap::iterator it, bool readable, bool writable, bool error);
+	void remove(EntryMap::iterator it, const Exception& exc);
+	enum Control
+	{
+		CONTROL_ADD,
+		CONTROL_MODIFY,
+		CONTROL_REMOVE
+	};
+
+	void control(Control op, AsyncConnection& connection, bool writing);
+	int wait(std::vector<AsyncConnection*>& ready, std::vector<int>& events);
+
+	enum
+	{
+		EVENT_READ = 1,
+		EVENT_WRITE = 2,
+		EVENT_ERROR = 4
+	};
+
+	int _pipe[2];
+#if defined(MONGODB_ASYNC_EPOLL)
+	int _epoll;
+	std::vector<epoll_event> _events;
+#elif defined(POCO_HAVE_FD_POLL)
+	std::vector<pollfd> _pollfds;
+	std::vector<AsyncConnection*> _polled;
+#endif
+	EntryMap _entries;
+	mutable Poco::FastMutex _mutex;
+	std::vector<AsyncConnection::Ptr> _added;
+	std::vector<AsyncConnection*> _changes;
+	std::size_t _count;
+	bool _stop;
+	Poco::Thread _thread;
+};
+
+
+AsyncClient::Loop::Loop()
+	: _count(0)
+	, _stop(false)
+{
+#if defined(MONGODB_ASYNC_EPOLL) || defined(POCO_HAVE_FD_POLL)
+	if ( ::pipe(_pipe) != 0 )
+	{
+		throw SystemException("Cannot create event loop pipe");
+	}
+	::fcntl(_pipe[0], F_SETFL, ::fcntl(_pipe[0], F_GETFL) | O_NONBLOCK);
+	::fcntl(_pipe[1], F_SETFL, ::fcntl(_pipe[1], F_GETFL) | O_NONBLOCK);
+#else
+	throw NotImplementedException("AsyncClient needs epoll or poll()");
+#endif
+
+#if defined(MONGODB_ASYNC_EPOLL)
+	_epoll = ::epoll_create(256);
+	if ( _epoll < 0 )
+	{
+		::close(_pipe[0]);
+		::close(_pipe[1]);
+		throw SystemException("Cannot create epoll instance");
+	}
+	_events.resize(256);
+	epoll_event event;
+	event.events = EPOLLIN;
+	event.data.ptr = 0;
+	::epoll_ctl(_epoll, EPOLL_CTL_ADD, _pipe[0], &event);
+#endif
+
+	_thread.start(*this);
+}
+
+
+AsyncClient::Loop::~Loop()
+{
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		_stop = true;
+		wakeUp();
+	}
+	_thread.join();
+
+#if defined(MONGODB_ASYNC_EPOLL)
+	::close(_epoll);
+#endif
+#if defined(MONGODB_ASYNC_EPOLL) || defined(POCO_HAVE_FD_POLL)
+	::close(_pipe[0]);
+	::close(_pipe[1]);
+#endif
+}
+
+
+void AsyncClient::Loop::add(const AsyncConnection::Ptr& pConnection)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_added.push_back(pConnection);
+	++_count;
+	if ( _changes.empty() )
+	{
+		wakeUp();
+	}
+	_changes.push_back(_added.back().get());
+}
+
+
+void AsyncClient::Loop::update(AsyncConnection* pConnection)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	// Only the first change since the loop last looked needs a wakeup.
+	if ( _changes.empty() )
+	{
+		wakeUp();
+	}
+	_changes.push_back(pConnection);
+}
+
+
+std::size_t AsyncClient::Loop::connections() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _count;
+}
+
+
+void AsyncClient::Loop::wakeUp()
+{
+	char c = 1;
+	while ( ::write(_pipe[1], &c, 1) < 0 && errno == EINTR )
+	{
+	}
+}
+
+
+void AsyncClient::Loop::run()
+{
+	std::vector<AsyncConnection*> ready;
+	std::vector<int> events;
+	for (;;)
+	{
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if ( _stop )
+			{
+				break;
+			}
+		}
+		applyChanges();
+
+		wait(ready, events);
+		for(std::size_t i = 0; i < ready.size(); ++i)
+		{
+			EntryMap::iterator it = _entries.find(ready[i]);
+			if ( it != _entries.end() )
+			{
+				handle(it, (events[i] & EVENT_READ) != 0, (events[i] & EVENT_WRITE) != 0, (events[i] & EVENT_ERROR) != 0);
+			}
+		}
+	}
+
+	applyChanges();
+	IOException exc("MongoDB AsyncClient stopped");
+	while ( ! _entries.empty() )
+	{
+		remove(_entries.begin(), exc);
+	}
+}
+
+
+void AsyncClient::Loop::applyChanges()
+{
+	std::vector<AsyncConnection::Ptr> added;
+	std::vector<AsyncConnection*> changes;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		added.swap(_added);
+		changes.swap(_changes);
+	}
+
+	for(std::vector<AsyncConnection::Ptr>::iterator it = added.begin(); it != added.end(); ++it)
+	{
+		Entry entry;
+		entry.pConnection = *it;
+		entry.registered = false;
+		entry.writing = false;
+		_entries.insert(EntryMap::value_type(it->get(), entry));
+	}
+
+	// A connection may have been removed after the change was queued,
+	// so changes are looked up rather than dereferenced.
+	for(std::vector<AsyncConnection*>::iterator it = changes.begin(); it != changes.end(); ++it)
+	{
+		EntryMap::iterator entry = _entries.find(*it);
+		if ( entry != _entries.end() )
+		{
+			watch(entry);
+		}
+	}
+}
+
+
+void AsyncClient::Loop::watch(EntryMap::iterator it)
+{
+	Entry& entry = it->second;
+	AsyncConnection& connection = *entry.pConnection;
+	if ( connection.isClosed() )
+	{
+		IOException exc("Connection to " + connection.address().toString() + " closed");
+		remove(it, exc);
+		return;
+	}
+
+	bool writing = connection.wantsWrite();
+	try
+	{
+		if ( ! entry.registered )
+		{
+			control(CONTROL_ADD, connection, writing);
+			entry.registered = true;
+			entry.writing = writing;
+		}
+		else if ( writing != entry.writing )
+		{
+			control(CONTROL_MODIFY, connection, writing);
+			entry.writing = writing;
+		}
+	}
+	catch (Exception& exc)
+	{
+		remove(it, exc);
+	}
+}
+
+
+void AsyncClient::Loop::handle(EntryMap::iterator it, bool readable, bool writable, bool error)
+{
+	AsyncConnection& connection = *it->second.pConnection;
+	try
+	{
+		if ( writable || (error && ! readable) )
+		{
+			connection.onWritable();
+		}
+		if ( readable )
+		{
+			connection.onReadable();
+		}
+		else if ( error )
+		{
+			throw Net::ConnectionResetException(connection.address().toString());
+		}
+	}
+	catch (Exception& exc)
+	{
+		remove(it, exc);
+		return;
+	}
+	watch(it);
+}
+
+
+void AsyncClient::Loop::remove(EntryMap::iterator it, const Exception& exc)
+{
+	AsyncConnection::Ptr pConnection = it->second.pConnection;
+	if ( it->second.registered )
+	{
+		// Unregister before the socket is closed: its descriptor
+		// may be reused right away.
+		control(CONTROL_REMOVE, *pConnection, false);
+	}
+	_entries.erase(it);
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		--_count;
+	}
+	pConnection->fail(exc);
+}
+
+
+void AsyncClient::Loop::control(Control op, AsyncConnection& connection, bool writing)
+{
+#if defined(MONGODB_ASYNC_EPOLL)
+	epoll_event event;
+	event.events = EPOLLIN | (writing ? EPOLLOUT : 0);
+	event.data.ptr = &connection;
+	int ctl = op == CONTROL_ADD ? EPOLL_CTL_ADD : (op == CONTROL_MODIFY ? EPOLL_CTL_MOD : EPOLL_CTL_DEL);
+	if ( ::epoll_ctl(_epoll, ctl, connection.sockfd(), &event) != 0 && op != CONTROL_REMOVE )
+	{
+		throw SystemException("Cannot register socket with epoll");
+	}
+#else
+	// poll() gets the interest of every connection in wait().
+#endif
+}
+
+
+int AsyncClient::Loop::wait(std::vector<AsyncConnection*>& ready, std::vector<int>& events)
+{
+	ready.clear();
+	events.clear();
+	bool wakeup = false;
+
+#if defined(MONGODB_ASYNC_EPOLL)
+	int n = ::epoll_wait(_epoll, &_events[0], (int) _events.size(), -1);
+	for(int i = 0; i < n; ++i)
+	{
+		const epoll_event& event = _events[i];
+		if ( event.data.ptr == 0 )
+		{
+			wakeup = true;
+			continue;
+		}
+		int flags = 0;
+		if ( event.events & EPOLLIN ) flags |= EVENT_READ;
+		if ( event.events & EPOLLOUT ) flags |= EVENT_WRITE;
+		if ( event.events & (EPOLLERR | EPOLLHUP) ) flags |= EVENT_ERROR;
+		ready.push_back(static_cast<AsyncConnection*>(event.data.ptr));
+		events.push_back(flags);
+	}
+	if ( n == (int) _events.size() )
+	{
+		_events.resize(_events.size()*2);
+	}
+#elif defined(POCO_HAVE_FD_POLL)
+	_pollfds.resize(1);
+	_polled.resize(1);
+	_pollfds[0].fd = _pipe[0];
+	_pollfds[0].events = POLLIN;
+	_pollfds[0].revents = 0;
+	for(EntryMap::iterator it = _entries.begin(); it != _entries.end(); ++it)
+	{
+		if ( it->second.registered )
+		{
+			pollfd fd;
+			fd.fd = it->first->sockfd();
+			fd.events = POLLIN | (it->second.writing ? POLLOUT : 0);
+			fd.revents = 0;
+			_pollfds.push_back(fd);
+			_polled.push_back(it->first);
+		}
+	}
+	int n = ::poll(&_pollfds[0], _pollfds.size(), -1);
+	for(std::size_t i = 0; n > 0 && i < _pollfds.size(); ++i)
+	{
+		short revents = _pollfds[i].revents;
+		if ( revents == 0 )
+		{
+			continue;
+		}
+		if ( i == 0 )
+		{
+			wakeup = true;
+			continue;
+		}
+		int flags = 0;
+		if ( revents & POLLIN ) flags |= EVENT_READ;
+		if ( revents & POLLOUT ) flags |= EVENT_WRITE;
+		if ( revents & (POLLERR | POLLHUP | POLLNVAL) ) flags |= EVENT_ERROR;
+		ready.push_back(_polled[i]);
+		events.push_back(flags);
+	}
+#endif
+
+	if ( wakeup )
+	{
+		char buffer[256];
+		while ( ::read(_pipe[0], buffer, sizeof(buffer)) > 0 )
+		{
+		}
+	}
+	return (int) ready.size();
+}
+
+
+AsyncClient::AsyncClient(int threads)
+	: _next(0)
+{
+	poco_assert (threads > 0);
+
+	try
+	{
+		for(int i = 0; i < threads; ++i)
+		{
+			_loops.push_back(new Loop());
+		}
+	}
+	catch (...)
+	{
+		for(std::vector<Loop*>::iterator it = _loops.begin(); it != _loops.end(); ++it)
+		{
+			delete *it;
+		}
+		throw;
+	}
+}
+
+
+AsyncClient::~AsyncClient()
+{
+	for(std::vector<Loop*>::iterator it = _loops.begin(); it != _loops.end(); ++it)
+	{
+		delete *it;
+	}
+}
+
+
+AsyncConnection::Ptr AsyncClient::connect(const Net::SocketAddress& address)
+{
+	int loop;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		loop = _next;
+		_next = (_next + 1) % threads();
+	}
+
+	AsyncConnection::Ptr pConnection = new AsyncConnection(*this, loop, address);
+	_loops[loop]->add(pConnection);
+	return pConnection;
+}
+
+
+AsyncConnection::Ptr AsyncClient::connect(const std::string& hostAndPort)
+{
+	return connect(Net::SocketAddress(hostAndPort));
+}
+
+
+std::size_t AsyncClient::connections() const
+{
+	std::size_t count = 0;
+	for(std::vector<Loop*>::const_iterator it = _loops.begin(); it != _loops.end(); ++it)
+	{
+		count += (*it)->connections();
+	}
+	return count;
+}
+
+
+void AsyncClient::update(int loop, AsyncConnection* pConnection)
+{
+	_loops[loop]->update(pConnection);
+}
+
+
+} } // Poco::MongoDB
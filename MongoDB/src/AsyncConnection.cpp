@@ -0,0 +1,479 @@
+//
+// AsyncConnection.cpp
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  AsyncConnection
+//
+// Implementation of the AsyncConnection class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "Poco/MongoDB/AsyncConnection.h"
+#include "Poco/MongoDB/AsyncClient.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/MemoryStream.h"
+#include "Poco/BinaryReader.h"
+#include "Poco/ByteOrder.h"
+#include "Poco/ErrorHandler.h"
+
+#include <cstring>
+#include <algorithm>
+
+namespace Poco
+{
+namespace MongoDB
+{
+
+
+namespace
+{
+	const std::size_t INPUT_RESERVE = 64*1024;
+		/// Free space made available before every receive.
+
+	const Int32 MAX_MESSAGE_SIZE = 48*1024*1024;
+
+	int lastError()
+	{
+#if defined(POCO_OS_FAMILY_WINDOWS)
+		return WSAGetLastError();
+#else
+		return errno;
+#endif
+	}
+
+	bool wouldBlock(int error)
+	{
+		return error == POCO_EAGAIN || error == POCO_EWOULDBLOCK;
+	}
+}
+
+
+AsyncConnection::ResponseHandler::~ResponseHandler()
+{
+}
+
+
+AsyncConnection::AsyncConnection(AsyncClient& client, int loop, const Net::SocketAddress& address)
+	: _client(client)
+	, _loop(loop)
+	, _address(address)
+	, _sockfd(POCO_INVALID_SOCKET)
+	, _lastRequestID(0)
+	, _connecting(true)
+	, _writeScheduled(false)
+	, _pError(0)
+	, _pQueued(&_buffers[0])
+	, _pWriting(&_buffers[1])
+	, _written(0)
+	, _input(INPUT_RESERVE)
+	, _inputStart(0)
+	, _inputEnd(0)
+{
+	try
+	{
+		_socket.connectNB(address);
+		_socket.setNoDelay(true);
+		_sockfd = _socket.impl()->sockfd();
+	}
+	catch (Exception& exc)
+	{
+		// Reported like a connect that fails later; the event loop
+		// removes the connection.
+		_pError = exc.clone();
+	}
+}
+
+
+AsyncConnection::~AsyncConnection()
+{
+	delete _pError;
+}
+
+
+AsyncConnection::AsyncResponse AsyncConnection::sendRequestAsync(RequestMessage& request, bool readViews)
+{
+	Pending pending;
+	pending.pResult = new ResultHolder();
+	pending.pResult->data(new ResponseMessage());
+	pending.pResult->data().readViews(readViews);
+	pending.pHandler = 0;
+	pending.readViews = readViews;
+	queue(request, &pending);
+	return AsyncResponse(pending.pResult.duplicate());
+}
+
+
+void AsyncConnection::sendRequest(RequestMessage& request, ResponseHandler& handler, bool readViews)
+{
+	Pending pending;
+	pending.pHandler = &handler;
+	pending.readViews = readViews;
+	queue(request, &pending);
+}
+
+
+void AsyncConnection::sendRequest(RequestMessage& request)
+{
+	queue(request, 0);
+}
+
+
+void AsyncConnection::queue(RequestMessage& request, Pending* pPending)
+{
+	if ( pPending )
+	{
+		MessageHeader::OpCode opCode = request.header().opCode();
+		if ( opCode != MessageHeader::Query && opCode != MessageHeader::GetMore )
+		{
+			throw InvalidArgumentException("Only query and getmore requests have a response");
+		}
+	}
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if ( _pError )
+	{
+		_pError->rethrow();
+	}
+
+	request.header().requestID(++_lastRequestID);
+	request.build(*_pQueued);
+	if ( pPending )
+	{
+		_pending.insert(PendingMap::value_type(_lastRequestID, *pPending));
+	}
+
+	if ( _connecting || _writeScheduled )
+	{
+		// The event loop writes the output when the socket is writable.
+		return;
+	}
+
+	try
+	{
+		if ( flushOutput() )
+		{
+			return;
+		}
+		_writeScheduled = true;
+	}
+	catch (Exception& exc)
+	{
+		// The event loop fails the outstanding requests, including this one.
+		_pError = exc.clone();
+	}
+	_client.update(_loop, this);
+}
+
+
+bool AsyncConnection::flushOutput()
+{
+	for (;;)
+	{
+		if ( _written == _pWriting->size() )
+		{
+			_pWriting->reset();
+			_written = 0;
+			if ( _pQueued->size() == 0 )
+			{
+				return true;
+			}
+			std::swap(_pQueued, _pWriting);
+		}
+
+		int flags = 0;
+#if defined(MSG_NOSIGNAL)
+		flags |= MSG_NOSIGNAL;
+#endif
+		int sent = ::send(_sockfd, _pWriting->data() + _written, (int) (_pWriting->size() - _written), flags);
+		if ( sent < 0 )
+		{
+			int error = lastError();
+			if ( wouldBlock(error) )
+			{
+				return false;
+			}
+			if ( error != POCO_EINTR )
+			{
+				throw IOException("Cannot send request to " + _address.toString(), error);
+			}
+		}
+		else
+		{
+			_written += sent;
+		}
+	}
+}
+
+
+void AsyncConnection::onWritable()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if ( _connecting )
+	{
+		int error = _socket.impl()->socketError();
+		if ( error != 0 )
+		{
+			throw Net::ConnectionRefusedException(_address.toString(), error);
+		}
+		_connecting = false;
+		_writeScheduled = true;
+	}
+	if ( _writeScheduled && flushOutput() )
+	{
+		_writeScheduled = false;
+	}
+}
+
+
+void AsyncConnection::onReadable()
+{
+	if ( _input.size() - _inputEnd < INPUT_RESERVE )
+	{
+		if ( _inputStart > 0 )
+		{
+			std::memmove(&_input[0], &_input[_inputStart], _inputEnd - _inputStart);
+			_inputEnd -= _inputStart;
+			_inputStart = 0;
+		}
+		if ( _input.size() - _inputEnd < INPUT_RESERVE )
+		{
+			_input.resize(_inputEnd + INPUT_RESERVE);
+		}
+	}
+
+	int received = ::recv(_sockfd, &_input[_inputEnd], (int) (_input.size() - _inputEnd), 0);
+	if ( received < 0 )
+	{
+		int error = lastError();
+		if ( wouldBlock(error) || error == POCO_EINTR )
+		{
+			return;
+		}
+		throw IOException("Cannot receive reply from " + _address.toString(), error);
+	}
+	if ( received == 0 )
+	{
+		throw Net::ConnectionResetException("Connection closed by " + _address.toString());
+	}
+	_inputEnd += received;
+
+	// Hand out every complete message. A message that is still incomplete
+	// gets room for its full length before the next receive.
+	while ( _inputEnd - _inputStart >= 4 )
+	{
+		Int32 length;
+		std::memcpy(&length, &_input[_inputStart], 4);
+		length = ByteOrder::fromLittleEndian(length);
+		if ( length < MSG_HEADER_SIZE + 20 || length > MAX_MESSAGE_SIZE )
+		{
+			throw DataFormatException("Invalid reply message length");
+		}
+		if ( _inputEnd - _inputStart < (std::size_t) length )
+		{
+			if ( _input.size() - _inputStart < (std::size_t) length )
+			{
+				_input.resize(_inputStart + length + INPUT_RESERVE);
+			}
+			break;
+		}
+		dispatch(&_input[_inputStart], length);
+		_inputStart += length;
+	}
+	if ( _inputStart == _inputEnd )
+	{
+		_inputStart = 0;
+		_inputEnd = 0;
+	}
+}
+
+
+void AsyncConnection::dispatch(const char* message, std::size_t length)
+{
+	Poco::MemoryInputStream istr(message, length);
+	BinaryReader reader(istr, BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
+	_response.header().read(reader);
+
+	Pending pending;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		PendingMap::iterator it = _pending.find(_response.header().responseTo());
+		if ( it == _pending.end() )
+		{
+			return;
+		}
+		pending = it->second;
+		_pending.erase(it);
+	}
+
+	ResponseMessage* pResponse = pending.pHandler ? &_response : &pending.pResult->data();
+	if ( pResponse != &_response )
+	{
+		pResponse->header() = _response.header();
+	}
+	pResponse->readViews(pending.readViews);
+	try
+	{
+		pResponse->readBody(istr);
+	}
+	catch (Exception& exc)
+	{
+		// The message length is known, so only this reply is lost.
+		if ( pending.pHandler )
+		{
+			try
+			{
+				pending.pHandler->onError(exc);
+			}
+			catch (...)
+			{
+				ErrorHandler::handle();
+			}
+		}
+		else
+		{
+			pending.pResult->error(exc);
+			pending.pResult->notify();
+		}
+		return;
+	}
+
+	if ( pending.pHandler )
+	{
+		try
+		{
+			pending.pHandler->onResponse(*pResponse);
+		}
+		catch (Exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (...)
+		{
+			ErrorHandler::handle();
+		}
+	}
+	else
+	{
+		pending.pResult->notify();
+	}
+}
+
+
+void AsyncConnection::fail(const Exception& exc)
+{
+	PendingMap pending;
+	Exception* pError;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if ( _pError == 0 )
+		{
+			_pError = exc.clone();
+		}
+		pError = _pError->clone();
+		pending.swap(_pending);
+		try
+		{
+			_socket.close();
+		}
+		catch (Exception&)
+		{
+		}
+	}
+
+	for(PendingMap::iterator it = pending.begin(); it != pending.end(); ++it)
+	{
+		if ( it->second.pHandler )
+		{
+			try
+			{
+				it->second.pHandler->onError(*pError);
+			}
+			catch (...)
+			{
+				ErrorHandler::handle();
+			}
+		}
+		else
+		{
+			it->second.pResult->error(*pError);
+			it->second.pResult->notify();
+		}
+	}
+	delete pError;
+}
+
+
+void AsyncConnection::close()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if ( _pError == 0 )
+	{
+		_pError = new IOException("Connection to " + _address.toString() + " closed");
+		_client.update(_loop, this);
+	}
+}
+
+
+std::size_t AsyncConnection::pendingRequests() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _pending.size();
+}
+
+
+bool AsyncConnection::isConnected() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _pError == 0;
+}
+
+
+bool AsyncConnection::wantsWrite() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _connecting || _writeScheduled;
+}
+
+
+bool AsyncConnection::isClosed() const
+{
+	return ! isConnected();
+}
+
+
+} } // Poco::MongoDB
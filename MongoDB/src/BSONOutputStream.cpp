@@ -0,0 +1,148 @@
+//
+// BSONOutputStream.cpp
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  BSONOutputStream
+//
+// Implementation of the BSONOutputStream class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "Poco/MongoDB/BSONOutputStream.h"
+#include "Poco/ByteOrder.h"
+#include "Poco/Bugcheck.h"
+
+#include <cstring>
+
+namespace Poco {
+namespace MongoDB {
+
+
+BSONStreamBuf::BSONStreamBuf(std::size_t initialCapacity) : _buffer(initialCapacity > 0 ? initialCapacity : 1)
+{
+	setp(&_buffer[0], &_buffer[0] + _buffer.size());
+}
+
+
+BSONStreamBuf::~BSONStreamBuf()
+{
+}
+
+
+void BSONStreamBuf::reset()
+{
+	setp(&_buffer[0], &_buffer[0] + _buffer.size());
+}
+
+
+void BSONStreamBuf::patch(std::size_t offset, const char* bytes, std::size_t length)
+{
+	poco_assert (offset + length <= size());
+
+	std::memcpy(&_buffer[offset], bytes, length);
+}
+
+
+void BSONStreamBuf::grow(std::size_t minCapacity)
+{
+	std::size_t used = size();
+	std::size_t capacity = _buffer.size() * 2;
+	if (capacity < minCapacity) capacity = minCapacity;
+	_buffer.resize(capacity);
+	setp(&_buffer[0], &_buffer[0] + capacity);
+	pbump(static_cast<int>(used));
+}
+
+
+BSONStreamBuf::int_type BSONStreamBuf::overflow(int_type c)
+{
+	if (traits_type::eq_int_type(c, traits_type::eof()))
+		return traits_type::not_eof(c);
+
+	grow(size() + 1);
+	*pptr() = traits_type::to_char_type(c);
+	pbump(1);
+	return c;
+}
+
+
+std::streamsize BSONStreamBuf::xsputn(const char* s, std::streamsize n)
+{
+	if (n <= 0) return 0;
+
+	std::size_t length = static_cast<std::size_t>(n);
+	if (static_cast<std::size_t>(epptr() - pptr()) < length)
+	{
+		grow(size() + length);
+	}
+	std::memcpy(pptr(), s, length);
+	pbump(static_cast<int>(length));
+	return n;
+}
+
+
+BSONIOS::BSONIOS(std::size_t initialCapacity) : _buf(initialCapacity)
+{
+	poco_ios_init(&_buf);
+}
+
+
+BSONIOS::~BSONIOS()
+{
+}
+
+
+BSONOutputStream::BSONOutputStream(std::size_t initialCapacity) :
+	BSONIOS(initialCapacity),
+	std::ostream(&_buf)
+{
+}
+
+
+BSONOutputStream::~BSONOutputStream()
+{
+}
+
+
+void BSONOutputStream::reset()
+{
+	_buf.reset();
+	clear();
+}
+
+
+void BSONOutputStream::patch(std::size_t offset, Int32 value)
+{
+	Int32 le = ByteOrder::toLittleEndian(value);
+	_buf.patch(offset, reinterpret_cast<const char*>(&le), sizeof(le));
+}
+
+
+}} // Namespace Poco::MongoDB
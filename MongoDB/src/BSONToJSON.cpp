@@ -0,0 +1,339 @@
+//
+// BSONToJSON.cpp
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  BSONToJSON
+//
+// Implementation of the BSONToJSON class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "Poco/MongoDB/BSONToJSON.h"
+#include "Poco/ByteOrder.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Exception.h"
+
+#include <cstring>
+
+namespace Poco
+{
+namespace MongoDB
+{
+
+
+namespace
+{
+	Int32 readInt32(const char* p)
+	{
+		Int32 value;
+		std::memcpy(&value, p, sizeof(value));
+		return ByteOrder::fromLittleEndian(value);
+	}
+
+	Int64 readInt64(const char* p)
+	{
+		Int64 value;
+		std::memcpy(&value, p, sizeof(value));
+		return ByteOrder::fromLittleEndian(value);
+	}
+
+	const char* need(const char* pos, const char* end, std::size_t size)
+		/// Returns pos + size, or throws if there are less than size bytes.
+	{
+		if ( std::size_t(end - pos) < size )
+		{
+			throw DataFormatException("Truncated BSON element");
+		}
+		return pos + size;
+	}
+
+	const char* cstringEnd(const char* pos, const char* end)
+		/// Returns the position of the 0x00 terminating the cstring at pos.
+	{
+		const char* nul = static_cast<const char*>(std::memchr(pos, 0, end - pos));
+		if ( nul == 0 )
+		{
+			throw DataFormatException("Unterminated BSON cstring");
+		}
+		return nul;
+	}
+
+	const char* stringValue(const char* pos, const char* end, std::size_t& length)
+		/// Returns the characters of the BSON string at pos.
+	{
+		need(pos, end, 4);
+		Int32 size = readInt32(pos);
+		if ( size < 1 || size > end - pos - 4 || pos[4 + size - 1] != '\0' )
+		{
+			throw DataFormatException("Invalid BSON string");
+		}
+		length = size - 1;
+		return pos + 4;
+	}
+
+	const char HEX[] = "0123456789abcdef";
+
+	const char BASE64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	void appendBase64(std::string& str, const unsigned char* data, std::size_t size)
+	{
+		std::size_t i = 0;
+		for(; i + 2 < size; i += 3)
+		{
+			str += BASE64[data[i] >> 2];
+			str += BASE64[((data[i] & 0x03) << 4) | (data[i + 1] >> 4)];
+			str += BASE64[((data[i + 1] & 0x0F) << 2) | (data[i + 2] >> 6)];
+			str += BASE64[data[i + 2] & 0x3F];
+		}
+		if ( i + 1 == size )
+		{
+			str += BASE64[data[i] >> 2];
+			str += BASE64[(data[i] & 0x03) << 4];
+			str.append("==", 2);
+		}
+		else if ( i + 2 == size )
+		{
+			str += BASE64[data[i] >> 2];
+			str += BASE64[((data[i] & 0x03) << 4) | (data[i + 1] >> 4)];
+			str += BASE64[(data[i + 1] & 0x0F) << 2];
+			str += '=';
+		}
+	}
+}
+
+
+BSONToJSON::BSONToJSON(JSON::Writer& writer)
+	: _writer(writer)
+{
+}
+
+
+BSONToJSON::~BSONToJSON()
+{
+}
+
+
+std::size_t BSONToJSON::write(const char* data, std::size_t available)
+{
+	return writeDocument(data, data + available, false) - data;
+}
+
+
+void BSONToJSON::write(const DocumentView& view)
+{
+	writeDocument(view.data(), view.data() + view.size(), false);
+}
+
+
+const char* BSONToJSON::writeDocument(const char* pos, const char* end, bool isArray)
+{
+	need(pos, end, 5);
+	Int32 size = readInt32(pos);
+	if ( size < 5 || size > end - pos || pos[size - 1] != '\0' )
+	{
+		throw DataFormatException("Invalid BSON document size");
+	}
+	const char* last = pos + size - 1;
+	pos += 4;
+
+	if ( isArray )
+	{
+		_writer.startArray();
+	}
+	else
+	{
+		_writer.startObject();
+	}
+
+	while ( pos < last )
+	{
+		unsigned char type = static_cast<unsigned char>(*pos++);
+		const char* name = pos;
+		pos = cstringEnd(pos, last);
+		if ( ! isArray )
+		{
+			_writer.key(name, pos - name);
+		}
+		pos = writeValue(type, pos + 1, last);
+	}
+
+	if ( isArray )
+	{
+		_writer.endArray();
+	}
+	else
+	{
+		_writer.endObject();
+	}
+	return last + 1;
+}
+
+
+const char* BSONToJSON::writeValue(unsigned char type, const char* pos, const char* end)
+{
+	switch(type)
+	{
+	case 0x01: // double
+		{
+			need(pos, end, 8);
+			Int64 bits = readInt64(pos);
+			double value;
+			std::memcpy(&value, &bits, sizeof(value));
+			_writer.value(value);
+			return pos + 8;
+		}
+	case 0x02: // string
+	case 0x0E: // symbol
+		{
+			std::size_t length;
+			const char* value = stringValue(pos, end, length);
+			_writer.value(value, length);
+			return value + length + 1;
+		}
+	case 0x03: // document
+	case 0x04: // array
+		return writeDocument(pos, end, type == 0x04);
+	case 0x05: // binary
+		{
+			need(pos, end, 5);
+			Int32 size = readInt32(pos);
+			if ( size < 0 || size > end - pos - 5 )
+			{
+				throw DataFormatException("Invalid BSON binary size");
+			}
+			unsigned char subtype = static_cast<unsigned char>(pos[4]);
+			_scratch.clear();
+			appendBase64(_scratch, reinterpret_cast<const unsigned char*>(pos + 5), size);
+			_writer.startObject();
+			_writer.key("$binary", 7);
+			_writer.value(_scratch.data(), _scratch.size());
+			char hex[2] = { HEX[subtype >> 4], HEX[subtype & 0x0F] };
+			_writer.key("$type", 5);
+			_writer.value(hex, 2);
+			_writer.endObject();
+			return pos + 5 + size;
+		}
+	case 0x06: // undefined
+	case 0x0A: // null
+		_writer.null();
+		return pos;
+	case 0x07: // ObjectId
+		{
+			need(pos, end, 12);
+			char hex[24];
+			for(int i = 0; i < 12; ++i)
+			{
+				unsigned char c = static_cast<unsigned char>(pos[i]);
+				hex[2*i] = HEX[c >> 4];
+				hex[2*i + 1] = HEX[c & 0x0F];
+			}
+			writeWrapper("$oid", hex, 24);
+			return pos + 12;
+		}
+	case 0x08: // bool
+		need(pos, end, 1);
+		_writer.value(*pos != 0);
+		return pos + 1;
+	case 0x09: // UTC datetime
+		need(pos, end, 8);
+		_writer.startObject();
+		_writer.key("$date", 5);
+		_writer.value(readInt64(pos));
+		_writer.endObject();
+		return pos + 8;
+	case 0x0B: // regex
+		{
+			const char* pattern = pos;
+			const char* patternEnd = cstringEnd(pattern, end);
+			const char* options = patternEnd + 1;
+			const char* optionsEnd = cstringEnd(options, end);
+			_writer.startObject();
+			_writer.key("$regex", 6);
+			_writer.value(pattern, patternEnd - pattern);
+			_writer.key("$options", 8);
+			_writer.value(options, optionsEnd - options);
+			_writer.endObject();
+			return optionsEnd + 1;
+		}
+	case 0x0D: // JavaScript code
+		{
+			std::size_t length;
+			const char* code = stringValue(pos, end, length);
+			writeWrapper("$code", code, length);
+			return code + length + 1;
+		}
+	case 0x10: // int32
+		need(pos, end, 4);
+		_writer.value(static_cast<int>(readInt32(pos)));
+		return pos + 4;
+	case 0x11: // timestamp
+		{
+			need(pos, end, 8);
+			UInt64 value = static_cast<UInt64>(readInt64(pos));
+			_writer.startObject();
+			_writer.key("$timestamp", 10);
+			_writer.startObject();
+			_writer.key("t", 1);
+			_writer.value(static_cast<Int64>(value >> 32));
+			_writer.key("i", 1);
+			_writer.value(static_cast<Int64>(value & 0xFFFFFFFF));
+			_writer.endObject();
+			_writer.endObject();
+			return pos + 8;
+		}
+	case 0x12: // int64
+		need(pos, end, 8);
+		_scratch.clear();
+		NumberFormatter::append(_scratch, readInt64(pos));
+		writeWrapper("$numberLong", _scratch.data(), _scratch.size());
+		return pos + 8;
+	case 0xFF: // MinKey
+	case 0x7F: // MaxKey
+		_writer.startObject();
+		_writer.key(type == 0xFF ? "$minKey" : "$maxKey", 7);
+		_writer.value(1);
+		_writer.endObject();
+		return pos;
+	default:
+		throw DataFormatException("Unsupported BSON type", NumberFormatter::formatHex(type));
+	}
+}
+
+
+void BSONToJSON::writeWrapper(const char* key, const char* text, std::size_t length)
+{
+	_writer.startObject();
+	_writer.key(key, std::strlen(key));
+	_writer.value(text, length);
+	_writer.endObject();
+}
+
+
+}} // Poco::MongoDB
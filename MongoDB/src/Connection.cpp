@@ -37,6 +37,7 @@
 #include <iostream>
 
 #include "Poco/Net/SocketStream.h"
+#include "Poco/Net/NetException.h"
 #include "Poco/MongoDB/Connection.h"
 
 namespace Poco
@@ -44,23 +45,23 @@ namespace Poco
 namespace MongoDB
 {
 
-Connection::Connection() : _address(), _socket()
+Connection::Connection() : _address(), _socket(), _lastRequestID(0), _pipelined(false), _pReaderError(0), _reader("MongoDB::Connection"), _readerAdapter(*this, &Connection::readResponses)
 {
 }
 
 
-Connection::Connection(const std::string& hostAndPort) : _address(hostAndPort), _socket()
+Connection::Connection(const std::string& hostAndPort) : _address(hostAndPort), _socket(), _lastRequestID(0), _pipelined(false), _pReaderError(0), _reader("MongoDB::Connection"), _readerAdapter(*this, &Connection::readResponses)
 {
 	connect();
 }
 
-Connection::Connection(const std::string& host, int port) : _address(host, port), _socket()
+Connection::Connection(const std::string& host, int port) : _address(host, port), _socket(), _lastRequestID(0), _pipelined(false), _pReaderError(0), _reader("MongoDB::Connection"), _readerAdapter(*this, &Connection::readResponses)
 {
 	connect();
 }
 
 
-Connection::Connection(const Net::SocketAddress& addrs) : _address(addrs), _socket()
+Connection::Connection(const Net::SocketAddress& addrs) : _address(addrs), _socket(), _lastRequestID(0), _pipelined(false), _pReaderError(0), _reader("MongoDB::Connection"), _readerAdapter(*this, &Connection::readResponses)
 {
 	connect();
 }
@@ -70,6 +71,7 @@ Connection::~Connection()
 {
 	try
 	{
+		stopReader();
 		_socket.close();
 	}
 	catch (...)
@@ -80,6 +82,7 @@ Connection::~Connection()
 
 void Connection::connect()
 {
+	stopReader();
 	_socket.connect(_address);
 }
 
@@ -105,21 +108,263 @@ void Connection::connect(const Net::SocketAddress& addrs)
 
 void Connection::disconnect()
 {
+	stopReader();
 	_socket.close();
 }
 
+bool Connection::isConnected() const
+{
+	if ( _pipelined )
+	{
+		Poco::FastMutex::ScopedLock lock(_pendingMutex);
+		return _pReaderError == 0;
+	}
+
+	if ( _socket.impl()->sockfd() == POCO_INVALID_SOCKET )
+	{
+		return false;
+	}
+
+	try
+	{
+		return ! _socket.poll(Poco::Timespan(0), Net::Socket::SELECT_READ | Net::Socket::SELECT_ERROR);
+	}
+	catch (Poco::Exception&)
+	{
+		return false;
+	}
+}
+
+
 void Connection::sendRequest(RequestMessage& request)
 {
-	Net::SocketOutputStream sos(_socket);
-	request.send(sos);
+	Poco::FastMutex::ScopedLock lock(_writeMutex);
+
+	request.header().requestID(++_lastRequestID);
+	request.send(_socket);
 }
 
 void Connection::sendRequest(RequestMessage& request, ResponseMessage& response)
 {
+	if ( _pipelined )
+	{
+		AsyncResponse result = sendPipelined(request, response);
+		result.wait();
+		if ( result.failed() )
+		{
+			result.exception()->rethrow();
+		}
+		return;
+	}
+
 	sendRequest(request);
 
 	Net::SocketInputStream sis(_socket);
 	response.read(sis);
 }
 
+
+Connection::AsyncResponse Connection::sendRequestAsync(RequestMessage& request, bool readViews)
+{
+	std::vector<RequestMessage*> requests(1, &request);
+	std::vector<AsyncResponse> responses;
+	sendRequestsAsync(requests, responses, readViews);
+	return responses.back();
+}
+
+
+void Connection::sendRequestsAsync(const std::vector<RequestMessage*>& requests, std::vector<AsyncResponse>& responses, bool readViews)
+{
+	if ( ! _pipelined )
+	{
+		startReader();
+	}
+
+	Poco::FastMutex::ScopedLock lock(_writeMutex);
+
+	// Register all replies before the first byte is sent: the reader
+	// thread may receive a reply before the last request is written.
+	BSONOutputStream bson;
+	std::size_t first = responses.size();
+	for(std::vector<RequestMessage*>::const_iterator it = requests.begin(); it != requests.end(); ++it)
+	{
+		MessageHeader::OpCode opCode = (*it)->header().opCode();
+		if ( opCode != MessageHeader::Query && opCode != MessageHeader::GetMore )
+		{
+			throw InvalidArgumentException("Only query and getmore requests have a response");
+		}
+
+		(*it)->header().requestID(++_lastRequestID);
+		AsyncResponse result(new ActiveResultHolder<ResponseMessage>());
+		result.data(new ResponseMessage());
+		result.data().readViews(readViews);
+		addPending(_lastRequestID, PendingResponse(&result.data(), result));
+		responses.push_back(result);
+		(*it)->build(bson);
+	}
+
+	try
+	{
+		sendBytes(bson.data(), bson.size());
+	}
+	catch (Exception& exc)
+	{
+		for(std::size_t i = first; i < responses.size(); ++i)
+		{
+			Poco::FastMutex::ScopedLock pendingLock(_pendingMutex);
+			_pending.erase(requests[i - first]->header().requestID());
+			responses[i].error(exc);
+			responses[i].notify();
+		}
+		throw;
+	}
+}
+
+
+Connection::AsyncResponse Connection::sendPipelined(RequestMessage& request, ResponseMessage& response)
+{
+	Poco::FastMutex::ScopedLock lock(_writeMutex);
+
+	request.header().requestID(++_lastRequestID);
+	AsyncResponse result(new ActiveResultHolder<ResponseMessage>());
+	addPending(_lastRequestID, PendingResponse(&response, result));
+
+	try
+	{
+		request.send(_socket);
+	}
+	catch (Exception& exc)
+	{
+		Poco::FastMutex::ScopedLock pendingLock(_pendingMutex);
+		_pending.erase(request.header().requestID());
+		throw;
+	}
+	return result;
+}
+
+
+std::size_t Connection::pendingRequests() const
+{
+	Poco::FastMutex::ScopedLock lock(_pendingMutex);
+
+	return _pending.size();
+}
+
+
+void Connection::sendBytes(const char* data, std::size_t length)
+{
+	while ( length > 0 )
+	{
+		int sent = _socket.sendBytes(data, (int) length);
+		data += sent;
+		length -= sent;
+	}
+}
+
+
+void Connection::startReader()
+{
+	Poco::FastMutex::ScopedLock lock(_writeMutex);
+
+	if ( ! _pipelined )
+	{
+		_reader.start(_readerAdapter);
+		_pipelined = true;
+	}
+}
+
+
+void Connection::stopReader()
+{
+	if ( _pipelined )
+	{
+		try
+		{
+			_socket.shutdown();
+		}
+		catch (Exception&)
+		{
+		}
+		_reader.join();
+		_pipelined = false;
+	}
+	delete _pReaderError;
+	_pReaderError = 0;
+}
+
+
+void Connection::readResponses()
+{
+	Net::SocketInputStream sis(_socket);
+	ResponseMessage unexpected;
+	ResponseMessage* pResponse = 0;
+	AsyncResponse result(new ActiveResultHolder<ResponseMessage>());
+	try
+	{
+		for (;;)
+		{
+			BinaryReader reader(sis, BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
+			unexpected.header().read(reader);
+
+			pResponse = &unexpected;
+			{
+				Poco::FastMutex::ScopedLock lock(_pendingMutex);
+				PendingMap::iterator it = _pending.find(unexpected.header().responseTo());
+				if ( it != _pending.end() )
+				{
+					pResponse = it->second.pResponse;
+					result = it->second.result;
+					_pending.erase(it);
+				}
+			}
+
+			pResponse->header() = unexpected.header();
+			pResponse->readBody(sis);
+			if ( pResponse != &unexpected )
+			{
+				result.notify();
+			}
+			pResponse = 0;
+		}
+	}
+	catch (Exception& exc)
+	{
+		if ( pResponse != 0 && pResponse != &unexpected )
+		{
+			result.error(exc);
+			result.notify();
+		}
+		failPending(exc);
+	}
+}
+
+
+void Connection::addPending(Int32 requestID, const PendingResponse& pending)
+{
+	Poco::FastMutex::ScopedLock lock(_pendingMutex);
+
+	if ( _pReaderError )
+	{
+		_pReaderError->rethrow();
+	}
+	_pending.insert(PendingMap::value_type(requestID, pending));
+}
+
+
+void Connection::failPending(const Exception& exc)
+{
+	PendingMap pending;
+	{
+		Poco::FastMutex::ScopedLock lock(_pendingMutex);
+		pending.swap(_pending);
+		delete _pReaderError;
+		_pReaderError = exc.clone();
+	}
+	for(PendingMap::iterator it = pending.begin(); it != pending.end(); ++it)
+	{
+		it->second.result.error(exc);
+		it->second.result.notify();
+	}
+}
+
 } } // Poco::MongoDB
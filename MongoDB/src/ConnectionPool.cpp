@@ -0,0 +1,294 @@
+//
+// ConnectionPool.cpp
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  ConnectionPool
+//
+// Implementation of the ConnectionPool class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "Poco/MongoDB/ConnectionPool.h"
+#include "Poco/MongoDB/QueryRequest.h"
+#include "Poco/MongoDB/ResponseMessage.h"
+#include "Poco/Exception.h"
+
+namespace Poco
+{
+namespace MongoDB
+{
+
+
+ConnectionPool::ConnectionPool(const Net::SocketAddress& address, std::size_t minSize, std::size_t maxSize, int idleTimeout)
+	: _factory(address)
+	, _minSize(minSize)
+	, _maxSize(maxSize)
+	, _idleTimeout(idleTimeout, 0)
+	, _size(0)
+{
+	poco_assert (minSize <= maxSize && maxSize > 0);
+}
+
+
+ConnectionPool::~ConnectionPool()
+{
+	for (IdleVector::iterator it = _idle.begin(); it != _idle.end(); ++it)
+	{
+		_factory.destroyObject(it->pConnection);
+	}
+}
+
+
+Connection::Ptr ConnectionPool::borrowConnection(long timeout)
+{
+	Timestamp start;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+		for (;;)
+		{
+			while ( ! _idle.empty() )
+			{
+				Connection::Ptr pConnection = _idle.back().pConnection;
+				_idle.pop_back();
+				if ( _factory.validateObject(pConnection) )
+				{
+					_factory.activateObject(pConnection);
+					return pConnection;
+				}
+				_factory.destroyObject(pConnection);
+				--_size;
+			}
+
+			if ( _size < _maxSize )
+			{
+				++_size;
+				break;
+			}
+
+			long remaining = timeout - long(start.elapsed()/1000);
+			if ( remaining <= 0 || ! _available.tryWait(_mutex, remaining) )
+			{
+				throw TimeoutException("No connection available", address().toString());
+			}
+		}
+	}
+
+	Connection::Ptr pConnection = newConnection();
+	_factory.activateObject(pConnection);
+	return pConnection;
+}
+
+
+void ConnectionPool::returnConnection(Connection::Ptr pConnection)
+{
+	if ( _factory.validateObject(pConnection) )
+	{
+		_factory.deactivateObject(pConnection);
+
+		FastMutex::ScopedLock lock(_mutex);
+		Timestamp now;
+		addIdle(IdleConnection(pConnection, now, now));
+		_available.signal();
+	}
+	else
+	{
+		_factory.destroyObject(pConnection);
+
+		FastMutex::ScopedLock lock(_mutex);
+		--_size;
+		_available.signal();
+	}
+}
+
+
+void ConnectionPool::maintain()
+{
+	Timestamp round;
+
+	std::vector<Connection::Ptr> reaped;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+		IdleVector::iterator it = _idle.begin();
+		while ( it != _idle.end() && _size > _minSize && it->lastUsed.isElapsed(_idleTimeout.totalMicroseconds()) )
+		{
+			reaped.push_back(it->pConnection);
+			--_size;
+			++it;
+		}
+		_idle.erase(_idle.begin(), it);
+	}
+	for (std::vector<Connection::Ptr>::iterator it = reaped.begin(); it != reaped.end(); ++it)
+	{
+		_factory.destroyObject(*it);
+	}
+
+	// Ping the idle connections one at a time, so that all others
+	// stay available for borrowing meanwhile.
+	for (;;)
+	{
+		Connection::Ptr pConnection;
+		Timestamp lastUsed;
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			IdleVector::iterator it = _idle.begin();
+			while ( it != _idle.end() && ! (it->lastChecked < round) )
+			{
+				++it;
+			}
+			if ( it == _idle.end() )
+			{
+				break;
+			}
+			pConnection = it->pConnection;
+			lastUsed = it->lastUsed;
+			_idle.erase(it);
+		}
+
+		bool valid = false;
+		try
+		{
+			ping(*pConnection);
+			valid = _factory.validateObject(pConnection);
+		}
+		catch (Exception&)
+		{
+		}
+
+		FastMutex::ScopedLock lock(_mutex);
+		if ( valid )
+		{
+			addIdle(IdleConnection(pConnection, lastUsed, Timestamp()));
+		}
+		else
+		{
+			_factory.destroyObject(pConnection);
+			--_size;
+		}
+		_available.signal();
+	}
+
+	for (;;)
+	{
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			if ( _size >= _minSize )
+			{
+				break;
+			}
+			++_size;
+		}
+
+		Connection::Ptr pConnection = newConnection();
+
+		FastMutex::ScopedLock lock(_mutex);
+		Timestamp now;
+		addIdle(IdleConnection(pConnection, now, now));
+		_available.signal();
+	}
+}
+
+
+Document::Ptr ConnectionPool::ping(Connection& connection)
+{
+	QueryRequest request("admin.$cmd");
+	request.numberToReturn(1);
+	request.query().add("isMaster", 1);
+
+	ResponseMessage response;
+	connection.sendRequest(request, response);
+	if ( response.documents().empty() )
+	{
+		throw IOException("No reply to isMaster", connection.address().toString());
+	}
+	return response.documents()[0];
+}
+
+
+std::size_t ConnectionPool::size() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+	return _size;
+}
+
+
+std::size_t ConnectionPool::idle() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+	return _idle.size();
+}
+
+
+Connection::Ptr ConnectionPool::newConnection()
+{
+	try
+	{
+		return _factory.createObject();
+	}
+	catch (...)
+	{
+		FastMutex::ScopedLock lock(_mutex);
+		--_size;
+		_available.signal();
+		throw;
+	}
+}
+
+
+void ConnectionPool::addIdle(const IdleConnection& idle)
+{
+	IdleVector::iterator it = _idle.end();
+	while ( it != _idle.begin() && idle.lastUsed < (it - 1)->lastUsed )
+	{
+		--it;
+	}
+	_idle.insert(it, idle);
+}
+
+
+PooledConnection::PooledConnection(ConnectionPool::Ptr pPool, long timeout)
+	: _pPool(pPool)
+	, _pConnection(pPool->borrowConnection(timeout))
+{
+}
+
+
+PooledConnection::~PooledConnection()
+{
+	try
+	{
+		_pPool->returnConnection(_pConnection);
+	}
+	catch (...)
+	{
+	}
+}
+
+
+}} // Poco::MongoDB
@@ -0,0 +1,213 @@
+//
+// Cursor.cpp
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  Cursor
+//
+// Implementation of the Cursor class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "Poco/MongoDB/Cursor.h"
+#include "Poco/MongoDB/GetMoreRequest.h"
+#include "Poco/MongoDB/KillCursorsRequest.h"
+
+namespace Poco
+{
+namespace MongoDB
+{
+
+
+Cursor::Cursor(Connection& connection, const std::string& collectionName, QueryRequest::Flags flags)
+	: _connection(connection)
+	, _collectionName(collectionName)
+	, _query(collectionName, flags)
+	, _batchSize(0)
+	, _prefetch(DEFAULT_PREFETCH)
+	, _readViews(false)
+	, _started(false)
+	, _cursorID(0)
+	, _current(false)
+	, _position(0)
+{
+}
+
+
+Cursor::~Cursor()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+	}
+}
+
+
+bool Cursor::next()
+{
+	if ( ! _started )
+	{
+		_started = true;
+		_query.numberToReturn(_batchSize);
+		_batches.push_back(_connection.sendRequestAsync(_query, _readViews));
+	}
+
+	if ( _current )
+	{
+		if ( ++_position < batchCount(_batches.front().data()) )
+		{
+			return true;
+		}
+		_batches.pop_front();
+		_current = false;
+	}
+
+	for(;;)
+	{
+		if ( _batches.empty() )
+		{
+			if ( _cursorID == 0 )
+			{
+				return false;
+			}
+			requestMore();
+		}
+
+		Connection::AsyncResponse batch = _batches.front();
+		batch.wait();
+		if ( batch.failed() )
+		{
+			_batches.clear();
+			_cursorID = 0;
+			batch.exception()->rethrow();
+		}
+
+		ResponseMessage& response = batch.data();
+		if ( response.responseFlags() & ResponseMessage::RESPONSE_QUERY_FAILURE )
+		{
+			std::string error("Query failure");
+			if ( batchCount(response) > 0 )
+			{
+				error = _readViews
+					? response.views()[0].getString("$err").toString()
+					: response.documents()[0]->get<std::string>("$err");
+			}
+			_batches.clear();
+			_cursorID = 0;
+			throw IOException(error);
+		}
+		if ( response.responseFlags() & ResponseMessage::RESPONSE_CURSOR_NOT_FOUND )
+		{
+			_batches.pop_front();
+			if ( _cursorID == 0 )
+			{
+				// A prefetched batch requested before the cursor was exhausted
+				continue;
+			}
+			_batches.clear();
+			_cursorID = 0;
+			throw NotFoundException("Cursor not found on server");
+		}
+
+		_cursorID = response.cursorID();
+		fill();
+
+		if ( batchCount(response) == 0 )
+		{
+			_batches.pop_front();
+			continue;
+		}
+
+		_current = true;
+		_position = 0;
+		return true;
+	}
+}
+
+
+Document::Ptr Cursor::document() const
+{
+	poco_assert (_current && ! _readViews);
+
+	return _batches.front().data().documents()[_position];
+}
+
+
+const DocumentView& Cursor::view() const
+{
+	poco_assert (_current && _readViews);
+
+	return _batches.front().data().views()[_position];
+}
+
+
+void Cursor::close()
+{
+	_started = true;
+	_current = false;
+	_batches.clear();
+
+	if ( _cursorID != 0 )
+	{
+		KillCursorsRequest kill;
+		kill.cursors().push_back(_cursorID);
+		_cursorID = 0;
+		_connection.sendRequest(kill);
+	}
+}
+
+
+void Cursor::requestMore()
+{
+	GetMoreRequest getMore(_collectionName, _cursorID);
+	getMore.numberToReturn(_batchSize);
+	_batches.push_back(_connection.sendRequestAsync(getMore, _readViews));
+}
+
+
+void Cursor::fill()
+{
+	// The front batch is the one being consumed, the others are in flight.
+	while ( _cursorID != 0 && _batches.size() <= (std::size_t) _prefetch )
+	{
+		requestMore();
+	}
+}
+
+
+std::size_t Cursor::batchCount(ResponseMessage& response) const
+{
+	return _readViews ? response.views().size() : response.documents().size();
+}
+
+
+}} // Namespace Poco::MongoDB
@@ -41,6 +41,8 @@
 #include "Poco/MongoDB/Binary.h"
 #include "Poco/MongoDB/ObjectId.h"
 #include "Poco/MongoDB/Array.h"
+#include "Poco/MongoDB/BSONOutputStream.h"
+#include "Poco/Hash.h"
 
 namespace Poco
 {
@@ -52,10 +54,12 @@ Document::Document()
 {
 }
 
+
 Document::~Document()
 {
 }
 
+
 void Document::read(BinaryReader& reader)
 {
 	int size;
@@ -66,17 +70,32 @@ void Document::read(BinaryReader& reader)
 
 	while( type != '\0' )
 	{
-		Element::Ptr element;
-
 		std::string name = BSONReader(reader).readCString();
+		_fields.push_back(DocumentField(name, type));
+		DocumentField& field = _fields.back();
 
+		Element::Ptr element;
 		switch(type)
 		{
 		case ElementTraits<double>::TypeId:
-			element = new ConcreteElement<double>(name, 0);
+			reader >> field.value.d;
 			break;
 		case ElementTraits<Int32>::TypeId:
-			element = new ConcreteElement<Int32>(name, 0);
+			reader >> field.value.i32;
+			break;
+		case ElementTraits<Int64>::TypeId:
+			reader >> field.value.i64;
+			break;
+		case ElementTraits<bool>::TypeId:
+			{
+				unsigned char b;
+				reader >> b;
+				field.value.b = b != 0;
+			}
+			break;
+		case ElementTraits<Poco::Timestamp>::TypeId:
+			reader >> field.value.i64;
+			field.value.i64 *= 1000;
 			break;
 		case ElementTraits<std::string>::TypeId:
 			element = new ConcreteElement<std::string>(name, "");
@@ -93,12 +112,6 @@ void Document::read(BinaryReader& reader)
 		case ElementTraits<ObjectId::Ptr>::TypeId:
 			element = new ConcreteElement<ObjectId::Ptr>(name, new ObjectId());
 			break;
-		case ElementTraits<bool>::TypeId:
-			element = new ConcreteElement<bool>(name, false);
-			break;
-		case ElementTraits<Poco::Timestamp>::TypeId:
-			element = new ConcreteElement<Poco::Timestamp>(name, Poco::Timestamp());
-			break;
 		case ElementTraits<NullValue>::TypeId:
 			element = new ConcreteElement<NullValue>(name, NullValue(0));
 			break;
@@ -108,11 +121,9 @@ void Document::read(BinaryReader& reader)
 		case ElementTraits<JavaScriptCode::Ptr>::TypeId:
 			element = new ConcreteElement<JavaScriptCode::Ptr>(name, new JavaScriptCode());
 			break;
-		case ElementTraits<Int64>::TypeId:
-			element = new ConcreteElement<Int64>(name, 0);
-			break;
 		default:
 			{
+				_fields.pop_back();
 				std::stringstream ss;
 				ss << "Element " << name << " contains an unsupported type " << std::hex << (int) type;
 				throw Poco::NotImplementedException(ss.str());
@@ -122,20 +133,50 @@ void Document::read(BinaryReader& reader)
 		//		x7F -> Max Key
 		}
 
-		element->read(reader);
-		_elements.insert(element);
+		if ( ! element.isNull() )
+		{
+			element->read(reader);
+			field.element = element;
+		}
+		indexLast();
 
 		reader >> type;
 	}
 }
 
 
+Element::Ptr Document::get(const std::string& name) const
+{
+	const DocumentField* pField = find(name);
+	if ( pField == 0 )
+	{
+		return Element::Ptr();
+	}
+
+	switch(pField->type)
+	{
+	case ElementTraits<double>::TypeId:
+		return new ConcreteElement<double>(name, pField->value.d);
+	case ElementTraits<Int32>::TypeId:
+		return new ConcreteElement<Int32>(name, pField->value.i32);
+	case ElementTraits<Int64>::TypeId:
+		return new ConcreteElement<Int64>(name, pField->value.i64);
+	case ElementTraits<bool>::TypeId:
+		return new ConcreteElement<bool>(name, pField->value.b);
+	case ElementTraits<Poco::Timestamp>::TypeId:
+		return new ConcreteElement<Poco::Timestamp>(name, FieldStorage<Poco::Timestamp>::get(*pField));
+	default:
+		return pField->element;
+	}
+}
+
+
 std::string Document::toString() const
 {
 	std::ostringstream oss;
-	for(ElementSet::iterator it = _elements.begin(); it != _elements.end(); ++it)
+	for(FieldVector::const_iterator it = _fields.begin(); it != _fields.end(); ++it)
 	{
-		oss << (*it)->name() << " ";
+		oss << it->name << " ";
 	}
 	return oss.str();
 }
@@ -143,33 +184,141 @@ std::string Document::toString() const
 
 void Document::write(BinaryWriter& writer)
 {
-	if ( _elements.empty() )
+	BSONOutputStream* pBSON = dynamic_cast<BSONOutputStream*>(&writer.stream());
+	if ( pBSON == 0 )
 	{
-		writer << 5;
+		// Not a contiguous buffer: build the document in one and copy it.
+		BSONOutputStream bson;
+		BinaryWriter bsonWriter(bson, BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+		write(bsonWriter);
+		writer.writeRaw(bson.data(), bson.size());
+		return;
 	}
-	else
+
+	// Write a placeholder for the length and patch it when the size is known.
+	// Embedded documents end up here with the same writer, so nothing is copied.
+	std::size_t start = pBSON->size();
+	writer << (Poco::Int32) 0;
+	for(FieldVector::iterator it = _fields.begin(); it != _fields.end(); ++it)
 	{
-		std::stringstream sstream;
-		Poco::BinaryWriter tempWriter(sstream);
-		for(ElementSet::iterator it = _elements.begin(); it != _elements.end(); ++it)
+		writer << (unsigned char) it->type;
+		BSONWriter(writer).writeCString(it->name);
+		switch(it->type)
 		{
-			tempWriter << (unsigned char) (*it)->type();
-			BSONWriter(tempWriter).writeCString((*it)->name());
-			Element::Ptr element = *it;
-			element->write(tempWriter);
+		case ElementTraits<double>::TypeId:
+			writer << it->value.d;
+			break;
+		case ElementTraits<Int32>::TypeId:
+			writer << it->value.i32;
+			break;
+		case ElementTraits<Int64>::TypeId:
+			writer << it->value.i64;
+			break;
+		case ElementTraits<bool>::TypeId:
+			writer << (unsigned char) (it->value.b ? 0x01 : 0x00);
+			break;
+		case ElementTraits<Poco::Timestamp>::TypeId:
+			writer << (it->value.i64 / 1000);
+			break;
+		default:
+			it->element->write(writer);
+			break;
 		}
-		tempWriter.flush();
-		
-		Poco::Int32 len = 5 + sstream.tellp(); /* 5 = sizeof(len) + 0-byte */
-		writer << len;
-		writer.writeRaw(sstream.str());
 	}
 	writer << '\0';
+	pBSON->patch(start, (Poco::Int32) (pBSON->size() - start));
 }
 
+
 void Document::addElement(Element::Ptr element)
 {
-	_elements.insert(element);
+	_fields.push_back(DocumentField(element->name(), element->type()));
+	DocumentField& field = _fields.back();
+	switch(field.type)
+	{
+	case ElementTraits<double>::TypeId:
+		field.value.d = element.cast<ConcreteElement<double> >()->value();
+		break;
+	case ElementTraits<Int32>::TypeId:
+		field.value.i32 = element.cast<ConcreteElement<Int32> >()->value();
+		break;
+	case ElementTraits<Int64>::TypeId:
+		field.value.i64 = element.cast<ConcreteElement<Int64> >()->value();
+		break;
+	case ElementTraits<bool>::TypeId:
+		field.value.b = element.cast<ConcreteElement<bool> >()->value();
+		break;
+	case ElementTraits<Poco::Timestamp>::TypeId:
+		FieldStorage<Poco::Timestamp>::set(field, element.cast<ConcreteElement<Poco::Timestamp> >()->value());
+		break;
+	default:
+		field.element = element;
+		break;
+	}
+	indexLast();
+}
+
+
+const DocumentField* Document::find(const std::string& name) const
+{
+	if ( _index.empty() && _fields.size() >= INDEX_THRESHOLD )
+	{
+		buildIndex();
+	}
+
+	if ( ! _index.empty() )
+	{
+		std::size_t mask = _index.size() - 1;
+		for(std::size_t slot = Poco::hash(name) & mask; _index[slot] >= 0; slot = (slot + 1) & mask)
+		{
+			const DocumentField& field = _fields[_index[slot]];
+			if ( field.name == name )
+			{
+				return &field;
+			}
+		}
+		return 0;
+	}
+
+	for(FieldVector::const_iterator it = _fields.begin(); it != _fields.end(); ++it)
+	{
+		if ( it->name == name )
+		{
+			return &*it;
+		}
+	}
+	return 0;
+}
+
+
+void Document::buildIndex() const
+{
+	std::size_t slots = 2*INDEX_THRESHOLD;
+	while ( slots < 2*_fields.size() )
+	{
+		slots *= 2;
+	}
+	_index.assign(slots, -1);
+	for(std::size_t pos = 0; pos < _fields.size(); ++pos)
+	{
+		insertIndex(pos);
+	}
+}
+
+
+void Document::insertIndex(std::size_t pos) const
+{
+	const std::string& name = _fields[pos].name;
+	std::size_t mask = _index.size() - 1;
+	std::size_t slot = Poco::hash(name) & mask;
+	for(; _index[slot] >= 0; slot = (slot + 1) & mask)
+	{
+		if ( _fields[_index[slot]].name == name )
+		{
+			return;
+		}
+	}
+	_index[slot] = (Int32) pos;
 }
 
 }} // Namespace Poco::MongoDB
@@ -0,0 +1,392 @@
+//
+// DocumentView.cpp
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  DocumentView
+//
+// Implementation of the DocumentView class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "Poco/MongoDB/DocumentView.h"
+#include "Poco/MongoDB/Array.h"
+#include "Poco/MongoDB/Binary.h"
+#include "Poco/MongoDB/ObjectId.h"
+#include "Poco/ByteOrder.h"
+#include "Poco/MemoryStream.h"
+#include "Poco/Exception.h"
+
+namespace Poco {
+namespace MongoDB {
+
+
+namespace
+{
+	Int32 readInt32(const char* p)
+	{
+		Int32 value;
+		std::memcpy(&value, p, sizeof(value));
+		return ByteOrder::fromLittleEndian(value);
+	}
+
+	Int64 readInt64(const char* p)
+	{
+		Int64 value;
+		std::memcpy(&value, p, sizeof(value));
+		return ByteOrder::fromLittleEndian(value);
+	}
+
+	std::size_t cstringSize(const char* p, const char* end)
+		/// Returns the size of the cstring at p, including the 0x00.
+	{
+		const char* nul = static_cast<const char*>(std::memchr(p, 0, end - p));
+		if (!nul) throw DataFormatException("Unterminated BSON cstring");
+		return nul - p + 1;
+	}
+
+	std::size_t stringSize(const char* p, const char* end)
+		/// Returns the size of a length-prefixed BSON value at p
+		/// (string, javascript, symbol), including the prefix.
+	{
+		if (end - p < 4) throw DataFormatException("Truncated BSON string");
+		Int32 len = readInt32(p);
+		if (len < 1 || len > end - p - 4 || p[4 + len - 1] != 0)
+			throw DataFormatException("Invalid BSON string");
+		return 4 + len;
+	}
+
+	std::size_t valueSize(int type, const char* p, const char* end)
+		/// Returns the size of the value of the given type at p.
+	{
+		std::size_t size;
+		switch (type)
+		{
+		case 0x06: // undefined
+		case 0x0A: // null
+		case 0x7F: // max key
+		case 0xFF: // min key
+			return 0;
+		case 0x08: // bool
+			size = 1;
+			break;
+		case 0x10: // int32
+			size = 4;
+			break;
+		case 0x01: // double
+		case 0x09: // UTC datetime
+		case 0x11: // timestamp
+		case 0x12: // int64
+			size = 8;
+			break;
+		case 0x07: // ObjectId
+			size = 12;
+			break;
+		case 0x13: // decimal128
+			size = 16;
+			break;
+		case 0x02: // string
+		case 0x0D: // javascript
+		case 0x0E: // symbol
+			return stringSize(p, end);
+		case 0x0C: // DBPointer
+			size = stringSize(p, end) + 12;
+			break;
+		case 0x03: // document
+		case 0x04: // array
+		case 0x0F: // javascript with scope
+			if (end - p < 5) throw DataFormatException("Truncated BSON document");
+			size = readInt32(p);
+			if (size < 5) throw DataFormatException("Invalid BSON document size");
+			break;
+		case 0x05: // binary
+			if (end - p < 5) throw DataFormatException("Truncated BSON binary");
+			size = readInt32(p);
+			if (size > 0x7FFFFFFF) throw DataFormatException("Invalid BSON binary size");
+			size += 5;
+			break;
+		case 0x0B: // regular expression
+			size = cstringSize(p, end);
+			return size + cstringSize(p + size, end);
+		default:
+			throw DataFormatException("Unsupported BSON type", NumberFormatter::formatHex(type));
+		}
+		if (size > static_cast<std::size_t>(end - p))
+			throw DataFormatException("Truncated BSON value");
+		return size;
+	}
+}
+
+
+//
+// DocumentView::Field
+//
+DocumentView::Field::Field() : _name(""), _nameLength(0), _type(0), _value(0), _valueSize(0)
+{
+}
+
+
+void DocumentView::Field::checkType(int type) const
+{
+	if (_type != type)
+		throw BadCastException(name().toString());
+}
+
+
+Int32 DocumentView::Field::asInt32() const
+{
+	checkType(ElementTraits<Int32>::TypeId);
+	return readInt32(_value);
+}
+
+
+Int64 DocumentView::Field::asInt64() const
+{
+	checkType(ElementTraits<Int64>::TypeId);
+	return readInt64(_value);
+}
+
+
+double DocumentView::Field::asDouble() const
+{
+	checkType(ElementTraits<double>::TypeId);
+	Int64 bits = readInt64(_value);
+	double value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+
+bool DocumentView::Field::asBool() const
+{
+	checkType(ElementTraits<bool>::TypeId);
+	return *_value != 0;
+}
+
+
+StringView DocumentView::Field::asString() const
+{
+	checkType(ElementTraits<std::string>::TypeId);
+	return StringView(_value + 4, _valueSize - 5);
+}
+
+
+Timestamp DocumentView::Field::asTimestamp() const
+{
+	checkType(ElementTraits<Timestamp>::TypeId);
+	return Timestamp(readInt64(_value) * 1000);
+}
+
+
+DocumentView DocumentView::Field::asDocument() const
+{
+	if (_type != ElementTraits<Document::Ptr>::TypeId && _type != ElementTraits<Array::Ptr>::TypeId)
+		throw BadCastException(name().toString());
+	return DocumentView(_value, _valueSize);
+}
+
+
+//
+// DocumentView::Iterator
+//
+DocumentView::Iterator::Iterator() : _pos(0), _end(0)
+{
+}
+
+
+DocumentView::Iterator::Iterator(const char* pos, const char* end) : _pos(pos), _end(end)
+{
+	parse();
+}
+
+
+DocumentView::Iterator& DocumentView::Iterator::operator ++ ()
+{
+	poco_check_ptr (_pos);
+
+	_pos = _field._value + _field._valueSize;
+	parse();
+	return *this;
+}
+
+
+void DocumentView::Iterator::parse()
+{
+	// The document terminator is the last byte and is not part of [_pos, _end).
+	if (_pos == _end)
+	{
+		_pos = 0;
+		return;
+	}
+	_field._type = static_cast<unsigned char>(*_pos);
+	_field._name = _pos + 1;
+	std::size_t nameSize = cstringSize(_field._name, _end);
+	_field._nameLength = nameSize - 1;
+	_field._value = _field._name + nameSize;
+	_field._valueSize = valueSize(_field._type, _field._value, _end);
+}
+
+
+//
+// DocumentView
+//
+DocumentView::DocumentView() : _data(0), _size(0)
+{
+}
+
+
+DocumentView::DocumentView(const char* data, std::size_t available) : _data(data), _size(0)
+{
+	if (available < 5)
+		throw DataFormatException("Truncated BSON document");
+	Int32 size = readInt32(data);
+	if (size < 5 || static_cast<std::size_t>(size) > available || data[size - 1] != 0)
+		throw DataFormatException("Invalid BSON document");
+	_size = size;
+}
+
+
+DocumentView::~DocumentView()
+{
+}
+
+
+DocumentView::Iterator DocumentView::begin() const
+{
+	if (_data == 0) return Iterator();
+	return Iterator(_data + 4, _data + _size - 1);
+}
+
+
+DocumentView::Iterator DocumentView::find(const std::string& name) const
+{
+	Iterator it = begin();
+	for (; it != end(); ++it)
+	{
+		if (it->name() == name) break;
+	}
+	return it;
+}
+
+
+DocumentView::Field DocumentView::field(const std::string& name) const
+{
+	Iterator it = find(name);
+	if (it == end())
+		throw NotFoundException(name);
+	return *it;
+}
+
+
+bool DocumentView::isNull(const std::string& name) const
+{
+	return field(name).isNull();
+}
+
+
+int DocumentView::type(const std::string& name) const
+{
+	return field(name).type();
+}
+
+
+Int32 DocumentView::getInt32(const std::string& name) const
+{
+	return field(name).asInt32();
+}
+
+
+Int64 DocumentView::getInt64(const std::string& name) const
+{
+	return field(name).asInt64();
+}
+
+
+double DocumentView::getDouble(const std::string& name) const
+{
+	return field(name).asDouble();
+}
+
+
+bool DocumentView::getBool(const std::string& name) const
+{
+	return field(name).asBool();
+}
+
+
+StringView DocumentView::getString(const std::string& name) const
+{
+	return field(name).asString();
+}
+
+
+Timestamp DocumentView::getTimestamp(const std::string& name) const
+{
+	return field(name).asTimestamp();
+}
+
+
+DocumentView DocumentView::getDocument(const std::string& name) const
+{
+	Field f = field(name);
+	f.checkType(ElementTraits<Document::Ptr>::TypeId);
+	return f.asDocument();
+}
+
+
+DocumentView DocumentView::getArray(const std::string& name) const
+{
+	Field f = field(name);
+	f.checkType(ElementTraits<Array::Ptr>::TypeId);
+	return f.asDocument();
+}
+
+
+std::size_t DocumentView::fieldCount() const
+{
+	std::size_t count = 0;
+	for (Iterator it = begin(); it != end(); ++it) ++count;
+	return count;
+}
+
+
+Document::Ptr DocumentView::toDocument() const
+{
+	if (_data == 0)
+		throw NullPointerException("DocumentView is null");
+
+	MemoryInputStream mis(_data, _size);
+	BinaryReader reader(mis, BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
+	Document::Ptr doc = new Document();
+	doc->read(reader);
+	return doc;
+}
+
+
+}} // Namespace Poco::MongoDB
@@ -0,0 +1,546 @@
+//
+// JSONToBSON.cpp
+//
+// $Id$
+//
+// Library: MongoDB
+// Package: MongoDB
+// Module:  JSONToBSON
+//
+// Implementation of the JSONToBSON class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "Poco/MongoDB/JSONToBSON.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Exception.h"
+
+#include <cstring>
+
+namespace Poco
+{
+namespace MongoDB
+{
+
+
+namespace
+{
+	int formatIndex(char* buffer, int index)
+		/// Writes index as a decimal number and returns its length.
+	{
+		char digits[12];
+		int n = 0;
+		do
+		{
+			digits[n++] = char('0' + index % 10);
+			index /= 10;
+		}
+		while ( index > 0 );
+		for(int i = 0; i < n; ++i)
+		{
+			buffer[i] = digits[n - 1 - i];
+		}
+		return n;
+	}
+
+	int hexDigit(char c)
+	{
+		if ( c >= '0' && c <= '9' ) return c - '0';
+		if ( c >= 'a' && c <= 'f' ) return c - 'a' + 10;
+		if ( c >= 'A' && c <= 'F' ) return c - 'A' + 10;
+		return -1;
+	}
+
+	int base64Digit(char c)
+	{
+		if ( c >= 'A' && c <= 'Z' ) return c - 'A';
+		if ( c >= 'a' && c <= 'z' ) return c - 'a' + 26;
+		if ( c >= '0' && c <= '9' ) return c - '0' + 52;
+		if ( c == '+' ) return 62;
+		if ( c == '/' ) return 63;
+		return -1;
+	}
+
+	bool decodeBase64(const std::string& text, std::vector<char>& data)
+	{
+		data.clear();
+		unsigned int bits = 0;
+		int count = 0;
+		for(std::string::const_iterator it = text.begin(); it != text.end() && *it != '='; ++it)
+		{
+			int digit = base64Digit(*it);
+			if ( digit < 0 ) return false;
+			bits = (bits << 6) | digit;
+			count += 6;
+			if ( count >= 8 )
+			{
+				count -= 8;
+				data.push_back(char((bits >> count) & 0xFF));
+			}
+		}
+		return true;
+	}
+
+	void invalid(const std::string& key)
+	{
+		throw DataFormatException("Invalid extended JSON value", key);
+	}
+}
+
+
+JSONToBSON::JSONToBSON(BSONOutputStream& bson)
+	: _bson(bson)
+	, _writer(bson, BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER)
+	, _documents(0)
+	, _extended(EXT_NONE)
+	, _captureDepth(0)
+{
+}
+
+
+JSONToBSON::~JSONToBSON()
+{
+}
+
+
+void JSONToBSON::reset()
+{
+	_levels.clear();
+	_extended = EXT_NONE;
+	_captureDepth = 0;
+	_captured.clear();
+}
+
+
+void JSONToBSON::startObject()
+{
+	if ( _extended != EXT_NONE )
+	{
+		++_captureDepth;
+		return;
+	}
+
+	if ( _levels.empty() || _levels.back().isSequence )
+	{
+		openDocument();
+		return;
+	}
+
+	// Only the first key tells whether this is extended JSON.
+	Level& parent = _levels.back();
+	Level level;
+	level.start = 0;
+	level.isArray = false;
+	level.isSequence = false;
+	level.pending = true;
+	level.index = 0;
+	if ( parent.isArray )
+	{
+		char buffer[12];
+		level.name.assign(buffer, formatIndex(buffer, parent.index++));
+	}
+	else
+	{
+		level.name = _key;
+	}
+	_levels.push_back(level);
+}
+
+
+void JSONToBSON::endObject()
+{
+	if ( _extended != EXT_NONE )
+	{
+		if ( _captureDepth > 0 )
+		{
+			--_captureDepth;
+			return;
+		}
+		writeExtended(_levels.back().name);
+		_extended = EXT_NONE;
+		_levels.pop_back();
+		return;
+	}
+
+	if ( _levels.back().pending )
+	{
+		flushPending();
+	}
+	closeDocument();
+}
+
+
+void JSONToBSON::startArray()
+{
+	if ( _extended != EXT_NONE )
+	{
+		invalid(_key);
+	}
+
+	if ( _levels.empty() )
+	{
+		Level level;
+		level.start = 0;
+		level.isArray = false;
+		level.isSequence = true;
+		level.pending = false;
+		level.index = 0;
+		_levels.push_back(level);
+		return;
+	}
+
+	beginElement(0x04);
+	openDocument();
+	_levels.back().isArray = true;
+}
+
+
+void JSONToBSON::endArray()
+{
+	if ( _levels.back().isSequence )
+	{
+		_levels.pop_back();
+		return;
+	}
+	closeDocument();
+}
+
+
+void JSONToBSON::key(const std::string& k)
+{
+	if ( _extended == EXT_NONE && _levels.back().pending )
+	{
+		_extended = extended(k);
+		if ( _extended != EXT_NONE )
+		{
+			_captureDepth = 0;
+			_captured.clear();
+		}
+		else
+		{
+			flushPending();
+		}
+	}
+	_key = k;
+}
+
+
+void JSONToBSON::null()
+{
+	if ( _extended != EXT_NONE )
+	{
+		capture(std::string(), 0, false);
+		return;
+	}
+	beginElement(0x0A);
+}
+
+
+void JSONToBSON::value(int v)
+{
+	if ( _extended != EXT_NONE )
+	{
+		capture(std::string(), v, true);
+		return;
+	}
+	beginElement(0x10);
+	_writer << (Int32) v;
+}
+
+
+void JSONToBSON::value(const std::string& value)
+{
+	if ( _extended != EXT_NONE )
+	{
+		capture(value, 0, false);
+		return;
+	}
+	beginElement(0x02);
+	_writer << (Int32) (value.size() + 1);
+	_bson.write(value.data(), value.size());
+	_writer << '\0';
+}
+
+
+void JSONToBSON::value(double d)
+{
+	if ( _extended != EXT_NONE )
+	{
+		capture(std::string(), d, true);
+		return;
+	}
+	beginElement(0x01);
+	_writer << d;
+}
+
+
+void JSONToBSON::value(bool b)
+{
+	if ( _extended != EXT_NONE )
+	{
+		capture(std::string(), b ? 1 : 0, true);
+		return;
+	}
+	beginElement(0x08);
+	_writer << (unsigned char) (b ? 0x01 : 0x00);
+}
+
+
+JSONToBSON::Extended JSONToBSON::extended(const std::string& k)
+{
+	if ( k.size() < 4 || k[0] != '$' )
+	{
+		return EXT_NONE;
+	}
+	if ( k == "$oid" ) return EXT_OID;
+	if ( k == "$date" ) return EXT_DATE;
+	if ( k == "$binary" ) return EXT_BINARY;
+	if ( k == "$numberLong" ) return EXT_LONG;
+	if ( k == "$regex" ) return EXT_REGEX;
+	if ( k == "$code" ) return EXT_CODE;
+	if ( k == "$timestamp" ) return EXT_TIMESTAMP;
+	if ( k == "$minKey" ) return EXT_MINKEY;
+	if ( k == "$maxKey" ) return EXT_MAXKEY;
+	return EXT_NONE;
+}
+
+
+void JSONToBSON::beginElement(unsigned char type)
+{
+	if ( _levels.empty() || _levels.back().isSequence )
+	{
+		throw DataFormatException("Only objects can be written as BSON documents");
+	}
+
+	Level& top = _levels.back();
+	_writer << type;
+	if ( top.isArray )
+	{
+		char buffer[12];
+		_bson.write(buffer, formatIndex(buffer, top.index++));
+	}
+	else
+	{
+		if ( std::memchr(_key.data(), 0, _key.size()) )
+		{
+			throw DataFormatException("A BSON key can't contain a 0x00", _key);
+		}
+		_bson.write(_key.data(), _key.size());
+	}
+	_writer << '\0';
+}
+
+
+void JSONToBSON::writeHeader(unsigned char type, const std::string& name)
+{
+	if ( std::memchr(name.data(), 0, name.size()) )
+	{
+		throw DataFormatException("A BSON key can't contain a 0x00", name);
+	}
+	_writer << type;
+	_bson.write(name.data(), name.size());
+	_writer << '\0';
+}
+
+
+void JSONToBSON::flushPending()
+{
+	Level& top = _levels.back();
+	writeHeader(0x03, top.name);
+	top.pending = false;
+	top.start = _bson.size();
+	_writer << (Int32) 0;
+}
+
+
+void JSONToBSON::openDocument()
+{
+	Level level;
+	level.start = _bson.size();
+	level.isArray = false;
+	level.isSequence = false;
+	level.pending = false;
+	level.index = 0;
+	_levels.push_back(level);
+	_writer << (Int32) 0;
+}
+
+
+void JSONToBSON::closeDocument()
+{
+	_writer << '\0';
+	const Level& top = _levels.back();
+	_bson.patch(top.start, (Int32) (_bson.size() - top.start));
+	bool isDocument = ! top.isArray;
+	_levels.pop_back();
+	if ( isDocument && (_levels.empty() || _levels.back().isSequence) )
+	{
+		++_documents;
+	}
+}
+
+
+void JSONToBSON::capture(const std::string& text, double number, bool isNumber)
+{
+	Captured value;
+	value.key = _key;
+	value.text = text;
+	value.number = number;
+	value.isNumber = isNumber;
+	_captured.push_back(value);
+}
+
+
+const JSONToBSON::Captured* JSONToBSON::captured(const char* key) const
+{
+	for(std::vector<Captured>::const_iterator it = _captured.begin(); it != _captured.end(); ++it)
+	{
+		if ( it->key == key )
+		{
+			return &*it;
+		}
+	}
+	return 0;
+}
+
+
+void JSONToBSON::writeExtended(const std::string& name)
+{
+	switch(_extended)
+	{
+	case EXT_OID:
+		{
+			const Captured* pOid = captured("$oid");
+			if ( pOid == 0 || pOid->isNumber || pOid->text.size() != 24 ) invalid("$oid");
+			char id[12];
+			for(int i = 0; i < 12; ++i)
+			{
+				int high = hexDigit(pOid->text[2*i]);
+				int low = hexDigit(pOid->text[2*i + 1]);
+				if ( high < 0 || low < 0 ) invalid("$oid");
+				id[i] = char((high << 4) | low);
+			}
+			writeHeader(0x07, name);
+			_bson.write(id, 12);
+		}
+		break;
+	case EXT_DATE:
+		{
+			Int64 millis = 0;
+			const Captured* pDate = captured("$date");
+			const Captured* pLong = captured("$numberLong");
+			if ( pDate != 0 && pDate->isNumber )
+			{
+				millis = (Int64) pDate->number;
+			}
+			else if ( pLong == 0 || ! NumberParser::tryParse64(pLong->text, millis) )
+			{
+				invalid("$date");
+			}
+			writeHeader(0x09, name);
+			_writer << millis;
+		}
+		break;
+	case EXT_LONG:
+		{
+			const Captured* pLong = captured("$numberLong");
+			Int64 value;
+			if ( pLong == 0 || pLong->isNumber || ! NumberParser::tryParse64(pLong->text, value) ) invalid("$numberLong");
+			writeHeader(0x12, name);
+			_writer << value;
+		}
+		break;
+	case EXT_BINARY:
+		{
+			const Captured* pData = captured("$binary");
+			const Captured* pType = captured("$type");
+			std::vector<char> data;
+			if ( pData == 0 || pData->isNumber || ! decodeBase64(pData->text, data) ) invalid("$binary");
+			int subtype = 0;
+			if ( pType != 0 )
+			{
+				if ( pType->isNumber || pType->text.empty() || pType->text.size() > 2 ) invalid("$type");
+				for(std::string::const_iterator it = pType->text.begin(); it != pType->text.end(); ++it)
+				{
+					int digit = hexDigit(*it);
+					if ( digit < 0 ) invalid("$type");
+					subtype = (subtype << 4) | digit;
+				}
+			}
+			writeHeader(0x05, name);
+			_writer << (Int32) data.size() << (unsigned char) subtype;
+			if ( ! data.empty() )
+			{
+				_bson.write(&data[0], data.size());
+			}
+		}
+		break;
+	case EXT_REGEX:
+		{
+			const Captured* pRegex = captured("$regex");
+			const Captured* pOptions = captured("$options");
+			if ( pRegex == 0 || pRegex->isNumber || (pOptions != 0 && pOptions->isNumber) ) invalid("$regex");
+			writeHeader(0x0B, name);
+			_bson.write(pRegex->text.c_str(), pRegex->text.size() + 1);
+			if ( pOptions != 0 )
+			{
+				_bson.write(pOptions->text.data(), pOptions->text.size());
+			}
+			_writer << '\0';
+		}
+		break;
+	case EXT_CODE:
+		{
+			const Captured* pCode = captured("$code");
+			if ( pCode == 0 || pCode->isNumber ) invalid("$code");
+			writeHeader(0x0D, name);
+			_writer << (Int32) (pCode->text.size() + 1);
+			_bson.write(pCode->text.c_str(), pCode->text.size() + 1);
+		}
+		break;
+	case EXT_TIMESTAMP:
+		{
+			const Captured* pT = captured("t");
+			const Captured* pI = captured("i");
+			if ( pT == 0 || pI == 0 || ! pT->isNumber || ! pI->isNumber ) invalid("$timestamp");
+			writeHeader(0x11, name);
+			_writer << (UInt64) ((UInt64(pT->number) << 32) | UInt32(pI->number));
+		}
+		break;
+	case EXT_MINKEY:
+		writeHeader(0xFF, name);
+		break;
+	case EXT_MAXKEY:
+		writeHeader(0x7F, name);
+		break;
+	default:
+		break;
+	}
+}
+
+
+}} // Poco::MongoDB
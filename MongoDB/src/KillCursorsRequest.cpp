@@ -55,7 +55,7 @@ KillCursorsRequest::~KillCursorsRequest()
 void KillCursorsRequest::buildRequest(BinaryWriter& writer)
 {
 	writer << 0; // 0 - reserved for future use
-	writer << _cursors.size();
+	writer << (Int32) _cursors.size();
 	for(std::vector<Int64>::iterator it = _cursors.begin(); it != _cursors.end(); ++it)
 	{
 		writer << *it;
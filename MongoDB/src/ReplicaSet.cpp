@@ -35,73 +35,337 @@
 // DEALINGS IN THE SOFTWARE.
 //
 #include "Poco/MongoDB/ReplicaSet.h"
-#include "Poco/MongoDB/QueryRequest.h"
-#include "Poco/MongoDB/ResponseMessage.h"
+#include "Poco/MongoDB/Array.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Exception.h"
+#include <algorithm>
 
 namespace Poco
 {
 namespace MongoDB
 {
 
-ReplicaSet::ReplicaSet(const std::vector<Net::SocketAddress> &addresses) : _addresses(addresses)
+ReplicaSet::ReplicaSet(const std::vector<Net::SocketAddress> &addresses)
+	: _addresses(addresses)
+	, _minPoolSize(1)
+	, _maxPoolSize(16)
+	, _idleTimeout(60)
+	, _monitorInterval(DEFAULT_MONITOR_INTERVAL)
+	, _monitorThread("MongoDB::ReplicaSet")
+	, _monitorAdapter(*this, &ReplicaSet::monitor)
 {
+	for(std::vector<Net::SocketAddress>::iterator it = _addresses.begin(); it != _addresses.end(); ++it)
+	{
+		addMember(*it);
+	}
 }
 
 ReplicaSet::~ReplicaSet()
 {
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+	}
 }
 
 
-Connection::Ptr ReplicaSet::findMaster()
+void ReplicaSet::setPoolSize(std::size_t minSize, std::size_t maxSize)
 {
-	Connection::Ptr master;
+	poco_assert (minSize <= maxSize && maxSize > 0);
 
-	for(std::vector<Net::SocketAddress>::iterator it = _addresses.begin(); it != _addresses.end(); ++it)
-	{
-		master = isMaster(*it);
-		if ( ! master.isNull() )
-		{
-			break;
-		}
-	}
+	ScopedWriteRWLock lock(_lock);
+	_minPoolSize = minSize;
+	_maxPoolSize = maxSize;
+}
 
-	return master;
+
+void ReplicaSet::setIdleTimeout(int seconds)
+{
+	ScopedWriteRWLock lock(_lock);
+	_idleTimeout = seconds;
 }
 
-Connection::Ptr ReplicaSet::isMaster(const Net::SocketAddress& address)
+
+void ReplicaSet::setMonitorInterval(long milliseconds)
 {
-	Connection::Ptr conn = new Connection();
+	_monitorInterval = milliseconds;
+}
 
-	try
+
+void ReplicaSet::start()
+{
+	refresh();
+	if ( ! _monitorThread.isRunning() )
 	{
-		conn->connect(address);
+		_stopMonitor.reset();
+		_monitorThread.start(_monitorAdapter);
+	}
+}
 
-		QueryRequest request("admin.$cmd");
-		request.numberToReturn(1);
-		request.query().add("isMaster", 1);
 
-		ResponseMessage response;
-		conn->sendRequest(request, response);
+void ReplicaSet::stop()
+{
+	if ( _monitorThread.isRunning() )
+	{
+		_stopMonitor.set();
+		_monitorThread.join();
+	}
+}
 
-		if ( response.documents().size() > 0 )
+
+void ReplicaSet::refresh()
+{
+	std::vector<std::string> visited;
+	for (;;)
+	{
+		std::string key;
+		Net::SocketAddress address;
+		Connection::Ptr pMonitor;
 		{
-			Document::Ptr doc = response.documents()[0];
-			if ( doc->get<bool>("ismaster") )
+			ScopedReadRWLock lock(_lock);
+			MemberMap::const_iterator it = _members.begin();
+			while ( it != _members.end() && std::find(visited.begin(), visited.end(), it->first) != visited.end() )
 			{
-				return conn;
+				++it;
 			}
-			else if ( doc->exists("primary") )
+			if ( it == _members.end() )
 			{
-				return isMaster(Net::SocketAddress(doc->get<std::string>("primary")));
+				break;
+			}
+			key = it->first;
+			address = it->second.member.address;
+			pMonitor = it->second.pMonitor;
+		}
+		visited.push_back(key);
+
+		Document::Ptr pReply;
+		Timestamp::TimeDiff roundTripTime = 0;
+		try
+		{
+			if ( pMonitor.isNull() || ! pMonitor->isConnected() )
+			{
+				pMonitor = new Connection(address);
+			}
+			Timestamp start;
+			pReply = ConnectionPool::ping(*pMonitor);
+			roundTripTime = start.elapsed();
+		}
+		catch (Exception&)
+		{
+			pMonitor = 0;
+		}
+
+		bool isPrimary = false;
+		bool isSecondary = false;
+		std::vector<Net::SocketAddress> hosts;
+		if ( ! pReply.isNull() )
+		{
+			isPrimary = pReply->isType<bool>("ismaster") && pReply->get<bool>("ismaster");
+			isSecondary = pReply->isType<bool>("secondary") && pReply->get<bool>("secondary");
+			if ( pReply->isType<Array::Ptr>("hosts") )
+			{
+				Array::Ptr pHosts = pReply->get<Array::Ptr>("hosts");
+				for (int i = 0; pHosts->isType<std::string>(NumberFormatter::format(i)); ++i)
+				{
+					try
+					{
+						hosts.push_back(Net::SocketAddress(pHosts->get<std::string>(NumberFormatter::format(i))));
+					}
+					catch (Exception&)
+					{
+					}
+				}
+			}
+			if ( pReply->isType<std::string>("primary") )
+			{
+				try
+				{
+					hosts.push_back(Net::SocketAddress(pReply->get<std::string>("primary")));
+				}
+				catch (Exception&)
+				{
+				}
+			}
+		}
+
+		ScopedWriteRWLock lock(_lock);
+		Member& member = _members[key].member;
+		_members[key].pMonitor = pMonitor;
+		member.reachable = ! pReply.isNull();
+		member.primary = isPrimary;
+		member.secondary = isSecondary;
+		if ( member.reachable )
+		{
+			// Exponentially weighted moving average with a weight of 0.2
+			// for the new sample, as the MongoDB server selection spec does.
+			member.roundTripTime = member.roundTripTime < 0 ? roundTripTime : (roundTripTime + 4*member.roundTripTime)/5;
+		}
+		if ( isPrimary )
+		{
+			_primary = key;
+		}
+		else if ( _primary == key )
+		{
+			_primary.clear();
+		}
+		for (std::vector<Net::SocketAddress>::iterator it = hosts.begin(); it != hosts.end(); ++it)
+		{
+			addMember(*it);
+		}
+	}
+
+	std::vector<ConnectionPool::Ptr> pools;
+	{
+		ScopedReadRWLock lock(_lock);
+		for (MemberMap::const_iterator it = _members.begin(); it != _members.end(); ++it)
+		{
+			if ( it->second.member.reachable )
+			{
+				pools.push_back(it->second.pPool);
 			}
 		}
 	}
-	catch(...)
+	for (std::vector<ConnectionPool::Ptr>::iterator it = pools.begin(); it != pools.end(); ++it)
 	{
-		conn = NULL;
+		try
+		{
+			(*it)->maintain();
+		}
+		catch (Exception&)
+		{
+		}
+	}
+}
+
+
+ConnectionPool::Ptr ReplicaSet::primary() const
+{
+	ScopedReadRWLock lock(_lock);
+	MemberMap::const_iterator it = _members.find(_primary);
+	if ( it == _members.end() )
+	{
+		throw NotFoundException("No primary in replica set");
+	}
+	return it->second.pPool;
+}
+
+
+ConnectionPool::Ptr ReplicaSet::secondary() const
+{
+	ScopedReadRWLock lock(_lock);
+	const MemberState* pNearest = 0;
+	for (MemberMap::const_iterator it = _members.begin(); it != _members.end(); ++it)
+	{
+		const Member& member = it->second.member;
+		if ( member.reachable && member.secondary && (pNearest == 0 || member.roundTripTime < pNearest->member.roundTripTime) )
+		{
+			pNearest = &it->second;
+		}
+	}
+	if ( pNearest )
+	{
+		return pNearest->pPool;
+	}
+
+	MemberMap::const_iterator it = _members.find(_primary);
+	if ( it == _members.end() )
+	{
+		throw NotFoundException("No primary or secondary in replica set");
+	}
+	return it->second.pPool;
+}
+
+
+ConnectionPool::Ptr ReplicaSet::pool(const QueryRequest& request) const
+{
+	if ( request.flags() & QueryRequest::QUERY_SLAVE_OK )
+	{
+		return secondary();
+	}
+	return primary();
+}
+
+
+std::vector<ReplicaSet::Member> ReplicaSet::members() const
+{
+	ScopedReadRWLock lock(_lock);
+	std::vector<Member> members;
+	for (MemberMap::const_iterator it = _members.begin(); it != _members.end(); ++it)
+	{
+		members.push_back(it->second.member);
+	}
+	return members;
+}
+
+
+Connection::Ptr ReplicaSet::findMaster()
+{
+	bool known;
+	{
+		ScopedReadRWLock lock(_lock);
+		known = ! _primary.empty();
+	}
+	if ( ! known )
+	{
+		refresh();
+	}
+
+	Net::SocketAddress address;
+	{
+		ScopedReadRWLock lock(_lock);
+		MemberMap::const_iterator it = _members.find(_primary);
+		if ( it == _members.end() )
+		{
+			return NULL;
+		}
+		address = it->second.member.address;
+	}
+
+	try
+	{
+		return new Connection(address);
+	}
+	catch (Exception&)
+	{
+		return NULL;
+	}
+}
+
+
+bool ReplicaSet::addMember(const Net::SocketAddress& address)
+{
+	std::string key = address.toString();
+	if ( _members.find(key) != _members.end() )
+	{
+		return false;
+	}
+
+	MemberState& state = _members[key];
+	state.member.address = address;
+	state.member.reachable = false;
+	state.member.primary = false;
+	state.member.secondary = false;
+	state.member.roundTripTime = -1;
+	state.pPool = new ConnectionPool(address, _minPoolSize, _maxPoolSize, _idleTimeout);
+	return true;
+}
+
+
+void ReplicaSet::monitor()
+{
+	while ( ! _stopMonitor.tryWait(_monitorInterval) )
+	{
+		try
+		{
+			refresh();
+		}
+		catch (...)
+		{
+		}
 	}
-	
-	return NULL; 
 }
 
 
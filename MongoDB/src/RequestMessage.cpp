@@ -36,8 +36,6 @@
 //
 
 #include "Poco/MongoDB/RequestMessage.h"
-#include "Poco/Net/SocketStream.h"
-#include "Poco/StreamCopier.h"
 
 namespace Poco
 {
@@ -54,19 +52,41 @@ RequestMessage::~RequestMessage()
 }
 
 
-void RequestMessage::send(std::ostream& ostr)
+void RequestMessage::build(BSONOutputStream& bson)
 {
-	std::stringstream ss;
-	BinaryWriter requestWriter(ss);
-	buildRequest(requestWriter);
-	requestWriter.flush();
+	std::size_t start = bson.size();
+	BinaryWriter writer(bson, BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+	_header.write(writer);
+	buildRequest(writer);
+
+	messageLength(bson.size() - start - MSG_HEADER_SIZE);
+	bson.patch(start, _header.messageLength());
+}
 
-	messageLength(ss.tellp());
 
-	BinaryWriter socketWriter(ostr, BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
-	_header.write(socketWriter);
-	StreamCopier::copyStream(ss, ostr);
+void RequestMessage::send(std::ostream& ostr)
+{
+	BSONOutputStream bson;
+	build(bson);
+	ostr.write(bson.data(), bson.size());
 	ostr.flush();
 }
 
+
+void RequestMessage::send(Net::StreamSocket& socket)
+{
+	BSONOutputStream bson;
+	build(bson);
+
+	const char* data = bson.data();
+	int remaining = (int) bson.size();
+	while ( remaining > 0 )
+	{
+		// A blocking socket normally takes everything at once.
+		int sent = socket.sendBytes(data, remaining);
+		data += sent;
+		remaining -= sent;
+	}
+}
+
 }} // Namespace MongoDB
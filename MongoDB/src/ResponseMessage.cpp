@@ -43,7 +43,7 @@ namespace Poco
 namespace MongoDB
 {
 
-ResponseMessage::ResponseMessage() : Message(MessageHeader::Reply), _responseFlags(0), _cursorID(0), _startingFrom(0), _numberReturned(0)
+ResponseMessage::ResponseMessage() : Message(MessageHeader::Reply), _responseFlags(0), _cursorID(0), _startingFrom(0), _numberReturned(0), _readViews(false), _buffer(0)
 {
 }
 
@@ -56,22 +56,37 @@ void ResponseMessage::clear()
 {
 	_cursorID = 0;
 	_documents.clear();
+	_views.clear();
 }
 
 
 void ResponseMessage::read(std::istream& istr)
 {
-	clear();
-
 	BinaryReader reader(istr, BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
 	
 	_header.read(reader);
 
+	readBody(istr);
+}
+
+
+void ResponseMessage::readBody(std::istream& istr)
+{
+	clear();
+
+	BinaryReader reader(istr, BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
+
 	reader >> _responseFlags;
 	reader >> _cursorID;
 	reader >> _startingFrom;
 	reader >> _numberReturned;
 
+	if ( _readViews )
+	{
+		readViewBody(istr);
+		return;
+	}
+
 	for(int i = 0; i < _numberReturned; ++i)
 	{
 		Document::Ptr doc = new Document();
@@ -80,4 +95,36 @@ void ResponseMessage::read(std::istream& istr)
 	}
 }
 
+
+void ResponseMessage::readViewBody(std::istream& istr)
+{
+	// The reply body is read with a single call and the views point into it.
+	Int32 bodyLength = _header.messageLength() - MSG_HEADER_SIZE - 20;
+	if ( bodyLength < 0 || _numberReturned < 0 )
+	{
+		throw DataFormatException("Invalid reply message length");
+	}
+	if ( bodyLength == 0 )
+	{
+		return;
+	}
+
+	_buffer.resize(bodyLength, false); // only reallocates when growing
+	istr.read(_buffer.begin(), bodyLength);
+	if ( istr.gcount() != bodyLength )
+	{
+		throw DataFormatException("Truncated reply message");
+	}
+
+	_views.reserve(_numberReturned);
+	const char* pos = _buffer.begin();
+	const char* end = pos + bodyLength;
+	for(int i = 0; i < _numberReturned; ++i)
+	{
+		DocumentView view(pos, end - pos);
+		_views.push_back(view);
+		pos += view.size();
+	}
+}
+
 }} // Namespace MongoDB
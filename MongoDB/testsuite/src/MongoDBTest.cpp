@@ -29,22 +29,242 @@
 // DEALINGS IN THE SOFTWARE.
 //
 #include <iostream>
+#include <sstream>
 
 #include "Poco/DateTime.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/StreamCopier.h"
 
 #include "Poco/MongoDB/InsertRequest.h"
 #include "Poco/MongoDB/QueryRequest.h"
 #include "Poco/MongoDB/DeleteRequest.h"
+#include "Poco/MongoDB/Array.h"
+#include "Poco/MongoDB/Binary.h"
+#include "Poco/MongoDB/ObjectId.h"
+#include "Poco/MongoDB/DocumentView.h"
+#include "Poco/MongoDB/BSONOutputStream.h"
+#include "Poco/MongoDB/Cursor.h"
+#include "Poco/MongoDB/ConnectionPool.h"
+#include "Poco/MongoDB/ReplicaSet.h"
+#include "Poco/MongoDB/AsyncClient.h"
+#include "Poco/MongoDB/BSONToJSON.h"
+#include "Poco/MongoDB/JSONToBSON.h"
+#include "Poco/JSON/Parser.h"
+#include "Poco/JSON/Writer.h"
 
 #include "Poco/Net/NetException.h"
 
 #include "MongoDBTest.h"
+#include "TestServer.h"
 #include "CppUnit/TestCaller.h"
 #include "CppUnit/TestSuite.h"
 
 using namespace Poco::MongoDB;
 
 
+namespace
+{
+	std::string makeReply(Document::Vector& documents)
+		/// Returns an OP_REPLY message containing the given documents,
+		/// as it would be sent by the server.
+	{
+		std::ostringstream body;
+		Poco::BinaryWriter bodyWriter(body, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+		for(Document::Vector::iterator it = documents.begin(); it != documents.end(); ++it)
+		{
+			(*it)->write(bodyWriter);
+		}
+		bodyWriter.flush();
+
+		std::ostringstream reply;
+		Poco::BinaryWriter writer(reply, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+		writer << (Poco::Int32) (16 + 20 + body.str().size());
+		writer << (Poco::Int32) 1; // requestID
+		writer << (Poco::Int32) 1; // responseTo
+		writer << (Poco::Int32) MessageHeader::Reply;
+		writer << (Poco::Int32) 0; // responseFlags
+		writer << (Poco::Int64) 42; // cursorID
+		writer << (Poco::Int32) 0; // startingFrom
+		writer << (Poco::Int32) documents.size();
+		writer.writeRaw(body.str());
+		writer.flush();
+		return reply.str();
+	}
+
+
+	class DocumentBuilder : public Poco::JSON::Handler
+		/// Builds Documents from parser events, as a client would
+		/// without JSONToBSON.
+	{
+	public:
+		void startObject()
+		{
+			Document::Ptr doc = new Document();
+			if ( _stack.empty() || _stack.back().isNull() ) _documents.push_back(doc);
+			else add(doc);
+			_stack.push_back(doc);
+		}
+
+		void endObject()
+		{
+			_stack.pop_back();
+		}
+
+		void startArray()
+		{
+			if ( _stack.empty() )
+			{
+				// A top-level array holds the documents.
+				_stack.push_back(Document::Ptr());
+				return;
+			}
+			Array::Ptr array = new Array();
+			add(array);
+			_stack.push_back(array);
+		}
+
+		void endArray()
+		{
+			_stack.pop_back();
+		}
+
+		void key(const std::string& k)
+		{
+			_key = k;
+		}
+
+		void null()
+		{
+			add(NullValue());
+		}
+
+		void value(int v)
+		{
+			add(v);
+		}
+
+		void value(const std::string& value)
+		{
+			add(value);
+		}
+
+		void value(double d)
+		{
+			add(d);
+		}
+
+		void value(bool b)
+		{
+			add(b);
+		}
+
+		Document::Vector& documents()
+		{
+			return _documents;
+		}
+
+	private:
+		template<typename T>
+		void add(T value)
+		{
+			Document::Ptr top = _stack.back();
+			if ( dynamic_cast<Array*>(top.get()) )
+			{
+				top->add(Poco::NumberFormatter::format(top->size()), value);
+			}
+			else
+			{
+				top->add(_key, value);
+			}
+		}
+
+		Document::Vector _documents;
+		Document::Vector _stack;
+		std::string _key;
+	};
+
+
+	class ResponseCounter : public AsyncConnection::ResponseHandler
+		/// Counts the replies and errors of an AsyncConnection and
+		/// adds up the "i" fields of the replies.
+	{
+	public:
+		ResponseCounter(int expected) : _expected(expected), _responses(0), _errors(0), _sum(0)
+		{
+		}
+
+		void onResponse(ResponseMessage& response)
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			_sum += response.views()[0].getInt32("i");
+			if ( ++_responses + _errors == _expected ) _done.set();
+		}
+
+		void onError(const Poco::Exception&)
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if ( _responses + ++_errors == _expected ) _done.set();
+		}
+
+		bool wait(long milliseconds)
+		{
+			return _done.tryWait(milliseconds);
+		}
+
+		int responses() const
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			return _responses;
+		}
+
+		int errors() const
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			return _errors;
+		}
+
+		Poco::Int64 sum() const
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			return _sum;
+		}
+
+	private:
+		int _expected;
+		int _responses;
+		int _errors;
+		Poco::Int64 _sum;
+		Poco::Event _done;
+		mutable Poco::FastMutex _mutex;
+	};
+
+
+	class QueryRunner : public Poco::Runnable
+		/// Sends queries one after another on a blocking Connection.
+	{
+	public:
+		QueryRunner(const std::string& address, int count) : _connection(address), _count(count)
+		{
+		}
+
+		void run()
+		{
+			QueryRequest request("team.players");
+			request.query().add("i", 1);
+			for(int i = 0; i < _count; ++i)
+			{
+				ResponseMessage response;
+				_connection.sendRequest(request, response);
+			}
+		}
+
+	private:
+		Connection _connection;
+		int _count;
+	};
+}
+
+
 MongoDBTest::MongoDBTest(const std::string& name)
 	: CppUnit::TestCase("MongoDB")
 	, _connected(false)
@@ -57,6 +277,292 @@ MongoDBTest::~MongoDBTest()
 }
 
 
+void MongoDBTest::testConnectionPool()
+{
+	TestServer server;
+	ConnectionPool::Ptr pPool = new ConnectionPool(Poco::Net::SocketAddress(server.address()), 2, 3, 0);
+	assert (pPool->size() == 0);
+
+	pPool->maintain();
+	assert (pPool->size() == 2);
+	assert (pPool->idle() == 2);
+
+	QueryRequest query("team.players");
+	query.query().add("name", std::string("Braun"));
+	ResponseMessage response;
+	int requests = server.requests();
+	{
+		PooledConnection c1(pPool);
+		PooledConnection c2(pPool);
+		assert (pPool->idle() == 0);
+		assert (server.requests() == requests);
+
+		// Only beyond the prestarted connections a new one is opened
+		PooledConnection c3(pPool);
+		assert (pPool->size() == 3);
+		try
+		{
+			PooledConnection c4(pPool, 50);
+			fail ("pool exhausted - must throw");
+		}
+		catch (Poco::TimeoutException&)
+		{
+		}
+
+		c3->sendRequest(query, response);
+		assert (response.documents().size() == 1);
+	}
+	assert (pPool->size() == 3);
+	assert (pPool->idle() == 3);
+
+	// With a zero idle timeout, maintain() closes everything above
+	// minSize and pings the rest.
+	pPool->maintain();
+	assert (pPool->size() == 2);
+	assert (pPool->idle() == 2);
+	assert (server.requests() == requests + 3);
+
+	// A broken connection is not taken back
+	Connection::Ptr pConnection = pPool->borrowConnection();
+	pConnection->disconnect();
+	pPool->returnConnection(pConnection);
+	assert (pPool->size() == 1);
+	pPool->maintain();
+	assert (pPool->size() == 2);
+}
+
+
+void MongoDBTest::testReplicaSet()
+{
+	TestServer primary;
+	TestServer near(1);
+	TestServer far(20);
+
+	std::vector<std::string> hosts;
+	hosts.push_back(primary.address());
+	hosts.push_back(near.address());
+	hosts.push_back(far.address());
+	hosts.push_back("127.0.0.1:1");
+	primary.setMaster(true, hosts);
+	near.setMaster(false, hosts);
+	far.setMaster(false, hosts);
+
+	// The other members are found through the seed
+	std::vector<Poco::Net::SocketAddress> seeds(1, Poco::Net::SocketAddress(far.address()));
+	ReplicaSet rs(seeds);
+	rs.setPoolSize(1, 4);
+	rs.refresh();
+
+	std::vector<ReplicaSet::Member> members = rs.members();
+	assert (members.size() == 4);
+	int reachable = 0;
+	for (std::vector<ReplicaSet::Member>::iterator it = members.begin(); it != members.end(); ++it)
+	{
+		if ( it->reachable ) ++reachable;
+	}
+	assert (reachable == 3);
+	assert (rs.primary()->address().toString() == primary.address());
+	assert (rs.secondary()->address().toString() == near.address());
+
+	QueryRequest query("team.players");
+	assert (rs.pool(query)->address().toString() == primary.address());
+	query.flags(QueryRequest::QUERY_SLAVE_OK);
+	assert (rs.pool(query)->address().toString() == near.address());
+
+	// The pools have been filled by refresh(): no I/O when acquiring
+	assert (rs.secondary()->idle() == 1);
+	int requests = near.requests();
+	{
+		PooledConnection connection(rs.pool(query));
+		assert (near.requests() == requests);
+		ResponseMessage response;
+		connection->sendRequest(query, response);
+		assert (response.documents().size() == 1);
+	}
+
+	// Failover
+	primary.setMaster(false, hosts);
+	near.setMaster(true, hosts);
+	rs.refresh();
+	assert (rs.primary()->address().toString() == near.address());
+	assert (rs.secondary()->address().toString() == primary.address());
+	Connection::Ptr pMaster = rs.findMaster();
+	assert (!pMaster.isNull());
+	assert (pMaster->address().toString() == near.address());
+
+	// The monitor picks up changes in the background
+	rs.setMonitorInterval(10);
+	rs.start();
+	near.setMaster(false, hosts);
+	primary.setMaster(true, hosts);
+	for (int i = 0; i < 100; ++i)
+	{
+		try
+		{
+			if ( rs.primary()->address().toString() == primary.address() ) break;
+		}
+		catch (Poco::NotFoundException&)
+		{
+			// between the step-down and the election
+		}
+		Poco::Thread::sleep(20);
+	}
+	assert (rs.primary()->address().toString() == primary.address());
+	rs.stop();
+}
+
+
+void MongoDBTest::testDocumentOrder()
+{
+	// Commands depend on the field order: the command name comes first.
+	Document command;
+	command.add("findAndModify", std::string("players"));
+	command.add("query", Document::Ptr(new Document()));
+	command.add("new", true);
+	command.add("upsert", false);
+	command.add("limit", (Poco::Int64) 10);
+	command.add("maxTime", 1.5);
+	command.add("since", Poco::Timestamp(1354000000000000LL));
+	assert (command.size() == 7);
+
+	BSONOutputStream bson;
+	Poco::BinaryWriter writer(bson, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+	command.write(writer);
+	DocumentView view(bson.data(), bson.size());
+	const char* names[] = { "findAndModify", "query", "new", "upsert", "limit", "maxTime", "since" };
+	int n = 0;
+	for(DocumentView::Iterator it = view.begin(); it != view.end(); ++it, ++n)
+	{
+		assert (it->name() == std::string(names[n]));
+	}
+	assert (n == 7);
+
+	// Reading keeps the order and the inline values
+	std::istringstream istr(std::string(bson.data(), bson.size()));
+	Poco::BinaryReader reader(istr, Poco::BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
+	Document copy;
+	copy.read(reader);
+	assert (copy.toString() == "findAndModify query new upsert limit maxTime since ");
+	assert (copy.get<bool>("new"));
+	assert (!copy.get<bool>("upsert"));
+	assert (copy.get<Poco::Int64>("limit") == 10);
+	assert (copy.get<double>("maxTime") == 1.5);
+	assert (copy.get<Poco::Timestamp>("since") == Poco::Timestamp(1354000000000000LL));
+	assert (copy.get("limit")->toString() == "10");
+	assert (copy.isType<Document::Ptr>("query"));
+
+	// Elements added directly are unpacked into inline values
+	copy.addElement(new ConcreteElement<Poco::Int32>("extra", 42));
+	assert (copy.get<Poco::Int32>("extra") == 42);
+
+	// A wide document is looked up through the hash index
+	Document wide;
+	for(int i = 0; i < 100; ++i)
+	{
+		wide.add("field" + Poco::NumberFormatter::format(i), i);
+	}
+	assert (wide.get<Poco::Int32>("field42") == 42);
+	wide.add("field100", 100);
+	wide.add("field0", -1);
+	assert (wide.get<Poco::Int32>("field100") == 100);
+	assert (wide.get<Poco::Int32>("field0") == 0);
+	assert (!wide.exists("field101"));
+
+	Document wideCopy(wide);
+	wideCopy.add("field101", 101);
+	assert (wideCopy.get<Poco::Int32>("field101") == 101);
+	assert (!wide.exists("field101"));
+	wideCopy.clear();
+	assert (wideCopy.empty());
+	assert (!wideCopy.exists("field42"));
+}
+
+
+void MongoDBTest::testDocumentBenchmark()
+{
+	const int widths[] = { 10, 100, 1000 };
+	const int totalFields = 2000000;
+
+	std::cout << std::endl << "Documents with " << totalFields << " fields in total:";
+	for(int w = 0; w < 3; ++w)
+	{
+		const int width = widths[w];
+		const int count = totalFields / width;
+		std::vector<std::string> names;
+		for(int i = 0; i < width; ++i)
+		{
+			names.push_back("field" + Poco::NumberFormatter::format(i));
+		}
+
+		Poco::Stopwatch sw;
+		Document::Vector documents;
+		sw.start();
+		for(int n = 0; n < count; ++n)
+		{
+			Document::Ptr doc = new Document();
+			for(int i = 0; i < width; ++i)
+			{
+				switch(i % 4)
+				{
+				case 0: doc->add(names[i], i); break;
+				case 1: doc->add(names[i], i * 0.5); break;
+				case 2: doc->add(names[i], i % 3 == 0); break;
+				case 3: doc->add(names[i], names[i]); break;
+				}
+			}
+			documents.push_back(doc);
+		}
+		sw.stop();
+		Poco::Timestamp::TimeDiff buildTime = sw.elapsed();
+
+		BSONOutputStream bson;
+		Poco::BinaryWriter writer(bson, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+		sw.restart();
+		for(Document::Vector::iterator it = documents.begin(); it != documents.end(); ++it)
+		{
+			(*it)->write(writer);
+		}
+		sw.stop();
+		Poco::Timestamp::TimeDiff writeTime = sw.elapsed();
+
+		std::istringstream istr(std::string(bson.data(), bson.size()));
+		Poco::BinaryReader reader(istr, Poco::BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
+		Document::Vector readDocuments;
+		sw.restart();
+		for(int n = 0; n < count; ++n)
+		{
+			Document::Ptr doc = new Document();
+			doc->read(reader);
+			readDocuments.push_back(doc);
+		}
+		sw.stop();
+		Poco::Timestamp::TimeDiff readTime = sw.elapsed();
+
+		Poco::Int64 sum = 0;
+		sw.restart();
+		for(Document::Vector::iterator it = readDocuments.begin(); it != readDocuments.end(); ++it)
+		{
+			for(int i = 0; i < width; i += 4)
+			{
+				sum += (*it)->get<Poco::Int32>(names[i]);
+			}
+		}
+		sw.stop();
+		Poco::Timestamp::TimeDiff lookupTime = sw.elapsed();
+		Poco::Int64 expected = 0;
+		for(int i = 0; i < width; i += 4) expected += i;
+		assert (sum == expected * count);
+
+		std::cout << std::endl << "  " << count << " x " << width << " fields: "
+			<< "build " << buildTime / 1000 << " ms, "
+			<< "write " << writeTime / 1000 << " ms, "
+			<< "read " << readTime / 1000 << " ms, "
+			<< "get " << lookupTime / 1000 << " ms";
+	}
+	std::cout << std::endl;
+}
+
+
 void MongoDBTest::setUp()
 {
 	try
@@ -198,6 +704,973 @@ void MongoDBTest::testDeleteRequest()
 	_mongo.sendRequest(request);
 }
 
+
+void MongoDBTest::testDocumentView()
+{
+	Poco::DateTime birthdate;
+	birthdate.assign(1969, 3, 9);
+
+	Document::Ptr address = new Document();
+	address->add("city", std::string("Antwerp"));
+
+	Array::Ptr tags = new Array();
+	tags->add("0", std::string("left"));
+	tags->add("1", std::string("back"));
+
+	Document::Vector documents;
+	Document::Ptr player = new Document();
+	player->add("lastname", std::string("Braem"));
+	player->add("start", 1993);
+	player->add("score", 7.5);
+	player->add("active", false);
+	player->add("caps", (Poco::Int64) 5000000000LL);
+	player->add("birthdate", birthdate.timestamp());
+	player->add("address", address);
+	player->add("tags", tags);
+	player->add("unknown", NullValue());
+	documents.push_back(player);
+	documents.push_back(new Document());
+
+	std::string reply = makeReply(documents);
+
+	ResponseMessage response;
+	response.readViews(true);
+	std::istringstream istr(reply);
+	response.read(istr);
+
+	assert (response.cursorID() == 42);
+	assert (response.documents().empty());
+	assert (response.views().size() == 2);
+
+	DocumentView view = response.views()[0];
+	assert (view.getString("lastname") == std::string("Braem"));
+	assert (view.getInt32("start") == 1993);
+	assert (view.getDouble("score") == 7.5);
+	assert (!view.getBool("active"));
+	assert (view.getInt64("caps") == 5000000000LL);
+	assert (view.getTimestamp("birthdate") == birthdate.timestamp());
+	assert (view.isNull("unknown"));
+	assert (view.getDocument("address").getString("city") == std::string("Antwerp"));
+	assert (view.exists("tags"));
+	assert (!view.exists("firstname"));
+	assert (view.fieldCount() == 9);
+
+	// The string points into the response buffer
+	StringView lastname = view.getString("lastname");
+	assert (lastname.data() > view.data() && lastname.data() < view.data() + view.size());
+
+	DocumentView tagsView = view.getArray("tags");
+	std::string joined;
+	for(DocumentView::Iterator it = tagsView.begin(); it != tagsView.end(); ++it)
+	{
+		joined += it->name().toString() + "=" + it->asString().toString() + " ";
+	}
+	assert (joined == "0=left 1=back ");
+
+	try
+	{
+		view.getInt32("lastname");
+		fail("type mismatch - must throw");
+	}
+	catch(Poco::BadCastException&)
+	{
+	}
+
+	try
+	{
+		view.getArray("address");
+		fail("type mismatch - must throw");
+	}
+	catch(Poco::BadCastException&)
+	{
+	}
+
+	try
+	{
+		view.getString("firstname");
+		fail("missing field - must throw");
+	}
+	catch(Poco::NotFoundException&)
+	{
+	}
+
+	assert (response.views()[1].empty());
+	assert (response.views()[1].begin() == response.views()[1].end());
+
+	Document::Ptr copy = view.toDocument();
+	assert (copy->get<std::string>("lastname") == "Braem");
+	assert (copy->get<Poco::Int32>("start") == 1993);
+	assert (!copy->get<bool>("active"));
+
+	// The same reply still decodes into documents by default
+	ResponseMessage documentResponse;
+	std::istringstream istr2(reply);
+	documentResponse.read(istr2);
+	assert (documentResponse.views().empty());
+	assert (documentResponse.documents().size() == 2);
+	assert (documentResponse.documents()[0]->get<std::string>("lastname") == "Braem");
+	assert (documentResponse.documents()[0]->get<Poco::Int64>("caps") == 5000000000LL);
+
+	// Corrupt the length of the first document
+	std::string corrupt(reply);
+	corrupt[36] = 0x7f;
+	std::istringstream istr3(corrupt);
+	try
+	{
+		response.read(istr3);
+		fail("invalid document - must throw");
+	}
+	catch(Poco::DataFormatException&)
+	{
+	}
+}
+
+
+void MongoDBTest::testDocumentViewBenchmark()
+{
+	const int documentCount = 10000;
+	const int iterations = 20;
+
+	Document::Vector documents;
+	for(int i = 0; i < documentCount; ++i)
+	{
+		Document::Ptr doc = new Document();
+		doc->add("name", std::string("player") + Poco::NumberFormatter::format(i));
+		doc->add("number", i);
+		doc->add("score", i * 0.5);
+		doc->add("active", i % 2 == 0);
+		doc->add("team", std::string("Royal Antwerp FC"));
+		Document::Ptr stats = new Document();
+		stats->add("goals", i % 30);
+		stats->add("games", i % 50);
+		doc->add("stats", stats);
+		documents.push_back(doc);
+	}
+	std::string reply = makeReply(documents);
+
+	Poco::Stopwatch sw;
+	Poco::Int64 documentSum = 0;
+	ResponseMessage documentResponse;
+	sw.start();
+	for(int n = 0; n < iterations; ++n)
+	{
+		std::istringstream istr(reply);
+		documentResponse.read(istr);
+		for(Document::Vector::iterator it = documentResponse.documents().begin(); it != documentResponse.documents().end(); ++it)
+		{
+			documentSum += (*it)->get<Poco::Int32>("number");
+			documentSum += (*it)->get<std::string>("name").size();
+		}
+	}
+	sw.stop();
+	Poco::Timestamp::TimeDiff documentTime = sw.elapsed();
+
+	Poco::Int64 viewSum = 0;
+	ResponseMessage viewResponse;
+	viewResponse.readViews(true);
+	sw.restart();
+	for(int n = 0; n < iterations; ++n)
+	{
+		std::istringstream istr(reply);
+		viewResponse.read(istr);
+		for(DocumentView::Vector::iterator it = viewResponse.views().begin(); it != viewResponse.views().end(); ++it)
+		{
+			viewSum += it->getInt32("number");
+			viewSum += it->getString("name").size();
+		}
+	}
+	sw.stop();
+	Poco::Timestamp::TimeDiff viewTime = sw.elapsed();
+
+	assert (documentSum == viewSum);
+
+	std::cout << std::endl << iterations << " x " << documentCount << " documents (" << reply.size() << " bytes): "
+		<< "Document " << documentTime / 1000 << " ms, "
+		<< "DocumentView " << viewTime / 1000 << " ms" << std::endl;
+}
+
+
+void MongoDBTest::testInsertRequestEncoding()
+{
+	Poco::MongoDB::InsertRequest request("team.players");
+	for(int i = 0; i < 3; ++i)
+	{
+		Document::Ptr player = new Document();
+		player->add("number", i);
+		player->add("lastname", std::string("Braem"));
+		Document::Ptr stats = new Document();
+		stats->add("goals", i * 10);
+		Document::Ptr season = new Document();
+		season->add("year", 1993 + i);
+		stats->add("season", season);
+		player->add("stats", stats);
+		request.documents().push_back(player);
+	}
+
+	std::ostringstream ostr;
+	request.send(ostr);
+	std::string message = ostr.str();
+
+	BSONOutputStream bson;
+	request.build(bson);
+	assert (std::string(bson.data(), bson.size()) == message);
+
+	// header
+	std::istringstream istr(message);
+	Poco::BinaryReader reader(istr, Poco::BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
+	Poco::Int32 messageLength, requestID, responseTo, opCode, flags;
+	reader >> messageLength >> requestID >> responseTo >> opCode >> flags;
+	assert (messageLength == (Poco::Int32) message.size());
+	assert (opCode == MessageHeader::Insert);
+	assert (BSONReader(reader).readCString() == "team.players");
+
+	// documents, with all (nested) length prefixes patched
+	std::size_t pos = 16 + 4 + std::string("team.players").size() + 1;
+	for(int i = 0; i < 3; ++i)
+	{
+		DocumentView view(message.data() + pos, message.size() - pos);
+		assert (view.getInt32("number") == i);
+		assert (view.getString("lastname") == std::string("Braem"));
+		DocumentView stats = view.getDocument("stats");
+		assert (stats.getInt32("goals") == i * 10);
+		assert (stats.getDocument("season").getInt32("year") == 1993 + i);
+		pos += view.size();
+	}
+	assert (pos == message.size());
+
+	// A document written to a plain stream goes through a temporary buffer
+	std::ostringstream plain;
+	Poco::BinaryWriter plainWriter(plain, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+	request.documents()[0]->write(plainWriter);
+	plainWriter.flush();
+	DocumentView first(message.data() + 16 + 4 + 13, message.size());
+	assert (plain.str() == std::string(first.data(), first.size()));
+
+	// The stream grows and can be reused
+	BSONOutputStream small(8);
+	request.build(small);
+	assert (std::string(small.data(), small.size()) == message);
+	small.reset();
+	assert (small.size() == 0);
+	request.build(small);
+	assert (std::string(small.data(), small.size()) == message);
+}
+
+
+void MongoDBTest::testInsertBatchBenchmark()
+{
+	const int documentCount = 5000;
+	const int iterations = 20;
+
+	Poco::MongoDB::InsertRequest request("team.players");
+	for(int i = 0; i < documentCount; ++i)
+	{
+		Document::Ptr doc = new Document();
+		doc->add("name", std::string("player") + Poco::NumberFormatter::format(i));
+		doc->add("number", i);
+		doc->add("score", i * 0.5);
+		doc->add("team", std::string("Royal Antwerp FC"));
+		Document::Ptr stats = new Document();
+		stats->add("goals", i % 30);
+		stats->add("games", i % 50);
+		Document::Ptr season = new Document();
+		season->add("year", 1993);
+		season->add("league", std::string("Jupiler Pro League"));
+		stats->add("season", season);
+		doc->add("stats", stats);
+		request.documents().push_back(doc);
+	}
+
+	Poco::Stopwatch sw;
+	std::size_t size = 0;
+	sw.start();
+	for(int n = 0; n < iterations; ++n)
+	{
+		std::ostringstream ostr;
+		request.send(ostr);
+		size = ostr.str().size();
+	}
+	sw.stop();
+	Poco::Timestamp::TimeDiff streamTime = sw.elapsed();
+
+	// Baseline: the body is assembled in a std::stringstream and copied
+	// behind the header, as RequestMessage::send did before BSONOutputStream.
+	std::size_t baselineSize = 0;
+	sw.restart();
+	for(int n = 0; n < iterations; ++n)
+	{
+		std::stringstream body;
+		Poco::BinaryWriter bodyWriter(body, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+		bodyWriter << (Poco::Int32) 0;
+		BSONWriter(bodyWriter).writeCString("team.players");
+		for(Document::Vector::iterator it = request.documents().begin(); it != request.documents().end(); ++it)
+		{
+			(*it)->write(bodyWriter);
+		}
+		bodyWriter.flush();
+
+		std::ostringstream ostr;
+		Poco::BinaryWriter headerWriter(ostr, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+		request.header().write(headerWriter);
+		headerWriter.flush();
+		Poco::StreamCopier::copyStream(body, ostr);
+		baselineSize = ostr.str().size();
+	}
+	sw.stop();
+	Poco::Timestamp::TimeDiff baselineTime = sw.elapsed();
+	assert (baselineSize == size);
+
+	BSONOutputStream bson;
+	sw.restart();
+	for(int n = 0; n < iterations; ++n)
+	{
+		bson.reset();
+		request.build(bson);
+	}
+	sw.stop();
+	Poco::Timestamp::TimeDiff bufferTime = sw.elapsed();
+
+	assert (bson.size() == size);
+
+	std::cout << std::endl << iterations << " x " << documentCount << " documents (" << size << " bytes): "
+		<< "stringstream " << baselineTime / 1000 << " ms, "
+		<< "send(ostream) " << streamTime / 1000 << " ms, "
+		<< "build(BSONOutputStream) " << bufferTime / 1000 << " ms" << std::endl;
+}
+
+
+void MongoDBTest::testPipelining()
+{
+	TestServer server(5);
+	Connection connection("127.0.0.1", server.port());
+
+	QueryRequest first("team.players");
+	first.query().add("i", -1);
+	ResponseMessage response;
+	connection.sendRequest(first, response);
+	assert (!connection.isPipelined());
+	assert (response.header().responseTo() == first.header().requestID());
+	assert (response.documents()[0]->get<Poco::Int32>("i") == -1);
+
+	std::vector<Poco::SharedPtr<QueryRequest> > requests;
+	std::vector<Connection::AsyncResponse> results;
+	for(int i = 0; i < 50; ++i)
+	{
+		Poco::SharedPtr<QueryRequest> request = new QueryRequest("team.players");
+		request->query().add("i", i);
+		requests.push_back(request);
+		results.push_back(connection.sendRequestAsync(*request));
+	}
+	assert (connection.isPipelined());
+	for(int i = 0; i < 50; ++i)
+	{
+		assert (requests[i]->header().requestID() > (i == 0 ? first.header().requestID() : requests[i - 1]->header().requestID()));
+		results[i].wait();
+		assert (!results[i].failed());
+		ResponseMessage& reply = results[i].data();
+		assert (reply.header().responseTo() == requests[i]->header().requestID());
+		assert (reply.documents()[0]->get<Poco::Int32>("i") == i);
+	}
+
+	// A batch written with one sendBytes() call, read as views
+	std::vector<RequestMessage*> batch;
+	for(int i = 0; i < 10; ++i) batch.push_back(requests[i].get());
+	std::vector<Connection::AsyncResponse> batchResults;
+	connection.sendRequestsAsync(batch, batchResults, true);
+	assert (batchResults.size() == 10);
+	for(int i = 0; i < 10; ++i)
+	{
+		batchResults[i].wait();
+		assert (batchResults[i].data().views()[0].getInt32("i") == i);
+	}
+
+	// Blocking requests are routed through the reader thread as well
+	connection.sendRequest(first, response);
+	assert (response.documents()[0]->get<Poco::Int32>("i") == -1);
+	assert (connection.pendingRequests() == 0);
+
+	try
+	{
+		InsertRequest insert("team.players");
+		connection.sendRequestAsync(insert);
+		fail("insert has no response - must throw");
+	}
+	catch(Poco::InvalidArgumentException&)
+	{
+	}
+
+	// Outstanding requests fail when the connection goes away
+	Connection::AsyncResponse pending = connection.sendRequestAsync(first);
+	connection.disconnect();
+	assert (pending.available());
+	assert (pending.failed());
+}
+
+
+void MongoDBTest::testPipeliningBenchmark()
+{
+	const int count = 200;
+	const long latency = 1;
+
+	TestServer server(latency);
+	Connection connection("127.0.0.1", server.port());
+
+	std::vector<Poco::SharedPtr<QueryRequest> > requests;
+	for(int i = 0; i < count; ++i)
+	{
+		Poco::SharedPtr<QueryRequest> request = new QueryRequest("team.players");
+		request->query().add("i", i);
+		requests.push_back(request);
+	}
+
+	Poco::Stopwatch sw;
+	sw.start();
+	for(int i = 0; i < count; ++i)
+	{
+		ResponseMessage response;
+		connection.sendRequest(*requests[i], response);
+	}
+	sw.stop();
+	Poco::Timestamp::TimeDiff sequentialTime = sw.elapsed();
+
+	std::vector<Connection::AsyncResponse> results;
+	sw.restart();
+	for(int i = 0; i < count; ++i)
+	{
+		results.push_back(connection.sendRequestAsync(*requests[i]));
+	}
+	for(int i = 0; i < count; ++i)
+	{
+		results[i].wait();
+	}
+	sw.stop();
+	Poco::Timestamp::TimeDiff pipelinedTime = sw.elapsed();
+
+	std::cout << std::endl << count << " queries, " << latency << " ms server latency: "
+		<< "sequential " << sequentialTime / 1000 << " ms (" << count * 1000000.0 / sequentialTime << " req/s, "
+		<< sequentialTime / count << " us/req round-trip), "
+		<< "pipelined " << pipelinedTime / 1000 << " ms (" << count * 1000000.0 / pipelinedTime << " req/s)" << std::endl;
+}
+
+
+void MongoDBTest::testCursor()
+{
+	TestServer server;
+	Connection connection("127.0.0.1", server.port());
+
+	{
+		Cursor cursor(connection, "team.players");
+		cursor.query().add("count", 1000);
+		cursor.batchSize(100);
+		cursor.prefetch(2);
+		int n = 0;
+		while ( cursor.next() )
+		{
+			assert (cursor.document()->get<Poco::Int32>("i") == n);
+			++n;
+		}
+		assert (n == 1000);
+		assert (cursor.cursorID() == 0);
+		assert (!cursor.next());
+	}
+
+	// Prefetching beyond the end and reading views
+	{
+		Cursor cursor(connection, "team.players");
+		cursor.query().add("count", 250);
+		cursor.batchSize(100);
+		cursor.prefetch(4);
+		cursor.readViews(true);
+		int n = 0;
+		while ( cursor.next() )
+		{
+			assert (cursor.view().getInt32("i") == n);
+			++n;
+		}
+		assert (n == 250);
+	}
+
+	// Without prefetching
+	{
+		Cursor cursor(connection, "team.players");
+		cursor.query().add("count", 10);
+		cursor.batchSize(3);
+		cursor.prefetch(0);
+		int n = 0;
+		while ( cursor.next() ) ++n;
+		assert (n == 10);
+	}
+
+	// An empty result
+	{
+		Cursor cursor(connection, "team.players");
+		cursor.query().add("count", 0);
+		assert (!cursor.next());
+	}
+	assert (server.openCursors() == 0);
+	assert (server.killedCursors() == 0);
+
+	// Destroying an open cursor kills it on the server
+	{
+		Cursor cursor(connection, "team.players");
+		cursor.query().add("count", 1000);
+		cursor.batchSize(100);
+		for(int i = 0; i < 150; ++i)
+		{
+			assert (cursor.next());
+		}
+		assert (cursor.cursorID() != 0);
+	}
+	// The server handles requests in order: after this round trip the kill has been processed.
+	QueryRequest ping("team.players");
+	ResponseMessage response;
+	connection.sendRequest(ping, response);
+	assert (server.killedCursors() == 1);
+	assert (server.openCursors() == 0);
+	assert (connection.pendingRequests() == 0);
+}
+
+
+void MongoDBTest::testCursorBenchmark()
+{
+	const int count = 20000;
+	const int batchSize = 500;
+	const long latency = 2;
+
+	TestServer server(latency);
+	Connection connection("127.0.0.1", server.port());
+
+	Poco::Stopwatch sw;
+	int depths[] = { 0, 1, 2, 4 };
+	std::cout << std::endl << count << " documents in batches of " << batchSize << ", "
+		<< latency << " ms server latency, 2 ms processing per batch:";
+	for(int d = 0; d < 4; ++d)
+	{
+		Cursor cursor(connection, "team.players");
+		cursor.query().add("count", count);
+		cursor.batchSize(batchSize);
+		cursor.prefetch(depths[d]);
+		cursor.readViews(true);
+
+		int n = 0;
+		sw.restart();
+		while ( cursor.next() )
+		{
+			if ( ++n % batchSize == 0 ) Poco::Thread::sleep(2);
+		}
+		sw.stop();
+		assert (n == count);
+		std::cout << std::endl << "  prefetch " << depths[d] << ": " << sw.elapsed() / 1000 << " ms";
+	}
+	std::cout << std::endl;
+}
+
+
+void MongoDBTest::testBSONToJSON()
+{
+	Document::Ptr address = new Document();
+	address->add("city", std::string("Gent"));
+	Array::Ptr tags = new Array();
+	tags->add("0", 1);
+	tags->add("1", std::string("x\ty"));
+	Binary::Ptr binary = new Binary(3, 0x80);
+	memcpy(binary->buffer().begin(), "abc", 3);
+
+	Document doc;
+	doc.add("name", std::string("Franky"));
+	doc.add("age", 42);
+	doc.add("height", 1.85);
+	doc.add("weight", 80.0);
+	doc.add("big", (Poco::Int64) 5000000000LL);
+	doc.add("alive", true);
+	doc.add("spouse", NullValue());
+	doc.add("born", Poco::Timestamp(1234000));
+	doc.add("address", address);
+	doc.add("tags", tags);
+	doc.add("data", binary);
+
+	BSONOutputStream bson;
+	Poco::BinaryWriter writer(bson, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+	doc.write(writer);
+
+	Poco::JSON::Writer json;
+	BSONToJSON bsonToJSON(json);
+	assert(bsonToJSON.write(bson.data(), bson.size()) == bson.size());
+	assert(json.str() == "{\"name\":\"Franky\",\"age\":42,\"height\":1.85,\"weight\":80.0,"
+		"\"big\":{\"$numberLong\":\"5000000000\"},\"alive\":true,\"spouse\":null,"
+		"\"born\":{\"$date\":1234},\"address\":{\"city\":\"Gent\"},\"tags\":[1,\"x\\ty\"],"
+		"\"data\":{\"$binary\":\"YWJj\",\"$type\":\"80\"}}");
+
+	// A document view writes the same text.
+	Poco::JSON::Writer viewJSON;
+	BSONToJSON viewToJSON(viewJSON);
+	viewToJSON.write(DocumentView(bson.data(), bson.size()));
+	assert(viewJSON.str() == json.str());
+
+	// A truncated document is rejected.
+	Poco::JSON::Writer truncated;
+	BSONToJSON truncatedToJSON(truncated);
+	try
+	{
+		truncatedToJSON.write(bson.data(), bson.size() - 1);
+		fail("truncated document must throw");
+	}
+	catch(Poco::DataFormatException&)
+	{
+	}
+}
+
+
+void MongoDBTest::testJSONToBSON()
+{
+	// BSON -> JSON -> BSON gives the same bytes.
+	Document::Ptr nested = new Document();
+	nested->add("a", 1.0);
+	nested->add("b", std::string("\xc3\xa9"));
+	Array::Ptr array = new Array();
+	array->add("0", nested);
+	array->add("1", -7);
+	Binary::Ptr binary = new Binary(5, 0x00);
+	memcpy(binary->buffer().begin(), "hello", 5);
+
+	Document doc;
+	doc.add("string", std::string("value"));
+	doc.add("int", 2147483647);
+	doc.add("long", (Poco::Int64) -9000000000LL);
+	doc.add("double", 2.5);
+	doc.add("integral", -3.0);
+	doc.add("bool", false);
+	doc.add("null", NullValue());
+	doc.add("date", Poco::Timestamp(1357000000000000LL));
+	doc.add("nested", nested);
+	doc.add("array", array);
+	doc.add("binary", binary);
+
+	BSONOutputStream original;
+	Poco::BinaryWriter writer(original, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+	doc.write(writer);
+
+	Poco::JSON::Writer json;
+	BSONToJSON bsonToJSON(json);
+	bsonToJSON.write(original.data(), original.size());
+
+	BSONOutputStream roundTrip;
+	JSONToBSON jsonToBSON(roundTrip);
+	Poco::JSON::Parser parser;
+	parser.setHandler(&jsonToBSON);
+	parser.parse(json.str());
+	assert(jsonToBSON.documents() == 1);
+	assert(roundTrip.size() == original.size());
+	assert(std::string(roundTrip.data(), roundTrip.size()) == std::string(original.data(), original.size()));
+
+	// Extended JSON -> BSON -> JSON gives the same text.
+	std::string extended = "{\"_id\":{\"$oid\":\"50a9f8e3c2b1a09f8e7d6c5b\"},"
+		"\"re\":{\"$regex\":\"^a.*\",\"$options\":\"i\"},"
+		"\"code\":{\"$code\":\"function() {}\"},"
+		"\"ts\":{\"$timestamp\":{\"t\":1357000000,\"i\":3}},"
+		"\"min\":{\"$minKey\":1},\"max\":{\"$maxKey\":1},"
+		"\"list\":[{\"$numberLong\":\"1\"},{\"$oid\":\"000000000000000000000001\"}]}";
+	BSONOutputStream bson;
+	JSONToBSON extendedToBSON(bson);
+	parser.setHandler(&extendedToBSON);
+	parser.parse(extended);
+	Poco::JSON::Writer extendedJSON;
+	BSONToJSON extendedToJSON(extendedJSON);
+	extendedToJSON.write(bson.data(), bson.size());
+	assert(extendedJSON.str() == extended);
+
+	DocumentView view(bson.data(), bson.size());
+	assert(view.type("_id") == ElementTraits<ObjectId::Ptr>::TypeId);
+	assert(view.type("list") == ElementTraits<Array::Ptr>::TypeId);
+
+	// $date also accepts a $numberLong, and operators stay documents.
+	BSONOutputStream query;
+	JSONToBSON queryToBSON(query);
+	parser.setHandler(&queryToBSON);
+	parser.parse("[{\"at\":{\"$date\":{\"$numberLong\":\"1234\"}}},"
+		"{\"age\":{\"$gt\":18,\"$type\":2},\"n\":{}}]");
+	assert(queryToBSON.documents() == 2);
+	Poco::JSON::Writer queryJSON;
+	BSONToJSON queryToJSON(queryJSON);
+	queryJSON.startArray();
+	std::size_t offset = queryToJSON.write(query.data(), query.size());
+	queryToJSON.write(query.data() + offset, query.size() - offset);
+	queryJSON.endArray();
+	assert(queryJSON.str() == "[{\"at\":{\"$date\":1234}},{\"age\":{\"$gt\":18,\"$type\":2},\"n\":{}}]");
+
+	// Values outside a document and malformed extended JSON are rejected.
+	const char* invalid[] = { "[1]", "[[{}]]", "{\"id\":{\"$oid\":\"xyz\"}}", "{\"n\":{\"$numberLong\":1}}" };
+	for(int i = 0; i < 4; ++i)
+	{
+		BSONOutputStream out;
+		JSONToBSON handler(out);
+		parser.setHandler(&handler);
+		try
+		{
+			parser.parse(invalid[i]);
+			fail("invalid input must throw");
+		}
+		catch(Poco::DataFormatException&)
+		{
+		}
+	}
+}
+
+
+void MongoDBTest::testTranscodeBenchmark()
+{
+	const int count = 100000;
+
+	Document::Vector documents;
+	for(int n = 0; n < count; ++n)
+	{
+		Document::Ptr address = new Document();
+		address->add("street", std::string("Main Street"));
+		address->add("number", n % 200);
+		Document::Ptr doc = new Document();
+		doc->add("id", n);
+		doc->add("name", "user" + Poco::NumberFormatter::format(n));
+		doc->add("score", n * 0.25);
+		doc->add("active", n % 2 == 0);
+		doc->add("balance", n * 1.5);
+		doc->add("email", std::string("user@example.com"));
+		doc->add("address", address);
+		documents.push_back(doc);
+	}
+
+	BSONOutputStream bson;
+	Poco::BinaryWriter writer(bson, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+	for(Document::Vector::iterator it = documents.begin(); it != documents.end(); ++it)
+	{
+		(*it)->write(writer);
+	}
+
+	// BSON -> JSON through Document::read and Document::toString.
+	Poco::Stopwatch sw;
+	std::istringstream istr(std::string(bson.data(), bson.size()));
+	Poco::BinaryReader reader(istr, Poco::BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
+	std::string domText("[");
+	sw.start();
+	for(int n = 0; n < count; ++n)
+	{
+		Document doc;
+		doc.read(reader);
+		if ( n > 0 ) domText += ',';
+		domText += doc.toString();
+	}
+	domText += ']';
+	sw.stop();
+	Poco::Timestamp::TimeDiff domToJSON = sw.elapsed();
+
+	// BSON -> JSON with BSONToJSON.
+	Poco::JSON::Writer json;
+	BSONToJSON bsonToJSON(json);
+	sw.restart();
+	json.startArray();
+	std::size_t offset = 0;
+	while ( offset < bson.size() )
+	{
+		offset += bsonToJSON.write(bson.data() + offset, bson.size() - offset);
+	}
+	json.endArray();
+	sw.stop();
+	Poco::Timestamp::TimeDiff streamToJSON = sw.elapsed();
+
+	// JSON -> BSON through Documents.
+	Poco::JSON::Parser parser;
+	DocumentBuilder builder;
+	BSONOutputStream domBSON;
+	Poco::BinaryWriter domWriter(domBSON, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+	sw.restart();
+	parser.setHandler(&builder);
+	parser.parse(json.str());
+	for(Document::Vector::iterator it = builder.documents().begin(); it != builder.documents().end(); ++it)
+	{
+		(*it)->write(domWriter);
+	}
+	sw.stop();
+	Poco::Timestamp::TimeDiff domToBSON = sw.elapsed();
+
+	// JSON -> BSON with JSONToBSON.
+	BSONOutputStream streamBSON;
+	JSONToBSON jsonToBSON(streamBSON);
+	sw.restart();
+	parser.setHandler(&jsonToBSON);
+	parser.parse(json.str());
+	sw.stop();
+	Poco::Timestamp::TimeDiff streamToBSON = sw.elapsed();
+
+	assert(jsonToBSON.documents() == (std::size_t) count);
+	assert(std::string(streamBSON.data(), streamBSON.size()) == std::string(bson.data(), bson.size()));
+	assert(std::string(domBSON.data(), domBSON.size()) == std::string(bson.data(), bson.size()));
+
+	double megabytes = json.str().size() / (1024.0 * 1024.0);
+	std::cout << std::endl << count << " documents, " << megabytes << " MB of JSON" << std::endl
+		<< "BSON -> JSON  Document::toString: " << domToJSON / 1000 << " ms, BSONToJSON: " << streamToJSON / 1000 << " ms" << std::endl
+		<< "JSON -> BSON  Document: " << domToBSON / 1000 << " ms, JSONToBSON: " << streamToBSON / 1000 << " ms" << std::endl;
+}
+
+
+void MongoDBTest::testAsyncClient()
+{
+	TestServer server(5);
+	AsyncClient client(2);
+	AsyncConnection::Ptr pFirst = client.connect(server.address());
+	AsyncConnection::Ptr pSecond = client.connect(server.address());
+	assert (client.threads() == 2);
+	assert (client.connections() == 2);
+
+	// Futures, sent before the connections are established
+	std::vector<Poco::SharedPtr<QueryRequest> > requests;
+	std::vector<AsyncConnection::AsyncResponse> results;
+	for(int i = 0; i < 100; ++i)
+	{
+		Poco::SharedPtr<QueryRequest> request = new QueryRequest("team.players");
+		request->query().add("i", i);
+		requests.push_back(request);
+		results.push_back((i % 2 ? pFirst : pSecond)->sendRequestAsync(*request, i % 4 == 0));
+	}
+	for(int i = 0; i < 100; ++i)
+	{
+		results[i].wait();
+		assert (!results[i].failed());
+		ResponseMessage& reply = results[i].data();
+		assert (reply.header().responseTo() == requests[i]->header().requestID());
+		if ( i % 4 == 0 ) assert (reply.views()[0].getInt32("i") == i);
+		else assert (reply.documents()[0]->get<Poco::Int32>("i") == i);
+	}
+
+	// Callbacks on the event loop thread
+	ResponseCounter counter(100);
+	for(int i = 0; i < 100; ++i)
+	{
+		pFirst->sendRequest(*requests[i], counter, true);
+	}
+	assert (counter.wait(5000));
+	assert (counter.responses() == 100);
+	assert (counter.sum() == 99 * 100 / 2);
+	assert (pFirst->pendingRequests() == 0);
+
+	// A request without a reply is written in order with the others
+	int before = server.requests();
+	InsertRequest insert("team.players");
+	insert.documents().push_back(new Document());
+	pSecond->sendRequest(insert);
+	AsyncConnection::AsyncResponse after = pSecond->sendRequestAsync(*requests[0]);
+	after.wait();
+	assert (server.requests() == before + 2);
+
+	try
+	{
+		pSecond->sendRequestAsync(insert);
+		fail("insert has no response - must throw");
+	}
+	catch(Poco::InvalidArgumentException&)
+	{
+	}
+
+	// Closing a connection fails its outstanding requests
+	TestServer slow(500);
+	AsyncConnection::Ptr pSlow = client.connect(slow.address());
+	ResponseCounter slowCounter(1);
+	AsyncConnection::AsyncResponse pending = pSlow->sendRequestAsync(*requests[0]);
+	pSlow->sendRequest(*requests[1], slowCounter);
+	pSlow->close();
+	pending.wait();
+	assert (pending.failed());
+	assert (slowCounter.wait(5000));
+	assert (slowCounter.errors() == 1);
+	assert (!pSlow->isConnected());
+	try
+	{
+		pSlow->sendRequestAsync(*requests[0]);
+		fail("connection is closed - must throw");
+	}
+	catch(Poco::IOException&)
+	{
+	}
+
+	// A connection that can't be established fails its requests
+	Poco::UInt16 port;
+	{
+		Poco::Net::ServerSocket unused(0);
+		port = unused.address().port();
+	}
+	AsyncConnection::Ptr pRefused = client.connect(Poco::Net::SocketAddress("127.0.0.1", port));
+	try
+	{
+		AsyncConnection::AsyncResponse refused = pRefused->sendRequestAsync(*requests[0]);
+		refused.wait();
+		assert (refused.failed());
+	}
+	catch(Poco::Net::ConnectionRefusedException&)
+	{
+	}
+	assert (!pRefused->isConnected());
+	for(int i = 0; i < 100 && client.connections() > 2; ++i)
+	{
+		Poco::Thread::sleep(10);
+	}
+	assert (client.connections() == 2);
+}
+
+
+void MongoDBTest::testAsyncClientBenchmark()
+{
+	const int threads = 8;
+	const int count = 20000;
+	const long latency = 1;
+
+	TestServer server(latency);
+
+	// One thread per concurrent operation with blocking connections
+	std::vector<Poco::SharedPtr<QueryRunner> > runners;
+	std::vector<Poco::SharedPtr<Poco::Thread> > runnerThreads;
+	for(int i = 0; i < threads; ++i)
+	{
+		runners.push_back(new QueryRunner(server.address(), count / threads / 10));
+		runnerThreads.push_back(new Poco::Thread());
+	}
+	Poco::Stopwatch sw;
+	sw.start();
+	for(int i = 0; i < threads; ++i)
+	{
+		runnerThreads[i]->start(*runners[i]);
+	}
+	for(int i = 0; i < threads; ++i)
+	{
+		runnerThreads[i]->join();
+	}
+	sw.stop();
+	Poco::Timestamp::TimeDiff blockingTime = sw.elapsed();
+	int blockingCount = threads * (count / threads / 10);
+
+	// All queries in flight at once, on one event loop thread
+	AsyncClient client(1);
+	std::vector<AsyncConnection::Ptr> connections;
+	for(int i = 0; i < threads; ++i)
+	{
+		connections.push_back(client.connect(server.address()));
+	}
+	QueryRequest request("team.players");
+	request.query().add("i", 1);
+	ResponseCounter counter(count);
+	sw.restart();
+	for(int i = 0; i < count; ++i)
+	{
+		connections[i % threads]->sendRequest(request, counter, true);
+	}
+	assert (counter.wait(60000));
+	sw.stop();
+	Poco::Timestamp::TimeDiff asyncTime = sw.elapsed();
+	assert (counter.responses() == count);
+
+	std::cout << std::endl << latency << " ms server latency, " << threads << " connections: "
+		<< threads << " blocking threads " << blockingCount * 1000000.0 / blockingTime << " req/s, "
+		<< "1 event loop thread with " << count << " queries in flight " << count * 1000000.0 / asyncTime << " req/s" << std::endl;
+}
+
+
 CppUnit::Test* MongoDBTest::suite()
 {
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("MongoDBTest");
@@ -206,6 +1679,23 @@ CppUnit::Test* MongoDBTest::suite()
 	CppUnit_addTest(pSuite, MongoDBTest, testQueryRequest);
 	CppUnit_addTest(pSuite, MongoDBTest, testCountCommand);
 	CppUnit_addTest(pSuite, MongoDBTest, testDeleteRequest);
+	CppUnit_addTest(pSuite, MongoDBTest, testDocumentView);
+	CppUnit_addTest(pSuite, MongoDBTest, testDocumentViewBenchmark);
+	CppUnit_addTest(pSuite, MongoDBTest, testInsertRequestEncoding);
+	CppUnit_addTest(pSuite, MongoDBTest, testInsertBatchBenchmark);
+	CppUnit_addTest(pSuite, MongoDBTest, testPipelining);
+	CppUnit_addTest(pSuite, MongoDBTest, testPipeliningBenchmark);
+	CppUnit_addTest(pSuite, MongoDBTest, testCursor);
+	CppUnit_addTest(pSuite, MongoDBTest, testCursorBenchmark);
+	CppUnit_addTest(pSuite, MongoDBTest, testConnectionPool);
+	CppUnit_addTest(pSuite, MongoDBTest, testReplicaSet);
+	CppUnit_addTest(pSuite, MongoDBTest, testDocumentOrder);
+	CppUnit_addTest(pSuite, MongoDBTest, testDocumentBenchmark);
+	CppUnit_addTest(pSuite, MongoDBTest, testBSONToJSON);
+	CppUnit_addTest(pSuite, MongoDBTest, testJSONToBSON);
+	CppUnit_addTest(pSuite, MongoDBTest, testTranscodeBenchmark);
+	CppUnit_addTest(pSuite, MongoDBTest, testAsyncClient);
+	CppUnit_addTest(pSuite, MongoDBTest, testAsyncClientBenchmark);
 
 	return pSuite;
 }
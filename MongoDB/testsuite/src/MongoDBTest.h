@@ -63,6 +63,47 @@ public:
 	void testDeleteRequest();
 
 
+	void testDocumentView();
+
+
+	void testDocumentViewBenchmark();
+
+
+	void testInsertRequestEncoding();
+
+
+	void testInsertBatchBenchmark();
+
+
+	void testPipelining();
+
+
+	void testPipeliningBenchmark();
+
+
+	void testCursor();
+
+
+	void testCursorBenchmark();
+
+
+	void testConnectionPool();
+
+
+	void testReplicaSet();
+
+
+	void testDocumentOrder();
+
+
+	void testDocumentBenchmark();
+	void testBSONToJSON();
+	void testJSONToBSON();
+	void testTranscodeBenchmark();
+	void testAsyncClient();
+	void testAsyncClientBenchmark();
+
+
 	void setUp();
 
 
@@ -0,0 +1,400 @@
+//
+// TestServer.cpp
+//
+// $Id$
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "TestServer.h"
+#include "Poco/MongoDB/Message.h"
+#include "Poco/MongoDB/DocumentView.h"
+#include "Poco/MongoDB/ResponseMessage.h"
+#include "Poco/MongoDB/Document.h"
+#include "Poco/MongoDB/Array.h"
+#include "Poco/BinaryWriter.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/ByteOrder.h"
+#include "Poco/Timespan.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+
+using Poco::Net::Socket;
+using Poco::Net::StreamSocket;
+using Poco::Net::SocketAddress;
+using Poco::MongoDB::MessageHeader;
+
+
+namespace
+{
+	Poco::Int32 getInt32(const char* p)
+	{
+		Poco::Int32 value;
+		std::memcpy(&value, p, sizeof(value));
+		return Poco::ByteOrder::fromLittleEndian(value);
+	}
+
+	Poco::Int64 getInt64(const char* p)
+	{
+		Poco::Int64 value;
+		std::memcpy(&value, p, sizeof(value));
+		return Poco::ByteOrder::fromLittleEndian(value);
+	}
+
+	void putInt32(std::string& str, Poco::Int32 value)
+	{
+		value = Poco::ByteOrder::toLittleEndian(value);
+		str.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	void putInt64(std::string& str, Poco::Int64 value)
+	{
+		value = Poco::ByteOrder::toLittleEndian(value);
+		str.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	bool receiveAll(StreamSocket& ss, char* buffer, int length)
+	{
+		while (length > 0)
+		{
+			int n = ss.receiveBytes(buffer, length);
+			if (n <= 0) return false;
+			buffer += n;
+			length -= n;
+		}
+		return true;
+	}
+}
+
+
+TestServer::TestServer(long latency):
+	_socket(SocketAddress()),
+	_latency(latency),
+	_lastRequestID(0),
+	_requests(0),
+	_lastCursorID(0),
+	_killedCursors(0),
+	_primary(true),
+	_stop(false),
+	_thread("TestServer"),
+	_writer("TestServer::writer"),
+	_writerAdapter(*this, &TestServer::sendReplies)
+{
+	_writer.start(_writerAdapter);
+	_thread.start(*this);
+	_ready.wait();
+}
+
+
+TestServer::~TestServer()
+{
+	_stop = true;
+	_replyReady.set();
+	_thread.join();
+	_writer.join();
+	for (std::vector<Handler*>::iterator it = _handlers.begin(); it != _handlers.end(); ++it)
+	{
+		(*it)->thread.join();
+		delete *it;
+	}
+}
+
+
+Poco::UInt16 TestServer::port() const
+{
+	return _socket.address().port();
+}
+
+
+int TestServer::requests() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _requests;
+}
+
+
+int TestServer::openCursors() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return (int) _cursors.size();
+}
+
+
+int TestServer::killedCursors() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _killedCursors;
+}
+
+
+int TestServer::connections() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return (int) _handlers.size();
+}
+
+
+std::string TestServer::address() const
+{
+	return "127.0.0.1:" + Poco::NumberFormatter::format(port());
+}
+
+
+void TestServer::setMaster(bool primary, const std::vector<std::string>& hosts)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_primary = primary;
+	_hosts = hosts;
+}
+
+
+void TestServer::run()
+{
+	_ready.set();
+	Poco::Timespan span(250000);
+	while (!_stop)
+	{
+		if (!_socket.poll(span, Socket::SELECT_READ)) continue;
+
+		StreamSocket ss = _socket.acceptConnection();
+		ss.setNoDelay(true);
+		Handler* pHandler = new Handler(*this, ss);
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			_handlers.push_back(pHandler);
+		}
+		pHandler->thread.start(*pHandler);
+	}
+}
+
+
+TestServer::Handler::Handler(TestServer& srv, const StreamSocket& ss):
+	server(srv),
+	socket(ss),
+	thread("TestServer::handler")
+{
+}
+
+
+void TestServer::Handler::run()
+{
+	server.serve(socket);
+}
+
+
+void TestServer::serve(StreamSocket& ss)
+{
+	Poco::Timespan span(250000);
+	try
+	{
+		while (!_stop)
+		{
+			if (!ss.poll(span, Socket::SELECT_READ)) continue;
+
+			char header[MSG_HEADER_SIZE];
+			if (!receiveAll(ss, header, MSG_HEADER_SIZE)) break;
+			Poco::Int32 length = getInt32(header);
+			std::string body(length - MSG_HEADER_SIZE, '\0');
+			if (!body.empty() && !receiveAll(ss, &body[0], (int) body.size())) break;
+
+			handle(ss, getInt32(header + 4), getInt32(header + 12), body);
+		}
+	}
+	catch (Poco::Exception& exc)
+	{
+		std::cerr << "TestServer: " << exc.displayText() << std::endl;
+	}
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		for (std::deque<Reply>::iterator it = _replies.begin(); it != _replies.end();)
+		{
+			if (it->socket == ss)
+				it = _replies.erase(it);
+			else
+				++it;
+		}
+	}
+	// the writer may have taken a reply for this socket already
+	Poco::FastMutex::ScopedLock lock(_sendMutex);
+	ss.close();
+}
+
+
+void TestServer::handle(const StreamSocket& ss, Poco::Int32 requestID, Poco::Int32 opCode, const std::string& body)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	++_requests;
+	if (opCode == MessageHeader::Query)
+	{
+		// flags, collection name, numberToSkip, numberToReturn, query
+		std::size_t pos = 4 + std::strlen(body.c_str() + 4) + 1 + 8;
+		Poco::Int32 numberToReturn = getInt32(body.data() + pos - 4);
+		Poco::MongoDB::DocumentView query(body.data() + pos, body.size() - pos);
+		if (query.exists("isMaster"))
+		{
+			queueReply(ss, requestID, 0, 0, 0, 1, isMasterReply());
+		}
+		else if (query.exists("count"))
+		{
+			CursorState cursor;
+			cursor.next = 0;
+			cursor.count = query.getInt32("count");
+			_cursors[++_lastCursorID] = cursor;
+			sendBatch(ss, requestID, _lastCursorID, numberToReturn);
+		}
+		else
+		{
+			queueReply(ss, requestID, 0, 0, 0, 1, std::string(query.data(), query.size()));
+		}
+	}
+	else if (opCode == MessageHeader::GetMore)
+	{
+		// reserved, collection name, numberToReturn, cursorID
+		std::size_t pos = 4 + std::strlen(body.c_str() + 4) + 1;
+		Poco::Int32 numberToReturn = getInt32(body.data() + pos);
+		Poco::Int64 cursorID = getInt64(body.data() + pos + 4);
+		if (_cursors.find(cursorID) != _cursors.end())
+		{
+			sendBatch(ss, requestID, cursorID, numberToReturn);
+		}
+		else
+		{
+			queueReply(ss, requestID, Poco::MongoDB::ResponseMessage::RESPONSE_CURSOR_NOT_FOUND, 0, 0, 0, std::string());
+		}
+	}
+	else if (opCode == MessageHeader::KillCursors)
+	{
+		Poco::Int32 n = getInt32(body.data() + 4);
+		for (int i = 0; i < n; ++i)
+		{
+			if (_cursors.erase(getInt64(body.data() + 8 + i * 8)) > 0) ++_killedCursors;
+		}
+	}
+}
+
+
+std::string TestServer::isMasterReply() const
+{
+	Poco::MongoDB::Array::Ptr hosts = new Poco::MongoDB::Array();
+	for (std::size_t i = 0; i < _hosts.size(); ++i)
+	{
+		hosts->add(Poco::NumberFormatter::format(i), _hosts[i]);
+	}
+	Poco::MongoDB::Document reply;
+	reply.add("ismaster", _primary);
+	reply.add("secondary", !_primary);
+	if (!_hosts.empty()) reply.add("hosts", hosts);
+	reply.add("ok", 1.0);
+
+	std::ostringstream ostr;
+	Poco::BinaryWriter writer(ostr, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+	reply.write(writer);
+	return ostr.str();
+}
+
+
+void TestServer::sendBatch(const StreamSocket& ss, Poco::Int32 responseTo, Poco::Int64 cursorID, int batchSize)
+{
+	CursorState& cursor = _cursors[cursorID];
+	if (batchSize <= 0) batchSize = 101;
+	int first = cursor.next;
+	int count = std::min(batchSize, cursor.count - first);
+
+	std::string documents;
+	for (int i = first; i < first + count; ++i)
+	{
+		putInt32(documents, 12);
+		documents.append("\x10i\0", 3);
+		putInt32(documents, i);
+		documents.append(1, '\0');
+	}
+	cursor.next += count;
+	if (cursor.next == cursor.count)
+	{
+		_cursors.erase(cursorID);
+		cursorID = 0;
+	}
+	queueReply(ss, responseTo, 0, cursorID, first, count, documents);
+}
+
+
+void TestServer::queueReply(const StreamSocket& ss, Poco::Int32 responseTo, Poco::Int32 flags, Poco::Int64 cursorID, Poco::Int32 startingFrom, Poco::Int32 count, const std::string& documents)
+{
+	Reply reply;
+	reply.due += _latency * 1000;
+	reply.socket = ss;
+	putInt32(reply.message, (Poco::Int32) (MSG_HEADER_SIZE + 20 + documents.size()));
+	putInt32(reply.message, ++_lastRequestID);
+	putInt32(reply.message, responseTo);
+	putInt32(reply.message, MessageHeader::Reply);
+	putInt32(reply.message, flags);
+	putInt64(reply.message, cursorID);
+	putInt32(reply.message, startingFrom);
+	putInt32(reply.message, count);
+	reply.message.append(documents);
+	_replies.push_back(reply);
+	_replyReady.set();
+}
+
+
+void TestServer::sendReplies()
+{
+	while (!_stop)
+	{
+		Reply reply;
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if (!_replies.empty())
+			{
+				reply = _replies.front();
+				_replies.pop_front();
+			}
+		}
+		if (reply.message.empty())
+		{
+			_replyReady.tryWait(250);
+			continue;
+		}
+
+		Poco::Timestamp::TimeDiff wait = reply.due - Poco::Timestamp();
+		if (wait > 0) Poco::Thread::sleep(long((wait + 999) / 1000));
+		try
+		{
+			Poco::FastMutex::ScopedLock lock(_sendMutex);
+			if (reply.socket.impl()->initialized())
+				reply.socket.sendBytes(reply.message.data(), (int) reply.message.size());
+		}
+		catch (Poco::Exception& exc)
+		{
+			std::cerr << "TestServer: " << exc.displayText() << std::endl;
+		}
+	}
+}
@@ -0,0 +1,154 @@
+//
+// TestServer.h
+//
+// $Id$
+//
+// Definition of the TestServer class.
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef TestServer_INCLUDED
+#define TestServer_INCLUDED
+
+
+#include "Poco/MongoDB/MongoDB.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include "Poco/Mutex.h"
+#include "Poco/Timestamp.h"
+#include "Poco/RunnableAdapter.h"
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+
+class TestServer: public Poco::Runnable
+	/// A minimal stand-in for mongod. Every accepted connection is
+	/// served by its own thread.
+	///
+	/// A query is answered with a reply that contains the query document.
+	/// A query with an int32 field "count" opens a cursor over count
+	/// documents { i: 0 } ... { i: count - 1 }, returned in batches of
+	/// numberToReturn (default 101) documents via getmore requests.
+	/// An isMaster command is answered with the role and host list set
+	/// with setMaster(); by default the server is a standalone primary.
+	/// Replies are delayed by a fixed latency to simulate the network,
+	/// but requests keep being read while replies are pending, so
+	/// pipelined requests overlap like they would with a real server.
+{
+public:
+	TestServer(long latency = 0);
+		/// Creates the TestServer. latency is given in milliseconds.
+
+	~TestServer();
+		/// Destroys the TestServer.
+
+	Poco::UInt16 port() const;
+		/// Returns the port the server is listening on.
+
+	int requests() const;
+		/// Returns the number of requests received so far.
+
+	int openCursors() const;
+		/// Returns the number of cursors that are still open.
+
+	int killedCursors() const;
+		/// Returns the number of cursors killed by a kill cursors request.
+
+	int connections() const;
+		/// Returns the number of connections accepted so far.
+
+	std::string address() const;
+		/// Returns the address of the server as "127.0.0.1:port".
+
+	void setMaster(bool primary, const std::vector<std::string>& hosts);
+		/// Sets the reply to isMaster: if primary is false, the server
+		/// reports itself as a secondary. hosts is returned as the
+		/// replica set members.
+
+	void run();
+		/// Accepts connections and reads requests.
+
+private:
+	struct Reply
+	{
+		Poco::Timestamp         due;
+		Poco::Net::StreamSocket socket;
+		std::string             message;
+	};
+
+	class Handler: public Poco::Runnable
+	{
+	public:
+		Handler(TestServer& server, const Poco::Net::StreamSocket& socket);
+		void run();
+
+		TestServer&             server;
+		Poco::Net::StreamSocket socket;
+		Poco::Thread            thread;
+	};
+
+	struct CursorState
+	{
+		int next;
+		int count;
+	};
+
+	void serve(Poco::Net::StreamSocket& ss);
+	void handle(const Poco::Net::StreamSocket& ss, Poco::Int32 requestID, Poco::Int32 opCode, const std::string& body);
+	std::string isMasterReply() const;
+	void sendBatch(const Poco::Net::StreamSocket& ss, Poco::Int32 responseTo, Poco::Int64 cursorID, int batchSize);
+	void queueReply(const Poco::Net::StreamSocket& ss, Poco::Int32 responseTo, Poco::Int32 flags, Poco::Int64 cursorID, Poco::Int32 startingFrom, Poco::Int32 count, const std::string& documents);
+	void sendReplies();
+
+	Poco::Net::ServerSocket _socket;
+	std::vector<Handler*>   _handlers;
+	long                    _latency;
+	Poco::Int32             _lastRequestID;
+	int                     _requests;
+	Poco::Int64             _lastCursorID;
+	std::map<Poco::Int64, CursorState> _cursors;
+	int                     _killedCursors;
+	bool                    _primary;
+	std::vector<std::string> _hosts;
+	std::deque<Reply>       _replies;
+	mutable Poco::FastMutex _mutex;
+	Poco::FastMutex         _sendMutex;
+	Poco::Event             _replyReady;
+	Poco::Event             _ready;
+	bool                    _stop;
+	Poco::Thread            _thread;
+	Poco::Thread            _writer;
+	Poco::RunnableAdapter<TestServer> _writerAdapter;
+};
+
+
+#endif // TestServer_INCLUDED
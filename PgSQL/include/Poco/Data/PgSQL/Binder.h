@@ -239,6 +239,15 @@ public:
 
 	virtual void bind(std::size_t pos, const std::list<std::string>& val, Direction dir = PD_IN);
 
+	void setParameterCount(std::size_t count);
+		/// Sets the number of parameters of one execution of the statement
+		/// and discards the bound values. Elements of containers are bound
+		/// one set of parameters after another: element i of a container
+		/// bound at pos goes to pos + i*count. The default is 1.
+
+	std::size_t parameterCount() const;
+		/// Returns the number of parameters of one execution.
+
 	std::size_t size() const;
 		/// Return count of binded parameters
 
@@ -258,14 +267,39 @@ private:
 	}
 
 	void realBind(std::size_t pos, int type, const void* buffer, int length);
-		/// Common bind implementation
+		/// Common bind implementation. The parameter points to the
+		/// buffer, which is not copied.
+
+	void realBindFixed(std::size_t pos, int type, const void* buffer, int length);
+		/// Binds a value of up to 8 bytes, which is copied.
+
+	template <typename C>
+	void bindColumn(std::size_t pos, const C& values)
+		/// Binds the elements of a container, one per set of parameters.
+	{
+		std::size_t i = 0;
+		for (typename C::const_iterator it = values.begin(); it != values.end(); ++it, ++i)
+		{
+			bind(pos + i*_parameterCount, *it, PD_IN);
+		}
+	}
 
 private:
 
 	std::vector<PgSQL_BIND> _bindArray;
+	std::size_t _parameterCount;
 };
 
 
+//
+// inlines
+//
+inline std::size_t Binder::parameterCount() const
+{
+	return _parameterCount;
+}
+
+
 } } } // namespace Poco::Data::PgSQL
 
 
@@ -0,0 +1,235 @@
+//
+// CopyIn.h
+//
+// $Id: //poco/1.4/Data/PgSQL/include/Poco/Data/PgSQL/CopyIn.h#1 $
+//
+// Library: Data
+// Package: PgSQL
+// Module:  CopyIn
+//
+// Definition of the CopyIn class.
+//
+// Copyright (c) 2008, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Data_PgSQL_CopyIn_INCLUDED
+#define Data_PgSQL_CopyIn_INCLUDED
+
+#include "Poco/Data/PgSQL/PgSQL.h"
+#include "Poco/Data/PgSQL/Binder.h"
+#include "Poco/Data/PgSQL/SessionHandle.h"
+#include "Poco/SharedPtr.h"
+#include <vector>
+
+namespace Poco {
+namespace Data {
+namespace PgSQL {
+
+
+class PgSQL_API CopyIn
+	/// Loads rows into a table with COPY ... FROM STDIN (FORMAT binary),
+	/// which is much faster than executing an INSERT per row.
+	///
+	/// Values are converted with the Binder's type mapping and encoded
+	/// into the binary COPY format in a buffer; full buffers are sent
+	/// with PQputCopyData(). On a blocking connection, sending waits
+	/// while the server is behind; on a non-blocking connection, the
+	/// loader waits until the connection is writable again. Either way,
+	/// at most one buffer of rows is held in memory.
+	///
+	/// The binary format is not converted by the server, so the C++ types
+	/// must match the column types (for example, Poco::Int32 for integer,
+	/// Poco::Int64 for bigint, double for double precision).
+	///
+	/// Rows can be added value by value:
+	///
+	///     CopyIn copy(handle, "person", "name, age");
+	///     copy << name << age;
+	///     copy << otherName << otherAge;
+	///     std::size_t loaded = copy.end();
+	///
+	/// or as one container per column:
+	///
+	///     copy.column(names).column(ages);
+	///     std::size_t loaded = copy.end();
+	///
+	/// While the copy is in progress, no other statement can be executed
+	/// on the connection.
+{
+public:
+	typedef Poco::SharedPtr<CopyIn> Ptr;
+
+	enum
+	{
+		DEFAULT_BUFFER_SIZE = 1024*1024
+	};
+
+	CopyIn(SessionHandle& handle, const std::string& table, const std::string& columns = "", std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+		/// Starts copying into the given columns (a comma-separated list)
+		/// of the table, or into all of its columns if none are given.
+
+	virtual ~CopyIn();
+		/// Destroys the CopyIn. If end() has not been called,
+		/// the copy is aborted and no rows are loaded.
+
+	template <typename T>
+	CopyIn& operator << (const T& value)
+		/// Adds the value of the next column of the current row.
+		/// The row is complete when a value has been added for
+		/// every column. The value is encoded into the buffer
+		/// right away.
+	{
+		_binder.bind(0, value, AbstractBinder::PD_IN);
+		writeValue();
+		return *this;
+	}
+
+	template <typename C>
+	CopyIn& column(const C& values)
+		/// Adds a container with the values of the next column. Once a
+		/// container has been added for every column, all of their rows
+		/// are written. The containers must have the same size and must
+		/// stay valid until then.
+	{
+		_pending.push_back(new Column<C>(values));
+		if (_pending.size() == _columns)
+			writeColumns();
+		return *this;
+	}
+
+	std::size_t columns() const;
+		/// Returns the number of columns per row.
+
+	std::size_t rows() const;
+		/// Returns the number of rows written so far.
+
+	std::size_t end();
+		/// Sends the remaining rows and completes the copy.
+		/// Returns the number of rows loaded, as reported by the server.
+
+protected:
+	CopyIn(std::size_t columns, std::size_t bufferSize);
+		/// Creates a CopyIn without a connection, for subclasses that
+		/// send the encoded data elsewhere by overriding sendData()
+		/// and sendEnd().
+
+	virtual void sendData(const char* data, std::size_t length);
+		/// Sends a chunk of data in the binary COPY format to the server.
+
+	virtual std::size_t sendEnd();
+		/// Completes the copy on the server after all data has been sent.
+		/// Returns the number of rows loaded, as reported by the server.
+
+private:
+	class AbstractColumn
+	{
+	public:
+		virtual ~AbstractColumn()
+		{
+		}
+
+		virtual std::size_t size() const = 0;
+
+		virtual void bindNext(Binder& binder) = 0;
+			/// Binds the next value of the column.
+	};
+
+	template <typename C>
+	class Column: public AbstractColumn
+	{
+	public:
+		explicit Column(const C& values):
+			_values(values),
+			_it(values.begin())
+		{
+		}
+
+		std::size_t size() const
+		{
+			return _values.size();
+		}
+
+		void bindNext(Binder& binder)
+		{
+			binder.bind(0, *_it++, AbstractBinder::PD_IN);
+		}
+
+	private:
+		const C& _values;
+		typename C::const_iterator _it;
+	};
+
+	typedef Poco::SharedPtr<AbstractColumn> ColumnPtr;
+
+	CopyIn(const CopyIn&);
+	CopyIn& operator=(const CopyIn&);
+
+	void writeHeader();
+		/// Starts the buffer with the header of the binary COPY format.
+
+	void writeValue();
+		/// Encodes the bound value as the next field of the current row.
+
+	void writeColumns();
+		/// Encodes all rows of the pending columns.
+
+	void flush();
+		/// Sends the buffer with sendData().
+
+	void abort();
+
+	pg_conn* _connection;
+	Binder _binder;
+	std::size_t _columns;
+	std::size_t _column;
+	std::size_t _rows;
+	std::vector<ColumnPtr> _pending;
+	std::vector<char> _buffer;
+	std::size_t _bufferSize;
+	bool _active;
+};
+
+
+//
+// inlines
+//
+inline std::size_t CopyIn::columns() const
+{
+	return _columns;
+}
+
+
+inline std::size_t CopyIn::rows() const
+{
+	return _rows;
+}
+
+
+} } } // namespace Poco::Data::PgSQL
+
+
+#endif // Data_PgSQL_CopyIn_INCLUDED
@@ -0,0 +1,195 @@
+//
+// CopyOut.h
+//
+// $Id: //poco/1.4/Data/PgSQL/include/Poco/Data/PgSQL/CopyOut.h#1 $
+//
+// Library: Data
+// Package: PgSQL
+// Module:  CopyOut
+//
+// Definition of the CopyOut class.
+//
+// Copyright (c) 2008, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Data_PgSQL_CopyOut_INCLUDED
+#define Data_PgSQL_CopyOut_INCLUDED
+
+#include "Poco/Data/PgSQL/PgSQL.h"
+#include "Poco/Data/PgSQL/SessionHandle.h"
+#include "Poco/Data/LOB.h"
+#include "Poco/Data/Date.h"
+#include "Poco/Data/Time.h"
+#include "Poco/DateTime.h"
+#include "Poco/SharedPtr.h"
+#include <vector>
+
+namespace Poco {
+namespace Data {
+namespace PgSQL {
+
+
+class PgSQL_API CopyOut
+	/// Reads a table or query result with COPY ... TO STDOUT (FORMAT binary)
+	/// and decodes each field straight into a container per column.
+	///
+	///     std::vector<std::string> names;
+	///     std::vector<Poco::Int32> ages;
+	///     CopyOut copy(handle, "person", "name, age");
+	///     std::size_t rows = copy.into(names).into(ages).execute();
+	///
+	/// The source can also be a query in parentheses, e.g.
+	/// "(SELECT name, age FROM person WHERE age > 30)".
+	///
+	/// Values are decoded by the container's element type, which must
+	/// match the column type as for CopyIn. Integer types accept any
+	/// integer column width; DateTime and Date accept date and timestamp
+	/// columns. Null values are default-constructed in the container and
+	/// reported by isNull().
+{
+public:
+	typedef Poco::SharedPtr<CopyOut> Ptr;
+
+	CopyOut(SessionHandle& handle, const std::string& source, const std::string& columns = "");
+		/// Creates the CopyOut for the given columns (a comma-separated
+		/// list) of the source, or for all of its columns if none are given.
+
+	~CopyOut();
+		/// Destroys the CopyOut.
+
+	template <typename C>
+	CopyOut& into(C& values)
+		/// Adds the container receiving the next column. Rows are
+		/// appended to it.
+	{
+		_columns.push_back(new Column<C>(values));
+		return *this;
+	}
+
+	std::size_t execute();
+		/// Runs the copy and returns the number of rows received.
+		/// There must be a container for every column.
+
+	bool isNull(std::size_t col, std::size_t row) const;
+		/// Returns true if the value at the given column and row,
+		/// counted from the start of the last execution, was null.
+
+	std::size_t parse(const char* data, std::size_t length);
+		/// Decodes a chunk of data in the binary COPY format and appends
+		/// its rows to the containers. Returns the number of rows.
+		/// The first chunk must start with the header, and every chunk
+		/// must hold whole rows. execute() calls this for each chunk
+		/// received; it can also decode data obtained otherwise, such as
+		/// a file written by COPY ... TO (FORMAT binary).
+
+private:
+	class AbstractColumn
+	{
+	public:
+		virtual ~AbstractColumn()
+		{
+		}
+
+		virtual void append(const char* data, int length) = 0;
+			/// Decodes a value and appends it; a length of -1 means null.
+
+		virtual void clearNulls() = 0;
+
+		virtual bool isNull(std::size_t row) const = 0;
+	};
+
+	template <typename C>
+	class Column: public AbstractColumn
+	{
+	public:
+		explicit Column(C& values): _values(values)
+		{
+		}
+
+		void append(const char* data, int length)
+		{
+			typename C::value_type value = typename C::value_type();
+			if (length >= 0)
+				decode(data, static_cast<std::size_t>(length), value);
+			_values.push_back(value);
+			_nulls.push_back(length < 0);
+		}
+
+		void clearNulls()
+		{
+			_nulls.clear();
+		}
+
+		bool isNull(std::size_t row) const
+		{
+			return _nulls.at(row);
+		}
+
+	private:
+		C& _values;
+		std::vector<bool> _nulls;
+	};
+
+	typedef Poco::SharedPtr<AbstractColumn> ColumnPtr;
+
+	CopyOut(const CopyOut&);
+	CopyOut& operator=(const CopyOut&);
+
+	static void decode(const char* data, std::size_t length, Poco::Int8& val);
+	static void decode(const char* data, std::size_t length, Poco::UInt8& val);
+	static void decode(const char* data, std::size_t length, Poco::Int16& val);
+	static void decode(const char* data, std::size_t length, Poco::UInt16& val);
+	static void decode(const char* data, std::size_t length, Poco::Int32& val);
+	static void decode(const char* data, std::size_t length, Poco::UInt32& val);
+	static void decode(const char* data, std::size_t length, Poco::Int64& val);
+	static void decode(const char* data, std::size_t length, Poco::UInt64& val);
+#ifndef POCO_LONG_IS_64_BIT
+	static void decode(const char* data, std::size_t length, long& val);
+#endif
+	static void decode(const char* data, std::size_t length, bool& val);
+	static void decode(const char* data, std::size_t length, char& val);
+	static void decode(const char* data, std::size_t length, float& val);
+	static void decode(const char* data, std::size_t length, double& val);
+	static void decode(const char* data, std::size_t length, std::string& val);
+	static void decode(const char* data, std::size_t length, Poco::Data::BLOB& val);
+	static void decode(const char* data, std::size_t length, Poco::Data::CLOB& val);
+	static void decode(const char* data, std::size_t length, Poco::DateTime& val);
+	static void decode(const char* data, std::size_t length, Poco::Data::Date& val);
+	static void decode(const char* data, std::size_t length, Poco::Data::Time& val);
+
+	pg_conn* _connection;
+	std::string _query;
+	std::vector<ColumnPtr> _columns;
+	bool _header;
+	bool _done;
+};
+
+
+} } } // namespace Poco::Data::PgSQL
+
+
+#endif // Data_PgSQL_CopyOut_INCLUDED
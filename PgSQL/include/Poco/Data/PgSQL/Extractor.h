@@ -139,9 +139,18 @@ public:
 	virtual void reset();
 		/// Resets any information internally cached by the extractor.
 
+	void setRowCount(std::size_t rows);
+		/// Sets the number of rows, starting with the current one, that
+		/// the container extract functions decode.
+
 	////////////
-	// Not implemented extract functions
+	// Bulk extract functions
 	////////////
+	//
+	// Each call decodes one column of the received result, in binary
+	// format, straight into the container in a single pass. Null values
+	// are default-constructed in the container and recorded separately;
+	// isNull(col, row) reports them.
 
 	virtual bool extract(std::size_t pos, std::vector<Poco::Int8>& val);
 		/// Extracts an Int8 vector.
@@ -336,7 +345,31 @@ public:
 
 private:
 
-	bool realExtractFixed(std::size_t pos, int type, void* buffer, std::size_t length = 0);
+	template <typename T>
+	bool realExtractFixed(std::size_t pos, T& val);
+		/// Decodes a binary integer, floating-point or boolean value.
+
+	bool realExtractTimestamp(std::size_t pos, Poco::Int64& usecs);
+		/// Decodes a binary date, time or timestamp value into
+		/// microseconds since 2000-01-01 (or since midnight for time).
+
+	template <typename C, typename D>
+	bool extractColumn(std::size_t pos, C& val, const D& decode);
+		/// Decodes the column at pos for the current rows into the
+		/// container and records the nulls.
+
+	template <typename C>
+	bool extractNumbers(std::size_t pos, C& val);
+		/// Selects the number decoder for the column type.
+
+	template <typename C>
+	bool extractStrings(std::size_t pos, C& val);
+
+	template <typename C, typename D>
+	bool extractLOBs(std::size_t pos, C& val, const D& decode);
+
+	template <typename C, typename D>
+	bool extractTimestamps(std::size_t pos, C& val);
 
 	// Prevent VC8 warning "operator= could not be generated"
 	Extractor& operator=(const Extractor&);
@@ -345,6 +378,8 @@ private:
 
 	StatementExecutor& _stmt;
 	ResultMetadata& _metadata;
+	std::size_t _rowCount;
+	std::vector<std::vector<bool> > _nulls;
 };
 
 } } } // namespace Poco::Data::PgSQL
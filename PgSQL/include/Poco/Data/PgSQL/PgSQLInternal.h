@@ -13,6 +13,7 @@
 #ifndef pocoDataPQSQLINTERNAL_H_
 #define pocoDataPQSQLINTERNAL_H_
 
+#include "Poco/Bugcheck.h"
 #include <vector>
 #include <cstring>
 
@@ -26,6 +27,9 @@
 
 #define PgSQL_TYPE_BYTEARRAY 17 // QBYTEARRAY (BINARY)
 #define PgSQL_TYPE_STRING    25 // STRING (NOT BIN)
+#define PgSQL_TYPE_NAME      19 // QNAMEOID
+#define PgSQL_TYPE_BPCHAR    1042 // QBPCHAROID
+#define PgSQL_TYPE_VARCHAR   1043 // QVARCHAROID
 
 #define PgSQL_TYPE_FLOAT     700 // QFLOAT4OID
 #define PgSQL_TYPE_DOUBLE    701 // QFLOAT8OID
@@ -50,6 +54,9 @@ struct PgSQL_option
 };
 
 class PgSQL_BIND
+    /// A parameter value in binary format. The value either points to
+    /// memory of the caller, which must stay valid until the statement
+    /// has been executed, or is held in a small inline buffer.
 {
 public:
     PgSQL_BIND() :
@@ -61,30 +68,53 @@ public:
 
     PgSQL_BIND(int oid, const char* paramValue, int paramLenght) :
         _oid(oid),
-        _paramValue(paramLenght),
+        _paramValue(paramValue),
         _paramLenght(paramLenght)
     {
-        memcpy(&_paramValue[0], paramValue, paramLenght);
     }
 
-    PgSQL_BIND(const PgSQL_BIND& old) :
-        _oid(old._oid),
-        _paramValue(old._paramValue),
-        _paramLenght(old._paramLenght)
+    PgSQL_BIND(const PgSQL_BIND& old)
     {
+        assign(old);
     }
 
     PgSQL_BIND& operator =(const PgSQL_BIND& old)
     {
-        _oid = old._oid;
-        _paramValue = old._paramValue;
-        _paramLenght = old._paramLenght;
+        assign(old);
         return *this;
     }
 
+    void setFixed(int oid, const void* paramValue, int paramLenght)
+        /// Copies a value of up to 8 bytes into the inline buffer.
+    {
+        poco_assert (paramLenght >= 0 && paramLenght <= int(sizeof(_fixed)));
+
+        _oid = oid;
+        memcpy(_fixed, paramValue, paramLenght);
+        _paramValue = _fixed;
+        _paramLenght = paramLenght;
+    }
+
     int _oid;
-    std::vector<char> _paramValue;
+    const char* _paramValue;
     int _paramLenght;
+    char _fixed[8];
+
+private:
+    void assign(const PgSQL_BIND& old)
+    {
+        _oid = old._oid;
+        _paramLenght = old._paramLenght;
+        if (old._paramValue == old._fixed)
+        {
+            memcpy(_fixed, old._fixed, old._paramLenght);
+            _paramValue = _fixed;
+        }
+        else
+        {
+            _paramValue = old._paramValue;
+        }
+    }
 };
 
 #endif /* pocoDataPQSQLINTERNAL_H_ */
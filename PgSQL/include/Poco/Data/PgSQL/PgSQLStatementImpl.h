@@ -95,7 +95,9 @@ protected:
 		/// Compiles the statement, doesn't bind yet
 
 	virtual void bindImpl();
-		/// Binds parameters
+		/// Binds parameters and executes the statement. With bulk
+		/// binding, the statement is executed once per row of the bound
+		/// containers, in a single batch.
 
 	virtual AbstractExtractor& extractor();
 		/// Returns the concrete extractor used by the statement.
@@ -58,8 +58,10 @@ public:
 	void reset();
 		/// Resets the metadata.
 
-	void init(PGresult* stmt);
-		/// Initializes the metadata.
+	void init(PGresult* description);
+		/// Initializes the metadata from the description of a
+		/// prepared statement. The result is not taken over and
+		/// must be cleared by the caller.
 
 	std::size_t columnsReturned() const;
 		/// Returns the number of columns in resultset.
@@ -67,24 +69,15 @@ public:
 	const MetaColumn& metaColumn(std::size_t pos) const;
 		/// Returns the reference to the specified metacolumn.
 
-	PgSQL_BIND* row();
-		/// Returns pointer to native row.
+	int nativeType(std::size_t pos) const;
+		/// Returns the PgSQL type (OID) of the column.
 
 	std::size_t length(std::size_t pos) const;
 		/// Returns the length.
 
-	const unsigned char* rawData(std::size_t pos) const;
-		/// Returns raw data.
-
-	bool isNull(std::size_t pos) const;
-		/// Returns true if value at pos is null.
-
 private:
-	std::vector<MetaColumn>    _columns;
-	std::vector<PgSQL_BIND>    _row;
-	//std::vector<char>          _buffer;
-	//std::vector<unsigned long> _lengths;
-	//std::vector<bool>       _isNull;
+	std::vector<MetaColumn> _columns;
+	std::vector<int>        _types;
 };
 
 }}}
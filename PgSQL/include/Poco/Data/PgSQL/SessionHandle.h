@@ -42,6 +42,7 @@
 #include <libpq-fe.h>
 #include <pg_config.h>
 #include "Poco/Data/PgSQL/PgSQLException.h"
+#include "Poco/Data/PgSQL/StatementCache.h"
 
 #include <vector>
 
@@ -75,6 +76,9 @@ public:
 	void rollback();
         /// Rollback trabsaction
 
+	StatementCache& statementCache();
+        /// Returns the cache of prepared statements of the connection
+
 	operator PgSQL* ();
 
 private:
@@ -85,6 +89,7 @@ private:
 private:
 
 	pg_conn* _pHandle;
+	StatementCache _statementCache;
 };
 
 
@@ -92,6 +97,12 @@ private:
 // inlines
 //
 
+inline StatementCache& SessionHandle::statementCache()
+{
+	return _statementCache;
+}
+
+
 inline SessionHandle::operator PgSQL* ()
 {
 	return _pHandle;
@@ -45,6 +45,8 @@
 #include "Poco/Data/PgSQL/SessionHandle.h"
 #include "Poco/Data/PgSQL/StatementExecutor.h"
 #include "Poco/Data/PgSQL/ResultMetadata.h"
+#include "Poco/Data/PgSQL/CopyIn.h"
+#include "Poco/Data/PgSQL/CopyOut.h"
 #include "Poco/Mutex.h"
 
 
@@ -138,6 +140,33 @@ public:
 	Poco::Any getInsertId(const std::string&);
 		/// Get insert id
 
+	void setStatementCacheSize(const std::string&, const Poco::Any& value);
+		/// Sets the number of prepared statements kept on the connection
+		/// (an int or std::size_t). See StatementCache.
+
+	Poco::Any getStatementCacheSize(const std::string&);
+		/// Returns the number of prepared statements kept on the
+		/// connection, as std::size_t.
+
+	void setSingleRowMode(const std::string&, bool val);
+		/// Enables or disables single-row mode for statements
+		/// created after the call. In single-row mode (the default),
+		/// rows are received from the server one at a time while they
+		/// are iterated; otherwise, the whole result is received by
+		/// execute() and held in memory.
+
+	bool isSingleRowMode(const std::string& name="");
+		/// Returns true iff single-row mode is enabled.
+
+	CopyIn::Ptr copyIn(const std::string& table, const std::string& columns = "", std::size_t bufferSize = CopyIn::DEFAULT_BUFFER_SIZE);
+		/// Starts a bulk load into the given columns of the table with
+		/// binary COPY. See CopyIn for adding rows; CopyIn::end() returns
+		/// the number of rows loaded.
+
+	CopyOut::Ptr copyOut(const std::string& source, const std::string& columns = "");
+		/// Creates a binary COPY reader for the given columns of a table or
+		/// parenthesized query, decoding into column containers. See CopyOut.
+
     SessionHandle& handle();
         // Get handle
 
@@ -146,39 +175,16 @@ public:
 
 private:
 
-	template <typename T>
-	inline T& getValue(PgSQL_BIND* pResult, T& val)
-	{
-		return val = *((T*) pResult->_paramValue.data());
-	}
-
-	template <typename T>
-	T& getSetting(const std::string& name, T& val)
+	std::string& getSetting(const std::string& name, std::string& val);
 		/// Returns required setting.
 		/// Limited to one setting at a time.
-	{
-		StatementExecutor ex(_handle);
-		ResultMetadata metadata;
-		metadata.reset();
-		ex.prepare(Poco::format("SELECT @@%s", name), 0, 0);
-		metadata.init(ex);
-
-		if (metadata.columnsReturned() > 0)
-			ex.bindResult(metadata.row());
-		else
-			throw InvalidArgumentException("No data returned.");
-
-		ex.execute(0,0);
-		ex.fetch();
-		PgSQL_BIND* pResult = metadata.row();
-		return getValue<T>(pResult, val);
-	}
 
 	std::string     _connector;
 	SessionHandle   _handle;
 	bool            _connected;
 	bool            _inTransaction;
 	std::size_t     _timeout;
+	bool            _singleRowMode;
 	Poco::FastMutex _mutex;
 };
 
@@ -205,6 +211,36 @@ inline Poco::Any SessionImpl::getInsertId(const std::string&)
 }
 
 
+inline Poco::Any SessionImpl::getStatementCacheSize(const std::string&)
+{
+	return _handle.statementCache().capacity();
+}
+
+
+inline void SessionImpl::setSingleRowMode(const std::string&, bool val)
+{
+	_singleRowMode = val;
+}
+
+
+inline bool SessionImpl::isSingleRowMode(const std::string&)
+{
+	return _singleRowMode;
+}
+
+
+inline CopyIn::Ptr SessionImpl::copyIn(const std::string& table, const std::string& columns, std::size_t bufferSize)
+{
+	return new CopyIn(_handle, table, columns, bufferSize);
+}
+
+
+inline CopyOut::Ptr SessionImpl::copyOut(const std::string& source, const std::string& columns)
+{
+	return new CopyOut(_handle, source, columns);
+}
+
+
 inline SessionHandle& SessionImpl::handle()
 {
     return _handle;
@@ -0,0 +1,187 @@
+//
+// StatementCache.h
+//
+// $Id: //poco/1.4/Data/PgSQL/include/Poco/Data/PgSQL/StatementCache.h#1 $
+//
+// Library: Data
+// Package: PgSQL
+// Module:  StatementCache
+//
+// Definition of the StatementCache class.
+//
+// Copyright (c) 2008, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Data_PgSQL_StatementCache_INCLUDED
+#define Data_PgSQL_StatementCache_INCLUDED
+
+#include <libpq-fe.h>
+#include "Poco/Data/PgSQL/PgSQLException.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include <list>
+#include <map>
+#include <vector>
+
+namespace Poco {
+namespace Data {
+namespace PgSQL {
+
+
+class StatementCache
+	/// Caches the prepared statements of a connection, keyed by SQL text
+	/// and parameter types, so that statement objects executing the same
+	/// SQL share one server-side prepared statement.
+	///
+	/// Prepared statements are named "poco_1", "poco_2", ... in the
+	/// order they are prepared on the connection, so names never collide.
+	///
+	/// When the cache holds more statements than its capacity, the least
+	/// recently used ones that no statement object is using are
+	/// deallocated on the server. With a capacity of zero, only the
+	/// statements in use are kept.
+{
+public:
+	class Statement: public Poco::RefCountedObject
+		/// A prepared statement owned by the cache.
+	{
+	public:
+		typedef Poco::AutoPtr<Statement> Ptr;
+
+		Statement(const std::string& name, pg_result* description);
+			/// Creates the Statement. Takes ownership of the description.
+
+		const std::string& name() const;
+			/// Returns the name of the prepared statement.
+
+		pg_result* description() const;
+			/// Returns the description of the prepared statement.
+
+	protected:
+		~Statement();
+
+	private:
+		Statement(const Statement&);
+		Statement& operator=(const Statement&);
+
+		std::string _name;
+		pg_result* _description;
+	};
+
+	enum
+	{
+		DEFAULT_CAPACITY = 64
+	};
+
+	StatementCache();
+		/// Creates the StatementCache.
+
+	virtual ~StatementCache();
+		/// Destroys the StatementCache.
+
+	Statement::Ptr prepare(pg_conn* connection, const std::string& query, const std::vector<Oid>& types);
+		/// Returns the prepared statement for the query and parameter
+		/// types, preparing it on the connection if it is not cached.
+		/// The returned statement stays valid while it is referenced.
+
+	void setCapacity(pg_conn* connection, std::size_t capacity);
+		/// Sets the number of prepared statements that are kept,
+		/// deallocating unused ones beyond it.
+
+	std::size_t capacity() const;
+		/// Returns the capacity.
+
+	std::size_t size() const;
+		/// Returns the number of cached statements.
+
+	void clear();
+		/// Forgets all statements, without deallocating them on the
+		/// server. Used when the connection is closed.
+
+protected:
+	virtual pg_result* prepareStatement(pg_conn* connection, const std::string& name, const std::string& query, const std::vector<Oid>& types);
+		/// Prepares the statement on the server and returns its description.
+		/// Throws a StatementException if the statement can't be prepared.
+
+	virtual bool deallocateStatement(pg_conn* connection, const std::string& name);
+		/// Deallocates the prepared statement on the server. Returns false
+		/// if that isn't possible now, e.g. because the connection is busy.
+
+private:
+	struct Entry
+	{
+		std::string key;
+		Statement::Ptr pStatement;
+	};
+
+	typedef std::list<Entry> EntryList;
+	typedef std::map<std::string, EntryList::iterator> EntryMap;
+
+	StatementCache(const StatementCache&);
+	StatementCache& operator=(const StatementCache&);
+
+	void trim(pg_conn* connection);
+		/// Deallocates unused statements beyond the capacity.
+
+	EntryList _entries; // most recently used first
+	EntryMap _index;
+	std::size_t _capacity;
+	Poco::UInt64 _counter;
+};
+
+
+//
+// inlines
+//
+inline const std::string& StatementCache::Statement::name() const
+{
+	return _name;
+}
+
+
+inline pg_result* StatementCache::Statement::description() const
+{
+	return _description;
+}
+
+
+inline std::size_t StatementCache::capacity() const
+{
+	return _capacity;
+}
+
+
+inline std::size_t StatementCache::size() const
+{
+	return _index.size();
+}
+
+
+} } } // namespace Poco::Data::PgSQL
+
+
+#endif // Data_PgSQL_StatementCache_INCLUDED
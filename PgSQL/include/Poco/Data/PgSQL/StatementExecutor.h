@@ -42,6 +42,8 @@
 #include <libpq-fe.h>
 #include <pg_config.h>
 #include "Poco/Data/PgSQL/PgSQLException.h"
+#include "Poco/Data/PgSQL/SessionHandle.h"
+#include "Poco/Data/PgSQL/StatementCache.h"
 
 #include <vector>
 
@@ -51,6 +53,17 @@ namespace PgSQL {
 
 class StatementExecutor
 	/// PgSQL statement executor.
+	///
+	/// By default, a query that returns rows is executed in libpq's
+	/// single-row mode: fetch() receives one row at a time from the
+	/// connection, so result sets of any size are streamed through
+	/// constant memory. While rows are being streamed, the connection
+	/// is busy; another statement can be executed on it once all rows
+	/// have been fetched, or after this statement is executed again or
+	/// destroyed, which discards the remaining rows.
+	///
+	/// With single-row mode turned off, execute() receives the complete
+	/// result at once, which is cheaper for small queries.
 {
 public:
 	enum State
@@ -60,8 +73,8 @@ public:
 		STMT_EXECUTED
 	};
 
-	explicit StatementExecutor(PgSQL* conn);
-		/// Creates the StatementExecutor.
+	explicit StatementExecutor(SessionHandle& handle);
+		/// Creates the StatementExecutor for the connection.
 
 	~StatementExecutor();
 		/// Destroys the StatementExecutor.
@@ -69,37 +82,107 @@ public:
 	int state() const;
 		/// Returns the current state.
 
+	void setSingleRowMode(bool flag);
+		/// Sets whether rows are streamed one at a time (true, the default)
+		/// or received as a whole by execute(). Takes effect with the next
+		/// execute(). Single-row mode needs libpq 9.2 or newer; with older
+		/// versions the complete result is always received.
+
+	bool isSingleRowMode() const;
+		/// Returns true if rows are streamed one at a time.
+
 	void prepare(const std::string& query, PgSQL_BIND* params, std::size_t count);
-		/// Prepares the statement for execution.
+		/// Prepares the statement for execution. The prepared statement
+		/// is taken from the connection's StatementCache, so statement
+		/// objects with the same SQL text share it.
 
 	void bindResult(PgSQL_BIND* result);
 		/// Binds result.
 
 	void execute(PgSQL_BIND* params, std::size_t count);
-		/// Executes the statement.
+		/// Executes the statement. The parameter values are passed to
+		/// libpq without being copied.
+
+	std::size_t executeBatch(PgSQL_BIND* params, std::size_t count, std::size_t rows);
+		/// Executes the statement once for each of rows sets of count
+		/// parameters; params holds the sets one after another, as
+		/// produced by binding set i at positions i*count to i*count+count-1
+		/// of a Binder. With libpq 14 or newer, all executions are sent
+		/// in pipeline mode and cost a single round-trip. Returns the total
+		/// number of affected rows. Statements that return rows are
+		/// executed, but their rows are discarded.
+
+	void setResult(pg_result* result);
+		/// Takes ownership of a complete result with values in binary
+		/// format, such as one returned by PQexecParams(), and makes its
+		/// rows available to fetch() as if the statement had been executed.
+		/// The current result, if any, is discarded.
 
 	bool fetch();
-		/// Fetches the data.
+		/// Advances to the next row. Returns false when there are no
+		/// more rows.
+
+	bool isNull(std::size_t col) const;
+		/// Returns true if the value of the column in the current row is null.
+
+	const char* value(std::size_t col) const;
+		/// Returns the value of the column in the current row, in binary format.
+
+	std::size_t length(std::size_t col) const;
+		/// Returns the length of the value of the column in the current row.
+
+	pg_result* result() const;
+		/// Returns the result holding the current row.
+
+	int row() const;
+		/// Returns the index of the current row in result().
+
+	std::size_t rows() const;
+		/// Returns the number of received rows, starting with the current
+		/// one, that can be read from result() without fetching. In
+		/// single-row mode, this is at most one.
+
+	void skip(std::size_t rows);
+		/// Advances the current row by the given number of rows,
+		/// which must not be more than rows() - 1.
 
-	bool fetchColumn(std::size_t n, PgSQL_BIND *bind);
-		/// Fetches the column.
+	std::size_t affectedRows() const;
+		/// Returns the number of rows affected by the last execution,
+		/// or the number of rows returned once all have been fetched.
 
 	operator PgSQL_STMT* ();
-		/// Cast operator to native handle type.
+		/// Cast operator to native handle type. Returns the description
+		/// of the prepared statement, which holds the result columns.
 
 private:
 
 	StatementExecutor(const StatementExecutor&);
 	StatementExecutor& operator=(const StatementExecutor&);
 
-	static std::string getRandomName();
+	void finish();
+		/// Discards the current result and the rows that haven't been
+		/// fetched, so the connection can be used again.
+
+	void setAffectedRows(pg_result* result);
+
+	void bindParams(PgSQL_BIND* params, std::size_t count);
+		/// Fills the parameter arrays passed to libpq.
 
 private:
 	pg_conn* _connection;
+	StatementCache& _cache;
+	StatementCache::Statement::Ptr _pStatement;
+	pg_result* _description;
 	pg_result* _result;
+	int _row;
 	int _state;
+	bool _singleRowMode;
+	bool _streaming;
+	std::size_t _affectedRows;
 	std::string _query;
-	std::string _stmtName;
+	std::vector<const char*> _paramValues;
+	std::vector<int> _paramLengths;
+	std::vector<int> _paramFormats;
 };
 
 
@@ -108,11 +191,49 @@ private:
 //
 
 inline StatementExecutor::operator PgSQL_STMT* ()
+{
+	return _description;
+}
+
+
+inline bool StatementExecutor::isSingleRowMode() const
+{
+	return _singleRowMode;
+}
+
+
+inline pg_result* StatementExecutor::result() const
 {
 	return _result;
 }
 
 
+inline int StatementExecutor::row() const
+{
+	return _row;
+}
+
+
+inline std::size_t StatementExecutor::rows() const
+{
+	return (_result && _row >= 0) ? static_cast<std::size_t>(PQntuples(_result) - _row) : 0;
+}
+
+
+inline void StatementExecutor::skip(std::size_t rows)
+{
+	poco_assert (rows < this->rows());
+
+	_row += static_cast<int>(rows);
+}
+
+
+inline std::size_t StatementExecutor::affectedRows() const
+{
+	return _affectedRows;
+}
+
+
 }}}
 
 
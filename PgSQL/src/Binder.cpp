@@ -36,6 +36,31 @@
 
 #include "Poco/Data/PgSQL/Binder.h"
 #include "Poco/Data/PgSQL/PgSQLInternal.h"
+#include "Poco/ByteOrder.h"
+#include "Poco/Timespan.h"
+#include <cstring>
+
+
+namespace
+{
+	template <typename U, typename S>
+	inline U networkBits(S value)
+		/// Returns the bit pattern of value in network byte order,
+		/// as PostgreSQL expects binary parameters.
+	{
+		U bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return Poco::ByteOrder::toNetwork(bits);
+	}
+
+	const Poco::Int64 USECS_PER_DAY = Poco::Int64(86400)*1000000;
+
+	Poco::Int64 sincePostgresEpoch(const Poco::DateTime& val)
+		/// Returns microseconds since 2000-01-01.
+	{
+		return (val - Poco::DateTime(2000, 1, 1)).totalMicroseconds();
+	}
+}
 
 
 namespace Poco {
@@ -43,7 +68,8 @@ namespace Data {
 namespace PgSQL {
 
 
-Binder::Binder()
+Binder::Binder():
+	_parameterCount(1)
 {
 }
 
@@ -56,56 +82,62 @@ Binder::~Binder()
 void Binder::bind(std::size_t pos, const Poco::Int8& val, Direction dir)
 {
 	poco_assert(dir == PD_IN);
-	realBind(pos, PgSQL_TYPE_INT8, &val, 1);
+	realBindFixed(pos, PgSQL_TYPE_INT8, &val, 1);
 }
 
 
 void Binder::bind(std::size_t pos, const Poco::UInt8& val, Direction dir)
 {
 	poco_assert(dir == PD_IN);
-	realBind(pos, PgSQL_TYPE_INT8, &val, 1);
+	realBindFixed(pos, PgSQL_TYPE_INT8, &val, 1);
 }
 
 
 void Binder::bind(std::size_t pos, const Poco::Int16& val, Direction dir)
 {
 	poco_assert(dir == PD_IN);
-	realBind(pos, PgSQL_TYPE_INT16, &val, 2);
+	Poco::UInt16 bits = networkBits<Poco::UInt16>(val);
+	realBindFixed(pos, PgSQL_TYPE_INT16, &bits, 2);
 }
 
 
 void Binder::bind(std::size_t pos, const Poco::UInt16& val, Direction dir)
 {
 	poco_assert(dir == PD_IN);
-	realBind(pos, PgSQL_TYPE_INT16, &val, 2);
+	Poco::UInt16 bits = networkBits<Poco::UInt16>(val);
+	realBindFixed(pos, PgSQL_TYPE_INT16, &bits, 2);
 }
 
 
 void Binder::bind(std::size_t pos, const Poco::Int32& val, Direction dir)
 {
 	poco_assert(dir == PD_IN);
-	realBind(pos, PgSQL_TYPE_INT32, &val, 4);
+	Poco::UInt32 bits = networkBits<Poco::UInt32>(val);
+	realBindFixed(pos, PgSQL_TYPE_INT32, &bits, 4);
 }
 
 
 void Binder::bind(std::size_t pos, const Poco::UInt32& val, Direction dir)
 {
 	poco_assert(dir == PD_IN);
-	realBind(pos, PgSQL_TYPE_INT32, &val, 4);
+	Poco::UInt32 bits = networkBits<Poco::UInt32>(val);
+	realBindFixed(pos, PgSQL_TYPE_INT32, &bits, 4);
 }
 
 
 void Binder::bind(std::size_t pos, const Poco::Int64& val, Direction dir)
 {
 	poco_assert(dir == PD_IN);
-	realBind(pos, PgSQL_TYPE_INT64, &val, 8);
+	Poco::UInt64 bits = networkBits<Poco::UInt64>(val);
+	realBindFixed(pos, PgSQL_TYPE_INT64, &bits, 8);
 }
 
 
 void Binder::bind(std::size_t pos, const Poco::UInt64& val, Direction dir)
 {
 	poco_assert(dir == PD_IN);
-	realBind(pos, PgSQL_TYPE_INT64, &val, 8);
+	Poco::UInt64 bits = networkBits<Poco::UInt64>(val);
+	realBindFixed(pos, PgSQL_TYPE_INT64, &bits, 8);
 }
 
 
@@ -113,7 +145,8 @@ void Binder::bind(std::size_t pos, const Poco::UInt64& val, Direction dir)
 void Binder::bind(std::size_t pos, const long& val, Direction dir)
 {
 	poco_assert(dir == PD_IN);
-	realBind(pos, PgSQL_TYPE_INT64, &val, 8);
+	Poco::UInt64 bits = Poco::ByteOrder::toNetwork(static_cast<Poco::UInt64>(val));
+	realBindFixed(pos, PgSQL_TYPE_INT64, &bits, 8);
 }
 #endif
 
@@ -121,28 +154,30 @@ void Binder::bind(std::size_t pos, const long& val, Direction dir)
 void Binder::bind(std::size_t pos, const bool& val, Direction dir)
 {
 	poco_assert(dir == PD_IN);
-	realBind(pos, PgSQL_TYPE_BOOL, &val, 1);
+	realBindFixed(pos, PgSQL_TYPE_BOOL, &val, 1);
 }
 
 
 void Binder::bind(std::size_t pos, const float& val, Direction dir)
 {
 	poco_assert(dir == PD_IN);
-	realBind(pos, PgSQL_TYPE_FLOAT, &val, 4);
+	Poco::UInt32 bits = networkBits<Poco::UInt32>(val);
+	realBindFixed(pos, PgSQL_TYPE_FLOAT, &bits, 4);
 }
 
 
 void Binder::bind(std::size_t pos, const double& val, Direction dir)
 {
 	poco_assert(dir == PD_IN);
-	realBind(pos, PgSQL_TYPE_DOUBLE, &val, 8);
+	Poco::UInt64 bits = networkBits<Poco::UInt64>(val);
+	realBindFixed(pos, PgSQL_TYPE_DOUBLE, &bits, 8);
 }
 
 
 void Binder::bind(std::size_t pos, const char& val, Direction dir)
 {
 	poco_assert(dir == PD_IN);
-	realBind(pos, PgSQL_TYPE_INT8, &val, 1);
+	realBindFixed(pos, PgSQL_TYPE_INT8, &val, 1);
 }
 
 
@@ -169,60 +204,28 @@ void Binder::bind(std::size_t pos, const Poco::Data::CLOB& val, Direction dir)
 
 void Binder::bind(std::size_t pos, const DateTime& val, Direction dir)
 {
-#if 0
 	poco_assert(dir == PD_IN);
-	PgSQL_TIME mt = {0};
-
-	mt.year = val.year();
-	mt.month = val.month();
-	mt.day = val.day();
-	mt.hour = val.hour();
-	mt.minute = val.minute();
-	mt.second = val.second();
-	mt.second_part = val.millisecond();
-
-	mt.time_type  = PgSQL_TIMESTAMP_DATETIME;
-
-	_dates.push_back(mt);
-
-	realBind(pos, PgSQL_TYPE_DATETIME, &_dates.back(), sizeof(mt));
-#endif
+	Poco::UInt64 bits = networkBits<Poco::UInt64>(sincePostgresEpoch(val));
+	realBindFixed(pos, PgSQL_TYPE_TIMESTAMP, &bits, 8);
 }
 
 
 void Binder::bind(std::size_t pos, const Date& val, Direction dir)
 {
-#if 0
-    poco_assert(dir == PD_IN);
-	PgSQL_TIME mt = {0};
-
-	mt.year  = val.year();
-	mt.month = val.month();
-	mt.day   = val.day();
-
-	_dates.push_back(mt);
-
-	realBind(pos, PgSQL_TYPE_DATE, &_dates.back(), sizeof(mt));
-#endif
+	poco_assert(dir == PD_IN);
+	DateTime dt(val.year(), val.month(), val.day());
+	Poco::Int32 days = static_cast<Poco::Int32>(sincePostgresEpoch(dt)/USECS_PER_DAY);
+	Poco::UInt32 bits = networkBits<Poco::UInt32>(days);
+	realBindFixed(pos, PgSQL_TYPE_DATE, &bits, 4);
 }
 
 
 void Binder::bind(std::size_t pos, const Time& val, Direction dir)
 {
-#if 0
 	poco_assert(dir == PD_IN);
-	PgSQL_TIME mt = {0};
-
-	mt.hour   = val.hour();
-	mt.minute = val.minute();
-	mt.second = val.second();
-
-	mt.time_type = PgSQL_TIMESTAMP_TIME;
-
-	_dates.push_back(mt);
-
-	realBind(pos, PgSQL_TYPE_TIME, &_dates.back(), sizeof(mt));
-#endif
+	Poco::Timespan ts(0, val.hour(), val.minute(), val.second(), 0);
+	Poco::UInt64 bits = networkBits<Poco::UInt64>(ts.totalMicroseconds());
+	realBindFixed(pos, PgSQL_TYPE_TIME, &bits, 8);
 }
 
 
@@ -233,6 +236,15 @@ void Binder::bind(std::size_t pos, const NullData&, Direction dir)
 }
 
 
+void Binder::setParameterCount(std::size_t count)
+{
+	poco_assert (count > 0);
+
+	_parameterCount = count;
+	_bindArray.clear();
+}
+
+
 std::size_t Binder::size() const
 {
 	return static_cast<std::size_t>(_bindArray.size());
@@ -259,357 +271,417 @@ PgSQL_BIND* Binder::getBindArray() const
 void Binder::realBind(std::size_t pos, int type, const void* buffer, int length)
 {
 	if (pos >= _bindArray.size())
-	{
-		std::size_t s = static_cast<std::size_t>(_bindArray.size());
 		_bindArray.resize(pos + 1);
 
-		std::memset(&_bindArray[s], 0, sizeof(PgSQL_BIND) * (_bindArray.size() - s));
-	}
+	_bindArray[pos] = PgSQL_BIND(type, static_cast<const char*>(buffer), length);
+}
+
+
+void Binder::realBindFixed(std::size_t pos, int type, const void* buffer, int length)
+{
+	if (pos >= _bindArray.size())
+		_bindArray.resize(pos + 1);
 
-	PgSQL_BIND b(type, (const char*)buffer, length);
-	_bindArray[pos] = b;
+	_bindArray[pos].setFixed(type, buffer, length);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<Poco::Int8>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<Poco::Int8>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<Poco::Int8>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<Poco::UInt8>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<Poco::UInt8>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<Poco::UInt8>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<Poco::Int16>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<Poco::Int16>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<Poco::Int16>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<Poco::UInt16>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<Poco::UInt16>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<Poco::UInt16>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<Poco::Int32>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<Poco::Int32>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<Poco::Int32>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<Poco::UInt32>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<Poco::UInt32>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<Poco::UInt32>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<Poco::Int64>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<Poco::Int64>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<Poco::Int64>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<Poco::UInt64>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<Poco::UInt64>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<Poco::UInt64>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<bool>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<bool>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<bool>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<float>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<float>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<float>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<double>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<double>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<double>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<char>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<char>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<char>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<Poco::Data::BLOB>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<Poco::Data::BLOB>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<Poco::Data::BLOB>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<Poco::Data::CLOB>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<Poco::Data::CLOB>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<Poco::Data::CLOB>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<Poco::DateTime>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<Poco::DateTime>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<Poco::DateTime>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<Poco::Data::Date>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<Poco::Data::Date>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<Poco::Data::Date>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<Poco::Data::Time>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<Poco::Data::Time>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<Poco::Data::Time>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<Poco::Data::NullData>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<Poco::Data::NullData>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<Poco::Data::NullData>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::vector<std::string>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::deque<std::string>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
 void Binder::bind(std::size_t pos, const std::list<std::string>& val, Direction dir)
 {
-	throw NotImplementedException();
+	poco_assert(dir == PD_IN);
+	bindColumn(pos, val);
 }
 
 
@@ -0,0 +1,305 @@
+//
+// CopyIn.cpp
+//
+// $Id$
+//
+// Library: Data
+// Package: PgSQL
+// Module:  CopyIn
+//
+// Copyright (c) 2008, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Data/PgSQL/CopyIn.h"
+#include "Poco/ByteOrder.h"
+#include <cstdlib>
+#include <cstring>
+#if defined(POCO_OS_FAMILY_WINDOWS)
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#endif
+
+
+namespace
+{
+	const char COPY_SIGNATURE[] = "PGCOPY\n\377\r\n";
+
+	void appendInt16(std::vector<char>& buffer, Poco::Int16 value)
+	{
+		Poco::Int16 bits = Poco::ByteOrder::toNetwork(value);
+		const char* p = reinterpret_cast<const char*>(&bits);
+		buffer.insert(buffer.end(), p, p + sizeof(bits));
+	}
+
+	void appendInt32(std::vector<char>& buffer, Poco::Int32 value)
+	{
+		Poco::Int32 bits = Poco::ByteOrder::toNetwork(value);
+		const char* p = reinterpret_cast<const char*>(&bits);
+		buffer.insert(buffer.end(), p, p + sizeof(bits));
+	}
+
+	void waitWritable(PGconn* conn)
+		/// Waits until a non-blocking connection has sent its queued data.
+	{
+		int rc;
+		while ((rc = PQflush(conn)) == 1)
+		{
+			int fd = PQsocket(conn);
+			fd_set readSet;
+			fd_set writeSet;
+			FD_ZERO(&readSet);
+			FD_ZERO(&writeSet);
+			FD_SET(fd, &readSet);
+			FD_SET(fd, &writeSet);
+			if (select(fd + 1, &readSet, &writeSet, 0, 0) < 0)
+				throw Poco::Data::PgSQL::StatementException("select() error while copying");
+
+			// The server may block on sending us a notice, so read it.
+			if (FD_ISSET(fd, &readSet) && !PQconsumeInput(conn))
+				break;
+		}
+		if (rc < 0 || PQstatus(conn) == CONNECTION_BAD)
+			throw Poco::Data::PgSQL::StatementException(std::string("PQflush error: ") + PQerrorMessage(conn));
+	}
+}
+
+
+namespace Poco {
+namespace Data {
+namespace PgSQL {
+
+
+CopyIn::CopyIn(SessionHandle& handle, const std::string& table, const std::string& columns, std::size_t bufferSize):
+	_connection(handle),
+	_columns(0),
+	_column(0),
+	_rows(0),
+	_bufferSize(bufferSize),
+	_active(false)
+{
+	std::string query("COPY ");
+	query += table;
+	if (!columns.empty())
+	{
+		query += " (";
+		query += columns;
+		query += ")";
+	}
+	query += " FROM STDIN (FORMAT binary)";
+
+	PGresult* result = PQexec(_connection, query.c_str());
+	if (PQresultStatus(result) != PGRES_COPY_IN)
+	{
+		StatementException exc("COPY error", result, query);
+		PQclear(result);
+		throw exc;
+	}
+	_columns = static_cast<std::size_t>(PQnfields(result));
+	PQclear(result);
+	_active = true;
+
+	writeHeader();
+}
+
+
+CopyIn::CopyIn(std::size_t columns, std::size_t bufferSize):
+	_connection(0),
+	_columns(columns),
+	_column(0),
+	_rows(0),
+	_bufferSize(bufferSize),
+	_active(true)
+{
+	writeHeader();
+}
+
+
+CopyIn::~CopyIn()
+{
+	try
+	{
+		if (_active)
+			abort();
+	}
+	catch (...)
+	{
+	}
+}
+
+
+void CopyIn::writeHeader()
+{
+	_buffer.reserve(_bufferSize + 1024);
+	_buffer.insert(_buffer.end(), COPY_SIGNATURE, COPY_SIGNATURE + sizeof(COPY_SIGNATURE));
+	appendInt32(_buffer, 0); // flags
+	appendInt32(_buffer, 0); // header extension length
+}
+
+
+void CopyIn::writeValue()
+{
+	// The Binder doesn't copy strings and LOBs, so the value is
+	// encoded while the caller's data is known to be valid.
+	if (_column == 0)
+		appendInt16(_buffer, static_cast<Poco::Int16>(_columns));
+
+	const PgSQL_BIND& value = *_binder.getBindArray();
+	if (value._oid == PgSQL_TYPE_NULL)
+	{
+		appendInt32(_buffer, -1);
+	}
+	else
+	{
+		appendInt32(_buffer, value._paramLenght);
+		_buffer.insert(_buffer.end(), value._paramValue, value._paramValue + value._paramLenght);
+	}
+
+	if (++_column == _columns)
+	{
+		_column = 0;
+		++_rows;
+		if (_buffer.size() >= _bufferSize)
+			flush();
+	}
+}
+
+
+void CopyIn::writeColumns()
+{
+	if (_column != 0)
+	{
+		_pending.clear();
+		throw InvalidAccessException("CopyIn: row is incomplete");
+	}
+
+	std::size_t rows = _pending[0]->size();
+	for (std::size_t i = 1; i < _pending.size(); ++i)
+	{
+		if (_pending[i]->size() != rows)
+		{
+			_pending.clear();
+			throw InvalidArgumentException("CopyIn: columns differ in size");
+		}
+	}
+
+	for (std::size_t row = 0; row < rows; ++row)
+	{
+		for (std::size_t col = 0; col < _columns; ++col)
+		{
+			_pending[col]->bindNext(_binder);
+			writeValue();
+		}
+	}
+	_pending.clear();
+}
+
+
+void CopyIn::flush()
+{
+	if (_buffer.empty())
+		return;
+
+	sendData(&_buffer[0], _buffer.size());
+	_buffer.clear();
+}
+
+
+void CopyIn::sendData(const char* data, std::size_t length)
+{
+	int rc;
+	while ((rc = PQputCopyData(_connection, data, static_cast<int>(length))) == 0)
+	{
+		// Only a non-blocking connection returns 0; its queue is full.
+		waitWritable(_connection);
+	}
+	if (rc < 0)
+		throw StatementException(std::string("PQputCopyData error: ") + PQerrorMessage(_connection));
+}
+
+
+std::size_t CopyIn::end()
+{
+	if (!_active)
+		throw InvalidAccessException("CopyIn: copy already ended");
+
+	if (_column != 0 || !_pending.empty())
+		throw InvalidAccessException("CopyIn: last row is incomplete");
+
+	appendInt16(_buffer, -1); // trailer
+	flush();
+	_active = false;
+
+	return sendEnd();
+}
+
+
+std::size_t CopyIn::sendEnd()
+{
+	int rc;
+	while ((rc = PQputCopyEnd(_connection, 0)) == 0)
+	{
+		waitWritable(_connection);
+	}
+	if (rc < 0)
+		throw StatementException(std::string("PQputCopyEnd error: ") + PQerrorMessage(_connection));
+	if (PQisnonblocking(_connection))
+		waitWritable(_connection);
+
+	std::size_t loaded = 0;
+	std::string error;
+	while (PGresult* result = PQgetResult(_connection))
+	{
+		if (PQresultStatus(result) == PGRES_COMMAND_OK)
+			loaded = static_cast<std::size_t>(std::strtoul(PQcmdTuples(result), 0, 10));
+		else if (error.empty())
+			error = PQresultErrorMessage(result);
+		PQclear(result);
+	}
+	if (!error.empty())
+		throw StatementException("COPY error: " + error);
+
+	return loaded;
+}
+
+
+void CopyIn::abort()
+{
+	_active = false;
+	_buffer.clear();
+	if (!_connection)
+		return;
+	if (PQputCopyEnd(_connection, "aborted by client") == 0)
+		waitWritable(_connection);
+	while (PGresult* result = PQgetResult(_connection))
+	{
+		PQclear(result);
+	}
+}
+
+
+} } } // namespace Poco::Data::PgSQL
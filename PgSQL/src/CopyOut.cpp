@@ -0,0 +1,393 @@
+//
+// CopyOut.cpp
+//
+// $Id$
+//
+// Library: Data
+// Package: PgSQL
+// Module:  CopyOut
+//
+// Copyright (c) 2008, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Data/PgSQL/CopyOut.h"
+#include "Poco/Data/PgSQL/PgSQLException.h"
+#include "Poco/ByteOrder.h"
+#include "Poco/Timespan.h"
+#include <cstring>
+
+
+namespace
+{
+	const char COPY_SIGNATURE[] = "PGCOPY\n\377\r\n";
+	const std::size_t HEADER_SIZE = sizeof(COPY_SIGNATURE) + 8;
+	const Poco::Int64 USECS_PER_DAY = Poco::Int64(86400)*1000000;
+
+	Poco::Int16 readInt16(const char* data)
+	{
+		Poco::Int16 bits;
+		std::memcpy(&bits, data, sizeof(bits));
+		return Poco::ByteOrder::fromNetwork(bits);
+	}
+
+	Poco::Int32 readInt32(const char* data)
+	{
+		Poco::Int32 bits;
+		std::memcpy(&bits, data, sizeof(bits));
+		return Poco::ByteOrder::fromNetwork(bits);
+	}
+
+	Poco::Int64 readInt64(const char* data)
+	{
+		Poco::Int64 bits;
+		std::memcpy(&bits, data, sizeof(bits));
+		return Poco::ByteOrder::fromNetwork(bits);
+	}
+
+	Poco::Int64 readInteger(const char* data, std::size_t length)
+		/// Reads a smallint, integer or bigint ("char" and bool have one byte).
+	{
+		switch (length)
+		{
+		case 1: return static_cast<Poco::Int8>(data[0]);
+		case 2: return readInt16(data);
+		case 4: return readInt32(data);
+		case 8: return readInt64(data);
+		default:
+			throw Poco::Data::PgSQL::PgSQLException("CopyOut: not an integer");
+		}
+	}
+
+	double readFloat(const char* data, std::size_t length)
+		/// Reads a real or double precision.
+	{
+		if (length == 4)
+		{
+			Poco::Int32 bits = readInt32(data);
+			float f;
+			std::memcpy(&f, &bits, sizeof(f));
+			return f;
+		}
+		else if (length == 8)
+		{
+			Poco::Int64 bits = readInt64(data);
+			double d;
+			std::memcpy(&d, &bits, sizeof(d));
+			return d;
+		}
+		throw Poco::Data::PgSQL::PgSQLException("CopyOut: not a floating-point number");
+	}
+
+	Poco::DateTime readDateTime(const char* data, std::size_t length)
+		/// Reads a date (days) or timestamp (microseconds) since 2000-01-01.
+	{
+		Poco::Int64 usecs;
+		if (length == 4)
+			usecs = readInt32(data)*USECS_PER_DAY;
+		else if (length == 8)
+			usecs = readInt64(data);
+		else
+			throw Poco::Data::PgSQL::PgSQLException("CopyOut: not a date or timestamp");
+
+		return Poco::DateTime(2000, 1, 1) + Poco::Timespan(usecs);
+	}
+}
+
+
+namespace Poco {
+namespace Data {
+namespace PgSQL {
+
+
+CopyOut::CopyOut(SessionHandle& handle, const std::string& source, const std::string& columns):
+	_connection(handle),
+	_header(false),
+	_done(true)
+{
+	_query = "COPY ";
+	_query += source;
+	if (!columns.empty())
+	{
+		_query += " (";
+		_query += columns;
+		_query += ")";
+	}
+	_query += " TO STDOUT (FORMAT binary)";
+}
+
+
+CopyOut::~CopyOut()
+{
+	if (!_done)
+	{
+		// Receive the rest so that the connection can be used again.
+		char* buffer = 0;
+		while (PQgetCopyData(_connection, &buffer, 0) > 0)
+		{
+			PQfreemem(buffer);
+		}
+		while (PGresult* result = PQgetResult(_connection))
+		{
+			PQclear(result);
+		}
+	}
+}
+
+
+std::size_t CopyOut::execute()
+{
+	for (std::vector<ColumnPtr>::iterator it = _columns.begin(); it != _columns.end(); ++it)
+	{
+		(*it)->clearNulls();
+	}
+
+	PGresult* result = PQexec(_connection, _query.c_str());
+	if (PQresultStatus(result) != PGRES_COPY_OUT)
+	{
+		StatementException exc("COPY error", result, _query);
+		PQclear(result);
+		throw exc;
+	}
+	std::size_t columns = static_cast<std::size_t>(PQnfields(result));
+	PQclear(result);
+	_done = false;
+	_header = false;
+
+	if (columns != _columns.size())
+		throw InvalidArgumentException("CopyOut: need a container for every column");
+
+	// Each chunk returned by PQgetCopyData() holds one row, plus the
+	// header in the first one. Rows are decoded as they arrive, so only
+	// one is buffered at a time.
+	std::size_t rows = 0;
+	char* buffer = 0;
+	int length;
+	while ((length = PQgetCopyData(_connection, &buffer, 0)) > 0)
+	{
+		try
+		{
+			rows += parse(buffer, static_cast<std::size_t>(length));
+		}
+		catch (...)
+		{
+			PQfreemem(buffer);
+			throw;
+		}
+		PQfreemem(buffer);
+	}
+	_done = true;
+
+	std::string error;
+	if (length == -2)
+		error = PQerrorMessage(_connection);
+	while (PGresult* result = PQgetResult(_connection))
+	{
+		if (PQresultStatus(result) != PGRES_COMMAND_OK && error.empty())
+			error = PQresultErrorMessage(result);
+		PQclear(result);
+	}
+	if (!error.empty())
+		throw StatementException("COPY error: " + error);
+
+	return rows;
+}
+
+
+bool CopyOut::isNull(std::size_t col, std::size_t row) const
+{
+	return _columns.at(col)->isNull(row);
+}
+
+
+std::size_t CopyOut::parse(const char* data, std::size_t length)
+{
+	const char* end = data + length;
+	if (!_header)
+	{
+		if (length < HEADER_SIZE || std::memcmp(data, COPY_SIGNATURE, sizeof(COPY_SIGNATURE)) != 0)
+			throw PgSQLException("CopyOut: invalid COPY header");
+
+		Poco::Int32 extension = readInt32(data + sizeof(COPY_SIGNATURE) + 4);
+		if (extension < 0 || static_cast<std::size_t>(extension) > length - HEADER_SIZE)
+			throw PgSQLException("CopyOut: invalid COPY header");
+
+		data += HEADER_SIZE + extension;
+		_header = true;
+	}
+
+	std::size_t rows = 0;
+	while (end - data >= 2)
+	{
+		Poco::Int16 fields = readInt16(data);
+		data += 2;
+		if (fields == -1) // trailer
+			break;
+		if (static_cast<std::size_t>(fields) != _columns.size())
+			throw PgSQLException("CopyOut: unexpected number of fields");
+
+		for (std::size_t i = 0; i < _columns.size(); ++i)
+		{
+			if (end - data < 4)
+				throw PgSQLException("CopyOut: truncated row");
+			Poco::Int32 fieldLength = readInt32(data);
+			data += 4;
+			if (fieldLength > end - data)
+				throw PgSQLException("CopyOut: truncated row");
+
+			_columns[i]->append(data, fieldLength);
+			if (fieldLength > 0)
+				data += fieldLength;
+		}
+		++rows;
+	}
+	return rows;
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, Poco::Int8& val)
+{
+	val = static_cast<Poco::Int8>(readInteger(data, length));
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, Poco::UInt8& val)
+{
+	val = static_cast<Poco::UInt8>(readInteger(data, length));
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, Poco::Int16& val)
+{
+	val = static_cast<Poco::Int16>(readInteger(data, length));
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, Poco::UInt16& val)
+{
+	val = static_cast<Poco::UInt16>(readInteger(data, length));
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, Poco::Int32& val)
+{
+	val = static_cast<Poco::Int32>(readInteger(data, length));
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, Poco::UInt32& val)
+{
+	val = static_cast<Poco::UInt32>(readInteger(data, length));
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, Poco::Int64& val)
+{
+	val = readInteger(data, length);
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, Poco::UInt64& val)
+{
+	val = static_cast<Poco::UInt64>(readInteger(data, length));
+}
+
+
+#ifndef POCO_LONG_IS_64_BIT
+void CopyOut::decode(const char* data, std::size_t length, long& val)
+{
+	val = static_cast<long>(readInteger(data, length));
+}
+#endif
+
+
+void CopyOut::decode(const char* data, std::size_t length, bool& val)
+{
+	val = readInteger(data, length) != 0;
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, char& val)
+{
+	val = static_cast<char>(readInteger(data, length));
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, float& val)
+{
+	val = static_cast<float>(readFloat(data, length));
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, double& val)
+{
+	val = readFloat(data, length);
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, std::string& val)
+{
+	val.assign(data, length);
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, Poco::Data::BLOB& val)
+{
+	val.assignRaw(reinterpret_cast<const unsigned char*>(data), length);
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, Poco::Data::CLOB& val)
+{
+	val.assignRaw(data, length);
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, Poco::DateTime& val)
+{
+	val = readDateTime(data, length);
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, Poco::Data::Date& val)
+{
+	Poco::DateTime dt = readDateTime(data, length);
+	val.assign(dt.year(), dt.month(), dt.day());
+}
+
+
+void CopyOut::decode(const char* data, std::size_t length, Poco::Data::Time& val)
+{
+	if (length != 8)
+		throw PgSQLException("CopyOut: not a time");
+
+	Poco::Int64 usecs = readInt64(data);
+	Poco::Timespan ts(((usecs % USECS_PER_DAY) + USECS_PER_DAY) % USECS_PER_DAY);
+	val.assign(ts.hours(), ts.minutes(), ts.seconds());
+}
+
+
+} } } // namespace Poco::Data::PgSQL
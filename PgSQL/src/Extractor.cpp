@@ -38,13 +38,194 @@
 
 #include "Poco/Data/Date.h"
 #include "Poco/Data/Time.h"
+#include "Poco/ByteOrder.h"
+#include "Poco/DateTime.h"
+#include "Poco/Timespan.h"
+#include <cstring>
+
+
+namespace
+{
+	inline Poco::UInt8 fromNetwork(Poco::UInt8 value)
+	{
+		return value;
+	}
+
+	inline Poco::UInt16 fromNetwork(Poco::UInt16 value)
+	{
+		return Poco::ByteOrder::fromNetwork(value);
+	}
+
+	inline Poco::UInt32 fromNetwork(Poco::UInt32 value)
+	{
+		return Poco::ByteOrder::fromNetwork(value);
+	}
+
+	inline Poco::UInt64 fromNetwork(Poco::UInt64 value)
+	{
+		return Poco::ByteOrder::fromNetwork(value);
+	}
+
+	template <typename S, typename U>
+	inline S networkValue(const char* data)
+		/// Decodes a binary value of type S, sent as the bit
+		/// pattern U in network byte order.
+	{
+		U bits;
+		std::memcpy(&bits, data, sizeof(bits));
+		bits = fromNetwork(bits);
+		S value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	inline void checkLength(std::size_t length, std::size_t expected)
+	{
+		if (length != expected)
+			throw Poco::Data::PgSQL::PgSQLException("Extractor: unexpected length of binary value");
+	}
+
+	const Poco::Int64 USECS_PER_DAY = Poco::Int64(86400)*1000000;
+
+	Poco::Int64 timestampValue(int type, const char* data, std::size_t length)
+		/// Returns microseconds since 2000-01-01, or since midnight for time.
+	{
+		switch (type)
+		{
+		case PgSQL_TYPE_DATE:
+			checkLength(length, 4);
+			return networkValue<Poco::Int32, Poco::UInt32>(data)*USECS_PER_DAY;
+
+		case PgSQL_TYPE_TIME:
+		case PgSQL_TYPE_TIMESTAMP:
+			// integer_datetimes: 64-bit microseconds
+			checkLength(length, 8);
+			return networkValue<Poco::Int64, Poco::UInt64>(data);
+
+		default:
+			throw Poco::Data::PgSQL::PgSQLException("Extractor: not a date/time");
+		}
+	}
+
+	Poco::DateTime toDateTime(Poco::Int64 usecs)
+	{
+		return Poco::DateTime(2000, 1, 1) + Poco::Timespan(usecs);
+	}
+
+	Poco::Data::Date toDate(Poco::Int64 usecs)
+	{
+		Poco::DateTime dt = toDateTime(usecs);
+		return Poco::Data::Date(dt.year(), dt.month(), dt.day());
+	}
+
+	Poco::Data::Time toTime(Poco::Int64 usecs)
+	{
+		Poco::Timespan ts(((usecs % USECS_PER_DAY) + USECS_PER_DAY) % USECS_PER_DAY);
+		return Poco::Data::Time(ts.hours(), ts.minutes(), ts.seconds());
+	}
+
+	//
+	// Column decoders for bulk extraction; each converts the binary
+	// value of one non-null field.
+	//
+
+	template <typename T, typename S, typename U>
+	class NumberDecoder
+	{
+	public:
+		T operator () (const char* data, std::size_t length) const
+		{
+			checkLength(length, sizeof(S));
+			return static_cast<T>(networkValue<S, U>(data));
+		}
+	};
+
+	class StringDecoder
+	{
+	public:
+		std::string operator () (const char* data, std::size_t length) const
+		{
+			return std::string(data, length);
+		}
+	};
+
+	class BLOBDecoder
+	{
+	public:
+		Poco::Data::BLOB operator () (const char* data, std::size_t length) const
+		{
+			return Poco::Data::BLOB(reinterpret_cast<const unsigned char*>(data), length);
+		}
+	};
+
+	class CLOBDecoder
+	{
+	public:
+		Poco::Data::CLOB operator () (const char* data, std::size_t length) const
+		{
+			return Poco::Data::CLOB(data, length);
+		}
+	};
+
+	class DateTimeDecoder
+	{
+	public:
+		explicit DateTimeDecoder(int type): _type(type)
+		{
+		}
+
+		Poco::DateTime operator () (const char* data, std::size_t length) const
+		{
+			return toDateTime(timestampValue(_type, data, length));
+		}
+
+	private:
+		int _type;
+	};
+
+	class DateDecoder
+	{
+	public:
+		explicit DateDecoder(int type): _type(type)
+		{
+		}
+
+		Poco::Data::Date operator () (const char* data, std::size_t length) const
+		{
+			return toDate(timestampValue(_type, data, length));
+		}
+
+	private:
+		int _type;
+	};
+
+	class TimeDecoder
+	{
+	public:
+		explicit TimeDecoder(int type): _type(type)
+		{
+		}
+
+		Poco::Data::Time operator () (const char* data, std::size_t length) const
+		{
+			return toTime(timestampValue(_type, data, length));
+		}
+
+	private:
+		int _type;
+	};
+}
+
 
 namespace Poco {
 namespace Data {
 namespace PgSQL {
 
 
-Extractor::Extractor(StatementExecutor& st, ResultMetadata& md): _stmt(st), _metadata(md)
+Extractor::Extractor(StatementExecutor& st, ResultMetadata& md):
+	_stmt(st),
+	_metadata(md),
+	_rowCount(1)
 {
 }
 
@@ -56,49 +237,49 @@ Extractor::~Extractor()
 
 bool Extractor::extract(std::size_t pos, Poco::Int8& val)
 {
-	return realExtractFixed(pos, PgSQL_TYPE_INT8, &val);
+	return realExtractFixed(pos, val);
 }
 
 
 bool Extractor::extract(std::size_t pos, Poco::UInt8& val)
 {
-	return realExtractFixed(pos, PgSQL_TYPE_INT8, &val);
+	return realExtractFixed(pos, val);
 }
 
 
 bool Extractor::extract(std::size_t pos, Poco::Int16& val)
 {
-	return realExtractFixed(pos, PgSQL_TYPE_INT16, &val);
+	return realExtractFixed(pos, val);
 }
 
 
 bool Extractor::extract(std::size_t pos, Poco::UInt16& val)
 {
-	return realExtractFixed(pos, PgSQL_TYPE_INT16, &val);
+	return realExtractFixed(pos, val);
 }
 
 
 bool Extractor::extract(std::size_t pos, Poco::Int32& val)
 {
-	return realExtractFixed(pos, PgSQL_TYPE_INT32, &val);
+	return realExtractFixed(pos, val);
 }
 
 
 bool Extractor::extract(std::size_t pos, Poco::UInt32& val)
 {
-	return realExtractFixed(pos, PgSQL_TYPE_INT32, &val);
+	return realExtractFixed(pos, val);
 }
 
 
 bool Extractor::extract(std::size_t pos, Poco::Int64& val)
 {
-	return realExtractFixed(pos, PgSQL_TYPE_INT64, &val);
+	return realExtractFixed(pos, val);
 }
 
 
 bool Extractor::extract(std::size_t pos, Poco::UInt64& val)
 {
-	return realExtractFixed(pos, PgSQL_TYPE_INT64, &val);
+	return realExtractFixed(pos, val);
 }
 
 
@@ -106,32 +287,32 @@ bool Extractor::extract(std::size_t pos, Poco::UInt64& val)
 bool Extractor::extract(std::size_t pos, long& val)
 		/// Extracts a long. Returns false if null was received.
 {
-	return realExtractFixed(pos, PgSQL_TYPE_INT64, &val);
+	return realExtractFixed(pos, val);
 }
 #endif
 
 
 bool Extractor::extract(std::size_t pos, bool& val)
 {
-	return realExtractFixed(pos, PgSQL_TYPE_BOOL, &val);
+	return realExtractFixed(pos, val);
 }
 
 
 bool Extractor::extract(std::size_t pos, float& val)
 {
-	return realExtractFixed(pos, PgSQL_TYPE_FLOAT, &val);
+	return realExtractFixed(pos, val);
 }
 
 
 bool Extractor::extract(std::size_t pos, double& val)
 {
-	return realExtractFixed(pos, PgSQL_TYPE_DOUBLE, &val);
+	return realExtractFixed(pos, val);
 }
 
 
 bool Extractor::extract(std::size_t pos, char& val)
 {
-	return realExtractFixed(pos, PgSQL_TYPE_INT8, &val);
+	return realExtractFixed(pos, val);
 }
 
 
@@ -140,13 +321,13 @@ bool Extractor::extract(std::size_t pos, std::string& val)
 	if (_metadata.columnsReturned() <= pos)
 		throw PgSQLException("Extractor: attempt to extract more paremeters, than query result contain");
 
-	if (_metadata.isNull(static_cast<Poco::UInt32>(pos)))
-	return false;
+	if (_stmt.isNull(pos))
+		return false;
 
 	if (_metadata.metaColumn(static_cast<Poco::UInt32>(pos)).type() != Poco::Data::MetaColumn::FDT_STRING)
 		throw PgSQLException("Extractor: not a string");
 
-	val.assign(reinterpret_cast<const char*>(_metadata.rawData(pos)), _metadata.length(pos));
+	val.assign(_stmt.value(pos), _stmt.length(pos));
 	return true;
 }
 
@@ -156,13 +337,13 @@ bool Extractor::extract(std::size_t pos, Poco::Data::BLOB& val)
 	if (_metadata.columnsReturned() <= pos)
 		throw PgSQLException("Extractor: attempt to extract more paremeters, than query result contain");
 
-	if (_metadata.isNull(static_cast<Poco::UInt32>(pos)))
-	return false;
+	if (_stmt.isNull(pos))
+		return false;
 
 	if (_metadata.metaColumn(static_cast<Poco::UInt32>(pos)).type() != Poco::Data::MetaColumn::FDT_BLOB)
 		throw PgSQLException("Extractor: not a blob");
 
-	val.assignRaw(_metadata.rawData(pos), _metadata.length(pos));
+	val.assignRaw(reinterpret_cast<const unsigned char*>(_stmt.value(pos)), _stmt.length(pos));
 	return true;
 }
 
@@ -172,56 +353,50 @@ bool Extractor::extract(std::size_t pos, Poco::Data::CLOB& val)
 	if (_metadata.columnsReturned() <= pos)
 		throw PgSQLException("Extractor: attempt to extract more paremeters, than query result contain");
 
-	if (_metadata.isNull(static_cast<Poco::UInt32>(pos)))
-	return false;
+	if (_stmt.isNull(pos))
+		return false;
 
 	if (_metadata.metaColumn(static_cast<Poco::UInt32>(pos)).type() != Poco::Data::MetaColumn::FDT_BLOB)
 		throw PgSQLException("Extractor: not a blob");
 
-	val.assignRaw(reinterpret_cast<const char*>(_metadata.rawData(pos)), _metadata.length(pos));
+	val.assignRaw(_stmt.value(pos), _stmt.length(pos));
 	return true;
 }
 
 
 bool Extractor::extract(std::size_t pos, DateTime& val)
 {
-#if 0
-	PgSQL_TIME mt = {0};
+	Poco::Int64 usecs = 0;
 
-	if (!realExtractFixed(pos, PgSQL_TYPE_DATETIME, &mt))
+	if (!realExtractTimestamp(pos, usecs))
 		return false;
 
-	val.assign(mt.year, mt.month, mt.day, mt.hour, mt.minute, mt.second, mt.second_part, 0);
+	val = toDateTime(usecs);
 	return true;
-#endif
 }
 
 
 bool Extractor::extract(std::size_t pos, Date& val)
 {
-#if 0
-	PgSQL_TIME mt = {0};
+	Poco::Int64 usecs = 0;
 
-	if (!realExtractFixed(pos, PgSQL_TYPE_DATE, &mt))
+	if (!realExtractTimestamp(pos, usecs))
 		return false;
 
-	val.assign(mt.year, mt.month, mt.day);
+	val = toDate(usecs);
 	return true;
-#endif
 }
 
 
 bool Extractor::extract(std::size_t pos, Time& val)
 {
-#if 0
-	PgSQL_TIME mt = {0};
+	Poco::Int64 usecs = 0;
 
-	if (!realExtractFixed(pos, PgSQL_TYPE_TIME, &mt))
+	if (!realExtractTimestamp(pos, usecs))
 		return false;
 
-	val.assign(mt.hour, mt.minute, mt.second);
+	val = toTime(usecs);
 	return true;
-#endif
 }
 
 
@@ -239,391 +414,533 @@ bool Extractor::extract(std::size_t pos, Dynamic::Var& val)
 
 bool Extractor::isNull(std::size_t col, std::size_t row)
 {
-	poco_assert(row == POCO_DATA_INVALID_ROW);
-
 	if (_metadata.columnsReturned() <= col)
 		throw PgSQLException("Extractor: attempt to extract more paremeters, than query result contain");
 
-	if (_metadata.isNull(static_cast<Poco::UInt32>(col)))
-		return true;
+	if (row == POCO_DATA_INVALID_ROW)
+		return _stmt.isNull(col);
 
-	return false;
+	if (col >= _nulls.size() || row >= _nulls[col].size())
+		throw PgSQLException("Extractor: row was not extracted");
+
+	return _nulls[col][row];
+}
+
+
+void Extractor::setRowCount(std::size_t rows)
+{
+	_rowCount = rows;
 }
 
 void Extractor::reset()
 {
 	AbstractExtractor::reset();
+	_nulls.clear();
 }
 
 
-bool Extractor::realExtractFixed(std::size_t pos, int type, void* buffer, std::size_t length)
+template <typename T>
+bool Extractor::realExtractFixed(std::size_t pos, T& val)
 {
-#if 0
-	PgSQL_BIND bind = {0};
-	my_bool isNull = 0;
+	if (_metadata.columnsReturned() <= pos)
+		throw PgSQLException("Extractor: attempt to extract more paremeters, than query result contain");
+
+	if (_stmt.isNull(pos))
+		return false;
+
+	const char* data = _stmt.value(pos);
+	std::size_t length = _stmt.length(pos);
+
+	switch (_metadata.nativeType(pos))
+	{
+	case PgSQL_TYPE_BOOL:
+	case PgSQL_TYPE_INT8:
+		val = NumberDecoder<T, Poco::Int8, Poco::UInt8>()(data, length);
+		break;
+	case PgSQL_TYPE_INT16:
+		val = NumberDecoder<T, Poco::Int16, Poco::UInt16>()(data, length);
+		break;
+	case PgSQL_TYPE_INT32:
+		val = NumberDecoder<T, Poco::Int32, Poco::UInt32>()(data, length);
+		break;
+	case PgSQL_TYPE_INT64:
+		val = NumberDecoder<T, Poco::Int64, Poco::UInt64>()(data, length);
+		break;
+	case PgSQL_TYPE_FLOAT:
+		val = NumberDecoder<T, float, Poco::UInt32>()(data, length);
+		break;
+	case PgSQL_TYPE_DOUBLE:
+		val = NumberDecoder<T, double, Poco::UInt64>()(data, length);
+		break;
+	default:
+		throw PgSQLException("Extractor: not a number");
+	}
+
+	return true;
+}
 
-	bind.is_null	   = &isNull;
-	bind.buffer_type   = type;
-	bind.buffer		= buffer;
-	bind.buffer_length = static_cast<unsigned long>(length);
 
-	if (!_stmt.fetchColumn(pos, &bind))
+bool Extractor::realExtractTimestamp(std::size_t pos, Poco::Int64& usecs)
+{
+	if (_metadata.columnsReturned() <= pos)
+		throw PgSQLException("Extractor: attempt to extract more paremeters, than query result contain");
+
+	if (_stmt.isNull(pos))
 		return false;
 
-	return isNull == 0;
-#endif
+	usecs = timestampValue(_metadata.nativeType(pos), _stmt.value(pos), _stmt.length(pos));
+	return true;
+}
+
+
+template <typename C, typename D>
+bool Extractor::extractColumn(std::size_t pos, C& val, const D& decode)
+{
+	if (_metadata.columnsReturned() <= pos)
+		throw PgSQLException("Extractor: attempt to extract more paremeters, than query result contain");
+
+	if (_nulls.size() < _metadata.columnsReturned())
+		_nulls.resize(_metadata.columnsReturned());
+
+	std::vector<bool>& nulls = _nulls[pos];
+	nulls.assign(_rowCount, false);
+	val.assign(_rowCount, typename C::value_type());
+
+	PGresult* result = _stmt.result();
+	int row = _stmt.row();
+	int col = static_cast<int>(pos);
+	typename C::iterator it = val.begin();
+	for (std::size_t i = 0; i < _rowCount; ++i, ++row, ++it)
+	{
+		if (PQgetisnull(result, row, col))
+			nulls[i] = true;
+		else
+			*it = decode(PQgetvalue(result, row, col), static_cast<std::size_t>(PQgetlength(result, row, col)));
+	}
+
+	return true;
+}
+
+
+template <typename C>
+bool Extractor::extractNumbers(std::size_t pos, C& val)
+{
+	typedef typename C::value_type T;
+
+	if (_metadata.columnsReturned() <= pos)
+		throw PgSQLException("Extractor: attempt to extract more paremeters, than query result contain");
+
+	switch (_metadata.nativeType(pos))
+	{
+	case PgSQL_TYPE_BOOL:
+	case PgSQL_TYPE_INT8:
+		return extractColumn(pos, val, NumberDecoder<T, Poco::Int8, Poco::UInt8>());
+	case PgSQL_TYPE_INT16:
+		return extractColumn(pos, val, NumberDecoder<T, Poco::Int16, Poco::UInt16>());
+	case PgSQL_TYPE_INT32:
+		return extractColumn(pos, val, NumberDecoder<T, Poco::Int32, Poco::UInt32>());
+	case PgSQL_TYPE_INT64:
+		return extractColumn(pos, val, NumberDecoder<T, Poco::Int64, Poco::UInt64>());
+	case PgSQL_TYPE_FLOAT:
+		return extractColumn(pos, val, NumberDecoder<T, float, Poco::UInt32>());
+	case PgSQL_TYPE_DOUBLE:
+		return extractColumn(pos, val, NumberDecoder<T, double, Poco::UInt64>());
+	default:
+		throw PgSQLException("Extractor: not a number");
+	}
+}
+
+
+template <typename C>
+bool Extractor::extractStrings(std::size_t pos, C& val)
+{
+	if (_metadata.columnsReturned() <= pos)
+		throw PgSQLException("Extractor: attempt to extract more paremeters, than query result contain");
+
+	if (_metadata.metaColumn(pos).type() != Poco::Data::MetaColumn::FDT_STRING)
+		throw PgSQLException("Extractor: not a string");
+
+	return extractColumn(pos, val, StringDecoder());
+}
+
+
+template <typename C, typename D>
+bool Extractor::extractLOBs(std::size_t pos, C& val, const D& decode)
+{
+	if (_metadata.columnsReturned() <= pos)
+		throw PgSQLException("Extractor: attempt to extract more paremeters, than query result contain");
+
+	if (_metadata.metaColumn(pos).type() != Poco::Data::MetaColumn::FDT_BLOB)
+		throw PgSQLException("Extractor: not a blob");
+
+	return extractColumn(pos, val, decode);
+}
+
+
+template <typename C, typename D>
+bool Extractor::extractTimestamps(std::size_t pos, C& val)
+{
+	if (_metadata.columnsReturned() <= pos)
+		throw PgSQLException("Extractor: attempt to extract more paremeters, than query result contain");
+
+	return extractColumn(pos, val, D(_metadata.nativeType(pos)));
 }
 
 
 //////////////
-// Not implemented
+// Bulk extraction
 //////////////
 
 
-bool Extractor::extract(std::size_t , std::vector<Poco::Int8>& )
+bool Extractor::extract(std::size_t pos, std::vector<Poco::Int8>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<Poco::Int8>& )
+bool Extractor::extract(std::size_t pos, std::deque<Poco::Int8>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<Poco::Int8>& )
+bool Extractor::extract(std::size_t pos, std::list<Poco::Int8>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<Poco::UInt8>& )
+bool Extractor::extract(std::size_t pos, std::vector<Poco::UInt8>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<Poco::UInt8>& )
+bool Extractor::extract(std::size_t pos, std::deque<Poco::UInt8>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<Poco::UInt8>& )
+bool Extractor::extract(std::size_t pos, std::list<Poco::UInt8>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<Poco::Int16>& )
+bool Extractor::extract(std::size_t pos, std::vector<Poco::Int16>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<Poco::Int16>& )
+bool Extractor::extract(std::size_t pos, std::deque<Poco::Int16>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<Poco::Int16>& )
+bool Extractor::extract(std::size_t pos, std::list<Poco::Int16>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<Poco::UInt16>& )
+bool Extractor::extract(std::size_t pos, std::vector<Poco::UInt16>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<Poco::UInt16>& )
+bool Extractor::extract(std::size_t pos, std::deque<Poco::UInt16>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<Poco::UInt16>& )
+bool Extractor::extract(std::size_t pos, std::list<Poco::UInt16>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<Poco::Int32>& )
+bool Extractor::extract(std::size_t pos, std::vector<Poco::Int32>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<Poco::Int32>& )
+bool Extractor::extract(std::size_t pos, std::deque<Poco::Int32>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<Poco::Int32>& )
+bool Extractor::extract(std::size_t pos, std::list<Poco::Int32>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<Poco::UInt32>& )
+bool Extractor::extract(std::size_t pos, std::vector<Poco::UInt32>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<Poco::UInt32>& )
+bool Extractor::extract(std::size_t pos, std::deque<Poco::UInt32>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<Poco::UInt32>& )
+bool Extractor::extract(std::size_t pos, std::list<Poco::UInt32>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<Poco::Int64>& )
+bool Extractor::extract(std::size_t pos, std::vector<Poco::Int64>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<Poco::Int64>& )
+bool Extractor::extract(std::size_t pos, std::deque<Poco::Int64>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<Poco::Int64>& )
+bool Extractor::extract(std::size_t pos, std::list<Poco::Int64>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<Poco::UInt64>& )
+bool Extractor::extract(std::size_t pos, std::vector<Poco::UInt64>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<Poco::UInt64>& )
+bool Extractor::extract(std::size_t pos, std::deque<Poco::UInt64>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<Poco::UInt64>& )
+bool Extractor::extract(std::size_t pos, std::list<Poco::UInt64>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
 #ifndef POCO_LONG_IS_64_BIT
-bool Extractor::extract(std::size_t , std::vector<long>& )
+bool Extractor::extract(std::size_t pos, std::vector<long>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<long>& )
+bool Extractor::extract(std::size_t pos, std::deque<long>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<long>& )
+bool Extractor::extract(std::size_t pos, std::list<long>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 #endif
 
 
-bool Extractor::extract(std::size_t , std::vector<bool>& )
+bool Extractor::extract(std::size_t pos, std::vector<bool>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<bool>& )
+bool Extractor::extract(std::size_t pos, std::deque<bool>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<bool>& )
+bool Extractor::extract(std::size_t pos, std::list<bool>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<float>& )
+bool Extractor::extract(std::size_t pos, std::vector<float>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<float>& )
+bool Extractor::extract(std::size_t pos, std::deque<float>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<float>& )
+bool Extractor::extract(std::size_t pos, std::list<float>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<double>& )
+bool Extractor::extract(std::size_t pos, std::vector<double>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<double>& )
+bool Extractor::extract(std::size_t pos, std::deque<double>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<double>& )
+bool Extractor::extract(std::size_t pos, std::list<double>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<char>& )
+bool Extractor::extract(std::size_t pos, std::vector<char>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<char>& )
+bool Extractor::extract(std::size_t pos, std::deque<char>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<char>& )
+bool Extractor::extract(std::size_t pos, std::list<char>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractNumbers(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<std::string>& )
+bool Extractor::extract(std::size_t pos, std::vector<std::string>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractStrings(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<std::string>& )
+bool Extractor::extract(std::size_t pos, std::deque<std::string>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractStrings(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<std::string>& )
+bool Extractor::extract(std::size_t pos, std::list<std::string>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractStrings(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<BLOB>& )
+bool Extractor::extract(std::size_t pos, std::vector<BLOB>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractLOBs(pos, val, BLOBDecoder());
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<BLOB>& )
+bool Extractor::extract(std::size_t pos, std::deque<BLOB>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractLOBs(pos, val, BLOBDecoder());
 }
 
 
-bool Extractor::extract(std::size_t , std::list<BLOB>& )
+bool Extractor::extract(std::size_t pos, std::list<BLOB>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractLOBs(pos, val, BLOBDecoder());
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<CLOB>& )
+bool Extractor::extract(std::size_t pos, std::vector<CLOB>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractLOBs(pos, val, CLOBDecoder());
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<CLOB>& )
+bool Extractor::extract(std::size_t pos, std::deque<CLOB>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractLOBs(pos, val, CLOBDecoder());
 }
 
 
-bool Extractor::extract(std::size_t , std::list<CLOB>& )
+bool Extractor::extract(std::size_t pos, std::list<CLOB>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractLOBs(pos, val, CLOBDecoder());
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<DateTime>& )
+bool Extractor::extract(std::size_t pos, std::vector<DateTime>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractTimestamps<std::vector<DateTime>, DateTimeDecoder>(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<DateTime>& )
+bool Extractor::extract(std::size_t pos, std::deque<DateTime>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractTimestamps<std::deque<DateTime>, DateTimeDecoder>(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<DateTime>& )
+bool Extractor::extract(std::size_t pos, std::list<DateTime>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractTimestamps<std::list<DateTime>, DateTimeDecoder>(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<Date>& )
+bool Extractor::extract(std::size_t pos, std::vector<Date>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractTimestamps<std::vector<Date>, DateDecoder>(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<Date>& )
+bool Extractor::extract(std::size_t pos, std::deque<Date>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractTimestamps<std::deque<Date>, DateDecoder>(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<Date>& )
+bool Extractor::extract(std::size_t pos, std::list<Date>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractTimestamps<std::list<Date>, DateDecoder>(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::vector<Time>& )
+bool Extractor::extract(std::size_t pos, std::vector<Time>& val)
 {
-	throw NotImplementedException("std::vector extractor must be implemented.");
+	return extractTimestamps<std::vector<Time>, TimeDecoder>(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::deque<Time>& )
+bool Extractor::extract(std::size_t pos, std::deque<Time>& val)
 {
-	throw NotImplementedException("std::deque extractor must be implemented.");
+	return extractTimestamps<std::deque<Time>, TimeDecoder>(pos, val);
 }
 
 
-bool Extractor::extract(std::size_t , std::list<Time>& )
+bool Extractor::extract(std::size_t pos, std::list<Time>& val)
 {
-	throw NotImplementedException("std::list extractor must be implemented.");
+	return extractTimestamps<std::list<Time>, TimeDecoder>(pos, val);
 }
 
 
+//////////////
+// Not implemented
+//////////////
+
+
 bool Extractor::extract(std::size_t , std::vector<Any>& )
 {
 	throw NotImplementedException("std::vector extractor must be implemented.");
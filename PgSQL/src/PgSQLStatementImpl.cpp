@@ -35,6 +35,7 @@
 
 
 #include "Poco/Data/PgSQL/PgSQLStatementImpl.h"
+#include "Poco/Data/Limit.h"
 
 namespace Poco {
 namespace Data {
@@ -47,6 +48,7 @@ PgSQLStatementImpl::PgSQLStatementImpl(SessionImpl& h)
           _extractor(_stmt, _metadata),
 	_hasNext(NEXT_DONTKNOW)
 {
+	_stmt.setSingleRowMode(h.isSingleRowMode());
 }
 
 
@@ -63,7 +65,7 @@ std::size_t PgSQLStatementImpl::columnsReturned() const
 
 std::size_t PgSQLStatementImpl::affectedRowCount() const
 {
-    return 0;
+	return _stmt.affectedRows();
 }
 
 
@@ -105,6 +107,17 @@ std::size_t PgSQLStatementImpl::next()
 	if (!hasNext())
 		throw StatementException("No data received");
 
+	// Bulk extractions decode all rows received so far, up to the limit.
+	std::size_t rows = 1;
+	if (isBulkExtraction())
+	{
+		rows = _stmt.rows();
+		Poco::UInt32 limit = getExtractionLimit();
+		if (limit != Limit::LIMIT_UNLIMITED && limit < rows)
+			rows = limit;
+	}
+	_extractor.setRowCount(rows);
+
 	Poco::Data::AbstractExtractionVec::iterator it = extractions().begin();
 	Poco::Data::AbstractExtractionVec::iterator itEnd = extractions().end();
 	std::size_t pos = 0;
@@ -115,8 +128,9 @@ std::size_t PgSQLStatementImpl::next()
 		pos += (*it)->numOfColumnsHandled();
 	}
 
+	_stmt.skip(rows - 1);
 	_hasNext = NEXT_DONTKNOW;
-    return 1;
+	return rows;
 }
 
 
@@ -142,9 +156,6 @@ void PgSQLStatementImpl::compileImpl()
 	_metadata.reset();
 	_stmt.prepare(toString(), _binder.getBindArray(), _binder.size());
 	_metadata.init(_stmt);
-
-	if (_metadata.columnsReturned() > 0)
-		_stmt.bindResult(_metadata.row());
 }
 
 
@@ -154,13 +165,54 @@ void PgSQLStatementImpl::bindImpl()
 	std::size_t pos = 0;
 	Poco::Data::AbstractBindingVec::iterator it = binds.begin();
 	Poco::Data::AbstractBindingVec::iterator itEnd = binds.end();
+
+	if (isBulkBinding())
+	{
+		// Each row of the bound containers is one set of parameters,
+		// and all sets are sent in a single batch.
+		std::size_t count = 0;
+		for (; it != itEnd; ++it)
+			count += (*it)->numOfColumnsHandled();
+		std::size_t rows = binds.empty() ? 0 : binds.front()->numOfRowsHandled();
+
+		_binder.setParameterCount(count);
+		for (it = binds.begin(); it != itEnd && (*it)->canBind(); ++it)
+		{
+			(*it)->bind(pos);
+			pos += (*it)->numOfColumnsHandled();
+		}
+
+		_stmt.executeBatch(_binder.getBindArray(), count, rows);
+		_hasNext = NEXT_DONTKNOW;
+		return;
+	}
+
 	for (; it != itEnd && (*it)->canBind(); ++it)
 	{
 		(*it)->bind(pos);
 		pos += (*it)->numOfColumnsHandled();
 	}
 
-	_stmt.execute(_binder.getBindArray(), _binder.size());
+	// Columnar extraction needs the whole result at once. The mode is
+	// only read by execute(), so it is turned off for this execution.
+	if (isBulkExtraction() && _stmt.isSingleRowMode())
+	{
+		_stmt.setSingleRowMode(false);
+		try
+		{
+			_stmt.execute(_binder.getBindArray(), _binder.size());
+		}
+		catch (...)
+		{
+			_stmt.setSingleRowMode(true);
+			throw;
+		}
+		_stmt.setSingleRowMode(true);
+	}
+	else
+	{
+		_stmt.execute(_binder.getBindArray(), _binder.size());
+	}
 	_hasNext = NEXT_DONTKNOW;
 }
 
@@ -41,33 +41,6 @@
 
 namespace
 {
-	class ResultMetadataHandle
-		/// Simple exception-safe wrapper
-	{
-	public:
-
-		explicit ResultMetadataHandle(PGresult* stmt)
-		{
-			h = stmt;
-		}
-
-		~ResultMetadataHandle()
-		{
-			if (h)
-			{
-				PQclear(h);
-			}
-		}
-
-		operator PGresult* ()
-		{
-			return h;
-		}
-
-	private:
-
-		PGresult* h;
-	};
 /*
 	std::size_t fieldSize(const PgSQL_FIELD& field)
 		/// Convert field PgSQL-type and field PgSQL-length to actual field length
@@ -133,9 +106,24 @@ namespace
 			if (unsig) return Poco::Data::MetaColumn::FDT_UINT64;
 			return Poco::Data::MetaColumn::FDT_INT64;
 
+		case PgSQL_TYPE_BOOL:
+			return Poco::Data::MetaColumn::FDT_BOOL;
+
 		case PgSQL_TYPE_STRING:
+		case PgSQL_TYPE_VARCHAR:
+		case PgSQL_TYPE_BPCHAR:
+		case PgSQL_TYPE_NAME:
 			return Poco::Data::MetaColumn::FDT_STRING;
 
+		case PgSQL_TYPE_DATE:
+			return Poco::Data::MetaColumn::FDT_DATE;
+
+		case PgSQL_TYPE_TIME:
+			return Poco::Data::MetaColumn::FDT_TIME;
+
+		case PgSQL_TYPE_TIMESTAMP:
+			return Poco::Data::MetaColumn::FDT_TIMESTAMP;
+
 		case PgSQL_TYPE_BYTEARRAY:
 			return Poco::Data::MetaColumn::FDT_BLOB;
 		default:
@@ -153,23 +141,23 @@ namespace PgSQL {
 void ResultMetadata::reset()
 {
 	_columns.resize(0);
-	_row.resize(0);
+	_types.resize(0);
 }
 
 void ResultMetadata::init(PGresult* res)
 {
-	ResultMetadataHandle h(res);
+	reset();
 
-	if (!h)
+	if (!res)
 	{
 		// all right, it is normal
 		// querys such an "INSERT INTO" just does not have result at all
-		reset();
 		return;
 	}
 
 	std::size_t columns = PQnfields(res);
 	_columns.reserve(columns);
+	_types.reserve(columns);
 
 	for (std::size_t i = 0; i < columns; i++)
 	{
@@ -182,17 +170,7 @@ void ResultMetadata::init(PGresult* res)
 			true                             // nullable FIXME:
 			)
 		);
-	}
-
-	_row.resize(columns);
-
-	for (std::size_t i = 0; i < columns; i++)
-	{
-		_row[i] = PgSQL_BIND(
-		    PQftype(res, i),
-		    PQgetvalue(res, 0, i), // FIXME: real dat or metadata?
-		    PQfsize(res, i)
-		    );
+		_types.push_back(PQftype(res, i));
 	}
 }
 
@@ -206,9 +184,9 @@ const MetaColumn& ResultMetadata::metaColumn(std::size_t pos) const
 	return _columns[pos];
 }
 
-PgSQL_BIND* ResultMetadata::row()
+int ResultMetadata::nativeType(std::size_t pos) const
 {
-	return &_row[0];
+	return _types[pos];
 }
 
 std::size_t ResultMetadata::length(std::size_t pos) const
@@ -216,14 +194,4 @@ std::size_t ResultMetadata::length(std::size_t pos) const
 	return metaColumn(pos).length();
 }
 
-const unsigned char* ResultMetadata::rawData(std::size_t pos) const
-{
-	return reinterpret_cast<const unsigned char*>(_row[pos]._paramValue.data());
-}
-
-bool ResultMetadata::isNull(std::size_t pos) const
-{
-	return metaColumn(pos).isNullable();
-}
-
 }}} // namespace Poco::Data::PgSQL
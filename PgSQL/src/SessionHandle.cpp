@@ -92,6 +92,7 @@ void SessionHandle::close()
 {
 	if (_pHandle)
 	{
+		_statementCache.clear();
 		PQfinish(_pHandle);
 		_pHandle = 0;
 	}
@@ -70,12 +70,17 @@ SessionImpl::SessionImpl(const std::string& connectionString, std::size_t loginT
 	Poco::Data::AbstractSessionImpl<SessionImpl>(toLower(connectionString), loginTimeout),
 	_handle(),
 	_connected(false),
-	_inTransaction(false)
+	_inTransaction(false),
+	_singleRowMode(true)
 {
 	addProperty("insertId",
 		&SessionImpl::setInsertId,
 		&SessionImpl::getInsertId);
 
+	addProperty("statementCacheSize",
+		&SessionImpl::setStatementCacheSize,
+		&SessionImpl::getStatementCacheSize);
+
 	open();
 	setConnectionTimeout(CONNECTION_TIMEOUT_DEFAULT);
 }
@@ -151,6 +156,10 @@ void SessionImpl::open(const std::string& connect)
 		&SessionImpl::autoCommit,
 		&SessionImpl::isAutoCommit);
 
+	addFeature("singleRowMode",
+		&SessionImpl::setSingleRowMode,
+		&SessionImpl::isSingleRowMode);
+
 	_connected = true;
 }
 
@@ -203,8 +212,8 @@ void SessionImpl::autoCommit(const std::string&, bool val)
 
 bool SessionImpl::isAutoCommit(const std::string&)
 {
-	int ac = 0;
-	return 1 == getSetting("autocommit", ac);
+	std::string ac;
+	return "on" == getSetting("autocommit", ac);
 }
 
 
@@ -234,8 +243,8 @@ void SessionImpl::setTransactionIsolation(Poco::UInt32 ti)
 Poco::UInt32 SessionImpl::getTransactionIsolation()
 {
 	std::string isolation;
-	getSetting("tx_isolation", isolation);
-	Poco::replaceInPlace(isolation, "-", " ");
+	getSetting("transaction_isolation", isolation);
+	Poco::toUpperInPlace(isolation);
 	if (PgSQL_READ_UNCOMMITTED == isolation)
 		return Session::TRANSACTION_READ_UNCOMMITTED;
 	else if (PgSQL_READ_COMMITTED == isolation)
@@ -258,6 +267,34 @@ bool SessionImpl::hasTransactionIsolation(Poco::UInt32 ti)
 }
 
 
+void SessionImpl::setStatementCacheSize(const std::string&, const Poco::Any& value)
+{
+	std::size_t capacity;
+	if (value.type() == typeid(int))
+		capacity = static_cast<std::size_t>(Poco::AnyCast<int>(value));
+	else
+		capacity = Poco::AnyCast<std::size_t>(value);
+
+	_handle.statementCache().setCapacity(_handle, capacity);
+}
+
+
+std::string& SessionImpl::getSetting(const std::string& name, std::string& val)
+{
+	StatementExecutor ex(_handle);
+	ex.setSingleRowMode(false);
+	ex.prepare("SHOW " + name, 0, 0);
+	ex.execute(0, 0);
+
+	if (!ex.fetch())
+		throw InvalidArgumentException("No data returned.");
+
+	// SHOW returns a single text column; its binary form is the text.
+	val.assign(ex.value(0), ex.length(0));
+	return val;
+}
+
+
 void SessionImpl::close()
 {
 	if (_connected)
@@ -0,0 +1,174 @@
+//
+// StatementCache.cpp
+//
+// $Id$
+//
+// Library: Data
+// Package: PgSQL
+// Module:  StatementCache
+//
+// Copyright (c) 2008, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Data/PgSQL/StatementCache.h"
+#include "Poco/NumberFormatter.h"
+
+
+namespace Poco {
+namespace Data {
+namespace PgSQL {
+
+
+StatementCache::Statement::Statement(const std::string& name, pg_result* description):
+	_name(name),
+	_description(description)
+{
+}
+
+
+StatementCache::Statement::~Statement()
+{
+	if (_description)
+		PQclear(_description);
+}
+
+
+StatementCache::StatementCache():
+	_capacity(DEFAULT_CAPACITY),
+	_counter(0)
+{
+}
+
+
+StatementCache::~StatementCache()
+{
+}
+
+
+StatementCache::Statement::Ptr StatementCache::prepare(pg_conn* connection, const std::string& query, const std::vector<Oid>& types)
+{
+	std::string key(query);
+	for (std::vector<Oid>::const_iterator it = types.begin(); it != types.end(); ++it)
+	{
+		key += '\0';
+		NumberFormatter::append(key, static_cast<unsigned>(*it));
+	}
+
+	EntryMap::iterator it = _index.find(key);
+	if (it != _index.end())
+	{
+		_entries.splice(_entries.begin(), _entries, it->second);
+		return it->second->pStatement;
+	}
+
+	std::string name("poco_");
+	NumberFormatter::append(name, ++_counter);
+
+	Entry entry;
+	entry.key = key;
+	entry.pStatement = new Statement(name, prepareStatement(connection, name, query, types));
+	_entries.push_front(entry);
+	_index[key] = _entries.begin();
+
+	trim(connection);
+	return entry.pStatement;
+}
+
+
+pg_result* StatementCache::prepareStatement(pg_conn* connection, const std::string& name, const std::string& query, const std::vector<Oid>& types)
+{
+	PGresult* result = PQprepare(
+		connection,
+		name.c_str(),
+		query.c_str(),
+		static_cast<int>(types.size()),
+		types.empty() ? 0 : &types[0]
+		);
+	if (PQresultStatus(result) != PGRES_COMMAND_OK)
+	{
+		StatementException exc("PQprepare error", result, query);
+		PQclear(result);
+		throw exc;
+	}
+	PQclear(result);
+
+	PGresult* description = PQdescribePrepared(connection, name.c_str());
+	if (PQresultStatus(description) != PGRES_COMMAND_OK)
+	{
+		StatementException exc("PQdescribePrepared error", description, query);
+		PQclear(description);
+		throw exc;
+	}
+	return description;
+}
+
+
+bool StatementCache::deallocateStatement(pg_conn* connection, const std::string& name)
+{
+	std::string query("DEALLOCATE ");
+	query += name;
+	PGresult* result = PQexec(connection, query.c_str());
+	bool ok = PQresultStatus(result) == PGRES_COMMAND_OK;
+	PQclear(result);
+	return ok;
+}
+
+
+void StatementCache::setCapacity(pg_conn* connection, std::size_t capacity)
+{
+	_capacity = capacity;
+	trim(connection);
+}
+
+
+void StatementCache::clear()
+{
+	_index.clear();
+	_entries.clear();
+}
+
+
+void StatementCache::trim(pg_conn* connection)
+{
+	EntryList::iterator it = _entries.end();
+	while (_index.size() > _capacity && it != _entries.begin())
+	{
+		--it;
+		// Statements referenced only by the cache are not in use.
+		if (it->pStatement->referenceCount() > 1)
+			continue;
+
+		if (!deallocateStatement(connection, it->pStatement->name()))
+			break; // connection busy; retry on the next prepare
+
+		_index.erase(it->key);
+		it = _entries.erase(it);
+	}
+}
+
+
+} } } // namespace Poco::Data::PgSQL
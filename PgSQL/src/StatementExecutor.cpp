@@ -39,23 +39,152 @@
 #include <sstream>
 #include <cstdlib>
 
+#if defined(POCO_OS_FAMILY_WINDOWS)
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#include <sys/socket.h>
+#endif
+
+#if defined(PG_VERSION_NUM) && PG_VERSION_NUM >= 90200
+#define POCO_PGSQL_HAVE_SINGLE_ROW_MODE
+#endif
+#if defined(PG_VERSION_NUM) && PG_VERSION_NUM >= 140000
+#define POCO_PGSQL_HAVE_PIPELINE_MODE
+#endif
+
+namespace
+{
+	class ResultHandle
+		/// Clears a PGresult when it goes out of scope.
+	{
+	public:
+		explicit ResultHandle(PGresult* result): _result(result)
+		{
+		}
+
+		~ResultHandle()
+		{
+			if (_result)
+				PQclear(_result);
+		}
+
+		operator PGresult* ()
+		{
+			return _result;
+		}
+
+	private:
+		ResultHandle(const ResultHandle&);
+		ResultHandle& operator=(const ResultHandle&);
+
+		PGresult* _result;
+	};
+
+	void waitSocket(PGconn* conn, bool write)
+		/// Waits until the connection can be read, or written if requested.
+	{
+		int fd = PQsocket(conn);
+		fd_set readSet;
+		fd_set writeSet;
+		FD_ZERO(&readSet);
+		FD_ZERO(&writeSet);
+		FD_SET(fd, &readSet);
+		if (write)
+			FD_SET(fd, &writeSet);
+		if (select(fd + 1, &readSet, &writeSet, 0, 0) < 0)
+			throw Poco::Data::PgSQL::StatementException("select() error");
+	}
+
+#if defined(POCO_PGSQL_HAVE_PIPELINE_MODE)
+	void breakConnection(PGconn* conn)
+		/// Shuts down the socket of a connection whose protocol state is
+		/// unknown. libpq then reports the connection as bad, and later
+		/// statements fail instead of reading unrelated results.
+	{
+#if defined(POCO_OS_FAMILY_WINDOWS)
+		shutdown(PQsocket(conn), SD_BOTH);
+#else
+		shutdown(PQsocket(conn), SHUT_RDWR);
+#endif
+		PQconsumeInput(conn);
+	}
+
+	void abortPipeline(PGconn* conn, bool synced)
+		/// Leaves pipeline mode after an error. Results are only complete
+		/// up to a sync, so the sync is sent if it hasn't been, and the
+		/// queued results are received and dropped up to it. The
+		/// connection is left in blocking mode. If this fails, the
+		/// connection is broken off.
+	{
+		bool recovered = false;
+		try
+		{
+			while (PQflush(conn) == 1)
+			{
+				waitSocket(conn, true);
+				PQconsumeInput(conn);
+			}
+			if (PQsetnonblocking(conn, 0) == 0 && (synced || PQpipelineSync(conn)))
+			{
+				// A null result ends the results of one execution;
+				// two in a row mean that nothing is queued any more.
+				int nulls = 0;
+				while (nulls < 2 && PQstatus(conn) == CONNECTION_OK)
+				{
+					PGresult* result = PQgetResult(conn);
+					if (!result)
+					{
+						++nulls;
+						continue;
+					}
+					nulls = 0;
+
+					bool sync = PQresultStatus(result) == PGRES_PIPELINE_SYNC;
+					PQclear(result);
+					if (sync)
+						break;
+				}
+				recovered = PQexitPipelineMode(conn) != 0;
+			}
+		}
+		catch (Poco::Exception&)
+		{
+		}
+		if (!recovered && PQstatus(conn) == CONNECTION_OK)
+			breakConnection(conn);
+	}
+#endif
+}
+
 namespace Poco {
 namespace Data {
 namespace PgSQL {
 
 
-StatementExecutor::StatementExecutor(pg_conn* conn)
+StatementExecutor::StatementExecutor(SessionHandle& handle):
+	_connection(handle),
+	_cache(handle.statementCache()),
+	_description(0),
+	_result(0),
+	_row(-1),
+	_state(STMT_INITED),
+	_singleRowMode(true),
+	_streaming(false),
+	_affectedRows(0)
 {
-    _connection = conn;
-	_result = 0;
-	_state = STMT_INITED;
 }
 
 
 StatementExecutor::~StatementExecutor()
 {
-    if (_result)
-        PQclear(_result);
+	try
+	{
+		finish();
+	}
+	catch (...)
+	{
+	}
 }
 
 
@@ -65,45 +194,31 @@ int StatementExecutor::state() const
 }
 
 
-void StatementExecutor::prepare(const std::string& query, PgSQL_BIND* params, std::size_t count)
+void StatementExecutor::setSingleRowMode(bool flag)
 {
-    if (_state >= STMT_COMPILED)
-    {
-        _state = STMT_COMPILED;
-        return;
-    }
-
-    Oid* paramTypes = 0;
-
-    if (params && count>0)
-    {
-        paramTypes = new Oid[count];
-        for(std::size_t i = 0; i< count; ++i)
-        {
-            paramTypes[i] = params[i]._oid;
-        }
-    }
-
-    _stmtName = getRandomName();
+	_singleRowMode = flag;
+}
 
-    _result = PQprepare(
-        _connection,
-        _stmtName.c_str(),
-        query.c_str(),
-        count,
-        paramTypes
-        );
 
-    if (paramTypes)
-        delete[] paramTypes;
+void StatementExecutor::prepare(const std::string& query, PgSQL_BIND* params, std::size_t count)
+{
+	if (_state >= STMT_COMPILED)
+	{
+		_state = STMT_COMPILED;
+		return;
+	}
 
-    if (_result != 0)
-        throw StatementException("PQprepare error", _result, query);
+	std::vector<Oid> paramTypes(count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		paramTypes[i] = params[i]._oid;
+	}
 
-    // FIXME result status
+	_pStatement = _cache.prepare(_connection, query, paramTypes);
+	_description = _pStatement->description();
 
-    _query = query;
-    _state = STMT_COMPILED;
+	_query = query;
+	_state = STMT_COMPILED;
 }
 
 
@@ -111,10 +226,8 @@ void StatementExecutor::bindResult(PgSQL_BIND* result)
 {
 	if (_state < STMT_COMPILED)
 		throw StatementException("Satement is not compiled yet");
-/*
-	if (PgSQL_stmt_bind_result(_pHandle, result) != 0)
-		throw StatementException("PgSQL_stmt_bind_result error ", _pHandle, _query);
-		*/
+
+	// Values are read from the current row by fetch(), nothing to bind.
 }
 
 
@@ -123,38 +236,54 @@ void StatementExecutor::execute(PgSQL_BIND* params, std::size_t count)
 	if (_state < STMT_COMPILED)
 		throw StatementException("Satement is not compiled yet");
 
-    int* paramFormats = 0;
-    char** paramValues = 0;
-    int* paramLenghts = 0;
+	finish();
+	bindParams(params, count);
 
-    if (params && count>0)
-    {
-        paramFormats = new int[count];
-        paramValues = new char*[count];
-        paramLenghts = new int[count];
+	const std::string& name = _pStatement->name();
+	int nParams = static_cast<int>(count);
+	const char* const* values = count > 0 ? &_paramValues[0] : 0;
+	const int* lengths = count > 0 ? &_paramLengths[0] : 0;
+	const int* formats = count > 0 ? &_paramFormats[0] : 0;
 
-        for(std::size_t i = 0; i< count; ++i)
-        {
-            paramFormats[i] = 1; // force binary format
-            paramValues[i] = params[i]._paramValue.data();
-            paramLenghts[i] = params[i]._paramLenght;
-        }
-    }
+#if defined(POCO_PGSQL_HAVE_SINGLE_ROW_MODE)
+	if (_singleRowMode && PQnfields(_description) > 0)
+	{
+		if (!PQsendQueryPrepared(_connection, name.c_str(), nParams, values, lengths, formats, 1))
+			throw StatementException(std::string("PQsendQueryPrepared error: ") + PQerrorMessage(_connection));
+
+		_streaming = true;
+		if (!PQsetSingleRowMode(_connection))
+		{
+			finish();
+			throw StatementException("PQsetSingleRowMode error");
+		}
+		_state = STMT_EXECUTED;
+		return;
+	}
+#endif
 
-    _result = PQexecPrepared(_connection, _stmtName.c_str(), count, paramValues, paramLenghts, paramFormats, 1);
+	PGresult* result = PQexecPrepared(_connection, name.c_str(), nParams, values, lengths, formats, 1);
+	ExecStatusType status = PQresultStatus(result);
+	if (status != PGRES_TUPLES_OK && status != PGRES_COMMAND_OK)
+	{
+		ResultHandle guard(result);
+		throw StatementException("PQexecPrepared error", result, _query);
+	}
 
-    if (paramFormats)
-    {
-        delete [] paramFormats;
-        delete [] paramLenghts;
-        delete [] paramValues;
-    }
+	_result = result;
+	_row = -1;
+	setAffectedRows(result);
+	_state = STMT_EXECUTED;
+}
 
-    if (_result != 0)
-        throw StatementException("PgSQL_stmt_bind_param() error ", _result, _query);
 
-    // FIXME result status
+void StatementExecutor::setResult(pg_result* result)
+{
+	finish();
 
+	_result = result;
+	_row = -1;
+	setAffectedRows(result);
 	_state = STMT_EXECUTED;
 }
 
@@ -163,49 +292,232 @@ bool StatementExecutor::fetch()
 {
 	if (_state < STMT_EXECUTED)
 		throw StatementException("Satement is not executed yet");
-/*
-	int res = PgSQL_stmt_fetch(_pHandle);
 
-	if ((res != 0) && (res != PgSQL_NO_DATA))
-		throw StatementException("PgSQL_stmt_fetch error", _pHandle, _query);
+	if (!_streaming)
+	{
+		if (_result && _row + 1 < PQntuples(_result))
+		{
+			++_row;
+			return true;
+		}
+		return false;
+	}
+
+	if (_result)
+	{
+		PQclear(_result);
+		_result = 0;
+	}
+
+	PGresult* result = PQgetResult(_connection);
+	ExecStatusType status = PQresultStatus(result);
+#if defined(POCO_PGSQL_HAVE_SINGLE_ROW_MODE)
+	if (status == PGRES_SINGLE_TUPLE)
+	{
+		_result = result;
+		_row = 0;
+		return true;
+	}
+#endif
 
-	return (res == 0);
-	*/
-	return true;
+	// The final result has no rows. It reports the row count or an error.
+	ResultHandle guard(result);
+	if (result && status == PGRES_TUPLES_OK)
+		setAffectedRows(result);
+	finish();
+	if (result && status != PGRES_TUPLES_OK)
+		throw StatementException("PQgetResult error", result, _query);
+	return false;
 }
 
 
-bool StatementExecutor::fetchColumn(std::size_t n, PgSQL_BIND *bind)
+bool StatementExecutor::isNull(std::size_t col) const
 {
-	if (_state < STMT_EXECUTED)
-		throw StatementException("Satement is not executed yet");
-#if 0
-	int res = PgSQL_stmt_fetch_column(_pHandle, bind, static_cast<unsigned int>(n), 0);
+	poco_assert (_result != 0 && _row >= 0);
+
+	return PQgetisnull(_result, _row, static_cast<int>(col)) != 0;
+}
+
+
+const char* StatementExecutor::value(std::size_t col) const
+{
+	poco_assert (_result != 0 && _row >= 0);
+
+	return PQgetvalue(_result, _row, static_cast<int>(col));
+}
+
+
+std::size_t StatementExecutor::length(std::size_t col) const
+{
+	poco_assert (_result != 0 && _row >= 0);
+
+	return static_cast<std::size_t>(PQgetlength(_result, _row, static_cast<int>(col)));
+}
 
-	if ((res != 0) && (res != PgSQL_NO_DATA))
+
+void StatementExecutor::finish()
+{
+	if (_result)
 	{
-		std::ostringstream msg;
-		msg << "PgSQL_stmt_fetch_column(" << n << ") error";
-		throw StatementException(msg.str(), _pHandle, _query);
+		PQclear(_result);
+		_result = 0;
 	}
+	_row = -1;
 
-	return (res == 0);
-#endif
-	return true;
+	if (_streaming)
+	{
+		// Rows that haven't been fetched are received and dropped one
+		// at a time; the connection is usable again after the last one.
+		_streaming = false;
+		while (PGresult* result = PQgetResult(_connection))
+		{
+			PQclear(result);
+		}
+	}
+}
+
+
+void StatementExecutor::setAffectedRows(pg_result* result)
+{
+	_affectedRows = static_cast<std::size_t>(std::strtoul(PQcmdTuples(result), 0, 10));
+}
+
+
+void StatementExecutor::bindParams(PgSQL_BIND* params, std::size_t count)
+{
+	// The arrays are reused across executions; values are not copied.
+	_paramValues.resize(count);
+	_paramLengths.resize(count);
+	_paramFormats.resize(count, 1); // binary format
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (params[i]._oid == PgSQL_TYPE_NULL)
+			_paramValues[i] = 0;
+		else
+			_paramValues[i] = params[i]._paramValue ? params[i]._paramValue : "";
+		_paramLengths[i] = params[i]._paramLenght;
+	}
 }
 
-std::string StatementExecutor::getRandomName()
+
+std::size_t StatementExecutor::executeBatch(PgSQL_BIND* params, std::size_t count, std::size_t rows)
 {
-    char str[8] = "1234567";
-    str[0] = char((rand()%96)+' ');
-    str[1] = char((rand()%96)+' ');
-    str[2] = char((rand()%96)+' ');
-    str[3] = char((rand()%96)+' ');
-    str[4] = char((rand()%96)+' ');
-    str[5] = char((rand()%96)+' ');
-    str[6] = char((rand()%96)+' ');
-    str[7] = 0;
-    return str;
+	if (_state < STMT_COMPILED)
+		throw StatementException("Satement is not compiled yet");
+
+	finish();
+	_affectedRows = 0;
+	_state = STMT_EXECUTED;
+
+	const std::string& name = _pStatement->name();
+	int nParams = static_cast<int>(count);
+
+#if defined(POCO_PGSQL_HAVE_PIPELINE_MODE)
+	// All executions are queued in one pipeline and synced once. The
+	// connection is non-blocking meanwhile, so that results are read
+	// while queries are still being sent and neither side stalls.
+	bool wasNonBlocking = PQisnonblocking(_connection) != 0;
+	if (PQsetnonblocking(_connection, 1) != 0 || !PQenterPipelineMode(_connection))
+		throw StatementException(std::string("PQenterPipelineMode error: ") + PQerrorMessage(_connection));
+
+	std::string error;
+	bool synced = false;
+	bool done = false;
+	try
+	{
+		std::size_t sent = 0;
+		std::size_t received = 0;
+		while (!done)
+		{
+			int pending = PQflush(_connection);
+			while (pending == 0 && !synced)
+			{
+				if (sent < rows)
+				{
+					bindParams(params + sent*count, count);
+					if (!PQsendQueryPrepared(_connection, name.c_str(), nParams,
+						count > 0 ? &_paramValues[0] : 0,
+						count > 0 ? &_paramLengths[0] : 0,
+						count > 0 ? &_paramFormats[0] : 0, 1))
+						throw StatementException(std::string("PQsendQueryPrepared error: ") + PQerrorMessage(_connection));
+					++sent;
+				}
+				else
+				{
+					if (!PQpipelineSync(_connection))
+						throw StatementException(std::string("PQpipelineSync error: ") + PQerrorMessage(_connection));
+					synced = true;
+				}
+				if (synced || sent % 64 == 0)
+					pending = PQflush(_connection);
+			}
+			if (pending < 0 || !PQconsumeInput(_connection))
+				throw StatementException(std::string("pipeline error: ") + PQerrorMessage(_connection));
+
+			while ((received < sent || synced) && !PQisBusy(_connection))
+			{
+				PGresult* result = PQgetResult(_connection);
+				if (!result)
+					continue; // end of the results of one execution
+
+				ExecStatusType status = PQresultStatus(result);
+				if (status == PGRES_PIPELINE_SYNC)
+				{
+					done = true;
+				}
+				else
+				{
+					++received;
+					if (status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK)
+						_affectedRows += static_cast<std::size_t>(std::strtoul(PQcmdTuples(result), 0, 10));
+					else if (error.empty() && status != PGRES_PIPELINE_ABORTED)
+						error = PQresultErrorMessage(result);
+				}
+				PQclear(result);
+				if (done)
+					break;
+			}
+			if (!done)
+				waitSocket(_connection, pending == 1);
+		}
+		if (!PQexitPipelineMode(_connection))
+		{
+			while (PGresult* result = PQgetResult(_connection))
+			{
+				PQclear(result);
+			}
+			PQexitPipelineMode(_connection);
+		}
+		PQsetnonblocking(_connection, wasNonBlocking ? 1 : 0);
+	}
+	catch (...)
+	{
+		if (!done)
+			abortPipeline(_connection, synced);
+		else
+			PQexitPipelineMode(_connection);
+		PQsetnonblocking(_connection, wasNonBlocking ? 1 : 0);
+		throw;
+	}
+
+	if (!error.empty())
+		throw StatementException("batch error: " + error + "\t[statement]: " + _query);
+#else
+	for (std::size_t i = 0; i < rows; ++i)
+	{
+		bindParams(params + i*count, count);
+		ResultHandle result(PQexecPrepared(_connection, name.c_str(), nParams,
+			count > 0 ? &_paramValues[0] : 0,
+			count > 0 ? &_paramLengths[0] : 0,
+			count > 0 ? &_paramFormats[0] : 0, 1));
+		ExecStatusType status = PQresultStatus(result);
+		if (status != PGRES_TUPLES_OK && status != PGRES_COMMAND_OK)
+			throw StatementException("PQexecPrepared error", result, _query);
+		_affectedRows += static_cast<std::size_t>(std::strtoul(PQcmdTuples(result), 0, 10));
+	}
+#endif
+
+	return _affectedRows;
 }
 
 }}}
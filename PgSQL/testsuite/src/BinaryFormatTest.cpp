@@ -0,0 +1,406 @@
+//
+// BinaryFormatTest.cpp
+//
+// $Id: //poco/1.4/Data/PgSQL/testsuite/src/BinaryFormatTest.cpp#1 $
+//
+// Copyright (c) 2008, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "BinaryFormatTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Data/PgSQL/Binder.h"
+#include "Poco/Data/PgSQL/CopyIn.h"
+#include "Poco/Data/PgSQL/CopyOut.h"
+#include "Poco/Data/PgSQL/PgSQLInternal.h"
+#include "Poco/Data/PgSQL/SessionHandle.h"
+#include "Poco/DateTime.h"
+#include "Poco/Exception.h"
+#include <vector>
+#include <deque>
+#include <list>
+
+
+using Poco::Data::PgSQL::Binder;
+using Poco::Data::PgSQL::CopyIn;
+using Poco::Data::PgSQL::CopyOut;
+using Poco::Data::PgSQL::SessionHandle;
+using Poco::Data::AbstractBinder;
+using Poco::Data::Date;
+using Poco::Data::Time;
+using Poco::DateTime;
+
+
+namespace
+{
+	Poco::Int64 readBigEndian(const PgSQL_BIND& bind)
+		/// Assembles the value byte by byte, most significant first.
+	{
+		Poco::UInt64 value = 0;
+		for (int i = 0; i < bind._paramLenght; ++i)
+			value = (value << 8) | static_cast<unsigned char>(bind._paramValue[i]);
+		return static_cast<Poco::Int64>(value);
+	}
+
+	class BufferCopyIn: public CopyIn
+		/// Keeps the chunks of COPY data instead of sending them.
+	{
+	public:
+		BufferCopyIn(std::size_t columns, std::size_t bufferSize):
+			CopyIn(columns, bufferSize)
+		{
+		}
+
+		std::vector<std::string> chunks;
+
+	protected:
+		void sendData(const char* data, std::size_t length)
+		{
+			chunks.push_back(std::string(data, length));
+		}
+
+		std::size_t sendEnd()
+		{
+			return rows();
+		}
+	};
+}
+
+
+BinaryFormatTest::BinaryFormatTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+BinaryFormatTest::~BinaryFormatTest()
+{
+}
+
+
+void BinaryFormatTest::testBinderByteOrder()
+{
+	Binder binder;
+	binder.bind(0, Poco::Int16(0x0102), AbstractBinder::PD_IN);
+	binder.bind(1, Poco::Int32(0x01020304), AbstractBinder::PD_IN);
+	binder.bind(2, Poco::Int64(-2), AbstractBinder::PD_IN);
+	binder.bind(3, 1.0, AbstractBinder::PD_IN);
+	binder.bind(4, 1.0f, AbstractBinder::PD_IN);
+	binder.bind(5, true, AbstractBinder::PD_IN);
+	binder.bind(6, DateTime(2000, 1, 2, 0, 0, 1), AbstractBinder::PD_IN);
+	binder.bind(7, Date(1999, 12, 31), AbstractBinder::PD_IN);
+	binder.bind(8, Time(1, 2, 3), AbstractBinder::PD_IN);
+	assert (binder.size() == 9);
+
+	PgSQL_BIND* values = binder.getBindArray();
+	assert (values[0]._oid == PgSQL_TYPE_INT16);
+	assert (std::string(values[0]._paramValue, values[0]._paramLenght) == "\x01\x02");
+	assert (values[1]._oid == PgSQL_TYPE_INT32);
+	assert (std::string(values[1]._paramValue, values[1]._paramLenght) == "\x01\x02\x03\x04");
+	assert (values[2]._oid == PgSQL_TYPE_INT64);
+	assert (values[2]._paramLenght == 8);
+	assert (readBigEndian(values[2]) == -2);
+	assert (values[3]._oid == PgSQL_TYPE_DOUBLE);
+	assert (values[3]._paramLenght == 8);
+	assert (readBigEndian(values[3]) == Poco::Int64(0x3FF0000000000000LL));
+	assert (values[4]._oid == PgSQL_TYPE_FLOAT);
+	assert (std::string(values[4]._paramValue, values[4]._paramLenght) == std::string("\x3F\x80\x00\x00", 4));
+	assert (values[5]._oid == PgSQL_TYPE_BOOL);
+	assert (std::string(values[5]._paramValue, values[5]._paramLenght) == "\x01");
+
+	// dates and times count from 2000-01-01 and midnight
+	assert (values[6]._oid == PgSQL_TYPE_TIMESTAMP);
+	assert (values[6]._paramLenght == 8);
+	assert (readBigEndian(values[6]) == Poco::Int64(86401)*1000000);
+	assert (values[7]._oid == PgSQL_TYPE_DATE);
+	assert (values[7]._paramLenght == 4);
+	assert (static_cast<Poco::Int32>(readBigEndian(values[7])) == -1);
+	assert (values[8]._oid == PgSQL_TYPE_TIME);
+	assert (values[8]._paramLenght == 8);
+	assert (readBigEndian(values[8]) == Poco::Int64(3723)*1000000);
+
+	// a copied bind array keeps the values of up to 8 bytes
+	std::vector<PgSQL_BIND> copy(values, values + binder.size());
+	binder.bind(1, Poco::Int32(0), AbstractBinder::PD_IN);
+	assert (std::string(copy[1]._paramValue, copy[1]._paramLenght) == "\x01\x02\x03\x04");
+}
+
+
+void BinaryFormatTest::testBinderNull()
+{
+	std::string empty;
+	std::string text("text");
+	Binder binder;
+	binder.bind(0, Poco::Data::NULL_GENERIC, AbstractBinder::PD_IN);
+	binder.bind(1, empty, AbstractBinder::PD_IN);
+	binder.bind(2, text, AbstractBinder::PD_IN);
+
+	PgSQL_BIND* values = binder.getBindArray();
+	assert (values[0]._oid == PgSQL_TYPE_NULL);
+	assert (values[0]._paramValue == 0);
+
+	// an empty string is a value, not a null
+	assert (values[1]._oid == PgSQL_TYPE_STRING);
+	assert (values[1]._paramLenght == 0);
+	assert (values[1]._paramValue != 0);
+
+	// strings are passed without being copied
+	assert (values[2]._oid == PgSQL_TYPE_STRING);
+	assert (values[2]._paramValue == text.data());
+	assert (values[2]._paramLenght == 4);
+}
+
+
+void BinaryFormatTest::testBinderBulk()
+{
+	std::vector<Poco::Int32> ids;
+	std::list<std::string> names;
+	std::deque<bool> flags;
+	for (int i = 0; i < 3; ++i)
+	{
+		ids.push_back(i + 1);
+		names.push_back(std::string(i + 1, 'x'));
+		flags.push_back(i % 2 == 0);
+	}
+
+	// parameter sets follow each other, one per row
+	Binder binder;
+	binder.bind(0, Poco::Int32(42), AbstractBinder::PD_IN);
+	binder.setParameterCount(3);
+	assert (binder.parameterCount() == 3);
+	assert (binder.size() == 0);
+	binder.bind(0, ids, AbstractBinder::PD_IN);
+	binder.bind(1, names, AbstractBinder::PD_IN);
+	binder.bind(2, flags, AbstractBinder::PD_IN);
+	assert (binder.size() == 9);
+
+	PgSQL_BIND* values = binder.getBindArray();
+	std::list<std::string>::const_iterator itName = names.begin();
+	for (int i = 0; i < 3; ++i, ++itName)
+	{
+		PgSQL_BIND* row = values + i*3;
+		assert (row[0]._oid == PgSQL_TYPE_INT32);
+		assert (readBigEndian(row[0]) == i + 1);
+		assert (row[1]._oid == PgSQL_TYPE_STRING);
+		assert (row[1]._paramValue == itName->data());
+		assert (row[1]._paramLenght == i + 1);
+		assert (row[2]._oid == PgSQL_TYPE_BOOL);
+		assert (readBigEndian(row[2]) == (i % 2 == 0 ? 1 : 0));
+	}
+
+	// std::vector<bool> has no addressable elements; values are copied
+	std::vector<bool> bits(2, true);
+	std::vector<Poco::Data::NullData> nulls(2, Poco::Data::NULL_GENERIC);
+	binder.setParameterCount(2);
+	binder.bind(0, bits, AbstractBinder::PD_IN);
+	binder.bind(1, nulls, AbstractBinder::PD_IN);
+	assert (binder.size() == 4);
+	values = binder.getBindArray();
+	assert (values[2]._oid == PgSQL_TYPE_BOOL);
+	assert (readBigEndian(values[2]) == 1);
+	assert (values[3]._oid == PgSQL_TYPE_NULL);
+}
+
+
+void BinaryFormatTest::testCopyRoundTrip()
+{
+	const int rows = 50;
+
+	// a small buffer, so the data is sent in several chunks
+	BufferCopyIn copy(6, 128);
+	assert (copy.columns() == 6);
+	copy << Poco::Int32(-5) << std::string("abc") << 2.5 << (Poco::Int64(1) << 40) << true << DateTime(2012, 3, 4, 5, 6, 7);
+	copy << Poco::Data::NULL_GENERIC << std::string() << -0.25 << Poco::Int64(-1) << false << Poco::Data::NULL_GENERIC;
+	for (int i = 2; i < rows; ++i)
+	{
+		copy << Poco::Int32(i) << std::string(i, 'x') << i/4.0 << Poco::Int64(i)*1000000000 << (i % 2 == 0) << DateTime(1990 + i, 1, 1);
+	}
+
+	try
+	{
+		copy << Poco::Int32(0);
+		copy.end();
+		fail("incomplete row - must throw");
+	}
+	catch (Poco::InvalidAccessException&)
+	{
+	}
+	copy << std::string() << 0.0 << Poco::Int64(0) << false << DateTime(2000, 1, 1);
+	assert (copy.end() == rows + 1);
+	assert (copy.chunks.size() > 2);
+
+	SessionHandle handle;
+	CopyOut out(handle, "t");
+	std::vector<Poco::Int32> ints;
+	std::list<std::string> strings;
+	std::deque<double> doubles;
+	std::vector<Poco::Int64> bigints;
+	std::vector<bool> bools;
+	std::vector<DateTime> timestamps;
+	out.into(ints).into(strings).into(doubles).into(bigints).into(bools).into(timestamps);
+
+	std::size_t received = 0;
+	for (std::vector<std::string>::const_iterator it = copy.chunks.begin(); it != copy.chunks.end(); ++it)
+	{
+		received += out.parse(it->data(), it->size());
+	}
+	assert (received == rows + 1);
+	assert (ints.size() == rows + 1);
+
+	std::list<std::string>::const_iterator str = strings.begin();
+	assert (ints[0] == -5);
+	assert (*str++ == "abc");
+	assert (doubles[0] == 2.5);
+	assert (bigints[0] == Poco::Int64(1) << 40);
+	assert (bools[0]);
+	assert (timestamps[0] == DateTime(2012, 3, 4, 5, 6, 7));
+	for (std::size_t col = 0; col < 6; ++col)
+		assert (!out.isNull(col, 0));
+
+	// nulls are default-constructed; empty strings are not null
+	assert (out.isNull(0, 1));
+	assert (ints[1] == 0);
+	assert (!out.isNull(1, 1));
+	assert ((str++)->empty());
+	assert (doubles[1] == -0.25);
+	assert (bigints[1] == -1);
+	assert (!bools[1]);
+	assert (out.isNull(5, 1));
+
+	for (int i = 2; i < rows; ++i, ++str)
+	{
+		assert (ints[i] == i);
+		assert (*str == std::string(i, 'x'));
+		assert (doubles[i] == i/4.0);
+		assert (bigints[i] == Poco::Int64(i)*1000000000);
+		assert (bools[i] == (i % 2 == 0));
+		assert (timestamps[i] == DateTime(1990 + i, 1, 1));
+	}
+	assert (ints[rows] == 0);
+	assert (timestamps[rows] == DateTime(2000, 1, 1));
+}
+
+
+void BinaryFormatTest::testCopyColumns()
+{
+	std::vector<Poco::Int32> ints;
+	std::list<std::string> strings;
+	std::deque<double> doubles;
+	for (int i = 0; i < 10; ++i)
+	{
+		ints.push_back(i - 5);
+		strings.push_back(std::string(i, 'y'));
+		doubles.push_back(i*1.5);
+	}
+
+	BufferCopyIn byColumn(3, CopyIn::DEFAULT_BUFFER_SIZE);
+	byColumn.column(ints).column(strings).column(doubles);
+	assert (byColumn.rows() == 10);
+	byColumn.end();
+
+	BufferCopyIn byValue(3, CopyIn::DEFAULT_BUFFER_SIZE);
+	std::list<std::string>::const_iterator str = strings.begin();
+	for (int i = 0; i < 10; ++i)
+	{
+		byValue << ints[i] << *str++ << doubles[i];
+	}
+	byValue.end();
+
+	assert (byColumn.chunks.size() == 1);
+	assert (byColumn.chunks == byValue.chunks);
+
+	BufferCopyIn mismatch(2, CopyIn::DEFAULT_BUFFER_SIZE);
+	ints.pop_back();
+	try
+	{
+		mismatch.column(ints).column(doubles);
+		fail("columns differ in size - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void BinaryFormatTest::testCopyTemporaries()
+{
+	std::string text("abcdef");
+	std::string value("first");
+	BufferCopyIn copy(3, CopyIn::DEFAULT_BUFFER_SIZE);
+	copy << text.substr(0, 3);
+	copy << value;
+	value.replace(0, 5, "XXXXX");
+	copy << std::string(100, 'z');
+	copy.end();
+
+	SessionHandle handle;
+	CopyOut out(handle, "t");
+	std::vector<std::string> first;
+	std::vector<std::string> second;
+	std::vector<std::string> third;
+	out.into(first).into(second).into(third);
+	assert (out.parse(copy.chunks[0].data(), copy.chunks[0].size()) == 1);
+	assert (first[0] == "abc");
+	assert (second[0] == "first");
+	assert (third[0] == std::string(100, 'z'));
+
+	BufferCopyIn mixed(2, CopyIn::DEFAULT_BUFFER_SIZE);
+	std::vector<Poco::Int32> ints(3, 1);
+	mixed << Poco::Int32(0);
+	try
+	{
+		mixed.column(ints).column(ints);
+		fail("row is incomplete - must throw");
+	}
+	catch (Poco::InvalidAccessException&)
+	{
+	}
+}
+
+
+void BinaryFormatTest::setUp()
+{
+}
+
+
+void BinaryFormatTest::tearDown()
+{
+}
+
+
+CppUnit::Test* BinaryFormatTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("BinaryFormatTest");
+
+	CppUnit_addTest(pSuite, BinaryFormatTest, testBinderByteOrder);
+	CppUnit_addTest(pSuite, BinaryFormatTest, testBinderNull);
+	CppUnit_addTest(pSuite, BinaryFormatTest, testBinderBulk);
+	CppUnit_addTest(pSuite, BinaryFormatTest, testCopyRoundTrip);
+	CppUnit_addTest(pSuite, BinaryFormatTest, testCopyColumns);
+	CppUnit_addTest(pSuite, BinaryFormatTest, testCopyTemporaries);
+
+	return pSuite;
+}
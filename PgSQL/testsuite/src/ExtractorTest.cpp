@@ -0,0 +1,362 @@
+//
+// ExtractorTest.cpp
+//
+// $Id: //poco/1.4/Data/PgSQL/testsuite/src/ExtractorTest.cpp#1 $
+//
+// Copyright (c) 2008, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "ExtractorTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Data/PgSQL/Extractor.h"
+#include "Poco/Data/PgSQL/ResultMetadata.h"
+#include "Poco/Data/PgSQL/SessionHandle.h"
+#include "Poco/Data/PgSQL/StatementExecutor.h"
+#include "Poco/Data/PgSQL/PgSQLInternal.h"
+#include "Poco/ByteOrder.h"
+#include "Poco/DateTime.h"
+#include "Poco/Timespan.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Stopwatch.h"
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <deque>
+#include <list>
+
+
+using Poco::Data::PgSQL::Extractor;
+using Poco::Data::PgSQL::ResultMetadata;
+using Poco::Data::PgSQL::SessionHandle;
+using Poco::Data::PgSQL::StatementExecutor;
+using Poco::DateTime;
+using Poco::Timespan;
+
+
+namespace
+{
+	const DateTime EPOCH(2000, 1, 1);
+
+	template <typename T, typename U>
+	void setValue(PGresult* result, int row, int col, T value)
+	{
+		U bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		bits = Poco::ByteOrder::toNetwork(bits);
+		PQsetvalue(result, row, col, reinterpret_cast<char*>(&bits), sizeof(bits));
+	}
+
+	DateTime timestamp(int row)
+	{
+		return EPOCH + Timespan(row, 0, 0, 1, 0);
+	}
+
+	std::string text(int row)
+	{
+		return "row " + Poco::NumberFormatter::format(row);
+	}
+}
+
+
+ExtractorTest::ExtractorTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+ExtractorTest::~ExtractorTest()
+{
+}
+
+
+void ExtractorTest::testExtract()
+{
+	SessionHandle handle;
+	StatementExecutor executor(handle);
+	PGresult* result = createResult(20);
+	executor.setResult(result);
+	ResultMetadata metadata;
+	metadata.init(result);
+	Extractor extractor(executor, metadata);
+	assert (metadata.columnsReturned() == 5);
+
+	int row = 0;
+	while (executor.fetch())
+	{
+		Poco::Int32 i = -1;
+		assert (extractor.extract(0, i) == (row % 7 != 0));
+		assert (extractor.isNull(0, POCO_DATA_INVALID_ROW) == (row % 7 == 0));
+		if (row % 7 != 0)
+			assert (i == row);
+
+		double d = 0;
+		assert (extractor.extract(1, d));
+		assert (d == row*0.25);
+
+		std::string s;
+		assert (extractor.extract(2, s) == (row % 5 != 0));
+		if (row % 5 != 0)
+			assert (s == text(row));
+
+		Poco::Int64 l = 0;
+		assert (extractor.extract(3, l));
+		assert (l == -(Poco::Int64(row) << 33));
+
+		DateTime dt;
+		assert (extractor.extract(4, dt));
+		assert (dt == timestamp(row));
+		++row;
+	}
+	assert (row == 20);
+}
+
+
+void ExtractorTest::testBulkExtract()
+{
+	const int rows = 100;
+
+	SessionHandle handle;
+	StatementExecutor executor(handle);
+	PGresult* result = createResult(rows);
+	executor.setResult(result);
+	ResultMetadata metadata;
+	metadata.init(result);
+	Extractor extractor(executor, metadata);
+
+	assert (executor.fetch());
+	assert (executor.rows() == rows);
+	extractor.setRowCount(executor.rows());
+
+	std::vector<Poco::Int32> ints;
+	std::deque<double> doubles;
+	std::list<std::string> strings;
+	std::vector<Poco::Int64> bigints;
+	std::vector<DateTime> timestamps;
+	assert (extractor.extract(0, ints));
+	assert (extractor.extract(1, doubles));
+	assert (extractor.extract(2, strings));
+	assert (extractor.extract(3, bigints));
+	assert (extractor.extract(4, timestamps));
+	assert (ints.size() == rows);
+	assert (strings.size() == rows);
+
+	std::list<std::string>::const_iterator str = strings.begin();
+	for (int row = 0; row < rows; ++row, ++str)
+	{
+		assert (extractor.isNull(0, row) == (row % 7 == 0));
+		assert (ints[row] == (row % 7 == 0 ? 0 : row));
+		assert (!extractor.isNull(1, row));
+		assert (doubles[row] == row*0.25);
+		assert (extractor.isNull(2, row) == (row % 5 == 0));
+		assert (*str == (row % 5 == 0 ? std::string() : text(row)));
+		assert (bigints[row] == -(Poco::Int64(row) << 33));
+		assert (timestamps[row] == timestamp(row));
+	}
+
+	// integers widen to the container's type
+	std::vector<Poco::Int64> wide;
+	assert (extractor.extract(0, wide));
+	assert (wide[rows - 1] == rows - 1);
+	assert (extractor.isNull(0, 0));
+
+	try
+	{
+		extractor.extract(2, ints);
+		fail("not a number - must throw");
+	}
+	catch (Poco::Data::PgSQL::PgSQLException&)
+	{
+	}
+
+	extractor.reset();
+	try
+	{
+		extractor.isNull(0, 1);
+		fail("no rows extracted - must throw");
+	}
+	catch (Poco::Data::PgSQL::PgSQLException&)
+	{
+	}
+}
+
+
+void ExtractorTest::testBulkExtractRange()
+{
+	SessionHandle handle;
+	StatementExecutor executor(handle);
+	PGresult* result = createResult(30);
+	executor.setResult(result);
+	ResultMetadata metadata;
+	metadata.init(result);
+	Extractor extractor(executor, metadata);
+
+	// two batches of 10 rows starting at row 5, as with a limit
+	assert (executor.fetch());
+	executor.skip(5);
+	for (int batch = 0; batch < 2; ++batch)
+	{
+		extractor.setRowCount(10);
+		std::vector<Poco::Int32> ints;
+		assert (extractor.extract(0, ints));
+		assert (ints.size() == 10);
+		for (int i = 0; i < 10; ++i)
+		{
+			int row = 5 + batch*10 + i;
+			assert (extractor.isNull(0, i) == (row % 7 == 0));
+			if (row % 7 != 0)
+				assert (ints[i] == row);
+		}
+		executor.skip(9);
+		assert (executor.fetch());
+	}
+	assert (executor.rows() == 5);
+}
+
+
+void ExtractorTest::testExtractBenchmark()
+{
+	const int rows = 200000;
+
+	SessionHandle handle;
+	StatementExecutor executor(handle);
+	PGresult* result = createResult(rows);
+	executor.setResult(result);
+	ResultMetadata metadata;
+	metadata.init(result);
+	Extractor extractor(executor, metadata);
+
+	Poco::Stopwatch sw;
+	sw.start();
+	Poco::Int64 rowSum = 0;
+	double rowDoubles = 0;
+	while (executor.fetch())
+	{
+		Poco::Int32 i;
+		double d;
+		if (extractor.extract(0, i))
+			rowSum += i;
+		extractor.extract(1, d);
+		rowDoubles += d;
+	}
+	sw.stop();
+	Poco::Timestamp::TimeDiff rowTime = sw.elapsed();
+
+	result = createResult(rows);
+	executor.setResult(result);
+	metadata.init(result);
+	sw.restart();
+	assert (executor.fetch());
+	extractor.setRowCount(executor.rows());
+	std::vector<Poco::Int32> ints;
+	std::vector<double> doubles;
+	extractor.extract(0, ints);
+	extractor.extract(1, doubles);
+	Poco::Int64 bulkSum = 0;
+	double bulkDoubles = 0;
+	for (int row = 0; row < rows; ++row)
+	{
+		bulkSum += ints[row];
+		bulkDoubles += doubles[row];
+	}
+	sw.stop();
+	Poco::Timestamp::TimeDiff bulkTime = sw.elapsed();
+
+	assert (rowSum == bulkSum);
+	assert (rowDoubles == bulkDoubles);
+
+	std::cout << std::endl << rows << " rows, 2 columns: "
+		<< "row-at-a-time " << rowTime / 1000 << " ms, "
+		<< "bulk " << bulkTime / 1000 << " ms" << std::endl;
+}
+
+
+PGresult* ExtractorTest::createResult(int rows)
+{
+	PGresult* result = PQmakeEmptyPGresult(0, PGRES_TUPLES_OK);
+
+	PGresAttDesc columns[5];
+	std::memset(columns, 0, sizeof(columns));
+	const char* names[5] = {"i", "d", "s", "l", "t"};
+	const int types[5] = {PgSQL_TYPE_INT32, PgSQL_TYPE_DOUBLE, PgSQL_TYPE_STRING, PgSQL_TYPE_INT64, PgSQL_TYPE_TIMESTAMP};
+	const int sizes[5] = {4, 8, -1, 8, 8};
+	for (int col = 0; col < 5; ++col)
+	{
+		columns[col].name = const_cast<char*>(names[col]);
+		columns[col].typid = types[col];
+		columns[col].typlen = sizes[col];
+		columns[col].atttypmod = -1;
+		columns[col].format = 1;
+	}
+	PQsetResultAttrs(result, 5, columns);
+
+	for (int row = 0; row < rows; ++row)
+	{
+		if (row % 7 == 0)
+			PQsetvalue(result, row, 0, 0, -1);
+		else
+			setValue<Poco::Int32, Poco::UInt32>(result, row, 0, row);
+
+		setValue<double, Poco::UInt64>(result, row, 1, row*0.25);
+
+		if (row % 5 == 0)
+		{
+			PQsetvalue(result, row, 2, 0, -1);
+		}
+		else
+		{
+			std::string s = text(row);
+			PQsetvalue(result, row, 2, const_cast<char*>(s.data()), static_cast<int>(s.size()));
+		}
+
+		setValue<Poco::Int64, Poco::UInt64>(result, row, 3, -(Poco::Int64(row) << 33));
+		setValue<Poco::Int64, Poco::UInt64>(result, row, 4, (timestamp(row) - EPOCH).totalMicroseconds());
+	}
+	return result;
+}
+
+
+void ExtractorTest::setUp()
+{
+}
+
+
+void ExtractorTest::tearDown()
+{
+}
+
+
+CppUnit::Test* ExtractorTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ExtractorTest");
+
+	CppUnit_addTest(pSuite, ExtractorTest, testExtract);
+	CppUnit_addTest(pSuite, ExtractorTest, testBulkExtract);
+	CppUnit_addTest(pSuite, ExtractorTest, testBulkExtractRange);
+	CppUnit_addTest(pSuite, ExtractorTest, testExtractBenchmark);
+
+	return pSuite;
+}
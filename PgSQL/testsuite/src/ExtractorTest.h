@@ -0,0 +1,70 @@
+//
+// ExtractorTest.h
+//
+// $Id: //poco/1.4/Data/PgSQL/testsuite/src/ExtractorTest.h#1 $
+//
+// Definition of the ExtractorTest class.
+//
+// Copyright (c) 2008, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef ExtractorTest_INCLUDED
+#define ExtractorTest_INCLUDED
+
+
+#include "Poco/Data/PgSQL/PgSQL.h"
+#include "CppUnit/TestCase.h"
+#include <libpq-fe.h>
+
+
+class ExtractorTest: public CppUnit::TestCase
+	/// Checks row-at-a-time and bulk extraction on results built
+	/// with libpq's PQsetvalue(), so no server is needed.
+{
+public:
+	ExtractorTest(const std::string& name);
+	~ExtractorTest();
+
+	void testExtract();
+	void testBulkExtract();
+	void testBulkExtractRange();
+	void testExtractBenchmark();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+	static PGresult* createResult(int rows);
+		/// Creates a result with an integer, a double precision, a text,
+		/// a bigint and a timestamp column. Every seventh integer and
+		/// every fifth text value is null.
+};
+
+
+#endif // ExtractorTest_INCLUDED
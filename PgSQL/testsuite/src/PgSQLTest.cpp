@@ -0,0 +1,197 @@
+//
+// PgSQLTest.cpp
+//
+// $Id: //poco/1.4/Data/PgSQL/testsuite/src/PgSQLTest.cpp#1 $
+//
+// Copyright (c) 2008, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "PgSQLTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Data/PgSQL/Connector.h"
+#include "Poco/Data/PgSQL/StatementCache.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Any.h"
+#include <libpq-fe.h>
+#include <iostream>
+#include <vector>
+
+
+using namespace Poco::Data::Keywords;
+using Poco::Data::PgSQL::Connector;
+using Poco::Data::PgSQL::StatementCache;
+using Poco::Data::Session;
+using Poco::Data::Statement;
+using Poco::AnyCast;
+using Poco::NumberFormatter;
+
+
+namespace
+{
+	const std::string CONNINFO("host=localhost port=5432 dbname=postgres user=postgres connect_timeout=5");
+	const std::string CONNECTION_STRING("host=localhost;port=5432;dbname=postgres;user=postgres");
+}
+
+
+PgSQLTest::PgSQLTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+PgSQLTest::~PgSQLTest()
+{
+}
+
+
+void PgSQLTest::testBulkInsert()
+{
+	if (!_pSession)
+	{
+		std::cout << "test skipped." << std::endl;
+		return;
+	}
+
+	Session& session = *_pSession;
+	session.setFeature("bulk", true);
+	session << "CREATE TEMP TABLE bulk_test (id INTEGER, name VARCHAR(20))", now;
+
+	const int rows = 1000;
+	std::vector<int> ids;
+	std::vector<std::string> names;
+	for (int i = 0; i < rows; ++i)
+	{
+		ids.push_back(i);
+		names.push_back(NumberFormatter::format(i));
+	}
+
+	// one execution per row, all sent in a single batch
+	session << "INSERT INTO bulk_test VALUES ($1, $2)", use(ids, bulk), use(names, bulk), now;
+
+	Poco::Int64 count = 0;
+	session << "SELECT count(*) FROM bulk_test WHERE name = id::text", into(count), now;
+	assert (count == rows);
+}
+
+
+void PgSQLTest::testStatementCacheSize()
+{
+	if (!_pSession)
+	{
+		std::cout << "test skipped." << std::endl;
+		return;
+	}
+
+	Session& session = *_pSession;
+	assert (AnyCast<std::size_t>(session.getProperty("statementCacheSize")) == std::size_t(StatementCache::DEFAULT_CAPACITY));
+	session.setProperty("statementCacheSize", 2);
+	assert (AnyCast<std::size_t>(session.getProperty("statementCacheSize")) == 2);
+
+	for (int i = 0; i < 5; ++i)
+	{
+		int value = -1;
+		session << "SELECT " + NumberFormatter::format(i), into(value), now;
+		assert (value == i);
+	}
+
+	// the statement counting them is one of the two
+	Poco::Int64 count = 0;
+	session << "SELECT count(*) FROM pg_prepared_statements", into(count), now;
+	assert (count == 2);
+}
+
+
+void PgSQLTest::testSingleRowMode()
+{
+	if (!_pSession)
+	{
+		std::cout << "test skipped." << std::endl;
+		return;
+	}
+
+	Session& session = *_pSession;
+	assert (session.getFeature("singleRowMode"));
+	std::vector<int> streamed;
+	session << "SELECT generate_series(1, 100000)", into(streamed), now;
+
+	session.setFeature("singleRowMode", false);
+	assert (!session.getFeature("singleRowMode"));
+	std::vector<int> whole;
+	session << "SELECT generate_series(1, 100000)", into(whole), now;
+
+	assert (streamed.size() == 100000);
+	assert (streamed.back() == 100000);
+	assert (streamed == whole);
+
+	// a statement stopped early leaves the session usable
+	session.setFeature("singleRowMode", true);
+	{
+		std::vector<int> first;
+		Statement select = (session << "SELECT generate_series(1, 100000)", into(first), limit(10));
+		select.execute();
+		assert (first.size() == 10);
+		assert (first.back() == 10);
+	}
+
+	int value = 0;
+	session << "SELECT 42", into(value), now;
+	assert (value == 42);
+}
+
+
+void PgSQLTest::setUp()
+{
+	// Sessions don't report a failed connection, so the server is probed first.
+	PGconn* conn = PQconnectdb(CONNINFO.c_str());
+	bool connected = PQstatus(conn) == CONNECTION_OK;
+	PQfinish(conn);
+
+	Connector::registerConnector();
+	if (connected)
+		_pSession = new Session(Connector::KEY, CONNECTION_STRING);
+	else
+		std::cout << "Couldn't connect to localhost:5432. ";
+}
+
+
+void PgSQLTest::tearDown()
+{
+	_pSession = 0;
+	Connector::unregisterConnector();
+}
+
+
+CppUnit::Test* PgSQLTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("PgSQLTest");
+
+	CppUnit_addTest(pSuite, PgSQLTest, testBulkInsert);
+	CppUnit_addTest(pSuite, PgSQLTest, testStatementCacheSize);
+	CppUnit_addTest(pSuite, PgSQLTest, testSingleRowMode);
+
+	return pSuite;
+}
@@ -0,0 +1,243 @@
+//
+// StatementCacheTest.cpp
+//
+// $Id: //poco/1.4/Data/PgSQL/testsuite/src/StatementCacheTest.cpp#1 $
+//
+// Copyright (c) 2008, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "StatementCacheTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Data/PgSQL/StatementCache.h"
+#include <vector>
+
+
+using Poco::Data::PgSQL::StatementCache;
+using Poco::Data::PgSQL::StatementException;
+
+
+namespace
+{
+	class TestCache: public StatementCache
+		/// Records the statements that would be prepared and deallocated.
+	{
+	public:
+		TestCache(): busy(false)
+		{
+		}
+
+		std::vector<std::string> prepared;
+		std::vector<std::string> deallocated;
+		bool busy;
+
+	protected:
+		pg_result* prepareStatement(pg_conn*, const std::string& name, const std::string& query, const std::vector<Oid>&)
+		{
+			if (query == "invalid")
+				throw StatementException("syntax error");
+
+			prepared.push_back(name);
+			return PQmakeEmptyPGresult(0, PGRES_COMMAND_OK);
+		}
+
+		bool deallocateStatement(pg_conn*, const std::string& name)
+		{
+			if (busy)
+				return false;
+
+			deallocated.push_back(name);
+			return true;
+		}
+	};
+
+	const std::vector<Oid> NO_TYPES;
+}
+
+
+StatementCacheTest::StatementCacheTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+StatementCacheTest::~StatementCacheTest()
+{
+}
+
+
+void StatementCacheTest::testCache()
+{
+	TestCache cache;
+	assert (cache.capacity() == StatementCache::DEFAULT_CAPACITY);
+	assert (cache.size() == 0);
+
+	StatementCache::Statement::Ptr pFirst = cache.prepare(0, "SELECT 1", NO_TYPES);
+	assert (pFirst->name() == "poco_1");
+	assert (pFirst->description() != 0);
+	assert (cache.prepare(0, "SELECT 1", NO_TYPES) == pFirst);
+	assert (cache.prepared.size() == 1);
+
+	// the parameter types are part of the key
+	std::vector<Oid> types(1, 23);
+	StatementCache::Statement::Ptr pInt = cache.prepare(0, "SELECT $1", types);
+	types[0] = 25;
+	StatementCache::Statement::Ptr pText = cache.prepare(0, "SELECT $1", types);
+	assert (pInt->name() == "poco_2");
+	assert (pText->name() == "poco_3");
+	assert (cache.prepare(0, "SELECT $1", types) == pText);
+	assert (cache.size() == 3);
+	assert (cache.deallocated.empty());
+
+	// closing the connection forgets the statements without deallocating them
+	cache.clear();
+	assert (cache.size() == 0);
+	assert (cache.deallocated.empty());
+	assert (pFirst->name() == "poco_1");
+	assert (cache.prepare(0, "SELECT 1", NO_TYPES)->name() == "poco_4");
+}
+
+
+void StatementCacheTest::testEviction()
+{
+	TestCache cache;
+	cache.setCapacity(0, 2);
+	assert (cache.capacity() == 2);
+
+	cache.prepare(0, "A", NO_TYPES);
+	cache.prepare(0, "B", NO_TYPES);
+	cache.prepare(0, "C", NO_TYPES);
+	assert (cache.size() == 2);
+	assert (cache.deallocated.size() == 1);
+	assert (cache.deallocated[0] == "poco_1");
+
+	// using B makes C the least recently used
+	assert (cache.prepare(0, "B", NO_TYPES)->name() == "poco_2");
+	cache.prepare(0, "D", NO_TYPES);
+	assert (cache.size() == 2);
+	assert (cache.deallocated.size() == 2);
+	assert (cache.deallocated[1] == "poco_3");
+
+	// an evicted statement is prepared again under a new name
+	assert (cache.prepare(0, "A", NO_TYPES)->name() == "poco_5");
+	assert (cache.deallocated[2] == "poco_2");
+
+	cache.setCapacity(0, 0);
+	assert (cache.size() == 0);
+	assert (cache.deallocated.size() == 5);
+}
+
+
+void StatementCacheTest::testInUse()
+{
+	TestCache cache;
+	cache.setCapacity(0, 1);
+
+	StatementCache::Statement::Ptr pA = cache.prepare(0, "A", NO_TYPES);
+	StatementCache::Statement::Ptr pB = cache.prepare(0, "B", NO_TYPES);
+	assert (cache.size() == 2);
+	assert (cache.deallocated.empty());
+
+	// statements in use are kept, even beyond the capacity
+	cache.setCapacity(0, 0);
+	assert (cache.size() == 2);
+	assert (cache.deallocated.empty());
+
+	pA = 0;
+	cache.setCapacity(0, 1);
+	assert (cache.size() == 1);
+	assert (cache.deallocated.size() == 1);
+	assert (cache.deallocated[0] == "poco_1");
+	assert (cache.prepare(0, "B", NO_TYPES) == pB);
+
+	pB = 0;
+	cache.prepare(0, "C", NO_TYPES);
+	assert (cache.size() == 1);
+	assert (cache.deallocated.size() == 2);
+	assert (cache.deallocated[1] == "poco_2");
+}
+
+
+void StatementCacheTest::testBusy()
+{
+	TestCache cache;
+	cache.setCapacity(0, 1);
+	cache.busy = true;
+
+	cache.prepare(0, "A", NO_TYPES);
+	cache.prepare(0, "B", NO_TYPES);
+	assert (cache.size() == 2);
+	assert (cache.deallocated.empty());
+
+	// deallocation is retried on the next trim
+	cache.busy = false;
+	cache.prepare(0, "C", NO_TYPES);
+	assert (cache.size() == 1);
+	assert (cache.deallocated.size() == 2);
+	assert (cache.deallocated[0] == "poco_1");
+	assert (cache.deallocated[1] == "poco_2");
+}
+
+
+void StatementCacheTest::testPrepareError()
+{
+	TestCache cache;
+	cache.prepare(0, "A", NO_TYPES);
+	try
+	{
+		cache.prepare(0, "invalid", NO_TYPES);
+		fail("invalid statement - must throw");
+	}
+	catch (StatementException&)
+	{
+	}
+	assert (cache.size() == 1);
+	assert (cache.prepare(0, "B", NO_TYPES)->name() == "poco_3");
+}
+
+
+void StatementCacheTest::setUp()
+{
+}
+
+
+void StatementCacheTest::tearDown()
+{
+}
+
+
+CppUnit::Test* StatementCacheTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("StatementCacheTest");
+
+	CppUnit_addTest(pSuite, StatementCacheTest, testCache);
+	CppUnit_addTest(pSuite, StatementCacheTest, testEviction);
+	CppUnit_addTest(pSuite, StatementCacheTest, testInUse);
+	CppUnit_addTest(pSuite, StatementCacheTest, testBusy);
+	CppUnit_addTest(pSuite, StatementCacheTest, testPrepareError);
+
+	return pSuite;
+}
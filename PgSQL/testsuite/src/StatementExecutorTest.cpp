@@ -0,0 +1,296 @@
+//
+// StatementExecutorTest.cpp
+//
+// $Id: //poco/1.4/Data/PgSQL/testsuite/src/StatementExecutorTest.cpp#1 $
+//
+// Copyright (c) 2008, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "StatementExecutorTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Data/PgSQL/Binder.h"
+#include "Poco/Data/PgSQL/StatementExecutor.h"
+#include "Poco/Data/PgSQL/StatementCache.h"
+#include "Poco/NumberFormatter.h"
+#include <iostream>
+#include <vector>
+
+
+using Poco::Data::PgSQL::Binder;
+using Poco::Data::PgSQL::SessionHandle;
+using Poco::Data::PgSQL::StatementCache;
+using Poco::Data::PgSQL::StatementException;
+using Poco::Data::PgSQL::StatementExecutor;
+using Poco::Data::AbstractBinder;
+using Poco::NumberFormatter;
+
+
+namespace
+{
+	const std::string CONNINFO("host=localhost port=5432 dbname=postgres user=postgres connect_timeout=5");
+
+	void execute(SessionHandle& handle, const std::string& sql)
+	{
+		StatementExecutor ex(handle);
+		ex.prepare(sql, 0, 0);
+		ex.execute(0, 0);
+	}
+
+	Poco::Int64 intValue(const StatementExecutor& ex)
+		/// Returns the integer in the first column of the current row.
+	{
+		// binary integers are big-endian and as wide as their type
+		Poco::UInt64 bits = 0;
+		const char* value = ex.value(0);
+		std::size_t length = ex.length(0);
+		for (std::size_t i = 0; i < length; ++i)
+			bits = (bits << 8) | static_cast<unsigned char>(value[i]);
+		if (length < 8 && (bits >> (8*length - 1)))
+			bits |= ~Poco::UInt64(0) << (8*length);
+		return static_cast<Poco::Int64>(bits);
+	}
+
+	Poco::Int64 queryInt(SessionHandle& handle, const std::string& sql)
+		/// Returns the integer in the first column of the first row,
+		/// or -1 if there is no row.
+	{
+		StatementExecutor ex(handle);
+		ex.prepare(sql, 0, 0);
+		ex.execute(0, 0);
+		return ex.fetch() ? intValue(ex) : -1;
+	}
+
+	const std::string SERIES("SELECT generate_series(1, 100000)");
+	const Poco::Int64 SERIES_ROWS = 100000;
+}
+
+
+StatementExecutorTest::StatementExecutorTest(const std::string& name):
+	CppUnit::TestCase(name),
+	_connected(false)
+{
+}
+
+
+StatementExecutorTest::~StatementExecutorTest()
+{
+}
+
+
+void StatementExecutorTest::testSingleRowMode()
+{
+	if (!_connected)
+	{
+		std::cout << "test skipped." << std::endl;
+		return;
+	}
+
+	StatementExecutor select(_handle);
+	assert (select.isSingleRowMode());
+	select.prepare(SERIES, 0, 0);
+	select.execute(0, 0);
+
+	// rows arrive one at a time, each in its own result
+	Poco::Int64 count = 0;
+	while (select.fetch())
+	{
+		assert (select.rows() == 1);
+		assert (intValue(select) == ++count);
+	}
+	assert (count == SERIES_ROWS);
+	assert (select.affectedRows() == std::size_t(SERIES_ROWS));
+	assert (!select.fetch());
+
+	// without single-row mode, execute() receives all rows at once
+	select.setSingleRowMode(false);
+	select.execute(0, 0);
+	assert (select.fetch());
+	assert (select.rows() == std::size_t(SERIES_ROWS));
+	select.skip(SERIES_ROWS - 1);
+	assert (intValue(select) == SERIES_ROWS);
+	assert (!select.fetch());
+}
+
+
+void StatementExecutorTest::testEarlyFinish()
+{
+	if (!_connected)
+	{
+		std::cout << "test skipped." << std::endl;
+		return;
+	}
+
+	{
+		StatementExecutor select(_handle);
+		select.prepare(SERIES, 0, 0);
+		select.execute(0, 0);
+		for (int i = 1; i <= 10; ++i)
+		{
+			assert (select.fetch());
+			assert (intValue(select) == i);
+		}
+
+		// executing again discards the rows that haven't been fetched
+		select.execute(0, 0);
+		assert (select.fetch());
+		assert (intValue(select) == 1);
+	}
+
+	// so does destroying the statement; the connection is idle again
+	assert (PQtransactionStatus(_handle) == PQTRANS_IDLE);
+	assert (queryInt(_handle, "SELECT 42") == 42);
+}
+
+
+void StatementExecutorTest::testExecuteBatch()
+{
+	if (!_connected)
+	{
+		std::cout << "test skipped." << std::endl;
+		return;
+	}
+
+	execute(_handle, "CREATE TEMP TABLE batch_test (id INTEGER, name VARCHAR(20))");
+
+	const int rows = 1000;
+	std::vector<Poco::Int32> ids;
+	std::vector<std::string> names;
+	for (int i = 0; i < rows; ++i)
+	{
+		ids.push_back(i);
+		names.push_back(NumberFormatter::format(i));
+	}
+
+	Binder binder;
+	binder.setParameterCount(2);
+	binder.bind(0, ids, AbstractBinder::PD_IN);
+	binder.bind(1, names, AbstractBinder::PD_IN);
+
+	StatementExecutor insert(_handle);
+	insert.prepare("INSERT INTO batch_test VALUES ($1, $2)", binder.getBindArray(), 2);
+	assert (insert.executeBatch(binder.getBindArray(), 2, rows) == std::size_t(rows));
+	assert (insert.affectedRows() == std::size_t(rows));
+	assert (insert.executeBatch(binder.getBindArray(), 2, 0) == 0);
+
+	assert (queryInt(_handle, "SELECT count(*) FROM batch_test WHERE name = id::text") == rows);
+	assert (queryInt(_handle, "SELECT sum(id) FROM batch_test") == rows*(rows - 1)/2);
+}
+
+
+void StatementExecutorTest::testExecuteBatchError()
+{
+	if (!_connected)
+	{
+		std::cout << "test skipped." << std::endl;
+		return;
+	}
+
+	execute(_handle, "CREATE TEMP TABLE batch_error (id INTEGER PRIMARY KEY)");
+
+	std::vector<Poco::Int32> ids;
+	for (int i = 0; i < 100; ++i)
+		ids.push_back(i);
+	ids[50] = 0;
+
+	Binder binder;
+	binder.bind(0, ids, AbstractBinder::PD_IN);
+
+	StatementExecutor insert(_handle);
+	insert.prepare("INSERT INTO batch_error VALUES ($1)", binder.getBindArray(), 1);
+	try
+	{
+		insert.executeBatch(binder.getBindArray(), 1, ids.size());
+		fail ("duplicate key must fail");
+	}
+	catch (StatementException&)
+	{
+	}
+
+	// the connection and the statement are usable after the error
+	assert (PQstatus(_handle) == CONNECTION_OK);
+	execute(_handle, "DELETE FROM batch_error");
+	ids[50] = 50;
+	binder.bind(0, ids, AbstractBinder::PD_IN);
+	assert (insert.executeBatch(binder.getBindArray(), 1, ids.size()) == ids.size());
+	assert (queryInt(_handle, "SELECT count(*) FROM batch_error") == 100);
+}
+
+
+void StatementExecutorTest::testStatementCacheCapacity()
+{
+	if (!_connected)
+	{
+		std::cout << "test skipped." << std::endl;
+		return;
+	}
+
+	StatementCache& cache = _handle.statementCache();
+	cache.setCapacity(_handle, 2);
+	for (int i = 0; i < 5; ++i)
+		assert (queryInt(_handle, "SELECT " + NumberFormatter::format(i)) == i);
+	assert (cache.size() == 2);
+
+	// the statement counting them is one of the two
+	assert (queryInt(_handle, "SELECT count(*) FROM pg_prepared_statements") == 2);
+
+	cache.setCapacity(_handle, 0);
+	assert (cache.size() == 0);
+	assert (queryInt(_handle, "SELECT count(*) FROM pg_prepared_statements") == 1);
+}
+
+
+void StatementExecutorTest::setUp()
+{
+	// A failed connection is reported by its status, not by an exception.
+	_handle.connect(CONNINFO);
+	if (PQstatus(_handle) == CONNECTION_OK)
+		_connected = true;
+	else
+		std::cout << "Couldn't connect to localhost:5432. ";
+}
+
+
+void StatementExecutorTest::tearDown()
+{
+	_handle.close();
+	_connected = false;
+}
+
+
+CppUnit::Test* StatementExecutorTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("StatementExecutorTest");
+
+	CppUnit_addTest(pSuite, StatementExecutorTest, testSingleRowMode);
+	CppUnit_addTest(pSuite, StatementExecutorTest, testEarlyFinish);
+	CppUnit_addTest(pSuite, StatementExecutorTest, testExecuteBatch);
+	CppUnit_addTest(pSuite, StatementExecutorTest, testExecuteBatchError);
+	CppUnit_addTest(pSuite, StatementExecutorTest, testStatementCacheCapacity);
+
+	return pSuite;
+}
@@ -0,0 +1,70 @@
+//
+// StatementExecutorTest.h
+//
+// $Id: //poco/1.4/Data/PgSQL/testsuite/src/StatementExecutorTest.h#1 $
+//
+// Definition of the StatementExecutorTest class.
+//
+// Copyright (c) 2008, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef StatementExecutorTest_INCLUDED
+#define StatementExecutorTest_INCLUDED
+
+
+#include "Poco/Data/PgSQL/PgSQL.h"
+#include "Poco/Data/PgSQL/SessionHandle.h"
+#include "CppUnit/TestCase.h"
+
+
+class StatementExecutorTest: public CppUnit::TestCase
+	/// Executes statements on a PostgreSQL server on localhost:5432,
+	/// database and user "postgres". The tests are skipped if no
+	/// server is running.
+{
+public:
+	StatementExecutorTest(const std::string& name);
+	~StatementExecutorTest();
+
+	void testSingleRowMode();
+	void testEarlyFinish();
+	void testExecuteBatch();
+	void testExecuteBatchError();
+	void testStatementCacheCapacity();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+	Poco::Data::PgSQL::SessionHandle _handle;
+	bool _connected;
+};
+
+
+#endif // StatementExecutorTest_INCLUDED
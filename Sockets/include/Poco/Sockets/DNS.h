@@ -44,8 +44,6 @@
 #include "Poco/Sockets/SocketDefs.h"
 #include "Poco/Sockets/Address.h"
 #include "Poco/Sockets/HostEntry.h"
-#include "Poco/Mutex.h"
-#include <map>
 
 
 namespace Poco {
@@ -56,7 +54,10 @@ class Sockets_API DNS
 	/// This class provides an interface to the
 	/// domain name service.
 	///
-	/// An internal DNS cache is used to speed up name lookups.
+	/// Lookups go through the default Resolver, which caches
+	/// results according to their time-to-live and never blocks
+	/// lookups of other names while a name is being resolved.
+	/// See the Resolver class for details.
 {
 public:
 	static HostEntry hostByName(const std::string& hostname);
@@ -117,7 +118,7 @@ public:
 		/// Throws an IOException in case of any other error.
 
 	static void flushCache();
-		/// Flushes the internal DNS cache.
+		/// Flushes the cache of the default Resolver.
 
 protected:
 	static int lastError();
@@ -125,12 +126,14 @@ protected:
 		
 	static void error(int code, const std::string& arg);
 		/// Throws an exception according to the error code.
-		
-private:
-	typedef std::map<std::string, HostEntry> DNSCache;
-	
-	static DNSCache _cache;
-	static Poco::FastMutex _mutex;
+
+#if defined(POCO_HAVE_ADDRINFO)
+	static void aierror(int code, const std::string& arg);
+		/// Throws an exception according to the getaddrinfo()
+		/// or getnameinfo() error code.
+#endif
+
+	friend class SystemResolverBackend;
 };
 
 
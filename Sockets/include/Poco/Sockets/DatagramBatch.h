@@ -0,0 +1,215 @@
+//
+// DatagramBatch.h
+//
+// $Id: //poco/svn/Net/include/Poco/Net/DatagramBatch.h#1 $
+//
+// Library: Net
+// Package: Sockets
+// Module:  DatagramSocket
+//
+// Definition of the DatagramBatch class.
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Sockets_DatagramBatch_INCLUDED
+#define Sockets_DatagramBatch_INCLUDED
+
+
+#include "Poco/Sockets/Sockets.h"
+#include "Poco/Sockets/SocketAddress.h"
+#include <vector>
+
+
+namespace Poco {
+namespace Sockets {
+
+
+class Sockets_API DatagramBatch
+	/// DatagramBatch is a pool of preallocated datagram slots
+	/// used by DatagramSocket::receiveBatch() and
+	/// DatagramSocket::sendBatch().
+	///
+	/// Each slot consists of a payload buffer of fixed size,
+	/// the length of the datagram stored in it, and the
+	/// address of its peer. All memory is allocated once in
+	/// the constructor, so moving datagrams through a batch
+	/// does not allocate; peer addresses are kept in their
+	/// native form and only converted into a SocketAddress
+	/// when address() is called.
+	///
+	/// A batch must not be shared between threads that use it
+	/// concurrently.
+{
+public:
+	DatagramBatch(std::size_t capacity, std::size_t bufferSize);
+		/// Creates a DatagramBatch with capacity slots, each
+		/// holding a datagram of up to bufferSize bytes.
+
+	~DatagramBatch();
+		/// Destroys the DatagramBatch.
+
+	std::size_t capacity() const;
+		/// Returns the number of slots in the batch.
+
+	std::size_t bufferSize() const;
+		/// Returns the size of each slot's payload buffer.
+
+	char* buffer(std::size_t index);
+		/// Returns a pointer to the payload buffer of the given slot.
+
+	const char* buffer(std::size_t index) const;
+		/// Returns a pointer to the payload buffer of the given slot.
+
+	int length(std::size_t index) const;
+		/// Returns the length of the datagram in the given slot.
+
+	void setLength(std::size_t index, int length);
+		/// Sets the length of the datagram in the given slot.
+		/// The length must not exceed bufferSize().
+
+	SocketAddress address(std::size_t index) const;
+		/// Returns the peer address of the given slot.
+		///
+		/// After a receive, this is the address of the sender.
+		/// Throws an InvalidAccessException if the slot has no
+		/// address.
+
+	bool hasAddress(std::size_t index) const;
+		/// Returns true if the given slot has a peer address.
+
+	void setAddress(std::size_t index, const SocketAddress& address);
+		/// Sets the destination address for the given slot.
+
+	void clearAddress(std::size_t index);
+		/// Removes the peer address from the given slot.
+		/// Datagrams in slots without an address are sent to
+		/// the address the socket is connected to.
+
+	void assign(std::size_t index, const void* data, int length);
+		/// Copies length bytes from data into the given slot.
+
+	void assign(std::size_t index, const void* data, int length, const SocketAddress& address);
+		/// Copies length bytes from data into the given slot
+		/// and sets the slot's destination address.
+
+private:
+	DatagramBatch();
+	DatagramBatch(const DatagramBatch&);
+	DatagramBatch& operator = (const DatagramBatch&);
+
+	struct AddressSlot
+	{
+		union
+		{
+			struct sockaddr sa;
+			char data[SocketAddress::MAX_ADDRESS_LENGTH];
+		} addr;
+		poco_socklen_t length;
+	};
+
+	std::size_t              _capacity;
+	std::size_t              _bufferSize;
+	std::vector<char>        _buffers;
+	std::vector<int>         _lengths;
+	std::vector<AddressSlot> _addresses;
+#if POCO_OS == POCO_OS_LINUX
+	std::vector<struct iovec>   _iovecs;
+	std::vector<struct mmsghdr> _headers;
+#endif
+
+	friend class SocketImpl;
+};
+
+
+//
+// inlines
+//
+inline std::size_t DatagramBatch::capacity() const
+{
+	return _capacity;
+}
+
+
+inline std::size_t DatagramBatch::bufferSize() const
+{
+	return _bufferSize;
+}
+
+
+inline char* DatagramBatch::buffer(std::size_t index)
+{
+	poco_assert_dbg (index < _capacity);
+
+	return &_buffers[index*_bufferSize];
+}
+
+
+inline const char* DatagramBatch::buffer(std::size_t index) const
+{
+	poco_assert_dbg (index < _capacity);
+
+	return &_buffers[index*_bufferSize];
+}
+
+
+inline int DatagramBatch::length(std::size_t index) const
+{
+	poco_assert_dbg (index < _capacity);
+
+	return _lengths[index];
+}
+
+
+inline void DatagramBatch::setLength(std::size_t index, int length)
+{
+	poco_assert (index < _capacity && length >= 0 && std::size_t(length) <= _bufferSize);
+
+	_lengths[index] = length;
+}
+
+
+inline bool DatagramBatch::hasAddress(std::size_t index) const
+{
+	poco_assert_dbg (index < _capacity);
+
+	return _addresses[index].length != 0;
+}
+
+
+inline void DatagramBatch::clearAddress(std::size_t index)
+{
+	poco_assert (index < _capacity);
+
+	_addresses[index].length = 0;
+}
+
+
+} } // namespace Poco::Sockets
+
+
+#endif // Sockets_DatagramBatch_INCLUDED
@@ -42,6 +42,7 @@
 
 #include "Poco/Sockets/Sockets.h"
 #include "Poco/Sockets/Socket.h"
+#include "Poco/Sockets/DatagramBatch.h"
 
 
 namespace Poco {
@@ -102,6 +103,21 @@ public:
 		///
 		/// Cannot be used together with connect().
 
+	void bind(const SocketAddress& address, bool reuseAddress, bool reusePort);
+		/// Bind a local address to the socket.
+		///
+		/// If reuseAddress is true, sets the SO_REUSEADDR
+		/// socket option. If reusePort is true, sets the
+		/// SO_REUSEPORT socket option. This allows several
+		/// sockets, typically each owned by its own thread, to
+		/// bind to the same port; the kernel then distributes
+		/// incoming datagrams among them by sender address.
+		///
+		/// Throws a NotImplementedException if reusePort is
+		/// true and the platform does not support SO_REUSEPORT.
+		///
+		/// Cannot be used together with connect().
+
 	int sendBytes(const void* buffer, int length, int flags = 0);
 		/// Sends the contents of the given buffer through
 		/// the socket.
@@ -129,6 +145,33 @@ public:
 		///
 		/// Returns the number of bytes received.
 
+	int sendBatch(DatagramBatch& batch, std::size_t count, int flags = 0);
+		/// Sends the datagrams stored in the first count slots
+		/// of batch. Each datagram is sent to the address of its
+		/// slot, or, if the slot has no address, to the address
+		/// the socket is connected to.
+		///
+		/// On Linux, all datagrams are sent with a single
+		/// sendmmsg() system call.
+		///
+		/// Returns the number of datagrams sent. For a non-blocking
+		/// socket, this may be less than count.
+
+	int receiveBatch(DatagramBatch& batch, int flags = 0);
+		/// Receives up to batch.capacity() datagrams into the
+		/// slots of batch. The length and the sender address
+		/// of each datagram are stored in its slot, so the batch
+		/// can be passed to sendBatch() to reply to all senders.
+		///
+		/// Waits (subject to the receive timeout) for the first
+		/// datagram only; any further datagrams already queued
+		/// are returned along with it. On Linux, this takes a
+		/// single recvmmsg() system call.
+		///
+		/// Returns the number of datagrams received. Throws a
+		/// TimeoutException if no datagram arrives within the
+		/// receive timeout.
+
 	void setBroadcast(bool flag);
 		/// Sets the value of the SO_BROADCAST socket option.
 		///
@@ -70,11 +70,14 @@ protected:
 	HostEntryImpl(struct hostent* entry);
 		/// Creates the HostEntry from the data in a hostent structure.
 
-#if defined(_WIN32) && defined(POCO_HAVE_IPv6)
+#if defined(POCO_HAVE_ADDRINFO)
 	HostEntryImpl(struct addrinfo* info);
-		/// Creates the HostEntry from the data in a Windows addrinfo structure.
+		/// Creates the HostEntry from the data in an addrinfo structure.
 #endif
 
+	HostEntryImpl(const std::string& name, const AddressList& addresses, const AliasList& aliases);
+		/// Creates the HostEntry from the given name, addresses and aliases.
+
 	~HostEntryImpl();
 		/// Destroys the HostEntryImpl.
 
@@ -113,11 +116,15 @@ public:
 	HostEntry(struct hostent* entry);
 		/// Creates the HostEntry from the data in a hostent structure.
 
-#if defined(_WIN32) && defined(POCO_HAVE_IPv6)
+#if defined(POCO_HAVE_ADDRINFO)
 	HostEntry(struct addrinfo* info);
-		/// Creates the HostEntry from the data in a Windows addrinfo structure.
+		/// Creates the HostEntry from the data in an addrinfo structure.
 #endif
 
+	HostEntry(const std::string& name, const AddressList& addresses, const AliasList& aliases = AliasList());
+		/// Creates the HostEntry from the given canonical name,
+		/// addresses and alias names.
+
 	HostEntry(const HostEntry& entry);
 		/// Creates the HostEntry by copying another one.
 
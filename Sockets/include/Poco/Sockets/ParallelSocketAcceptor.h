@@ -0,0 +1,155 @@
+//
+// ParallelSocketAcceptor.h
+//
+// $Id: //poco/svn/Net/include/Poco/Net/ParallelSocketAcceptor.h#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  ParallelSocketAcceptor
+//
+// Definition of the ParallelSocketAcceptor class.
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Sockets_ParallelSocketAcceptor_INCLUDED
+#define Sockets_ParallelSocketAcceptor_INCLUDED
+
+
+#include "Poco/Sockets/Sockets.h"
+#include "Poco/Sockets/ParallelSocketReactor.h"
+#include "Poco/Sockets/SocketAcceptor.h"
+#include "Poco/Environment.h"
+#include <vector>
+
+
+namespace Poco {
+namespace Sockets {
+
+
+template <class ServiceHandler, class SR = SocketReactor>
+class ParallelSocketAcceptor: public SocketAcceptor<ServiceHandler>
+	/// This class implements the Acceptor part of the
+	/// Acceptor-Connector design pattern, handing out the
+	/// accepted connections to a number of reactors that
+	/// each run in their own thread.
+	///
+	/// The ParallelSocketAcceptor waits for connection requests
+	/// on a main SocketReactor (see SocketAcceptor). Each accepted
+	/// connection is assigned to one of its ParallelSocketReactors,
+	/// in round-robin order, and a ServiceHandler is created for
+	/// it on that reactor. Each of the reactors owns its own
+	/// PollSet, so the connections are served on as many threads
+	/// as there are reactors.
+	///
+	/// The ServiceHandler class must provide a constructor that
+	/// takes a StreamSocket and a SocketReactor as arguments,
+	/// e.g.:
+	///     MyServiceHandler(const StreamSocket& socket, SocketReactor& reactor)
+	///
+	/// When the ServiceHandler is done, it must destroy itself.
+{
+public:
+	typedef ParallelSocketReactor<SR> ParallelReactor;
+
+	explicit ParallelSocketAcceptor(ServerSocket& socket, unsigned threads = Poco::Environment::processorCount()):
+		SocketAcceptor<ServiceHandler>(socket),
+		_next(0)
+		/// Creates a ParallelSocketAcceptor using the given ServerSocket
+		/// and number of reactor threads.
+	{
+		init(threads);
+	}
+
+	ParallelSocketAcceptor(ServerSocket& socket, SocketReactor& reactor, unsigned threads = Poco::Environment::processorCount()):
+		SocketAcceptor<ServiceHandler>(socket),
+		_next(0)
+		/// Creates a ParallelSocketAcceptor using the given ServerSocket
+		/// and number of reactor threads, and registers it with
+		/// the given SocketReactor.
+	{
+		init(threads);
+		this->registerAcceptor(reactor);
+	}
+
+	~ParallelSocketAcceptor()
+		/// Destroys the ParallelSocketAcceptor and stops its reactors.
+	{
+		try
+		{
+			this->unregisterAcceptor();
+		}
+		catch (...)
+		{
+		}
+	}
+
+	std::size_t reactorCount() const
+		/// Returns the number of reactor threads.
+	{
+		return _reactors.size();
+	}
+
+protected:
+	ServiceHandler* createServiceHandler(StreamSocket& socket)
+		/// Creates the ServiceHandler on the next reactor.
+	{
+		return new ServiceHandler(socket, *nextReactor());
+	}
+
+	SocketReactor* nextReactor()
+		/// Returns the reactor the next connection is assigned to.
+	{
+		SocketReactor* pReactor = _reactors[_next].get();
+		if (++_next == _reactors.size()) _next = 0;
+		return pReactor;
+	}
+
+private:
+	typedef std::vector<typename ParallelReactor::Ptr> ReactorVec;
+
+	void init(unsigned threads)
+	{
+		if (threads == 0) threads = 1;
+		_reactors.reserve(threads);
+		for (unsigned i = 0; i < threads; ++i)
+			_reactors.push_back(new ParallelReactor);
+	}
+
+	ParallelSocketAcceptor();
+	ParallelSocketAcceptor(const ParallelSocketAcceptor&);
+	ParallelSocketAcceptor& operator = (const ParallelSocketAcceptor&);
+
+	ReactorVec  _reactors;
+	std::size_t _next;
+};
+
+
+} } // namespace Poco::Sockets
+
+
+#endif // Sockets_ParallelSocketAcceptor_INCLUDED
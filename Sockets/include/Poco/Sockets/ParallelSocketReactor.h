@@ -0,0 +1,103 @@
+//
+// ParallelSocketReactor.h
+//
+// $Id: //poco/svn/Net/include/Poco/Net/ParallelSocketReactor.h#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  ParallelSocketReactor
+//
+// Definition of the ParallelSocketReactor class.
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Sockets_ParallelSocketReactor_INCLUDED
+#define Sockets_ParallelSocketReactor_INCLUDED
+
+
+#include "Poco/Sockets/Sockets.h"
+#include "Poco/Sockets/SocketReactor.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Thread.h"
+
+
+namespace Poco {
+namespace Sockets {
+
+
+template <class SR>
+class ParallelSocketReactor: public SR
+	/// A SocketReactor that runs in its own thread.
+	///
+	/// The thread is started by the constructor, and the
+	/// reactor is stopped and joined by the destructor.
+	/// Used by the ParallelSocketAcceptor to distribute
+	/// connections over several reactors.
+{
+public:
+	typedef Poco::SharedPtr<ParallelSocketReactor> Ptr;
+
+	ParallelSocketReactor()
+		/// Creates the ParallelSocketReactor and starts its thread.
+	{
+		_thread.start(*this);
+	}
+
+	explicit ParallelSocketReactor(const Poco::Timespan& timeout):
+		SR(timeout)
+		/// Creates the ParallelSocketReactor, using the given
+		/// timeout, and starts its thread.
+	{
+		_thread.start(*this);
+	}
+
+	~ParallelSocketReactor()
+		/// Stops the reactor and waits for its thread to terminate.
+	{
+		try
+		{
+			this->stop();
+			_thread.join();
+		}
+		catch (...)
+		{
+		}
+	}
+
+private:
+	ParallelSocketReactor(const ParallelSocketReactor&);
+	ParallelSocketReactor& operator = (const ParallelSocketReactor&);
+
+	Poco::Thread _thread;
+};
+
+
+} } // namespace Poco::Sockets
+
+
+#endif // Sockets_ParallelSocketReactor_INCLUDED
@@ -0,0 +1,153 @@
+//
+// PollSet.h
+//
+// $Id: //poco/svn/Net/include/Poco/Net/PollSet.h#1 $
+//
+// Library: Net
+// Package: Sockets
+// Module:  PollSet
+//
+// Definition of the PollSet class.
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#ifndef Sockets_PollSet_INCLUDED
+#define Sockets_PollSet_INCLUDED
+
+
+#include "Poco/Sockets/Sockets.h"
+#include "Poco/Sockets/Socket.h"
+#include <vector>
+#include <utility>
+
+
+namespace Poco {
+namespace Sockets {
+
+
+class PollSetImpl;
+
+
+class Sockets_API PollSet
+	/// A PollSet holds a persistent set of sockets, each
+	/// registered with an interest mask made up of
+	/// Socket::SELECT_READ, Socket::SELECT_WRITE and
+	/// Socket::SELECT_ERROR.
+	///
+	/// Unlike Socket::poll() and Socket::select(), which rebuild
+	/// their descriptor sets on every call, registration with a
+	/// PollSet is incremental: sockets are added, updated and
+	/// removed individually, and poll() only reports the sockets
+	/// that are actually ready.
+	///
+	/// On Linux, the PollSet is backed by epoll, so the cost of
+	/// poll() depends on the number of ready sockets, not on the
+	/// number of registered ones. Sockets can be watched in
+	/// level-triggered (default) or edge-triggered mode.
+	/// On other platforms providing poll(), a persistent pollfd
+	/// array is used instead; that backend only supports
+	/// level-triggered mode.
+	///
+	/// add(), update() and remove() may be called from other
+	/// threads while a poll() is in progress. poll() itself must
+	/// only be called from one thread at a time.
+{
+public:
+	enum Trigger
+		/// The trigger mode of the PollSet.
+	{
+		TRIGGER_LEVEL, /// A socket is reported for as long as it is ready.
+		TRIGGER_EDGE   /// A socket is only reported when it becomes ready.
+	};
+
+	typedef std::pair<Socket, int> SocketMode;
+	typedef std::vector<SocketMode> SocketModeList;
+
+	PollSet(Trigger trigger = TRIGGER_LEVEL);
+		/// Creates an empty PollSet using the given trigger mode.
+		///
+		/// Throws a NotImplementedException if the trigger mode
+		/// is not supported on this platform.
+
+	~PollSet();
+		/// Destroys the PollSet.
+
+	void add(const Socket& socket, int mode);
+		/// Registers the socket with the given interest mask.
+		///
+		/// Throws an InvalidArgumentException if the socket is
+		/// already registered.
+
+	void update(const Socket& socket, int mode);
+		/// Changes the interest mask of a registered socket.
+		///
+		/// Throws a NotFoundException if the socket is not registered.
+
+	void remove(const Socket& socket);
+		/// Removes the socket from the PollSet.
+		/// Does nothing if the socket is not registered.
+		///
+		/// Sockets are identified by their SocketImpl, so a socket
+		/// that has been closed can still be removed.
+
+	bool has(const Socket& socket) const;
+		/// Returns true iff the socket is registered.
+
+	bool empty() const;
+		/// Returns true iff no sockets are registered.
+
+	std::size_t count() const;
+		/// Returns the number of registered sockets.
+
+	void clear();
+		/// Removes all sockets from the PollSet.
+
+	Trigger trigger() const;
+		/// Returns the trigger mode of the PollSet.
+
+	const SocketModeList& poll(const Poco::Timespan& timeout);
+		/// Waits until at least one of the registered sockets is
+		/// ready or the timeout expires, and returns the ready
+		/// sockets along with the subset of their interest mask
+		/// that is ready. An empty list is returned on timeout.
+		///
+		/// The returned list is owned by the PollSet and is
+		/// overwritten by the next call to poll().
+
+private:
+	PollSet(const PollSet&);
+	PollSet& operator = (const PollSet&);
+
+	PollSetImpl*   _pImpl;
+	SocketModeList _ready;
+};
+
+
+} } // namespace Poco::Sockets
+
+
+#endif // Sockets_PollSet_INCLUDED
@@ -0,0 +1,275 @@
+//
+// Resolver.h
+//
+// $Id: //poco/svn/Net/include/Poco/Net/Resolver.h#1 $
+//
+// Library: Net
+// Package: Address
+// Module:  DNS
+//
+// Definition of the Resolver class.
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Sockets_Resolver_INCLUDED
+#define Sockets_Resolver_INCLUDED
+
+
+#include "Poco/Sockets/Sockets.h"
+#include "Poco/Sockets/HostEntry.h"
+#include "Poco/Sockets/Address.h"
+#include "Poco/Sockets/ResolverBackend.h"
+#include "Poco/ActiveResult.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Exception.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Timespan.h"
+#include "Poco/Mutex.h"
+#include "Poco/Condition.h"
+#include <map>
+
+
+namespace Poco {
+namespace Sockets {
+
+
+class Sockets_API Resolver
+	/// Resolver is a thread-safe, caching host name resolver.
+	///
+	/// Lookups are performed by a ResolverBackend, by default
+	/// a SystemResolverBackend based on getaddrinfo(). Results
+	/// are cached for their time-to-live. Answers stating that
+	/// a host does not exist or has no address are cached for
+	/// the (usually shorter) negative time-to-live; other errors
+	/// are not cached.
+	///
+	/// The cache is divided into shards, each protected by its
+	/// own mutex, and no lock is held while the backend performs
+	/// a lookup. A slow lookup therefore only delays the threads
+	/// asking for the same name. Concurrent lookups for the same
+	/// name are coalesced into a single backend request.
+	///
+	/// An entry that has expired, but by less than the maximum
+	/// staleness, is still returned to callers while a refresh
+	/// runs in the background. Only when the maximum staleness
+	/// is exceeded as well do callers wait for a new lookup.
+	///
+	/// Asynchronous lookups and background refreshes run in
+	/// threads taken from the default ThreadPool. If no thread is
+	/// available, an asynchronous lookup is performed in the
+	/// calling thread and a refresh is postponed to the next
+	/// request for the entry.
+	///
+	/// The time-to-live settings are not synchronized and
+	/// should be changed before lookups start.
+	///
+	/// Usage example:
+	///     Resolver::Result result = resolver.hostByNameAsync("www.appinf.com");
+	///     ...
+	///     HostEntry entry = Resolver::get(result);
+{
+public:
+	typedef Poco::ActiveResult<HostEntry> Result;
+		/// The future returned by the asynchronous lookup methods.
+
+	Resolver();
+		/// Creates a Resolver using a SystemResolverBackend.
+
+	explicit Resolver(ResolverBackend* pBackend);
+		/// Creates a Resolver using the given backend.
+		/// The Resolver takes ownership of the backend.
+
+	~Resolver();
+		/// Waits for all asynchronous lookups and refreshes
+		/// to finish, then destroys the Resolver.
+
+	HostEntry hostByName(const std::string& hostname);
+		/// Returns the HostEntry for the host with the given name,
+		/// from the cache if possible.
+		///
+		/// If the name is not cached and no lookup for it is in
+		/// progress, the lookup is performed in the calling thread.
+		///
+		/// Throws a HostNotFoundException if the host cannot be
+		/// found, a NoAddressFoundException if it has no address,
+		/// or whatever exception the backend throws otherwise.
+
+	HostEntry hostByAddress(const Address& address);
+		/// Returns the HostEntry for the host with the given
+		/// address, from the cache if possible.
+		///
+		/// See hostByName() for the exceptions thrown.
+
+	Result hostByNameAsync(const std::string& hostname);
+		/// Starts a lookup of the given host name in a background
+		/// thread and returns a Result for it. Cached entries are
+		/// returned in an already completed Result.
+		///
+		/// Use get() to wait for the Result and obtain the
+		/// HostEntry.
+
+	Result hostByAddressAsync(const Address& address);
+		/// Starts a lookup of the given address in a background
+		/// thread and returns a Result for it. Cached entries are
+		/// returned in an already completed Result.
+
+	static HostEntry get(Result& result);
+		/// Waits for the given Result and returns its HostEntry,
+		/// or rethrows the exception the lookup failed with.
+
+	void setTTL(const Poco::Timespan& ttl);
+		/// Sets the default time-to-live for cached entries.
+		///
+		/// Only a custom ResolverBackend can set the time-to-live
+		/// of individual entries. The SystemResolverBackend does
+		/// not know the time-to-live of records, so all entries
+		/// it finds are cached for the default time-to-live.
+		///
+		/// The default is 60 seconds.
+
+	const Poco::Timespan& getTTL() const;
+		/// Returns the default time-to-live for cached entries.
+
+	void setNegativeTTL(const Poco::Timespan& ttl);
+		/// Sets the time-to-live for cached lookup failures.
+		///
+		/// The default is 5 seconds.
+
+	const Poco::Timespan& getNegativeTTL() const;
+		/// Returns the time-to-live for cached lookup failures.
+
+	void setMaxStale(const Poco::Timespan& maxStale);
+		/// Sets how long after its expiration an entry is still
+		/// served while being refreshed in the background.
+		/// A value of zero disables background refreshes.
+		///
+		/// The default is 5 minutes.
+
+	const Poco::Timespan& getMaxStale() const;
+		/// Returns how long after its expiration an entry is
+		/// still served while being refreshed.
+
+	void flush();
+		/// Removes all entries from the cache.
+		/// Lookups in progress are not affected.
+
+	std::size_t size() const;
+		/// Returns the number of cached entries, including
+		/// cached lookup failures.
+
+	static Resolver& defaultResolver();
+		/// Returns the Resolver used by the DNS class.
+
+private:
+	Resolver(const Resolver&);
+	Resolver& operator = (const Resolver&);
+
+	struct Entry
+	{
+		HostEntry                       hostEntry;
+		Poco::SharedPtr<Poco::Exception> pError;
+		Poco::Timestamp                 expires;
+		bool                            refreshing;
+	};
+
+	typedef std::map<std::string, Entry>  EntryMap;
+	typedef std::map<std::string, Result> PendingMap;
+
+	struct Shard
+	{
+		mutable Poco::FastMutex mutex;
+		EntryMap                entries;
+		PendingMap              pending;
+	};
+
+	enum
+	{
+		SHARD_COUNT = 16
+	};
+
+	Result lookup(const std::string& key, bool async);
+		/// Returns the cached entry for key, joins a lookup
+		/// for key already in progress, or starts a new one.
+
+	void resolve(const std::string& key);
+		/// Asks the backend for key, stores the answer in the
+		/// cache and completes the pending Result, if any.
+
+	HostEntry query(const std::string& key, Poco::Timespan& ttl);
+		/// Passes key to the appropriate backend method.
+
+	bool startTask(const std::string& key);
+		/// Runs resolve(key) in a thread from the default
+		/// ThreadPool. Returns false if no thread is available.
+
+	void taskDone();
+
+	Shard& shardFor(const std::string& key);
+
+	static void complete(Result& result, const Entry& entry);
+	static std::string addressKey(const Address& address);
+
+	class LookupTask;
+	friend class LookupTask;
+
+	Poco::SharedPtr<ResolverBackend> _pBackend;
+	Poco::Timespan                   _ttl;
+	Poco::Timespan                   _negativeTTL;
+	Poco::Timespan                   _maxStale;
+	Shard                            _shards[SHARD_COUNT];
+	Poco::FastMutex                  _taskMutex;
+	Poco::Condition                  _tasksDone;
+	int                              _tasks;
+};
+
+
+//
+// inlines
+//
+inline const Poco::Timespan& Resolver::getTTL() const
+{
+	return _ttl;
+}
+
+
+inline const Poco::Timespan& Resolver::getNegativeTTL() const
+{
+	return _negativeTTL;
+}
+
+
+inline const Poco::Timespan& Resolver::getMaxStale() const
+{
+	return _maxStale;
+}
+
+
+} } // namespace Poco::Sockets
+
+
+#endif // Sockets_Resolver_INCLUDED
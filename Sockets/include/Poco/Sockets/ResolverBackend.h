@@ -0,0 +1,128 @@
+//
+// ResolverBackend.h
+//
+// $Id: //poco/svn/Net/include/Poco/Net/ResolverBackend.h#1 $
+//
+// Library: Net
+// Package: Address
+// Module:  DNS
+//
+// Definition of the ResolverBackend class.
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Sockets_ResolverBackend_INCLUDED
+#define Sockets_ResolverBackend_INCLUDED
+
+
+#include "Poco/Sockets/Sockets.h"
+#include "Poco/Sockets/HostEntry.h"
+#include "Poco/Sockets/Address.h"
+#include "Poco/Timespan.h"
+#include "Poco/Mutex.h"
+
+
+namespace Poco {
+namespace Sockets {
+
+
+class Sockets_API ResolverBackend
+	/// ResolverBackend is the interface of the name service
+	/// a Resolver uses to perform the actual lookups.
+	///
+	/// A Resolver calls its backend concurrently from
+	/// multiple threads, so implementations must be thread-safe.
+{
+public:
+	ResolverBackend();
+		/// Creates the ResolverBackend.
+
+	virtual ~ResolverBackend();
+		/// Destroys the ResolverBackend.
+
+	virtual HostEntry hostByName(const std::string& hostname, Poco::Timespan& ttl) = 0;
+		/// Looks up the host with the given name.
+		///
+		/// On entry, ttl holds the Resolver's default time-to-live.
+		/// Implementations that know the time-to-live of the
+		/// records found may change it.
+		///
+		/// Throws a HostNotFoundException or a NoAddressFoundException
+		/// if the name does not exist or has no address. The Resolver
+		/// caches these answers for its negative time-to-live.
+		/// Any other exception is treated as a temporary failure
+		/// and not cached.
+
+	virtual HostEntry hostByAddress(const Address& address, Poco::Timespan& ttl) = 0;
+		/// Looks up the host with the given address.
+		///
+		/// See hostByName() for the meaning of ttl and the
+		/// exceptions thrown.
+
+private:
+	ResolverBackend(const ResolverBackend&);
+	ResolverBackend& operator = (const ResolverBackend&);
+};
+
+
+class Sockets_API SystemResolverBackend: public ResolverBackend
+	/// The default ResolverBackend, based on the system's
+	/// getaddrinfo() and getnameinfo() functions.
+	///
+	/// On platforms lacking these, gethostbyname() and
+	/// gethostbyaddr() are used instead. As these are not
+	/// reentrant, such lookups are serialized.
+	///
+	/// getaddrinfo() does not report aliases. If the name looked
+	/// up is not the canonical name, it is returned as the only
+	/// alias, as gethostbyname() does for a CNAME.
+	///
+	/// The system resolver does not report the time-to-live
+	/// of records, so ttl is never changed.
+{
+public:
+	SystemResolverBackend();
+		/// Creates the SystemResolverBackend.
+
+	~SystemResolverBackend();
+		/// Destroys the SystemResolverBackend.
+
+	HostEntry hostByName(const std::string& hostname, Poco::Timespan& ttl);
+	HostEntry hostByAddress(const Address& address, Poco::Timespan& ttl);
+
+private:
+#if !defined(POCO_HAVE_ADDRINFO)
+	static Poco::FastMutex _mutex;
+#endif
+};
+
+
+} } // namespace Poco::Sockets
+
+
+#endif // Sockets_ResolverBackend_INCLUDED
@@ -305,6 +305,11 @@ public:
 	static bool supportsIPv6();
 		/// Returns true if the system supports IPv6.
 
+	static SocketBuf makeBuffer(void* buffer, std::size_t length);
+		/// Returns a SocketBuf describing the given memory,
+		/// for use with the scatter/gather versions of
+		/// sendBytes() and receiveBytes().
+
 protected:
 	Socket(SocketImpl* pImpl);
 		/// Creates the Socket and attaches the given SocketImpl.
@@ -624,6 +629,20 @@ inline bool Socket::supportsIPv6()
 }
 
 
+inline SocketBuf Socket::makeBuffer(void* buffer, std::size_t length)
+{
+	SocketBuf buf;
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	buf.buf = reinterpret_cast<char*>(buffer);
+	buf.len = static_cast<ULONG>(length);
+#else
+	buf.iov_base = buffer;
+	buf.iov_len  = length;
+#endif
+	return buf;
+}
+
+
 } } // namespace Poco::Sockets
 
 
@@ -97,6 +97,7 @@
 #		include <sys/select.h>
 #	endif
 #	include <sys/ioctl.h>
+#	include <sys/uio.h>
 #	if defined(POCO_OS_FAMILY_VMS)
 #		include <inet.h>
 #	else
@@ -181,6 +182,11 @@
 #endif
 
 
+#if defined(POCO_OS_FAMILY_UNIX) || (defined(_WIN32) && defined(POCO_HAVE_IPv6))
+#	define POCO_HAVE_ADDRINFO   1
+#endif
+
+
 #if defined(POCO_HAVE_SALEN)
 #	define poco_set_sa_len(pSA, len) (pSA)->sa_len   = (len)
 #	define poco_set_sin_len(pSA)     (pSA)->sin_len  = sizeof(struct sockaddr_in)
@@ -212,4 +218,26 @@
 #endif
 
 
+#include <vector>
+
+
+namespace Poco {
+namespace Sockets {
+
+
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	typedef WSABUF SocketBuf;
+#else
+	typedef struct iovec SocketBuf;
+#endif
+	/// A buffer descriptor for scatter/gather I/O.
+	/// Use Socket::makeBuffer() to initialize one portably.
+
+typedef std::vector<SocketBuf> SocketBufVec;
+	/// A list of buffers for scatter/gather I/O.
+
+
+} } // namespace Poco::Sockets
+
+
 #endif // Sockets_SocketDefs_INCLUDED
@@ -45,12 +45,16 @@
 #include "Poco/Sockets/SocketAddress.h"
 #include "Poco/RefCountedObject.h"
 #include "Poco/Timespan.h"
+#include <istream>
 
 
 namespace Poco {
 namespace Sockets {
 
 
+class DatagramBatch;
+
+
 class Sockets_API SocketImpl: public Poco::RefCountedObject
 	/// This class encapsulates the Berkeley sockets API.
 	/// 
@@ -115,6 +119,18 @@ public:
 		///
 		/// If reuseAddress is true, sets the SO_REUSEADDR
 		/// socket option.
+
+	virtual void bind(const SocketAddress& address, bool reuseAddress, bool reusePort);
+		/// Bind a local address to the socket.
+		///
+		/// If reuseAddress is true, sets the SO_REUSEADDR
+		/// socket option. If reusePort is true, sets the
+		/// SO_REUSEPORT socket option, which lets several
+		/// sockets bind to the same address and port and
+		/// have the kernel distribute incoming datagrams or
+		/// connections among them. Throws a NotImplementedException
+		/// if reusePort is true and the platform does not
+		/// support SO_REUSEPORT.
 		
 	virtual void listen(int backlog = 64);
 		/// Puts the socket into listening state.
@@ -151,6 +167,40 @@ public:
 		/// in buffer. Up to length bytes are received.
 		///
 		/// Returns the number of bytes received.
+
+	virtual int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Sends the contents of the given buffers through
+		/// the socket with a single system call (sendmsg()
+		/// or WSASend()).
+		///
+		/// Returns the number of bytes sent, which may be
+		/// less than the total size of the buffers.
+
+	virtual int receiveBytes(SocketBufVec& buffers, int flags = 0);
+		/// Receives data from the socket and scatters it
+		/// over the given buffers with a single system call
+		/// (recvmsg() or WSARecv()), filling each buffer
+		/// before moving on to the next one.
+		///
+		/// Returns the number of bytes received.
+
+	virtual std::streamsize sendFile(const std::string& path, std::streamoff offset, std::streamsize count);
+		/// Sends count bytes (or, if count is negative, the rest)
+		/// of the file at path, starting at offset.
+		///
+		/// On Linux, the data is sent with sendfile() and never
+		/// copied to user space. On other platforms, the file is
+		/// read and sent through an intermediate buffer.
+		///
+		/// Returns the number of bytes sent. For a non-blocking
+		/// socket, this may be less than requested.
+
+	virtual std::streamsize sendFile(std::istream& istr, std::streamsize count);
+		/// Sends count bytes (or, if count is negative, everything
+		/// up to end of stream) read from the given stream, through
+		/// an intermediate buffer. The socket must be in blocking mode.
+		///
+		/// Returns the number of bytes sent.
 	
 	virtual int sendTo(const void* buffer, int length, const SocketAddress& address, int flags = 0);
 		/// Sends the contents of the given buffer through
@@ -165,6 +215,30 @@ public:
 		/// Stores the address of the sender in address.
 		///
 		/// Returns the number of bytes received.
+
+	virtual int sendBatch(DatagramBatch& batch, std::size_t count, int flags = 0);
+		/// Sends the datagrams in the first count slots of batch,
+		/// each to the slot's address, or to the connected peer
+		/// if the slot has no address.
+		///
+		/// On Linux, all datagrams are passed to the kernel with
+		/// a single sendmmsg() call. On other platforms, they
+		/// are sent one by one.
+		///
+		/// Returns the number of datagrams sent. For a non-blocking
+		/// socket, this may be less than count.
+
+	virtual int receiveBatch(DatagramBatch& batch, int flags = 0);
+		/// Receives up to batch.capacity() datagrams into the
+		/// slots of batch, storing their lengths and sender
+		/// addresses.
+		///
+		/// Blocks (subject to the receive timeout) until at least
+		/// one datagram is available, then returns all further
+		/// datagrams already queued without waiting for more.
+		/// On Linux, this takes a single recvmmsg() call.
+		///
+		/// Returns the number of datagrams received.
 	
 	virtual void sendUrgent(unsigned char data);
 		/// Sends one byte of urgent data through
@@ -431,6 +505,7 @@ private:
 	
 	friend class Socket;
 	friend class SecureSocketImpl;
+	friend class PollSetImpl;
 };
 
 
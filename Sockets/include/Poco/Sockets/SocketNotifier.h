@@ -0,0 +1,213 @@
+//
+// SocketNotifier.h
+//
+// $Id: //poco/svn/Net/include/Poco/Net/SocketNotifier.h#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  SocketNotifier
+//
+// Definition of the SocketNotifier class.
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Sockets_SocketNotifier_INCLUDED
+#define Sockets_SocketNotifier_INCLUDED
+
+
+#include "Poco/Sockets/Sockets.h"
+#include "Poco/Sockets/Socket.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/NotificationCenter.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Timespan.h"
+#include <set>
+
+
+namespace Poco {
+namespace Sockets {
+
+
+class SocketReactor;
+class SocketNotification;
+
+
+class Sockets_API SocketNotifier: public Poco::RefCountedObject
+	/// This class is used internally by SocketReactor
+	/// to notify registered event handlers of socket events.
+	///
+	/// It also keeps track of the socket's idle timeout
+	/// and the time of its last activity.
+{
+public:
+	explicit SocketNotifier(const Socket& socket);
+		/// Creates the SocketNotifier for the given socket.
+		
+	void addObserver(SocketReactor* pReactor, const Poco::AbstractObserver& observer);
+		/// Adds the given observer. 
+		
+	void removeObserver(SocketReactor* pReactor, const Poco::AbstractObserver& observer);
+		/// Removes the given observer. 
+		
+	bool hasObserver(const Poco::AbstractObserver& observer) const;
+		/// Returns true if the given observer is registered.
+
+	bool accepts(SocketNotification* pNotification);
+		/// Returns true if there is at least one observer for the given notification.
+		
+	void dispatch(SocketNotification* pNotification);
+		/// Dispatches the notification to all observers.
+		
+	bool hasObservers() const;
+		/// Returns true if there are subscribers.
+		
+	std::size_t countObservers() const;
+		/// Returns the number of subscribers;
+
+	int mode() const;
+		/// Returns the combination of Socket::SelectMode flags
+		/// the observers are interested in.
+
+	void setIdleTimeout(const Poco::Timespan& timeout);
+		/// Sets the idle timeout. Zero disables the idle timeout.
+
+	const Poco::Timespan& getIdleTimeout() const;
+		/// Returns the idle timeout.
+
+	void touch(const Poco::Timestamp& now);
+		/// Records activity on the socket.
+
+	const Poco::Timestamp& lastActivity() const;
+		/// Returns the time of the last activity on the socket.
+
+	void setDeadline(const Poco::Timestamp& deadline);
+		/// Records the deadline of the timer currently scheduled
+		/// for this socket in the reactor's timer wheel.
+
+	const Poco::Timestamp& getDeadline() const;
+		/// Returns the deadline of the currently scheduled timer.
+
+	Socket& socket();
+		/// Returns the socket.
+
+protected:
+	~SocketNotifier();
+		/// Destroys the SocketNotifier.
+
+private:
+	typedef std::multiset<SocketNotification*> EventSet;
+
+	EventSet                 _events;
+	Poco::NotificationCenter _nc;
+	Socket                   _socket;
+	int                      _mode;
+	Poco::Timespan           _idleTimeout;
+	Poco::Timestamp          _lastActivity;
+	Poco::Timestamp          _deadline;
+};
+
+
+//
+// inlines
+//
+inline bool SocketNotifier::accepts(SocketNotification* pNotification)
+{
+	return _events.find(pNotification) != _events.end();
+}
+
+
+inline bool SocketNotifier::hasObserver(const Poco::AbstractObserver& observer) const
+{
+	return _nc.hasObserver(observer);
+}
+
+
+inline bool SocketNotifier::hasObservers() const
+{
+	return _nc.hasObservers();
+}
+
+
+inline std::size_t SocketNotifier::countObservers() const
+{
+	return _nc.countObservers();
+}
+
+
+inline int SocketNotifier::mode() const
+{
+	return _mode;
+}
+
+
+inline void SocketNotifier::setIdleTimeout(const Poco::Timespan& timeout)
+{
+	_idleTimeout = timeout;
+}
+
+
+inline const Poco::Timespan& SocketNotifier::getIdleTimeout() const
+{
+	return _idleTimeout;
+}
+
+
+inline void SocketNotifier::touch(const Poco::Timestamp& now)
+{
+	_lastActivity = now;
+}
+
+
+inline const Poco::Timestamp& SocketNotifier::lastActivity() const
+{
+	return _lastActivity;
+}
+
+
+inline void SocketNotifier::setDeadline(const Poco::Timestamp& deadline)
+{
+	_deadline = deadline;
+}
+
+
+inline const Poco::Timestamp& SocketNotifier::getDeadline() const
+{
+	return _deadline;
+}
+
+
+inline Socket& SocketNotifier::socket()
+{
+	return _socket;
+}
+
+
+} } // namespace Poco::Sockets
+
+
+#endif // Sockets_SocketNotifier_INCLUDED
@@ -45,6 +45,11 @@
 
 
 namespace Poco {
+
+
+class FileInputStream;
+
+
 namespace Sockets {
 
 
@@ -133,6 +138,52 @@ public:
 		///
 		/// Throws a TimeoutException if a receive timeout has
 		/// been set and nothing is received within that interval.
+
+	int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Sends the contents of the given buffers through
+		/// the socket with a single system call, e.g. a
+		/// protocol header and its payload, without copying
+		/// them into one contiguous buffer first.
+		///
+		/// Returns the number of bytes sent, which may be
+		/// less than the total size of the buffers.
+
+	int receiveBytes(SocketBufVec& buffers, int flags = 0);
+		/// Receives data from the socket and scatters it over
+		/// the given buffers with a single system call, filling
+		/// each buffer before moving on to the next one.
+		///
+		/// Returns the number of bytes received.
+		/// A return value of 0 means a graceful shutdown
+		/// of the connection from the peer.
+		///
+		/// Throws a TimeoutException if a receive timeout has
+		/// been set and nothing is received within that interval.
+
+	std::streamsize sendFile(const std::string& path, std::streamoff offset = 0, std::streamsize count = -1);
+		/// Sends count bytes of the file at the given path,
+		/// starting at offset. If count is negative, the rest
+		/// of the file is sent.
+		///
+		/// On Linux, the file is sent with sendfile(), so its
+		/// contents are never copied to user space. On other
+		/// platforms, it is sent through an intermediate buffer.
+		///
+		/// Returns the number of bytes sent. For a non-blocking
+		/// socket, this may be less than requested; the caller
+		/// should continue at offset plus the returned value once
+		/// the socket is writable again.
+
+	std::streamsize sendFile(Poco::FileInputStream& istr, std::streamoff offset = 0, std::streamsize count = -1);
+		/// Sends count bytes read from the given stream, starting
+		/// at offset. If count is negative, everything up to the end
+		/// of the stream is sent.
+		///
+		/// The data is sent through an intermediate buffer. Use
+		/// the path-based overload to avoid the copy where supported.
+		/// The socket must be in blocking mode.
+		///
+		/// Returns the number of bytes sent.
 		/// Throws a NetException (or a subclass) in case of other errors.
 
 	void sendUrgent(unsigned char data);
@@ -0,0 +1,187 @@
+//
+// TimerWheel.h
+//
+// $Id: //poco/svn/Net/include/Poco/Net/TimerWheel.h#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  TimerWheel
+//
+// Definition of the TimerWheel class.
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Sockets_TimerWheel_INCLUDED
+#define Sockets_TimerWheel_INCLUDED
+
+
+#include "Poco/Sockets/Sockets.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Timespan.h"
+#include "Poco/Exception.h"
+#include <vector>
+#include <utility>
+
+
+namespace Poco {
+namespace Sockets {
+
+
+template <class K>
+class TimerWheel
+	/// A hashed timing wheel.
+	///
+	/// Timers are hashed by their deadline into a fixed number
+	/// of slots, each covering one tick of the wheel's resolution.
+	/// Scheduling a timer is O(1); advance() only visits the slots
+	/// for the ticks that have passed since the previous call, so
+	/// its cost is proportional to elapsed time and expired timers,
+	/// not to the number of scheduled timers.
+	///
+	/// Timers cannot be cancelled individually. Owners that need to
+	/// cancel or postpone a timer should keep the currently valid
+	/// deadline alongside the key, and ignore expired timers whose
+	/// deadline no longer matches (lazy cancellation).
+	///
+	/// Deadlines are rounded up to the wheel's resolution, so a timer
+	/// never expires early, but may expire up to one tick late.
+	///
+	/// The class is not thread-safe.
+{
+public:
+	typedef std::pair<K, Poco::Timestamp> Timer;
+	typedef std::vector<Timer> TimerList;
+
+	TimerWheel(const Poco::Timespan& resolution = Poco::Timespan(100000), std::size_t slots = 512):
+		_resolution(resolution.totalMicroseconds()),
+		_slots(slots),
+		_current(tick(Poco::Timestamp())),
+		_size(0)
+		/// Creates a TimerWheel with the given resolution and number of slots.
+		/// Timers further in the future than resolution*slots are
+		/// kept in the wheel for multiple revolutions.
+	{
+		if (_resolution <= 0 || slots == 0)
+			throw Poco::InvalidArgumentException("TimerWheel resolution and slots must be positive");
+	}
+
+	~TimerWheel()
+		/// Destroys the TimerWheel.
+	{
+	}
+
+	void schedule(const K& key, const Poco::Timestamp& deadline)
+		/// Schedules a timer for the given key.
+		/// A deadline in the past expires on the next advance().
+	{
+		Poco::Timestamp::TimeVal t = tick(deadline);
+		if (t < _current) t = _current;
+		_slots[slot(t)].push_back(Timer(key, deadline));
+		++_size;
+	}
+
+	void advance(const Poco::Timestamp& now, TimerList& expired)
+		/// Moves the wheel forward to now, appending all timers whose
+		/// deadline has passed to expired.
+	{
+		Poco::Timestamp::TimeVal nowTick = tick(now);
+		if (nowTick < _current) return;
+
+		Poco::Timestamp::TimeVal last = nowTick;
+		if (last - _current >= Poco::Timestamp::TimeVal(_slots.size()))
+			last = _current + _slots.size() - 1;
+		for (Poco::Timestamp::TimeVal t = _current; t <= last; ++t)
+		{
+			TimerList& timers = _slots[slot(t)];
+			std::size_t i = 0;
+			while (i < timers.size())
+			{
+				if (tick(timers[i].second) <= nowTick)
+				{
+					expired.push_back(timers[i]);
+					timers[i] = timers.back();
+					timers.pop_back();
+					--_size;
+				}
+				else ++i;
+			}
+		}
+		_current = nowTick + 1;
+	}
+
+	std::size_t size() const
+		/// Returns the number of scheduled timers.
+	{
+		return _size;
+	}
+
+	bool empty() const
+		/// Returns true iff no timers are scheduled.
+	{
+		return _size == 0;
+	}
+
+	void clear()
+		/// Removes all timers.
+	{
+		for (typename std::vector<TimerList>::iterator it = _slots.begin(); it != _slots.end(); ++it)
+			it->clear();
+		_size = 0;
+	}
+
+	Poco::Timespan resolution() const
+		/// Returns the resolution of the wheel.
+	{
+		return Poco::Timespan(_resolution);
+	}
+
+private:
+	TimerWheel(const TimerWheel&);
+	TimerWheel& operator = (const TimerWheel&);
+
+	Poco::Timestamp::TimeVal tick(const Poco::Timestamp& ts) const
+	{
+		return (ts.epochMicroseconds() + _resolution - 1)/_resolution;
+	}
+
+	std::size_t slot(Poco::Timestamp::TimeVal t) const
+	{
+		return std::size_t(t % Poco::Timestamp::TimeVal(_slots.size()));
+	}
+
+	Poco::Timestamp::TimeVal _resolution;
+	std::vector<TimerList>   _slots;
+	Poco::Timestamp::TimeVal _current;
+	std::size_t              _size;
+};
+
+
+} } // namespace Poco::Sockets
+
+
+#endif // Sockets_TimerWheel_INCLUDED
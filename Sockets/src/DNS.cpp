@@ -35,13 +35,12 @@
 
 
 #include "Poco/Sockets/DNS.h"
+#include "Poco/Sockets/Resolver.h"
 #include "Poco/Sockets/SocketException.h"
-#include "Poco/Sockets/SocketAddress.h"
 #include "Poco/Environment.h"
 #include "Poco/NumberFormatter.h"
 
 
-using Poco::FastMutex;
 using Poco::Environment;
 using Poco::NumberFormatter;
 using Poco::IOException;
@@ -78,83 +77,15 @@ namespace Poco {
 namespace Sockets {
 
 
-DNS::DNSCache DNS::_cache;
-Poco::FastMutex DNS::_mutex;
-
-
 HostEntry DNS::hostByName(const std::string& hostname)
 {
-	FastMutex::ScopedLock lock(_mutex);
-	
-	DNSCache::const_iterator it = _cache.find(hostname);
-	if (it != _cache.end())
-	{
-		return it->second;
-	}
-	else
-	{
-#if defined(_WIN32) && defined(POCO_HAVE_IPv6)
-		struct addrinfo* pAI;
-		struct addrinfo hints;
-		memset(&hints, 0, sizeof(hints));
-		hints.ai_flags = AI_CANONNAME;
-		if (getaddrinfo(hostname.c_str(), NULL, &hints, &pAI) == 0)
-		{
-			std::pair<DNSCache::iterator, bool> res = _cache.insert(std::pair<std::string, HostEntry>(hostname, HostEntry(pAI)));
-			freeaddrinfo(pAI);
-			return res.first->second;
-		}
-#else
-		struct hostent* he = gethostbyname(hostname.c_str());
-		if (he)
-		{
-			std::pair<DNSCache::iterator, bool> res = _cache.insert(std::pair<std::string, HostEntry>(hostname, HostEntry(he)));
-			return res.first->second;
-		}
-#endif
-	}
-	error(lastError(), hostname);      // will throw an appropriate exception
-	throw SocketException(); // to silence compiler
+	return Resolver::defaultResolver().hostByName(hostname);
 }
 
 
 HostEntry DNS::hostByAddress(const Address& address)
 {
-	FastMutex::ScopedLock lock(_mutex);
-
-#if defined(_WIN32) && defined(POCO_HAVE_IPv6)
-	SocketAddress sa(address, 0);
-	static char fqname[1024];
-	if (getnameinfo(sa.addr(), sa.length(), fqname, sizeof(fqname), NULL, 0, 0) == 0)
-	{
-		DNSCache::const_iterator it = _cache.find(std::string(fqname));
-		if (it != _cache.end())
-		{
-			return it->second;
-		}
-		else
-		{
-			struct addrinfo* pAI;
-			struct addrinfo hints;
-			memset(&hints, 0, sizeof(hints));
-			if (getaddrinfo(fqname, NULL, &hints, &pAI) == 0)
-			{
-				std::pair<DNSCache::iterator, bool> res = _cache.insert(std::pair<std::string, HostEntry>(std::string(fqname), HostEntry(pAI)));
-				freeaddrinfo(pAI);
-				return res.first->second;
-			}
-		}
-	}
-#else
-	struct hostent* he = gethostbyaddr(reinterpret_cast<const char*>(address.addr()), address.length(), address.af());
-	if (he)
-	{
-		std::pair<DNSCache::iterator, bool> res = _cache.insert(std::pair<std::string, HostEntry>(std::string(he->h_name), HostEntry(he)));
-		return res.first->second;
-	}
-#endif
-	error(lastError(), address.toString());      // will throw an appropriate exception
-	throw SocketException(); // to silence compiler
+	return Resolver::defaultResolver().hostByAddress(address);
 }
 
 
@@ -186,9 +117,7 @@ HostEntry DNS::thisHost()
 
 void DNS::flushCache()
 {
-	FastMutex::ScopedLock lock(_mutex);
-
-	_cache.clear();
+	Resolver::defaultResolver().flush();
 }
 
 
@@ -224,4 +153,38 @@ void DNS::error(int code, const std::string& arg)
 }
 
 
+#if defined(POCO_HAVE_ADDRINFO)
+
+
+void DNS::aierror(int code, const std::string& arg)
+{
+	switch (code)
+	{
+	case EAI_AGAIN:
+		throw DNSException("Temporary DNS error while resolving", arg);
+	case EAI_FAIL:
+		throw DNSException("Non recoverable DNS error while resolving", arg);
+	case EAI_NONAME:
+		throw HostNotFoundException(arg);
+#if defined(EAI_NODATA) && EAI_NODATA != EAI_NONAME
+	case EAI_NODATA:
+		throw NoAddressFoundException(arg);
+#endif
+#if defined(EAI_ADDRFAMILY)
+	case EAI_ADDRFAMILY:
+		throw NoAddressFoundException(arg);
+#endif
+#if defined(EAI_SYSTEM)
+	case EAI_SYSTEM:
+		throw IOException("System error while resolving", arg);
+#endif
+	default:
+		throw DNSException(gai_strerror(code), arg);
+	}
+}
+
+
+#endif
+
+
 } } // namespace Poco::Sockets
@@ -0,0 +1,114 @@
+//
+// DatagramBatch.cpp
+//
+// $Id: //poco/svn/Net/src/DatagramBatch.cpp#1 $
+//
+// Library: Net
+// Package: Sockets
+// Module:  DatagramSocket
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Sockets/DatagramBatch.h"
+#include "Poco/Exception.h"
+#include <cstring>
+
+
+namespace Poco {
+namespace Sockets {
+
+
+DatagramBatch::DatagramBatch(std::size_t capacity, std::size_t bufferSize):
+	_capacity(capacity),
+	_bufferSize(bufferSize),
+	_buffers(capacity*bufferSize),
+	_lengths(capacity),
+	_addresses(capacity)
+{
+	poco_assert (capacity > 0 && bufferSize > 0);
+
+	for (std::size_t i = 0; i < _capacity; ++i)
+	{
+		_addresses[i].length = 0;
+	}
+#if POCO_OS == POCO_OS_LINUX
+	_iovecs.resize(_capacity);
+	_headers.resize(_capacity);
+	std::memset(&_headers[0], 0, _capacity*sizeof(struct mmsghdr));
+	for (std::size_t i = 0; i < _capacity; ++i)
+	{
+		_iovecs[i].iov_base = buffer(i);
+		_iovecs[i].iov_len  = _bufferSize;
+		_headers[i].msg_hdr.msg_iov    = &_iovecs[i];
+		_headers[i].msg_hdr.msg_iovlen = 1;
+	}
+#endif
+}
+
+
+DatagramBatch::~DatagramBatch()
+{
+}
+
+
+SocketAddress DatagramBatch::address(std::size_t index) const
+{
+	poco_assert (index < _capacity);
+
+	const AddressSlot& slot = _addresses[index];
+	if (slot.length == 0) throw InvalidAccessException("Datagram slot has no address");
+	return SocketAddress(&slot.addr.sa, slot.length);
+}
+
+
+void DatagramBatch::setAddress(std::size_t index, const SocketAddress& address)
+{
+	poco_assert (index < _capacity);
+	poco_assert (address.length() <= sizeof(_addresses[index].addr));
+
+	AddressSlot& slot = _addresses[index];
+	std::memcpy(slot.addr.data, address.addr(), address.length());
+	slot.length = address.length();
+}
+
+
+void DatagramBatch::assign(std::size_t index, const void* data, int length)
+{
+	setLength(index, length);
+	std::memcpy(buffer(index), data, length);
+}
+
+
+void DatagramBatch::assign(std::size_t index, const void* data, int length, const SocketAddress& address)
+{
+	assign(index, data, length);
+	setAddress(index, address);
+}
+
+
+} } // namespace Poco::Sockets
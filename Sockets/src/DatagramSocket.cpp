@@ -109,6 +109,12 @@ void DatagramSocket::bind(const SocketAddress& address, bool reuseAddress)
 }
 
 
+void DatagramSocket::bind(const SocketAddress& address, bool reuseAddress, bool reusePort)
+{
+	impl()->bind(address, reuseAddress, reusePort);
+}
+
+
 int DatagramSocket::sendBytes(const void* buffer, int length, int flags)
 {
 	return impl()->sendBytes(buffer, length, flags);
@@ -133,4 +139,16 @@ int DatagramSocket::receiveFrom(void* buffer, int length, SocketAddress& address
 }
 
 
+int DatagramSocket::sendBatch(DatagramBatch& batch, std::size_t count, int flags)
+{
+	return impl()->sendBatch(batch, count, flags);
+}
+
+
+int DatagramSocket::receiveBatch(DatagramBatch& batch, int flags)
+{
+	return impl()->receiveBatch(batch, flags);
+}
+
+
 } } // namespace Poco::Sockets
@@ -79,7 +79,7 @@ HostEntryImpl::HostEntryImpl(struct hostent* entry)
 }
 
 
-#if defined(_WIN32) && defined(POCO_HAVE_IPv6)
+#if defined(POCO_HAVE_ADDRINFO)
 
 
 HostEntryImpl::HostEntryImpl(struct addrinfo* ainfo)
@@ -88,10 +88,23 @@ HostEntryImpl::HostEntryImpl(struct addrinfo* ainfo)
 	
 	for (struct addrinfo* ai = ainfo; ai; ai = ai->ai_next)
 	{
-		if (ai->ai_canonname)
+		if (ai->ai_canonname && _name.empty())
 			_name.assign(ai->ai_canonname);
-		else if (ai->ai_addrlen && ai->ai_addr)
-			_addresses.push_back(Address(ai->ai_addr, (poco_socklen_t) ai->ai_addrlen));
+		if (ai->ai_addrlen && ai->ai_addr)
+		{
+			// getaddrinfo() may return an address once per socket type
+			Address address;
+			if (ai->ai_family == AF_INET)
+				address = Address(&reinterpret_cast<struct sockaddr_in*>(ai->ai_addr)->sin_addr, sizeof(struct in_addr));
+#if defined(POCO_HAVE_IPv6)
+			else if (ai->ai_family == AF_INET6)
+				address = Address(&reinterpret_cast<struct sockaddr_in6*>(ai->ai_addr)->sin6_addr, sizeof(struct in6_addr));
+#endif
+			else
+				continue;
+			if (std::find(_addresses.begin(), _addresses.end(), address) == _addresses.end())
+				_addresses.push_back(address);
+		}
 	}
 }
 
@@ -99,6 +112,14 @@ HostEntryImpl::HostEntryImpl(struct addrinfo* ainfo)
 #endif
 
 
+HostEntryImpl::HostEntryImpl(const std::string& name, const AddressList& addresses, const AliasList& aliases):
+	_name(name),
+	_aliases(aliases),
+	_addresses(addresses)
+{
+}
+
+
 HostEntryImpl::~HostEntryImpl()
 {
 }
@@ -121,7 +142,7 @@ HostEntry::HostEntry(struct hostent* entry):
 }
 
 
-#if defined(_WIN32) && defined(POCO_HAVE_IPv6)
+#if defined(POCO_HAVE_ADDRINFO)
 HostEntry::HostEntry(struct addrinfo* info):
 	_pImpl(new HostEntryImpl(info))
 {
@@ -129,6 +150,12 @@ HostEntry::HostEntry(struct addrinfo* info):
 #endif
 
 
+HostEntry::HostEntry(const std::string& name, const AddressList& addresses, const AliasList& aliases):
+	_pImpl(new HostEntryImpl(name, addresses, aliases))
+{
+}
+
+
 HostEntry::~HostEntry()
 {
 }
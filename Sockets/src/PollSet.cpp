@@ -0,0 +1,663 @@
+//
+// PollSet.cpp
+//
+// $Id: //poco/svn/Net/src/PollSet.cpp#1 $
+//
+// Library: Net
+// Package: Sockets
+// Module:  PollSet
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Sockets/PollSet.h"
+#include "Poco/Sockets/SocketImpl.h"
+#include "Poco/Mutex.h"
+#include "Poco/Timespan.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Exception.h"
+#include <map>
+#if POCO_OS == POCO_OS_LINUX
+	#include <sys/epoll.h>
+	#include <unistd.h>
+#elif defined(POCO_HAVE_FD_POLL)
+	#include <poll.h>
+#endif
+
+
+namespace Poco {
+namespace Sockets {
+
+
+#if POCO_OS == POCO_OS_LINUX
+
+
+class PollSetImpl
+	/// epoll based implementation.
+	///
+	/// Every registered socket is kept in a heap allocated Entry
+	/// whose address is stored in the epoll_event, so that ready
+	/// events are translated back into sockets without a lookup.
+	/// Entries removed while a poll() is in progress may still be
+	/// referenced by the events just returned; they are only
+	/// deleted once poll() has translated its events.
+{
+public:
+	PollSetImpl(PollSet::Trigger trigger):
+		_trigger(trigger),
+		_epollfd(::epoll_create(INITIAL_EVENTS)),
+		_events(INITIAL_EVENTS),
+		_polling(false)
+	{
+		if (_epollfd < 0) SocketImpl::error();
+	}
+
+	~PollSetImpl()
+	{
+		clear();
+		::close(_epollfd);
+	}
+
+	void add(const Socket& socket, int mode)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (_entries.find(socket.impl()) != _entries.end())
+			throw InvalidArgumentException("Socket already in PollSet");
+
+		Entry* pEntry = new Entry(socket, mode);
+		try
+		{
+			control(EPOLL_CTL_ADD, pEntry);
+		}
+		catch (...)
+		{
+			delete pEntry;
+			throw;
+		}
+		_entries[socket.impl()] = pEntry;
+	}
+
+	void update(const Socket& socket, int mode)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		EntryMap::iterator it = _entries.find(socket.impl());
+		if (it == _entries.end())
+			throw NotFoundException("Socket not in PollSet");
+
+		int oldMode = it->second->mode;
+		it->second->mode = mode;
+		try
+		{
+			control(EPOLL_CTL_MOD, it->second);
+		}
+		catch (...)
+		{
+			it->second->mode = oldMode;
+			throw;
+		}
+	}
+
+	void remove(const Socket& socket)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		EntryMap::iterator it = _entries.find(socket.impl());
+		if (it != _entries.end()) erase(it);
+	}
+
+	bool has(const Socket& socket) const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		return _entries.find(socket.impl()) != _entries.end();
+	}
+
+	std::size_t count() const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		return _entries.size();
+	}
+
+	void clear()
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		while (!_entries.empty()) erase(_entries.begin());
+	}
+
+	PollSet::Trigger trigger() const
+	{
+		return _trigger;
+	}
+
+	void poll(const Poco::Timespan& timeout, PollSet::SocketModeList& result)
+	{
+		result.clear();
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			_polling = true;
+		}
+
+		Poco::Timespan remainingTime(timeout);
+		int rc;
+		do
+		{
+			Poco::Timestamp start;
+			rc = ::epoll_wait(_epollfd, &_events[0], int(_events.size()), int(remainingTime.totalMilliseconds()));
+			if (rc < 0 && SocketImpl::lastError() == POCO_EINTR)
+			{
+				Poco::Timestamp end;
+				Poco::Timespan waited = end - start;
+				if (waited < remainingTime)
+					remainingTime -= waited;
+				else
+					remainingTime = 0;
+			}
+		}
+		while (rc < 0 && SocketImpl::lastError() == POCO_EINTR);
+
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		int err = rc < 0 ? SocketImpl::lastError() : 0;
+		for (int i = 0; i < rc; ++i)
+		{
+			Entry* pEntry = static_cast<Entry*>(_events[i].data.ptr);
+			if (pEntry->removed) continue;
+
+			int mode = 0;
+			if (_events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) mode |= Socket::SELECT_READ;
+			if (_events[i].events & (EPOLLOUT | EPOLLERR)) mode |= Socket::SELECT_WRITE;
+			if (_events[i].events & EPOLLERR) mode |= Socket::SELECT_ERROR;
+			mode &= pEntry->mode;
+			if (mode) result.push_back(PollSet::SocketMode(pEntry->socket, mode));
+		}
+		if (rc == int(_events.size()) && _events.size() < MAX_EVENTS)
+			_events.resize(_events.size()*2);
+
+		for (EntryList::iterator it = _removed.begin(); it != _removed.end(); ++it)
+			delete *it;
+		_removed.clear();
+		_polling = false;
+
+		if (rc < 0) SocketImpl::error(err);
+	}
+
+private:
+	enum
+	{
+		INITIAL_EVENTS = 64,
+		MAX_EVENTS     = 4096
+	};
+
+	struct Entry
+	{
+		Entry(const Socket& s, int m): socket(s), fd(s.impl()->sockfd()), mode(m), removed(false)
+		{
+		}
+
+		Socket        socket;
+		poco_socket_t fd;
+		int           mode;
+		bool          removed;
+	};
+
+	typedef std::map<SocketImpl*, Entry*> EntryMap;
+	typedef std::vector<Entry*> EntryList;
+
+	void control(int op, Entry* pEntry)
+	{
+		struct epoll_event ev;
+		ev.events = 0;
+		if (pEntry->mode & Socket::SELECT_READ) ev.events |= EPOLLIN;
+		if (pEntry->mode & Socket::SELECT_WRITE) ev.events |= EPOLLOUT;
+		if (pEntry->mode & Socket::SELECT_ERROR) ev.events |= EPOLLERR;
+		if (_trigger == PollSet::TRIGGER_EDGE) ev.events |= EPOLLET;
+		ev.data.ptr = pEntry;
+		if (::epoll_ctl(_epollfd, op, pEntry->fd, &ev) < 0) SocketImpl::error();
+	}
+
+	void erase(EntryMap::iterator it)
+		/// Must be called with the mutex held.
+	{
+		// If the socket has been closed, the kernel has dropped the
+		// descriptor from the epoll set on its own, and the number may
+		// already belong to a new socket that must stay registered.
+		Entry* pEntry = it->second;
+		if (pEntry->socket.impl()->sockfd() != POCO_INVALID_SOCKET)
+		{
+			struct epoll_event ev;
+			ev.events = 0;
+			ev.data.ptr = 0;
+			::epoll_ctl(_epollfd, EPOLL_CTL_DEL, pEntry->fd, &ev);
+		}
+
+		_entries.erase(it);
+		if (_polling)
+		{
+			pEntry->removed = true;
+			_removed.push_back(pEntry);
+		}
+		else delete pEntry;
+	}
+
+	PollSet::Trigger           _trigger;
+	int                        _epollfd;
+	std::vector<epoll_event>   _events;
+	EntryMap                   _entries;
+	EntryList                  _removed;
+	bool                       _polling;
+	mutable Poco::FastMutex    _mutex;
+};
+
+
+#elif defined(POCO_HAVE_FD_POLL)
+
+
+class PollSetImpl
+	/// poll() based implementation.
+	///
+	/// The pollfd array is kept up to date incrementally; a socket
+	/// is removed by moving the last element into its slot. Since
+	/// poll() has to scan the whole array anyway, it works on a
+	/// copy, so that sockets can be added or removed concurrently.
+{
+public:
+	PollSetImpl(PollSet::Trigger trigger):
+		_trigger(trigger)
+	{
+		if (trigger != PollSet::TRIGGER_LEVEL)
+			throw NotImplementedException("Edge-triggered PollSet not supported on this platform");
+	}
+
+	~PollSetImpl()
+	{
+	}
+
+	void add(const Socket& socket, int mode)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (_index.find(socket.impl()) != _index.end())
+			throw InvalidArgumentException("Socket already in PollSet");
+
+		pollfd pfd;
+		pfd.fd = socket.impl()->sockfd();
+		pfd.events = events(mode);
+		pfd.revents = 0;
+		_pollfds.push_back(pfd);
+		_sockets.push_back(PollSet::SocketMode(socket, mode));
+		_index[socket.impl()] = _pollfds.size() - 1;
+		_fdIndex[pfd.fd] = _pollfds.size() - 1;
+	}
+
+	void update(const Socket& socket, int mode)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		IndexMap::iterator it = _index.find(socket.impl());
+		if (it == _index.end())
+			throw NotFoundException("Socket not in PollSet");
+
+		_pollfds[it->second].events = events(mode);
+		_sockets[it->second].second = mode;
+	}
+
+	void remove(const Socket& socket)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		IndexMap::iterator it = _index.find(socket.impl());
+		if (it == _index.end()) return;
+
+		std::size_t pos  = it->second;
+		std::size_t last = _pollfds.size() - 1;
+		// a closed socket's descriptor may have been reused by a
+		// socket added later, which then owns the fd index entry
+		FDIndexMap::iterator itFd = _fdIndex.find(_pollfds[pos].fd);
+		if (itFd != _fdIndex.end() && itFd->second == pos)
+			_fdIndex.erase(itFd);
+		if (pos != last)
+		{
+			_pollfds[pos] = _pollfds[last];
+			_sockets[pos] = _sockets[last];
+			_index[_sockets[pos].first.impl()] = pos;
+			_fdIndex[_pollfds[pos].fd] = pos;
+		}
+		_pollfds.pop_back();
+		_sockets.pop_back();
+		_index.erase(it);
+	}
+
+	bool has(const Socket& socket) const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		return _index.find(socket.impl()) != _index.end();
+	}
+
+	std::size_t count() const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		return _pollfds.size();
+	}
+
+	void clear()
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		_pollfds.clear();
+		_sockets.clear();
+		_index.clear();
+		_fdIndex.clear();
+	}
+
+	PollSet::Trigger trigger() const
+	{
+		return _trigger;
+	}
+
+	void poll(const Poco::Timespan& timeout, PollSet::SocketModeList& result)
+	{
+		result.clear();
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			_ready = _pollfds;
+		}
+		if (_ready.empty()) return;
+
+		Poco::Timespan remainingTime(timeout);
+		int rc;
+		do
+		{
+			Poco::Timestamp start;
+			rc = ::poll(&_ready[0], _ready.size(), int(remainingTime.totalMilliseconds()));
+			if (rc < 0 && SocketImpl::lastError() == POCO_EINTR)
+			{
+				Poco::Timestamp end;
+				Poco::Timespan waited = end - start;
+				if (waited < remainingTime)
+					remainingTime -= waited;
+				else
+					remainingTime = 0;
+			}
+		}
+		while (rc < 0 && SocketImpl::lastError() == POCO_EINTR);
+		if (rc < 0) SocketImpl::error();
+
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		for (std::vector<pollfd>::const_iterator it = _ready.begin(); rc > 0 && it != _ready.end(); ++it)
+		{
+			if (!it->revents) continue;
+			--rc;
+
+			FDIndexMap::const_iterator itIndex = _fdIndex.find(it->fd);
+			if (itIndex == _fdIndex.end()) continue;
+
+			const PollSet::SocketMode& sm = _sockets[itIndex->second];
+			int mode = 0;
+			if (it->revents & (POLLIN | POLLHUP | POLLERR)) mode |= Socket::SELECT_READ;
+			if (it->revents & (POLLOUT | POLLERR)) mode |= Socket::SELECT_WRITE;
+			if (it->revents & (POLLERR | POLLNVAL)) mode |= Socket::SELECT_ERROR;
+			mode &= sm.second;
+			if (mode) result.push_back(PollSet::SocketMode(sm.first, mode));
+		}
+	}
+
+private:
+	typedef std::map<SocketImpl*, std::size_t> IndexMap;
+	typedef std::map<poco_socket_t, std::size_t> FDIndexMap;
+
+	static short events(int mode)
+	{
+		short ev = 0;
+		if (mode & Socket::SELECT_READ) ev |= POLLIN;
+		if (mode & Socket::SELECT_WRITE) ev |= POLLOUT;
+		return ev;
+	}
+
+	PollSet::Trigger                _trigger;
+	std::vector<pollfd>             _pollfds;
+	PollSet::SocketModeList         _sockets;
+	IndexMap                        _index;
+	FDIndexMap                      _fdIndex;
+	std::vector<pollfd>             _ready;
+	mutable Poco::FastMutex         _mutex;
+};
+
+
+#else
+
+
+class PollSetImpl
+	/// Socket::select() based implementation, for platforms
+	/// providing neither epoll nor poll().
+{
+public:
+	PollSetImpl(PollSet::Trigger trigger):
+		_trigger(trigger)
+	{
+		if (trigger != PollSet::TRIGGER_LEVEL)
+			throw NotImplementedException("Edge-triggered PollSet not supported on this platform");
+	}
+
+	~PollSetImpl()
+	{
+	}
+
+	void add(const Socket& socket, int mode)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (find(socket) != _sockets.end())
+			throw InvalidArgumentException("Socket already in PollSet");
+
+		_sockets.push_back(PollSet::SocketMode(socket, mode));
+	}
+
+	void update(const Socket& socket, int mode)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		PollSet::SocketModeList::iterator it = find(socket);
+		if (it == _sockets.end())
+			throw NotFoundException("Socket not in PollSet");
+
+		it->second = mode;
+	}
+
+	void remove(const Socket& socket)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		PollSet::SocketModeList::iterator it = find(socket);
+		if (it != _sockets.end()) _sockets.erase(it);
+	}
+
+	bool has(const Socket& socket) const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		return const_cast<PollSetImpl*>(this)->find(socket) != _sockets.end();
+	}
+
+	std::size_t count() const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		return _sockets.size();
+	}
+
+	void clear()
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		_sockets.clear();
+	}
+
+	PollSet::Trigger trigger() const
+	{
+		return _trigger;
+	}
+
+	void poll(const Poco::Timespan& timeout, PollSet::SocketModeList& result)
+	{
+		result.clear();
+
+		Socket::SocketList readList;
+		Socket::SocketList writeList;
+		Socket::SocketList exceptList;
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+
+			for (PollSet::SocketModeList::const_iterator it = _sockets.begin(); it != _sockets.end(); ++it)
+			{
+				if (it->second & Socket::SELECT_READ) readList.push_back(it->first);
+				if (it->second & Socket::SELECT_WRITE) writeList.push_back(it->first);
+				if (it->second & Socket::SELECT_ERROR) exceptList.push_back(it->first);
+			}
+		}
+		if (readList.empty() && writeList.empty() && exceptList.empty()) return;
+
+		if (Socket::select(readList, writeList, exceptList, timeout) == 0) return;
+
+		collect(readList, Socket::SELECT_READ, result);
+		collect(writeList, Socket::SELECT_WRITE, result);
+		collect(exceptList, Socket::SELECT_ERROR, result);
+	}
+
+private:
+	PollSet::SocketModeList::iterator find(const Socket& socket)
+	{
+		for (PollSet::SocketModeList::iterator it = _sockets.begin(); it != _sockets.end(); ++it)
+		{
+			if (it->first == socket) return it;
+		}
+		return _sockets.end();
+	}
+
+	static void collect(const Socket::SocketList& ready, int mode, PollSet::SocketModeList& result)
+	{
+		for (Socket::SocketList::const_iterator it = ready.begin(); it != ready.end(); ++it)
+		{
+			PollSet::SocketModeList::iterator itResult = result.begin();
+			while (itResult != result.end() && !(itResult->first == *it)) ++itResult;
+			if (itResult != result.end())
+				itResult->second |= mode;
+			else
+				result.push_back(PollSet::SocketMode(*it, mode));
+		}
+	}
+
+	PollSet::Trigger                _trigger;
+	PollSet::SocketModeList         _sockets;
+	mutable Poco::FastMutex         _mutex;
+};
+
+
+#endif
+
+
+//
+// PollSet
+//
+
+
+PollSet::PollSet(Trigger trigger):
+	_pImpl(new PollSetImpl(trigger))
+{
+}
+
+
+PollSet::~PollSet()
+{
+	delete _pImpl;
+}
+
+
+void PollSet::add(const Socket& socket, int mode)
+{
+	_pImpl->add(socket, mode);
+}
+
+
+void PollSet::update(const Socket& socket, int mode)
+{
+	_pImpl->update(socket, mode);
+}
+
+
+void PollSet::remove(const Socket& socket)
+{
+	_pImpl->remove(socket);
+}
+
+
+bool PollSet::has(const Socket& socket) const
+{
+	return _pImpl->has(socket);
+}
+
+
+bool PollSet::empty() const
+{
+	return _pImpl->count() == 0;
+}
+
+
+std::size_t PollSet::count() const
+{
+	return _pImpl->count();
+}
+
+
+void PollSet::clear()
+{
+	_pImpl->clear();
+}
+
+
+PollSet::Trigger PollSet::trigger() const
+{
+	return _pImpl->trigger();
+}
+
+
+const PollSet::SocketModeList& PollSet::poll(const Poco::Timespan& timeout)
+{
+	_pImpl->poll(timeout, _ready);
+	return _ready;
+}
+
+
+} } // namespace Poco::Sockets
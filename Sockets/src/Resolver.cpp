@@ -0,0 +1,385 @@
+//
+// Resolver.cpp
+//
+// $Id: //poco/svn/Net/src/Resolver.cpp#1 $
+//
+// Library: Net
+// Package: Address
+// Module:  DNS
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Sockets/Resolver.h"
+#include "Poco/Sockets/SocketException.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/Runnable.h"
+#include "Poco/SingletonHolder.h"
+#include "Poco/Hash.h"
+
+
+using Poco::FastMutex;
+using Poco::Timestamp;
+using Poco::Timespan;
+using Poco::SharedPtr;
+using Poco::ThreadPool;
+using Poco::NoThreadAvailableException;
+
+
+namespace Poco {
+namespace Sockets {
+
+
+class Resolver::LookupTask: public Poco::Runnable
+	/// Performs a lookup for a Resolver in a pool thread
+	/// and deletes itself when done.
+{
+public:
+	LookupTask(Resolver& resolver, const std::string& key):
+		_resolver(resolver),
+		_key(key)
+	{
+	}
+
+	void run()
+	{
+		try
+		{
+			_resolver.resolve(_key);
+		}
+		catch (...)
+		{
+		}
+		_resolver.taskDone();
+		delete this;
+	}
+
+private:
+	Resolver&   _resolver;
+	std::string _key;
+};
+
+
+Resolver::Resolver():
+	_pBackend(new SystemResolverBackend),
+	_ttl(60, 0),
+	_negativeTTL(5, 0),
+	_maxStale(300, 0),
+	_tasks(0)
+{
+}
+
+
+Resolver::Resolver(ResolverBackend* pBackend):
+	_pBackend(pBackend),
+	_ttl(60, 0),
+	_negativeTTL(5, 0),
+	_maxStale(300, 0),
+	_tasks(0)
+{
+	poco_check_ptr (pBackend);
+}
+
+
+Resolver::~Resolver()
+{
+	try
+	{
+		FastMutex::ScopedLock lock(_taskMutex);
+		while (_tasks > 0) _tasksDone.wait(_taskMutex);
+	}
+	catch (...)
+	{
+	}
+}
+
+
+HostEntry Resolver::hostByName(const std::string& hostname)
+{
+	Result result = lookup(hostname, false);
+	return get(result);
+}
+
+
+HostEntry Resolver::hostByAddress(const Address& address)
+{
+	Result result = lookup(addressKey(address), false);
+	return get(result);
+}
+
+
+Resolver::Result Resolver::hostByNameAsync(const std::string& hostname)
+{
+	return lookup(hostname, true);
+}
+
+
+Resolver::Result Resolver::hostByAddressAsync(const Address& address)
+{
+	return lookup(addressKey(address), true);
+}
+
+
+HostEntry Resolver::get(Result& result)
+{
+	result.wait();
+	if (result.failed()) result.exception()->rethrow();
+	return result.data();
+}
+
+
+void Resolver::setTTL(const Timespan& ttl)
+{
+	_ttl = ttl;
+}
+
+
+void Resolver::setNegativeTTL(const Timespan& ttl)
+{
+	_negativeTTL = ttl;
+}
+
+
+void Resolver::setMaxStale(const Timespan& maxStale)
+{
+	_maxStale = maxStale;
+}
+
+
+void Resolver::flush()
+{
+	for (int i = 0; i < SHARD_COUNT; ++i)
+	{
+		FastMutex::ScopedLock lock(_shards[i].mutex);
+		_shards[i].entries.clear();
+	}
+}
+
+
+std::size_t Resolver::size() const
+{
+	std::size_t n = 0;
+	for (int i = 0; i < SHARD_COUNT; ++i)
+	{
+		FastMutex::ScopedLock lock(_shards[i].mutex);
+		n += _shards[i].entries.size();
+	}
+	return n;
+}
+
+
+namespace
+{
+	static SingletonHolder<Resolver> sh;
+}
+
+
+Resolver& Resolver::defaultResolver()
+{
+	return *sh.get();
+}
+
+
+Resolver::Result Resolver::lookup(const std::string& key, bool async)
+{
+	Shard& shard = shardFor(key);
+	Result result(new Poco::ActiveResultHolder<HostEntry>());
+	bool refresh = false;
+	bool start   = false;
+	{
+		FastMutex::ScopedLock lock(shard.mutex);
+
+		EntryMap::iterator it = shard.entries.find(key);
+		if (it != shard.entries.end())
+		{
+			Entry& entry = it->second;
+			Timestamp now;
+			if (now < entry.expires)
+			{
+				complete(result, entry);
+				return result;
+			}
+			if (!entry.pError && now < entry.expires + _maxStale.totalMicroseconds())
+			{
+				refresh = !entry.refreshing;
+				entry.refreshing = true;
+				complete(result, entry);
+			}
+		}
+		if (!result.available())
+		{
+			PendingMap::iterator itp = shard.pending.find(key);
+			if (itp != shard.pending.end()) return itp->second;
+			shard.pending.insert(PendingMap::value_type(key, result));
+			start = true;
+		}
+	}
+	if (start)
+	{
+		if (!async || !startTask(key)) resolve(key);
+	}
+	else if (refresh && !startTask(key))
+	{
+		FastMutex::ScopedLock lock(shard.mutex);
+		EntryMap::iterator it = shard.entries.find(key);
+		if (it != shard.entries.end()) it->second.refreshing = false;
+	}
+	return result;
+}
+
+
+void Resolver::resolve(const std::string& key)
+{
+	Entry entry;
+	entry.refreshing = false;
+	Timespan ttl = _ttl;
+	bool cache = true;
+	try
+	{
+		entry.hostEntry = query(key, ttl);
+	}
+	catch (HostNotFoundException& exc)
+	{
+		entry.pError = exc.clone();
+		ttl = _negativeTTL;
+	}
+	catch (NoAddressFoundException& exc)
+	{
+		entry.pError = exc.clone();
+		ttl = _negativeTTL;
+	}
+	catch (Poco::Exception& exc)
+	{
+		entry.pError = exc.clone();
+		cache = false;
+	}
+	catch (std::exception& exc)
+	{
+		entry.pError = new Poco::UnhandledException(exc.what());
+		cache = false;
+	}
+	catch (...)
+	{
+		entry.pError = new Poco::UnhandledException("unknown exception");
+		cache = false;
+	}
+	entry.expires += ttl.totalMicroseconds();
+
+	Shard& shard = shardFor(key);
+	PendingMap done;
+	{
+		FastMutex::ScopedLock lock(shard.mutex);
+
+		if (cache)
+		{
+			shard.entries[key] = entry;
+		}
+		else
+		{
+			// keep serving a stale entry after a temporary failure
+			EntryMap::iterator it = shard.entries.find(key);
+			if (it != shard.entries.end()) it->second.refreshing = false;
+		}
+		PendingMap::iterator itp = shard.pending.find(key);
+		if (itp != shard.pending.end())
+		{
+			done.insert(*itp);
+			shard.pending.erase(itp);
+		}
+	}
+	for (PendingMap::iterator it = done.begin(); it != done.end(); ++it)
+	{
+		complete(it->second, entry);
+	}
+}
+
+
+HostEntry Resolver::query(const std::string& key, Timespan& ttl)
+{
+	if (!key.empty() && key[0] == '[')
+		return _pBackend->hostByAddress(Address(key.substr(1, key.size() - 2)), ttl);
+	else
+		return _pBackend->hostByName(key, ttl);
+}
+
+
+bool Resolver::startTask(const std::string& key)
+{
+	{
+		FastMutex::ScopedLock lock(_taskMutex);
+		++_tasks;
+	}
+	LookupTask* pTask = new LookupTask(*this, key);
+	try
+	{
+		ThreadPool::defaultPool().start(*pTask);
+		return true;
+	}
+	catch (NoThreadAvailableException&)
+	{
+		delete pTask;
+		taskDone();
+		return false;
+	}
+}
+
+
+void Resolver::taskDone()
+{
+	FastMutex::ScopedLock lock(_taskMutex);
+	if (--_tasks == 0) _tasksDone.broadcast();
+}
+
+
+Resolver::Shard& Resolver::shardFor(const std::string& key)
+{
+	return _shards[Poco::hash(key) % SHARD_COUNT];
+}
+
+
+void Resolver::complete(Result& result, const Entry& entry)
+{
+	if (entry.pError)
+		result.error(*entry.pError);
+	else
+		result.data(new HostEntry(entry.hostEntry));
+	result.notify();
+}
+
+
+std::string Resolver::addressKey(const Address& address)
+{
+	// host names cannot contain brackets, so address keys
+	// never collide with names
+	std::string key("[");
+	key += address.toString();
+	key += ']';
+	return key;
+}
+
+
+} } // namespace Poco::Sockets
@@ -0,0 +1,150 @@
+//
+// ResolverBackend.cpp
+//
+// $Id: //poco/svn/Net/src/ResolverBackend.cpp#1 $
+//
+// Library: Net
+// Package: Address
+// Module:  DNS
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Sockets/ResolverBackend.h"
+#include "Poco/Sockets/DNS.h"
+#include "Poco/Sockets/SocketAddress.h"
+#include "Poco/Sockets/SocketException.h"
+#include "Poco/String.h"
+#include <cstring>
+
+
+using Poco::FastMutex;
+using Poco::Timespan;
+
+
+namespace Poco {
+namespace Sockets {
+
+
+//
+// ResolverBackend
+//
+
+
+ResolverBackend::ResolverBackend()
+{
+}
+
+
+ResolverBackend::~ResolverBackend()
+{
+}
+
+
+//
+// SystemResolverBackend
+//
+
+
+#if !defined(POCO_HAVE_ADDRINFO)
+Poco::FastMutex SystemResolverBackend::_mutex;
+#endif
+
+
+SystemResolverBackend::SystemResolverBackend()
+{
+}
+
+
+SystemResolverBackend::~SystemResolverBackend()
+{
+}
+
+
+HostEntry SystemResolverBackend::hostByName(const std::string& hostname, Timespan&)
+{
+#if defined(POCO_HAVE_ADDRINFO)
+	struct addrinfo* pAI;
+	struct addrinfo hints;
+	std::memset(&hints, 0, sizeof(hints));
+	hints.ai_flags    = AI_CANONNAME;
+	hints.ai_socktype = SOCK_STREAM;
+#if defined(POCO_HAVE_IPv6)
+	hints.ai_family   = AF_UNSPEC;
+#else
+	hints.ai_family   = AF_INET;
+#endif
+	int rc = getaddrinfo(hostname.c_str(), NULL, &hints, &pAI);
+	if (rc != 0) DNS::aierror(rc, hostname);
+	HostEntry entry;
+	try
+	{
+		entry = HostEntry(pAI);
+		freeaddrinfo(pAI);
+	}
+	catch (...)
+	{
+		freeaddrinfo(pAI);
+		throw;
+	}
+	// getaddrinfo() reports no aliases. Like gethostbyname(), the name
+	// looked up is listed as an alias if it isn't the canonical name.
+	if (entry.name().empty())
+		return HostEntry(hostname, entry.addresses());
+	else if (Poco::icompare(entry.name(), hostname) != 0)
+		return HostEntry(entry.name(), entry.addresses(), HostEntry::AliasList(1, hostname));
+	else
+		return entry;
+#else
+	FastMutex::ScopedLock lock(_mutex);
+
+	struct hostent* he = gethostbyname(hostname.c_str());
+	if (!he) DNS::error(DNS::lastError(), hostname);
+	return HostEntry(he);
+#endif
+}
+
+
+HostEntry SystemResolverBackend::hostByAddress(const Address& address, Timespan&)
+{
+#if defined(POCO_HAVE_ADDRINFO)
+	SocketAddress sa(address, 0);
+	char fqname[1025];
+	int rc = getnameinfo(sa.addr(), sa.length(), fqname, sizeof(fqname), NULL, 0, NI_NAMEREQD);
+	if (rc != 0) DNS::aierror(rc, address.toString());
+	return HostEntry(std::string(fqname), HostEntry::AddressList(1, address));
+#else
+	FastMutex::ScopedLock lock(_mutex);
+
+	struct hostent* he = gethostbyaddr(reinterpret_cast<const char*>(address.addr()), address.length(), address.af());
+	if (!he) DNS::error(DNS::lastError(), address.toString());
+	return HostEntry(he);
+#endif
+}
+
+
+} } // namespace Poco::Sockets
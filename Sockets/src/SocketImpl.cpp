@@ -37,22 +37,35 @@
 #include "Poco/Sockets/SocketImpl.h"
 #include "Poco/Sockets/SocketException.h"
 #include "Poco/Sockets/StreamSocketImpl.h"
+#include "Poco/Sockets/DatagramBatch.h"
 #include "Poco/NumberFormatter.h"
 #include "Poco/Timestamp.h"
 #include "Poco/File.h"
+#include "Poco/FileStream.h"
+#include "Poco/Buffer.h"
 //#include <string.h> // FD_SET needs memset on some platforms, so we can't use <cstring>
 #include <cstring> // g++ 4.3 won't compile without <cstring>
 #if defined(POCO_HAVE_FD_POLL)
 	#include <poll.h>
 #endif
+#if POCO_OS == POCO_OS_LINUX
+	#include <sys/sendfile.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+#endif
 
 
 using Poco::IOException;
 using Poco::TimeoutException;
 using Poco::InvalidArgumentException;
+using Poco::NotImplementedException;
 using Poco::NumberFormatter;
 using Poco::Timespan;
 using Poco::File;
+using Poco::FileInputStream;
+using Poco::FileNotFoundException;
+using Poco::FileAccessDeniedException;
+using Poco::OpenFileException;
 
 
 namespace Poco {
@@ -196,7 +209,7 @@ void SocketImpl::connectNB(const SocketAddress& address, const SocketAddress* pF
 }
 
 
-void SocketImpl::bind(const SocketAddress& address, bool reuseAddress)
+void SocketImpl::bind(const SocketAddress& address, bool reuseAddress, bool reusePort)
 {
 	if (_sockfd == POCO_INVALID_SOCKET)
 	{
@@ -205,7 +218,14 @@ void SocketImpl::bind(const SocketAddress& address, bool reuseAddress)
 	if (reuseAddress)
 	{
 		setReuseAddress(true);
-		setReusePort(true);
+	}
+	if (reusePort)
+	{
+#ifdef SO_REUSEPORT
+		setOption(SOL_SOCKET, SO_REUSEPORT, 1);
+#else
+		throw NotImplementedException("SO_REUSEPORT");
+#endif
 	}
 
 #ifdef POCO_OS_FAMILY_UNIX
@@ -216,6 +236,22 @@ void SocketImpl::bind(const SocketAddress& address, bool reuseAddress)
 	if (rc != 0) error(address.toString());
 }
 
+
+void SocketImpl::bind(const SocketAddress& address, bool reuseAddress)
+{
+	if (reuseAddress)
+	{
+		// as before, SO_REUSEPORT is set where available, but
+		// failure to set it is not an error
+		if (_sockfd == POCO_INVALID_SOCKET)
+		{
+			init(address.af());
+		}
+		setReusePort(true);
+	}
+	bind(address, reuseAddress, false);
+}
+
 	
 void SocketImpl::listen(int backlog)
 {
@@ -315,6 +351,171 @@ int SocketImpl::receiveBytes(void* buffer, int length, int flags)
 }
 
 
+int SocketImpl::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	poco_assert (_sockfd != POCO_INVALID_SOCKET);
+
+	if (buffers.empty()) return 0;
+
+#if defined(POCO_BROKEN_TIMEOUTS)
+	if (_sndTimeout.totalMicroseconds() != 0)
+	{
+		if (!poll(_sndTimeout, SELECT_WRITE))
+			throw TimeoutException();
+	}
+#endif
+
+	int rc;
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	DWORD sent = 0;
+	rc = WSASend(_sockfd, const_cast<LPWSABUF>(&buffers[0]), static_cast<DWORD>(buffers.size()), &sent, static_cast<DWORD>(flags), 0, 0);
+	if (rc == SOCKET_ERROR) error();
+	rc = static_cast<int>(sent);
+#else
+	struct msghdr msg;
+	std::memset(&msg, 0, sizeof(msg));
+	msg.msg_iov    = const_cast<struct iovec*>(&buffers[0]);
+	msg.msg_iovlen = buffers.size();
+	do
+	{
+		rc = ::sendmsg(_sockfd, &msg, flags);
+	}
+	while (rc < 0 && lastError() == POCO_EINTR);
+	if (rc < 0) error();
+#endif
+	return rc;
+}
+
+
+int SocketImpl::receiveBytes(SocketBufVec& buffers, int flags)
+{
+	poco_assert (_sockfd != POCO_INVALID_SOCKET);
+
+	if (buffers.empty()) return 0;
+
+#if defined(POCO_BROKEN_TIMEOUTS)
+	if (_recvTimeout.totalMicroseconds() != 0)
+	{
+		if (!poll(_recvTimeout, SELECT_READ))
+			throw TimeoutException();
+	}
+#endif
+
+	int rc;
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	DWORD received = 0;
+	DWORD dwFlags = static_cast<DWORD>(flags);
+	rc = WSARecv(_sockfd, &buffers[0], static_cast<DWORD>(buffers.size()), &received, &dwFlags, 0, 0);
+	if (rc != SOCKET_ERROR) rc = static_cast<int>(received);
+#else
+	struct msghdr msg;
+	std::memset(&msg, 0, sizeof(msg));
+	msg.msg_iov    = &buffers[0];
+	msg.msg_iovlen = buffers.size();
+	do
+	{
+		rc = ::recvmsg(_sockfd, &msg, flags);
+	}
+	while (rc < 0 && lastError() == POCO_EINTR);
+#endif
+	if (rc < 0) 
+	{
+		if (lastError() == POCO_EAGAIN || lastError() == POCO_ETIMEDOUT)
+			throw TimeoutException();
+		else
+			error();
+	}
+	return rc;
+}
+
+
+std::streamsize SocketImpl::sendFile(const std::string& path, std::streamoff offset, std::streamsize count)
+{
+	poco_assert (_sockfd != POCO_INVALID_SOCKET);
+
+#if POCO_OS == POCO_OS_LINUX
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		switch (errno)
+		{
+		case ENOENT:
+		case ENOTDIR:
+			throw FileNotFoundException(path);
+		case EACCES:
+			throw FileAccessDeniedException(path);
+		default:
+			throw OpenFileException(path);
+		}
+	}
+
+	std::streamsize sent = 0;
+	try
+	{
+		if (count < 0)
+		{
+			struct stat st;
+			if (::fstat(fd, &st) != 0)
+				throw OpenFileException(path);
+			count = st.st_size > offset ? std::streamsize(st.st_size - offset) : 0;
+		}
+
+		off_t off = offset;
+		while (sent < count)
+		{
+			// sendfile() transfers at most 0x7ffff000 bytes per call
+			std::size_t chunk = std::size_t(count - sent < 0x7ffff000 ? count - sent : 0x7ffff000);
+			ssize_t rc = ::sendfile(_sockfd, fd, &off, chunk);
+			if (rc < 0)
+			{
+				if (lastError() == POCO_EINTR) continue;
+				if (lastError() == POCO_EAGAIN && (sent > 0 || !_blocking)) break;
+				if (lastError() == POCO_EAGAIN) throw TimeoutException();
+				error();
+			}
+			if (rc == 0) break; // end of file
+			sent += rc;
+		}
+	}
+	catch (...)
+	{
+		::close(fd);
+		throw;
+	}
+	::close(fd);
+	return sent;
+#else
+	FileInputStream istr(path);
+	if (offset > 0) istr.seekg(offset);
+	return sendFile(istr, count);
+#endif
+}
+
+
+std::streamsize SocketImpl::sendFile(std::istream& istr, std::streamsize count)
+{
+	const std::size_t BUFFER_SIZE = 65536;
+	Poco::Buffer<char> buffer(BUFFER_SIZE);
+
+	std::streamsize sent = 0;
+	while (count < 0 || sent < count)
+	{
+		std::streamsize n = count < 0 || count - sent > std::streamsize(BUFFER_SIZE) ? std::streamsize(BUFFER_SIZE) : count - sent;
+		istr.read(buffer.begin(), n);
+		n = istr.gcount();
+		if (n <= 0) break;
+
+		std::streamsize written = 0;
+		while (written < n)
+		{
+			written += sendBytes(buffer.begin() + written, int(n - written));
+		}
+		sent += n;
+	}
+	return sent;
+}
+
+
 int SocketImpl::sendTo(const void* buffer, int length, const SocketAddress& address, int flags)
 {
 	poco_assert (_sockfd != POCO_INVALID_SOCKET);
@@ -366,6 +567,138 @@ int SocketImpl::receiveFrom(void* buffer, int length, SocketAddress& address, in
 }
 
 
+int SocketImpl::sendBatch(DatagramBatch& batch, std::size_t count, int flags)
+{
+	poco_assert (_sockfd != POCO_INVALID_SOCKET);
+	poco_assert (count <= batch.capacity());
+
+#if POCO_OS == POCO_OS_LINUX
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		DatagramBatch::AddressSlot& slot = batch._addresses[i];
+		struct msghdr& hdr = batch._headers[i].msg_hdr;
+		batch._iovecs[i].iov_len = batch._lengths[i];
+		hdr.msg_name    = slot.length ? &slot.addr.sa : 0;
+		hdr.msg_namelen = slot.length;
+	}
+	std::size_t sent = 0;
+	while (sent < count)
+	{
+		int rc = ::sendmmsg(_sockfd, &batch._headers[sent], unsigned(count - sent), flags);
+		if (rc < 0)
+		{
+			if (lastError() == POCO_EINTR) continue;
+			if (sent > 0 && lastError() == POCO_EAGAIN) break;
+			error();
+		}
+		sent += rc;
+	}
+	return int(sent);
+#else
+	std::size_t sent = 0;
+	while (sent < count)
+	{
+		DatagramBatch::AddressSlot& slot = batch._addresses[sent];
+		int rc;
+		do
+		{
+			if (slot.length)
+				rc = ::sendto(_sockfd, batch.buffer(sent), batch._lengths[sent], flags, &slot.addr.sa, slot.length);
+			else
+				rc = ::send(_sockfd, batch.buffer(sent), batch._lengths[sent], flags);
+		}
+		while (rc < 0 && lastError() == POCO_EINTR);
+		if (rc < 0)
+		{
+			if (sent > 0 && lastError() == POCO_EWOULDBLOCK) break;
+			error();
+		}
+		++sent;
+	}
+	return int(sent);
+#endif
+}
+
+
+int SocketImpl::receiveBatch(DatagramBatch& batch, int flags)
+{
+	poco_assert (_sockfd != POCO_INVALID_SOCKET);
+
+#if defined(POCO_BROKEN_TIMEOUTS)
+	if (_recvTimeout.totalMicroseconds() != 0)
+	{
+		if (!poll(_recvTimeout, SELECT_READ))
+			throw TimeoutException();
+	}
+#endif
+
+#if POCO_OS == POCO_OS_LINUX
+	const std::size_t capacity = batch.capacity();
+	for (std::size_t i = 0; i < capacity; ++i)
+	{
+		struct msghdr& hdr = batch._headers[i].msg_hdr;
+		batch._iovecs[i].iov_len = batch.bufferSize();
+		hdr.msg_name    = &batch._addresses[i].addr;
+		hdr.msg_namelen = sizeof(batch._addresses[i].addr);
+	}
+	int rc;
+	do
+	{
+		rc = ::recvmmsg(_sockfd, &batch._headers[0], unsigned(capacity), flags | MSG_WAITFORONE, 0);
+	}
+	while (rc < 0 && lastError() == POCO_EINTR);
+	if (rc < 0)
+	{
+		if (lastError() == POCO_EAGAIN || lastError() == POCO_ETIMEDOUT)
+			throw TimeoutException();
+		else
+			error();
+	}
+	for (int i = 0; i < rc; ++i)
+	{
+		batch._lengths[i] = int(batch._headers[i].msg_len);
+		batch._addresses[i].length = batch._headers[i].msg_hdr.msg_namelen;
+	}
+	return rc;
+#else
+	std::size_t received = 0;
+	do
+	{
+		DatagramBatch::AddressSlot& slot = batch._addresses[received];
+		slot.length = sizeof(slot.addr);
+		int rc;
+		do
+		{
+#if defined(MSG_DONTWAIT)
+			// only the first datagram is waited for
+			int rflags = received == 0 ? flags : flags | MSG_DONTWAIT;
+#else
+			int rflags = flags;
+#endif
+			rc = ::recvfrom(_sockfd, batch.buffer(received), int(batch.bufferSize()), rflags, &slot.addr.sa, &slot.length);
+		}
+		while (rc < 0 && lastError() == POCO_EINTR);
+		if (rc < 0)
+		{
+			slot.length = 0;
+			if (received > 0) break;
+			if (lastError() == POCO_EAGAIN || lastError() == POCO_ETIMEDOUT)
+				throw TimeoutException();
+			else
+				error();
+		}
+		batch._lengths[received++] = rc;
+	}
+#if defined(MSG_DONTWAIT)
+	while (received < batch.capacity());
+#else
+	while (false);
+#endif
+	return int(received);
+#endif
+}
+
+
 void SocketImpl::sendUrgent(unsigned char data)
 {
 	int rc = ::send(_sockfd, reinterpret_cast<const char*>(&data), sizeof(data), MSG_OOB);
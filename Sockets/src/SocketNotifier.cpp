@@ -0,0 +1,124 @@
+//
+// SocketNotifier.cpp
+//
+// $Id: //poco/svn/Net/src/SocketNotifier.cpp#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  SocketNotifier
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Sockets/SocketNotifier.h"
+#include "Poco/Sockets/SocketReactor.h"
+#include "Poco/Sockets/SocketNotification.h"
+
+
+namespace Poco {
+namespace Sockets {
+
+
+SocketNotifier::SocketNotifier(const Socket& socket):
+	_socket(socket),
+	_mode(0)
+{
+}
+
+	
+SocketNotifier::~SocketNotifier()
+{
+}
+
+	
+void SocketNotifier::addObserver(SocketReactor* pReactor, const Poco::AbstractObserver& observer)
+{
+	_nc.addObserver(observer);
+	if (observer.accepts(pReactor->_pReadableNotification))
+	{
+		_events.insert(pReactor->_pReadableNotification.get());
+		_mode |= Socket::SELECT_READ;
+	}
+	else if (observer.accepts(pReactor->_pWritableNotification))
+	{
+		_events.insert(pReactor->_pWritableNotification.get());
+		_mode |= Socket::SELECT_WRITE;
+	}
+	else if (observer.accepts(pReactor->_pErrorNotification))
+	{
+		_events.insert(pReactor->_pErrorNotification.get());
+		_mode |= Socket::SELECT_ERROR;
+	}
+	else if (observer.accepts(pReactor->_pTimeoutNotification))
+	{
+		_events.insert(pReactor->_pTimeoutNotification.get());
+	}
+}
+
+	
+void SocketNotifier::removeObserver(SocketReactor* pReactor, const Poco::AbstractObserver& observer)
+{
+	if (!_nc.hasObserver(observer)) return;
+
+	_nc.removeObserver(observer);
+	EventSet::iterator it = _events.end();
+	if (observer.accepts(pReactor->_pReadableNotification))
+		it = _events.find(pReactor->_pReadableNotification.get());
+	else if (observer.accepts(pReactor->_pWritableNotification))
+		it = _events.find(pReactor->_pWritableNotification.get());
+	else if (observer.accepts(pReactor->_pErrorNotification))
+		it = _events.find(pReactor->_pErrorNotification.get());
+	else if (observer.accepts(pReactor->_pTimeoutNotification))
+		it = _events.find(pReactor->_pTimeoutNotification.get());
+	if (it != _events.end())
+		_events.erase(it);
+
+	_mode = 0;
+	if (accepts(pReactor->_pReadableNotification)) _mode |= Socket::SELECT_READ;
+	if (accepts(pReactor->_pWritableNotification)) _mode |= Socket::SELECT_WRITE;
+	if (accepts(pReactor->_pErrorNotification)) _mode |= Socket::SELECT_ERROR;
+}
+
+
+void SocketNotifier::dispatch(SocketNotification* pNotification)
+{
+	pNotification->setSocket(_socket);
+	pNotification->duplicate();
+	try
+	{
+		_nc.postNotification(pNotification);
+	}
+	catch (...)
+	{
+		pNotification->setSocket(Socket());
+		throw;
+	}
+	pNotification->setSocket(Socket());
+}
+
+
+} } // namespace Poco::Sockets
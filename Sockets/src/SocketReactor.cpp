@@ -0,0 +1,375 @@
+//
+// SocketReactor.cpp
+//
+// $Id: //poco/svn/Net/src/SocketReactor.cpp#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  SocketReactor
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Sockets/SocketReactor.h"
+#include "Poco/Sockets/SocketNotification.h"
+#include "Poco/Sockets/SocketNotifier.h"
+#include "Poco/ErrorHandler.h"
+#include "Poco/Exception.h"
+
+
+using Poco::FastMutex;
+using Poco::Exception;
+using Poco::ErrorHandler;
+
+
+namespace Poco {
+namespace Sockets {
+
+
+SocketReactor::SocketReactor():
+	_stop(false),
+	_timeout(DEFAULT_TIMEOUT),
+	_pReadableNotification(new ReadableNotification(this)),
+	_pWritableNotification(new WritableNotification(this)),
+	_pErrorNotification(new ErrorNotification(this)),
+	_pTimeoutNotification(new TimeoutNotification(this)),
+	_pIdleNotification(new IdleNotification(this)),
+	_pShutdownNotification(new ShutdownNotification(this))
+{
+}
+
+
+SocketReactor::SocketReactor(const Poco::Timespan& timeout):
+	_stop(false),
+	_timeout(timeout),
+	_pReadableNotification(new ReadableNotification(this)),
+	_pWritableNotification(new WritableNotification(this)),
+	_pErrorNotification(new ErrorNotification(this)),
+	_pTimeoutNotification(new TimeoutNotification(this)),
+	_pIdleNotification(new IdleNotification(this)),
+	_pShutdownNotification(new ShutdownNotification(this))
+{
+}
+
+
+SocketReactor::~SocketReactor()
+{
+}
+
+
+void SocketReactor::run()
+{
+	while (!_stop)
+	{
+		try
+		{
+			if (countSockets() == 0)
+			{
+				onIdle();
+				_wakeUp.tryWait(long(_timeout.totalMilliseconds()));
+				continue;
+			}
+
+			Poco::Timespan timeout(_timeout);
+			{
+				FastMutex::ScopedLock lock(_mutex);
+				if (!_idleTimers.empty() && _idleTimers.resolution() < timeout)
+					timeout = _idleTimers.resolution();
+			}
+
+			const PollSet::SocketModeList& ready = _pollSet.poll(timeout);
+			Poco::Timestamp now;
+			if (ready.empty())
+			{
+				onTimeout();
+			}
+			else
+			{
+				for (PollSet::SocketModeList::const_iterator it = ready.begin(); it != ready.end(); ++it)
+				{
+					NotifierPtr pNotifier = getNotifier(it->first);
+					if (!pNotifier) continue;
+
+					pNotifier->touch(now);
+					if (it->second & Socket::SELECT_READ)
+						dispatch(pNotifier, _pReadableNotification);
+					if (it->second & Socket::SELECT_WRITE)
+						dispatch(pNotifier, _pWritableNotification);
+					if (it->second & Socket::SELECT_ERROR)
+						dispatch(pNotifier, _pErrorNotification);
+				}
+				onBusy();
+			}
+			expireIdleTimers(now);
+		}
+		catch (Exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (std::exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (...)
+		{
+			ErrorHandler::handle();
+		}
+	}
+	onShutdown();
+}
+
+	
+void SocketReactor::stop()
+{
+	_stop = true;
+	_wakeUp.set();
+}
+
+
+void SocketReactor::setTimeout(const Poco::Timespan& timeout)
+{
+	_timeout = timeout;
+}
+
+	
+const Poco::Timespan& SocketReactor::getTimeout() const
+{
+	return _timeout;
+}
+
+
+void SocketReactor::addEventHandler(const Socket& socket, const Poco::AbstractObserver& observer)
+{
+	bool wasEmpty = false;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		NotifierPtr pNotifier;
+		EventHandlerMap::iterator it = _handlers.find(socket.impl());
+		if (it == _handlers.end())
+		{
+			pNotifier = new SocketNotifier(socket);
+			pNotifier->addObserver(this, observer);
+			_pollSet.add(socket, pNotifier->mode());
+			wasEmpty = _handlers.empty();
+			_handlers[socket.impl()] = pNotifier;
+		}
+		else
+		{
+			pNotifier = it->second;
+			if (pNotifier->hasObserver(observer)) return;
+
+			int mode = pNotifier->mode();
+			pNotifier->addObserver(this, observer);
+			if (pNotifier->mode() != mode)
+				_pollSet.update(socket, pNotifier->mode());
+		}
+	}
+	if (wasEmpty) _wakeUp.set();
+}
+
+
+bool SocketReactor::hasEventHandler(const Socket& socket, const Poco::AbstractObserver& observer)
+{
+	NotifierPtr pNotifier = getNotifier(socket);
+	return pNotifier && pNotifier->hasObserver(observer);
+}
+
+
+void SocketReactor::removeEventHandler(const Socket& socket, const Poco::AbstractObserver& observer)
+{
+	NotifierPtr pNotifier;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		EventHandlerMap::iterator it = _handlers.find(socket.impl());
+		if (it == _handlers.end()) return;
+
+		pNotifier = it->second;
+		int mode = pNotifier->mode();
+		pNotifier->removeObserver(this, observer);
+		if (!pNotifier->hasObservers())
+		{
+			_handlers.erase(it);
+			_pollSet.remove(socket);
+		}
+		else if (pNotifier->mode() != mode)
+		{
+			_pollSet.update(socket, pNotifier->mode());
+		}
+	}
+}
+
+
+void SocketReactor::setIdleTimeout(const Socket& socket, const Poco::Timespan& timeout)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	EventHandlerMap::iterator it = _handlers.find(socket.impl());
+	if (it == _handlers.end())
+		throw NotFoundException("No event handler registered for socket");
+
+	NotifierPtr pNotifier = it->second;
+	pNotifier->setIdleTimeout(timeout);
+	if (timeout > 0)
+	{
+		Poco::Timestamp now;
+		Poco::Timestamp deadline = now + timeout.totalMicroseconds();
+		pNotifier->touch(now);
+		pNotifier->setDeadline(deadline);
+		_idleTimers.schedule(socket.impl(), deadline);
+	}
+}
+
+
+std::size_t SocketReactor::countSockets() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _handlers.size();
+}
+
+
+void SocketReactor::onTimeout()
+{
+}
+
+
+void SocketReactor::onIdle()
+{
+	dispatch(_pIdleNotification);
+}
+
+
+void SocketReactor::onShutdown()
+{
+	dispatch(_pShutdownNotification);
+}
+
+
+void SocketReactor::onBusy()
+{
+}
+
+
+SocketReactor::NotifierPtr SocketReactor::getNotifier(const Socket& socket)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	EventHandlerMap::iterator it = _handlers.find(socket.impl());
+	if (it != _handlers.end())
+		return it->second;
+	else
+		return NotifierPtr();
+}
+
+
+void SocketReactor::expireIdleTimers(const Poco::Timestamp& now)
+{
+	std::vector<NotifierPtr> timedOut;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		if (_idleTimers.empty()) return;
+
+		_expired.clear();
+		_idleTimers.advance(now, _expired);
+		for (IdleTimerWheel::TimerList::const_iterator it = _expired.begin(); it != _expired.end(); ++it)
+		{
+			EventHandlerMap::iterator itHandler = _handlers.find(it->first);
+			if (itHandler == _handlers.end()) continue;
+
+			NotifierPtr pNotifier = itHandler->second;
+			Poco::Timespan idleTimeout = pNotifier->getIdleTimeout();
+			// the timer is stale if the socket has been re-registered, or
+			// setIdleTimeout() has been called again since it was scheduled
+			if (idleTimeout == 0 || pNotifier->getDeadline() != it->second) continue;
+
+			Poco::Timestamp due = pNotifier->lastActivity() + idleTimeout.totalMicroseconds();
+			if (due <= now)
+			{
+				timedOut.push_back(pNotifier);
+				pNotifier->touch(now);
+				due = now + idleTimeout.totalMicroseconds();
+			}
+			pNotifier->setDeadline(due);
+			_idleTimers.schedule(pNotifier->socket().impl(), due);
+		}
+	}
+	for (std::vector<NotifierPtr>::iterator it = timedOut.begin(); it != timedOut.end(); ++it)
+	{
+		dispatch(*it, _pTimeoutNotification);
+	}
+}
+
+
+void SocketReactor::dispatch(const Socket& socket, SocketNotification* pNotification)
+{
+	NotifierPtr pNotifier = getNotifier(socket);
+	if (pNotifier) dispatch(pNotifier, pNotification);
+}
+
+
+void SocketReactor::dispatch(SocketNotification* pNotification)
+{
+	std::vector<NotifierPtr> delegates;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		delegates.reserve(_handlers.size());
+		for (EventHandlerMap::iterator it = _handlers.begin(); it != _handlers.end(); ++it)
+			delegates.push_back(it->second);
+	}
+	for (std::vector<NotifierPtr>::iterator it = delegates.begin(); it != delegates.end(); ++it)
+	{
+		dispatch(*it, pNotification);
+	}
+}
+
+
+void SocketReactor::dispatch(NotifierPtr& pNotifier, SocketNotification* pNotification)
+{
+	try
+	{
+		pNotifier->dispatch(pNotification);
+	}
+	catch (Exception& exc)
+	{
+		ErrorHandler::handle(exc);
+	}
+	catch (std::exception& exc)
+	{
+		ErrorHandler::handle(exc);
+	}
+	catch (...)
+	{
+		ErrorHandler::handle();
+	}
+}
+
+
+} } // namespace Poco::Sockets
@@ -36,6 +36,7 @@
 
 #include "Poco/Sockets/StreamSocket.h"
 #include "Poco/Sockets/StreamSocketImpl.h"
+#include "Poco/FileStream.h"
 #include "Poco/Exception.h"
 
 
@@ -143,6 +144,31 @@ int StreamSocket::receiveBytes(void* buffer, int length, int flags)
 }
 
 
+int StreamSocket::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	return impl()->sendBytes(buffers, flags);
+}
+
+
+int StreamSocket::receiveBytes(SocketBufVec& buffers, int flags)
+{
+	return impl()->receiveBytes(buffers, flags);
+}
+
+
+std::streamsize StreamSocket::sendFile(const std::string& path, std::streamoff offset, std::streamsize count)
+{
+	return impl()->sendFile(path, offset, count);
+}
+
+
+std::streamsize StreamSocket::sendFile(Poco::FileInputStream& istr, std::streamoff offset, std::streamsize count)
+{
+	istr.seekg(offset);
+	return impl()->sendFile(istr, count);
+}
+
+
 void StreamSocket::sendUrgent(unsigned char data)
 {
 	impl()->sendUrgent(data);
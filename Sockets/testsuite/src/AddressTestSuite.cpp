@@ -34,6 +34,7 @@
 #include "AddressTest.h"
 #include "SocketAddressTest.h"
 #include "DNSTest.h"
+#include "ResolverTest.h"
 
 
 CppUnit::Test* AddressTestSuite::suite()
@@ -43,6 +44,7 @@ CppUnit::Test* AddressTestSuite::suite()
 	pSuite->addTest(AddressTest::suite());
 	pSuite->addTest(SocketAddressTest::suite());
 	pSuite->addTest(DNSTest::suite());
+	pSuite->addTest(ResolverTest::suite());
 
 	return pSuite;
 }
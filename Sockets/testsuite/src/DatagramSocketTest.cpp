@@ -39,17 +39,24 @@
 #include "Poco/Sockets/SocketException.h"
 #include "Poco/Timespan.h"
 #include "Poco/Stopwatch.h"
+#include "Poco/NumberFormatter.h"
+#include <vector>
+#include <cstdlib>
+#include <iostream>
 
 
 using Poco::Sockets::Socket;
 using Poco::Sockets::DatagramSocket;
 using Poco::Sockets::SocketAddress;
 using Poco::Sockets::Address;
+using Poco::Sockets::DatagramBatch;
 using Poco::Timespan;
 using Poco::Stopwatch;
 using Poco::TimeoutException;
 using Poco::InvalidArgumentException;
 using Poco::IOException;
+using Poco::NotImplementedException;
+using Poco::NumberFormatter;
 
 
 DatagramSocketTest::DatagramSocketTest(const std::string& name): CppUnit::TestCase(name)
@@ -119,6 +126,197 @@ void DatagramSocketTest::testBroadcast()
 }
 
 
+void DatagramSocketTest::testSendReceiveBatch()
+{
+	UDPEchoServer echoServer(256, 16);
+	DatagramSocket ss;
+	SocketAddress sa("localhost", echoServer.port());
+
+	const int count = 16;
+	DatagramBatch out(count, 64);
+	for (int i = 0; i < count; ++i)
+	{
+		std::string msg = "message " + NumberFormatter::format(i);
+		out.assign(i, msg.data(), int(msg.size()), sa);
+	}
+	int n = ss.sendBatch(out, count);
+	assert (n == count);
+
+	ss.setReceiveTimeout(Timespan(5, 0));
+	DatagramBatch in(32, 64);
+	std::vector<bool> seen(count, false);
+	int received = 0;
+	while (received < count)
+	{
+		n = ss.receiveBatch(in);
+		assert (n > 0 && n <= 32);
+		for (int i = 0; i < n; ++i)
+		{
+			std::string msg(in.buffer(i), in.length(i));
+			assert (msg.compare(0, 8, "message ") == 0);
+			int index = std::atoi(msg.c_str() + 8);
+			assert (index >= 0 && index < count && !seen[index]);
+			seen[index] = true;
+			assert (in.hasAddress(i));
+			assert (in.address(i).port() == echoServer.port());
+		}
+		received += n;
+	}
+
+	// slots without address go to the connected peer
+	DatagramSocket cs;
+	cs.connect(sa);
+	out.clearAddress(0);
+	out.clearAddress(1);
+	n = cs.sendBatch(out, 2);
+	assert (n == 2);
+	cs.setReceiveTimeout(Timespan(5, 0));
+	received = 0;
+	while (received < 2)
+	{
+		received += cs.receiveBatch(in);
+	}
+	assert (std::string(in.buffer(received - 1), in.length(received - 1)) == "message 1");
+
+	in.clearAddress(0);
+	try
+	{
+		in.address(0);
+		fail("slot has no address - must throw");
+	}
+	catch (Poco::InvalidAccessException&)
+	{
+	}
+
+	DatagramSocket idle(SocketAddress("localhost", 0));
+	idle.setReceiveTimeout(Timespan(0, 100000));
+	try
+	{
+		idle.receiveBatch(in);
+		fail("nothing to receive - must throw");
+	}
+	catch (TimeoutException&)
+	{
+	}
+}
+
+
+void DatagramSocketTest::testReusePort()
+{
+	DatagramSocket s1;
+	try
+	{
+		s1.bind(SocketAddress("localhost", 0), false, true);
+	}
+	catch (NotImplementedException&)
+	{
+		std::cout << "SO_REUSEPORT not supported, test skipped" << std::endl;
+		return;
+	}
+	SocketAddress sa = s1.address();
+	DatagramSocket s2;
+	s2.bind(sa, false, true);
+	assert (s2.address().port() == sa.port());
+	assert (s1.getReusePort());
+	assert (s2.getReusePort());
+
+	// the kernel picks the receiving socket by hashing the sender
+	// address, so use many senders to reach both sockets
+	const int senders = 64;
+	for (int i = 0; i < senders; ++i)
+	{
+		DatagramSocket client;
+		client.sendTo("hello", 5, sa);
+	}
+
+	DatagramBatch batch(senders, 16);
+	DatagramSocket* sockets[] = {&s1, &s2};
+	int received[] = {0, 0};
+	for (int s = 0; s < 2; ++s)
+	{
+		sockets[s]->setReceiveTimeout(Timespan(0, 200000));
+		try
+		{
+			for (;;) received[s] += sockets[s]->receiveBatch(batch);
+		}
+		catch (TimeoutException&)
+		{
+		}
+	}
+	assert (received[0] + received[1] == senders);
+	assert (received[0] > 0 && received[1] > 0);
+}
+
+
+void DatagramSocketTest::testBatchPerformance()
+{
+	const int window = 64;
+	const int size = 64;
+	const Poco::Timestamp::TimeDiff duration = 1000000;
+
+	std::cout << std::endl;
+	for (int mode = 0; mode < 2; ++mode)
+	{
+		UDPEchoServer echoServer(size, mode == 0 ? 0 : window);
+		DatagramSocket ss;
+		ss.connect(SocketAddress("localhost", echoServer.port()));
+		ss.setReceiveTimeout(Timespan(0, 100000));
+
+		DatagramBatch batch(window, size);
+		for (int i = 0; i < window; ++i)
+			batch.assign(i, std::string(size, 'x').data(), size);
+		char buffer[size];
+
+		Poco::UInt64 echoed = 0;
+		Poco::UInt64 lost = 0;
+		Stopwatch sw;
+		sw.start();
+		while (sw.elapsed() < duration)
+		{
+			int pending = window;
+			if (mode == 0)
+			{
+				for (int i = 0; i < window; ++i)
+					ss.sendBytes(batch.buffer(i), size);
+			}
+			else
+			{
+				ss.sendBatch(batch, window);
+			}
+			try
+			{
+				while (pending > 0)
+				{
+					if (mode == 0)
+					{
+						ss.receiveBytes(buffer, sizeof(buffer));
+						--pending;
+					}
+					else pending -= ss.receiveBatch(batch);
+				}
+			}
+			catch (TimeoutException&)
+			{
+				lost += pending;
+			}
+			echoed += window - pending;
+			for (int i = 0; i < window; ++i)
+			{
+				batch.setLength(i, size);
+				batch.clearAddress(i);
+			}
+		}
+		sw.stop();
+
+		std::cout << (mode == 0 ? "one datagram per call:  " : "batches of 64 datagrams: ")
+			<< echoed << " datagrams echoed in " << sw.elapsed()/1000 << " [ms], "
+			<< (echoed*2)/(sw.elapsed()/1000000.0) << " [packets/s]";
+		if (lost > 0) std::cout << ", " << lost << " lost";
+		std::cout << std::endl;
+	}
+}
+
+
 void DatagramSocketTest::setUp()
 {
 }
@@ -136,6 +334,9 @@ CppUnit::Test* DatagramSocketTest::suite()
 	CppUnit_addTest(pSuite, DatagramSocketTest, testEcho);
 	CppUnit_addTest(pSuite, DatagramSocketTest, testSendToReceiveFrom);
 	CppUnit_addTest(pSuite, DatagramSocketTest, testBroadcast);
+	CppUnit_addTest(pSuite, DatagramSocketTest, testSendReceiveBatch);
+	CppUnit_addTest(pSuite, DatagramSocketTest, testReusePort);
+	CppUnit_addTest(pSuite, DatagramSocketTest, testBatchPerformance);
 
 	return pSuite;
 }
@@ -49,6 +49,9 @@ public:
 	void testEcho();
 	void testSendToReceiveFrom();
 	void testBroadcast();
+	void testSendReceiveBatch();
+	void testReusePort();
+	void testBatchPerformance();
 
 	void setUp();
 	void tearDown();
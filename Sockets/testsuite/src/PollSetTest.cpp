@@ -0,0 +1,400 @@
+//
+// PollSetTest.cpp
+//
+// $Id: //poco/svn/Sockets/testsuite/src/PollSetTest.cpp#1 $
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "PollSetTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "EchoServer.h"
+#include "Poco/Sockets/PollSet.h"
+#include "Poco/Sockets/StreamSocket.h"
+#include "Poco/Sockets/DatagramSocket.h"
+#include "Poco/Sockets/SocketAddress.h"
+#include "Poco/Timespan.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/Exception.h"
+#include <iostream>
+#include <algorithm>
+#ifdef POCO_OS_FAMILY_UNIX
+#include <sys/resource.h>
+#endif
+
+
+using Poco::Sockets::PollSet;
+using Poco::Sockets::Socket;
+using Poco::Sockets::StreamSocket;
+using Poco::Sockets::DatagramSocket;
+using Poco::Sockets::SocketAddress;
+using Poco::Timespan;
+using Poco::Stopwatch;
+using Poco::InvalidArgumentException;
+using Poco::NotFoundException;
+using Poco::NotImplementedException;
+
+
+namespace
+{
+	int collect(PollSet& pollSet, Socket::SocketList& ready, std::size_t expected)
+		/// Polls until the expected number of distinct sockets
+		/// has been reported readable, or a poll() times out.
+	{
+		while (ready.size() < expected)
+		{
+			const PollSet::SocketModeList& sml = pollSet.poll(Timespan(250000));
+			if (sml.empty()) break;
+			for (PollSet::SocketModeList::const_iterator it = sml.begin(); it != sml.end(); ++it)
+			{
+				if (std::find(ready.begin(), ready.end(), it->first) == ready.end())
+					ready.push_back(it->first);
+			}
+		}
+		return int(ready.size());
+	}
+}
+
+
+PollSetTest::PollSetTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+PollSetTest::~PollSetTest()
+{
+}
+
+
+void PollSetTest::testAddUpdateRemove()
+{
+	DatagramSocket s1(SocketAddress("127.0.0.1", 0));
+	DatagramSocket s2(SocketAddress("127.0.0.1", 0));
+
+	PollSet pollSet;
+	assert (pollSet.empty());
+	assert (pollSet.trigger() == PollSet::TRIGGER_LEVEL);
+
+	pollSet.add(s1, Socket::SELECT_READ);
+	assert (pollSet.has(s1));
+	assert (!pollSet.has(s2));
+	assert (pollSet.count() == 1);
+	try
+	{
+		pollSet.add(s1, Socket::SELECT_WRITE);
+		fail("already registered - must throw");
+	}
+	catch (InvalidArgumentException&)
+	{
+	}
+
+	pollSet.add(s2, Socket::SELECT_READ | Socket::SELECT_WRITE);
+	assert (pollSet.count() == 2);
+
+	pollSet.update(s1, Socket::SELECT_WRITE);
+	try
+	{
+		DatagramSocket s3(SocketAddress("127.0.0.1", 0));
+		pollSet.update(s3, Socket::SELECT_WRITE);
+		fail("not registered - must throw");
+	}
+	catch (NotFoundException&)
+	{
+	}
+
+	const PollSet::SocketModeList& ready = pollSet.poll(Timespan(250000));
+	assert (ready.size() == 2);
+	for (PollSet::SocketModeList::const_iterator it = ready.begin(); it != ready.end(); ++it)
+	{
+		assert (it->first == s1 || it->first == s2);
+		assert (it->second == Socket::SELECT_WRITE);
+	}
+
+	pollSet.remove(s1);
+	assert (!pollSet.has(s1));
+	assert (pollSet.count() == 1);
+	pollSet.remove(s1);
+	assert (pollSet.count() == 1);
+
+	pollSet.clear();
+	assert (pollSet.empty());
+	assert (pollSet.poll(Timespan(0)).empty());
+}
+
+
+void PollSetTest::testPoll()
+{
+	Timespan timeout(250000);
+
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("localhost", echoServer.port()));
+
+	PollSet pollSet;
+	pollSet.add(ss, Socket::SELECT_READ);
+	assert (pollSet.poll(timeout).empty());
+
+	ss.sendBytes("hello", 5);
+
+	const PollSet::SocketModeList* pReady = &pollSet.poll(timeout);
+	assert (pReady->size() == 1);
+	assert (pReady->front().first == ss);
+	assert (pReady->front().second == Socket::SELECT_READ);
+
+	pollSet.update(ss, Socket::SELECT_READ | Socket::SELECT_WRITE);
+	pReady = &pollSet.poll(timeout);
+	assert (pReady->size() == 1);
+	assert (pReady->front().second == (Socket::SELECT_READ | Socket::SELECT_WRITE));
+
+	char buffer[256];
+	int n = ss.receiveBytes(buffer, sizeof(buffer));
+	assert (n == 5);
+	assert (std::string(buffer, n) == "hello");
+
+	pollSet.update(ss, Socket::SELECT_READ);
+	assert (pollSet.poll(timeout).empty());
+
+	pollSet.remove(ss);
+	ss.close();
+}
+
+
+void PollSetTest::testPollMany()
+{
+	std::vector<DatagramSocket> sockets;
+	PollSet pollSet;
+	for (int i = 0; i < 20; ++i)
+	{
+		DatagramSocket s(SocketAddress("127.0.0.1", 0));
+		sockets.push_back(s);
+		pollSet.add(s, Socket::SELECT_READ);
+	}
+	assert (pollSet.poll(Timespan(0)).empty());
+
+	DatagramSocket sender(SocketAddress("127.0.0.1", 0));
+	sender.sendTo("a", 1, sockets[3].address());
+	sender.sendTo("b", 1, sockets[11].address());
+	sender.sendTo("c", 1, sockets[19].address());
+
+	Socket::SocketList ready;
+	assert (collect(pollSet, ready, 3) == 3);
+	assert (std::find(ready.begin(), ready.end(), sockets[3]) != ready.end());
+	assert (std::find(ready.begin(), ready.end(), sockets[11]) != ready.end());
+	assert (std::find(ready.begin(), ready.end(), sockets[19]) != ready.end());
+
+	char buffer[16];
+	assert (sockets[11].receiveBytes(buffer, sizeof(buffer)) == 1);
+	assert (buffer[0] == 'b');
+
+	const PollSet::SocketModeList& sml = pollSet.poll(Timespan(250000));
+	assert (sml.size() == 2);
+	for (PollSet::SocketModeList::const_iterator it = sml.begin(); it != sml.end(); ++it)
+		assert (it->first == sockets[3] || it->first == sockets[19]);
+}
+
+
+void PollSetTest::testPollRemoved()
+{
+	DatagramSocket s1(SocketAddress("127.0.0.1", 0));
+	DatagramSocket s2(SocketAddress("127.0.0.1", 0));
+	DatagramSocket sender(SocketAddress("127.0.0.1", 0));
+
+	PollSet pollSet;
+	pollSet.add(s1, Socket::SELECT_READ);
+	pollSet.add(s2, Socket::SELECT_READ);
+	sender.sendTo("x", 1, s1.address());
+	sender.sendTo("y", 1, s2.address());
+
+	Socket::SocketList ready;
+	assert (collect(pollSet, ready, 2) == 2);
+
+	pollSet.remove(s1);
+	const PollSet::SocketModeList& sml = pollSet.poll(Timespan(250000));
+	assert (sml.size() == 1);
+	assert (sml.front().first == s2);
+
+	pollSet.add(s1, Socket::SELECT_READ);
+	pollSet.remove(s2);
+	assert (pollSet.poll(Timespan(250000)).front().first == s1);
+}
+
+
+void PollSetTest::testRemoveClosed()
+{
+	DatagramSocket s1(SocketAddress("127.0.0.1", 0));
+	DatagramSocket sender(SocketAddress("127.0.0.1", 0));
+
+	PollSet pollSet;
+	pollSet.add(s1, Socket::SELECT_READ);
+	s1.close();
+
+	// the new socket usually gets the descriptor just freed by s1
+	DatagramSocket s2(SocketAddress("127.0.0.1", 0));
+	pollSet.add(s2, Socket::SELECT_READ);
+	pollSet.remove(s1);
+	assert (!pollSet.has(s1));
+	assert (pollSet.has(s2));
+	assert (pollSet.count() == 1);
+
+	sender.sendTo("x", 1, s2.address());
+	const PollSet::SocketModeList& sml = pollSet.poll(Timespan(250000));
+	assert (sml.size() == 1);
+	assert (sml.front().first == s2);
+}
+
+
+void PollSetTest::testEdgeTriggered()
+{
+#if POCO_OS == POCO_OS_LINUX
+	DatagramSocket s(SocketAddress("127.0.0.1", 0));
+	DatagramSocket sender(SocketAddress("127.0.0.1", 0));
+
+	PollSet pollSet(PollSet::TRIGGER_EDGE);
+	assert (pollSet.trigger() == PollSet::TRIGGER_EDGE);
+	pollSet.add(s, Socket::SELECT_READ);
+	assert (pollSet.poll(Timespan(0)).empty());
+
+	sender.sendTo("1", 1, s.address());
+	assert (pollSet.poll(Timespan(250000)).size() == 1);
+	// data is still pending, but there has been no new edge
+	assert (pollSet.poll(Timespan(0)).empty());
+
+	sender.sendTo("2", 1, s.address());
+	assert (pollSet.poll(Timespan(250000)).size() == 1);
+
+	char buffer[16];
+	assert (s.receiveBytes(buffer, sizeof(buffer)) == 1);
+	assert (s.receiveBytes(buffer, sizeof(buffer)) == 1);
+	assert (pollSet.poll(Timespan(0)).empty());
+#else
+	try
+	{
+		PollSet pollSet(PollSet::TRIGGER_EDGE);
+		fail("edge-triggered mode not supported - must throw");
+	}
+	catch (NotImplementedException&)
+	{
+	}
+#endif
+}
+
+
+void PollSetTest::testPollSetPerformance()
+{
+	static const int sizes[] = { 100, 1000, 10000, 50000 };
+	static const int active = 4;
+
+	int maxSockets = 0x7FFFFFFF;
+#ifdef POCO_OS_FAMILY_UNIX
+	struct rlimit rl;
+	if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY)
+		maxSockets = int(rl.rlim_cur) - 100;
+#endif
+
+	std::cout << std::endl;
+	DatagramSocket sender(SocketAddress("127.0.0.1", 0));
+	for (std::size_t i = 0; i < sizeof(sizes)/sizeof(sizes[0]); ++i)
+	{
+		int n = sizes[i];
+		if (n > maxSockets)
+		{
+			std::cout << n << " sockets: skipped, descriptor limit is " << maxSockets + 100 << std::endl;
+			continue;
+		}
+
+		std::vector<DatagramSocket> sockets;
+		sockets.reserve(n);
+		Socket::SocketList socketList;
+		PollSet pollSet;
+		for (int j = 0; j < n; ++j)
+		{
+			DatagramSocket s(SocketAddress("127.0.0.1", 0));
+			sockets.push_back(s);
+			socketList.push_back(s);
+			pollSet.add(s, Socket::SELECT_READ);
+		}
+		for (int j = 0; j < active; ++j)
+			sender.sendTo("x", 1, sockets[j*(n/active)].address());
+
+		Socket::SocketList ready;
+		assert (collect(pollSet, ready, active) == active);
+
+		int pollSetReps = 1000;
+		Stopwatch sw;
+		sw.start();
+		for (int j = 0; j < pollSetReps; ++j)
+			assert (pollSet.poll(Timespan(0)).size() == active);
+		sw.stop();
+		double pollSetTime = double(sw.elapsed())/pollSetReps;
+
+#if defined(POCO_HAVE_FD_POLL)
+		int socketPollReps = n > 1000 ? 3 : 100;
+		sw.restart();
+		for (int j = 0; j < socketPollReps; ++j)
+		{
+			Socket::SocketList readList(socketList);
+			Socket::SocketList writeList;
+			Socket::SocketList exceptList;
+			assert (Socket::poll(readList, writeList, exceptList, Timespan(0)) == active);
+		}
+		sw.stop();
+		double socketPollTime = double(sw.elapsed())/socketPollReps;
+
+		std::cout << n << " sockets, " << active << " active: Socket::poll() " << socketPollTime
+			<< " [us], PollSet::poll() " << pollSetTime << " [us]" << std::endl;
+#else
+		std::cout << n << " sockets, " << active << " active: PollSet::poll() " << pollSetTime << " [us]" << std::endl;
+#endif
+	}
+}
+
+
+void PollSetTest::setUp()
+{
+}
+
+
+void PollSetTest::tearDown()
+{
+}
+
+
+CppUnit::Test* PollSetTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("PollSetTest");
+
+	CppUnit_addTest(pSuite, PollSetTest, testAddUpdateRemove);
+	CppUnit_addTest(pSuite, PollSetTest, testPoll);
+	CppUnit_addTest(pSuite, PollSetTest, testPollMany);
+	CppUnit_addTest(pSuite, PollSetTest, testPollRemoved);
+	CppUnit_addTest(pSuite, PollSetTest, testRemoveClosed);
+	CppUnit_addTest(pSuite, PollSetTest, testEdgeTriggered);
+	CppUnit_addTest(pSuite, PollSetTest, testPollSetPerformance);
+
+	return pSuite;
+}
@@ -0,0 +1,437 @@
+//
+// ResolverTest.cpp
+//
+// $Id: //poco/svn/Sockets/testsuite/src/ResolverTest.cpp#1 $
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "ResolverTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Sockets/Resolver.h"
+#include "Poco/Sockets/ResolverBackend.h"
+#include "Poco/Sockets/DNS.h"
+#include "Poco/Sockets/SocketException.h"
+#include "Poco/Mutex.h"
+#include "Poco/Event.h"
+#include "Poco/Thread.h"
+#include "Poco/Stopwatch.h"
+#include <map>
+#include <vector>
+
+
+using Poco::Sockets::Resolver;
+using Poco::Sockets::ResolverBackend;
+using Poco::Sockets::DNS;
+using Poco::Sockets::Address;
+using Poco::Sockets::HostEntry;
+using Poco::Sockets::HostNotFoundException;
+using Poco::Sockets::NoAddressFoundException;
+using Poco::Sockets::DNSException;
+using Poco::FastMutex;
+using Poco::Timespan;
+using Poco::Thread;
+using Poco::Stopwatch;
+
+
+namespace
+{
+	class FakeBackend: public ResolverBackend
+		/// A ResolverBackend serving names from a table, for testing.
+		///
+		/// Lookups of names added with slow = true wait until
+		/// release() is called.
+	{
+	public:
+		FakeBackend():
+			_gate(false),
+			_calls(0)
+		{
+		}
+
+		void add(const std::string& name, const std::string& address, bool slow = false)
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			_hosts[name] = address;
+			if (slow) _slow[name] = true;
+		}
+
+		void setTTL(const std::string& name, const Timespan& ttl)
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			_ttls[name] = ttl;
+		}
+
+		void setFailing(const std::string& name)
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			_failing[name] = true;
+		}
+
+		void release()
+		{
+			_gate.set();
+		}
+
+		int calls()
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			return _calls;
+		}
+
+		HostEntry hostByName(const std::string& hostname, Timespan& ttl)
+		{
+			bool slow;
+			{
+				FastMutex::ScopedLock lock(_mutex);
+				++_calls;
+				slow = _slow.find(hostname) != _slow.end();
+			}
+			if (slow) _gate.wait();
+
+			FastMutex::ScopedLock lock(_mutex);
+			if (_failing.find(hostname) != _failing.end())
+				throw DNSException("Temporary DNS error while resolving", hostname);
+			std::map<std::string, std::string>::const_iterator it = _hosts.find(hostname);
+			if (it == _hosts.end())
+				throw HostNotFoundException(hostname);
+			std::map<std::string, Timespan>::const_iterator itTTL = _ttls.find(hostname);
+			if (itTTL != _ttls.end())
+				ttl = itTTL->second;
+			return HostEntry(hostname, HostEntry::AddressList(1, Address(it->second)));
+		}
+
+		HostEntry hostByAddress(const Address& address, Timespan& ttl)
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			++_calls;
+			for (std::map<std::string, std::string>::const_iterator it = _hosts.begin(); it != _hosts.end(); ++it)
+			{
+				if (it->second == address.toString())
+					return HostEntry(it->first, HostEntry::AddressList(1, address));
+			}
+			throw HostNotFoundException(address.toString());
+		}
+
+	private:
+		FastMutex                           _mutex;
+		Poco::Event                         _gate;
+		int                                 _calls;
+		std::map<std::string, std::string>  _hosts;
+		std::map<std::string, bool>         _slow;
+		std::map<std::string, bool>         _failing;
+		std::map<std::string, Timespan>     _ttls;
+	};
+
+
+	bool waitFor(FakeBackend& backend, int calls)
+	{
+		for (int i = 0; i < 500 && backend.calls() < calls; ++i)
+			Thread::sleep(10);
+		return backend.calls() == calls;
+	}
+}
+
+
+ResolverTest::ResolverTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+ResolverTest::~ResolverTest()
+{
+}
+
+
+void ResolverTest::testSystemBackend()
+{
+	Resolver resolver;
+	HostEntry entry = resolver.hostByName("localhost");
+	bool found = false;
+	for (HostEntry::AddressList::const_iterator it = entry.addresses().begin(); it != entry.addresses().end(); ++it)
+	{
+		if (it->isLoopback()) found = true;
+	}
+	assert (found);
+	assert (resolver.size() == 1);
+
+	entry = resolver.hostByAddress(Address("127.0.0.1"));
+	assert (!entry.name().empty());
+	assert (entry.addresses().size() == 1);
+	assert (entry.addresses()[0].toString() == "127.0.0.1");
+	assert (resolver.size() == 2);
+
+	entry = DNS::hostByName("localhost");
+	assert (!entry.addresses().empty());
+}
+
+
+void ResolverTest::testCache()
+{
+	FakeBackend* pBackend = new FakeBackend;
+	pBackend->add("www.example.com", "192.0.2.1");
+	Resolver resolver(pBackend);
+
+	HostEntry entry = resolver.hostByName("www.example.com");
+	assert (entry.name() == "www.example.com");
+	assert (entry.addresses().size() == 1);
+	assert (entry.addresses()[0].toString() == "192.0.2.1");
+	assert (pBackend->calls() == 1);
+
+	entry = resolver.hostByName("www.example.com");
+	assert (entry.addresses()[0].toString() == "192.0.2.1");
+	assert (pBackend->calls() == 1);
+
+	entry = resolver.hostByAddress(Address("192.0.2.1"));
+	assert (entry.name() == "www.example.com");
+	entry = resolver.hostByAddress(Address("192.0.2.1"));
+	assert (pBackend->calls() == 2);
+	assert (resolver.size() == 2);
+
+	resolver.flush();
+	assert (resolver.size() == 0);
+	resolver.hostByName("www.example.com");
+	assert (pBackend->calls() == 3);
+}
+
+
+void ResolverTest::testNegativeCache()
+{
+	FakeBackend* pBackend = new FakeBackend;
+	Resolver resolver(pBackend);
+	resolver.setNegativeTTL(Timespan(0, 100000));
+
+	for (int i = 0; i < 3; ++i)
+	{
+		try
+		{
+			resolver.hostByName("nonexistent.example.com");
+			fail("host not found - must throw");
+		}
+		catch (HostNotFoundException&)
+		{
+		}
+	}
+	assert (pBackend->calls() == 1);
+	assert (resolver.size() == 1);
+
+	Thread::sleep(200);
+	pBackend->add("nonexistent.example.com", "192.0.2.2");
+	HostEntry entry = resolver.hostByName("nonexistent.example.com");
+	assert (entry.addresses()[0].toString() == "192.0.2.2");
+	assert (pBackend->calls() == 2);
+}
+
+
+void ResolverTest::testTemporaryFailure()
+{
+	FakeBackend* pBackend = new FakeBackend;
+	pBackend->add("flaky.example.com", "192.0.2.3");
+	pBackend->setFailing("flaky.example.com");
+	Resolver resolver(pBackend);
+
+	for (int i = 0; i < 2; ++i)
+	{
+		try
+		{
+			resolver.hostByName("flaky.example.com");
+			fail("temporary failure - must throw");
+		}
+		catch (HostNotFoundException&)
+		{
+			fail("temporary failure - must not be reported as host not found");
+		}
+		catch (DNSException&)
+		{
+		}
+	}
+	assert (pBackend->calls() == 2);
+	assert (resolver.size() == 0);
+}
+
+
+void ResolverTest::testEntryTTL()
+{
+	FakeBackend* pBackend = new FakeBackend;
+	pBackend->add("short.example.com", "192.0.2.4");
+	pBackend->add("long.example.com", "192.0.2.5");
+	pBackend->setTTL("short.example.com", Timespan(0, 100000));
+	Resolver resolver(pBackend);
+	resolver.setMaxStale(0);
+
+	resolver.hostByName("short.example.com");
+	resolver.hostByName("long.example.com");
+	assert (pBackend->calls() == 2);
+
+	Thread::sleep(200);
+	resolver.hostByName("short.example.com");
+	resolver.hostByName("long.example.com");
+	assert (pBackend->calls() == 3);
+}
+
+
+void ResolverTest::testStaleRefresh()
+{
+	FakeBackend* pBackend = new FakeBackend;
+	pBackend->add("www.example.com", "192.0.2.6");
+	Resolver resolver(pBackend);
+	resolver.setTTL(Timespan(0, 500000));
+	resolver.setMaxStale(Timespan(60, 0));
+
+	resolver.hostByName("www.example.com");
+	assert (pBackend->calls() == 1);
+
+	Thread::sleep(600);
+	pBackend->add("www.example.com", "192.0.2.7");
+	HostEntry entry = resolver.hostByName("www.example.com");
+	assert (entry.addresses()[0].toString() == "192.0.2.6");
+	assert (waitFor(*pBackend, 2));
+
+	// wait for the refreshed entry to be stored
+	for (int i = 0; i < 500; ++i)
+	{
+		entry = resolver.hostByName("www.example.com");
+		if (entry.addresses()[0].toString() == "192.0.2.7") break;
+		Thread::sleep(10);
+	}
+	assert (entry.addresses()[0].toString() == "192.0.2.7");
+	assert (pBackend->calls() == 2);
+}
+
+
+void ResolverTest::testCoalescing()
+{
+	FakeBackend* pBackend = new FakeBackend;
+	pBackend->add("slow.example.com", "192.0.2.8", true);
+	Resolver resolver(pBackend);
+
+	std::vector<Resolver::Result> results;
+	for (int i = 0; i < 8; ++i)
+	{
+		results.push_back(resolver.hostByNameAsync("slow.example.com"));
+	}
+	assert (waitFor(*pBackend, 1));
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		assert (!results[i].available());
+	}
+
+	pBackend->release();
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		HostEntry entry = Resolver::get(results[i]);
+		assert (entry.addresses()[0].toString() == "192.0.2.8");
+	}
+	assert (pBackend->calls() == 1);
+}
+
+
+void ResolverTest::testIndependentNames()
+{
+	FakeBackend* pBackend = new FakeBackend;
+	pBackend->add("slow.example.com", "192.0.2.9", true);
+	pBackend->add("fast.example.com", "192.0.2.10");
+	Resolver resolver(pBackend);
+
+	Resolver::Result slow = resolver.hostByNameAsync("slow.example.com");
+	assert (waitFor(*pBackend, 1));
+
+	// a lookup in progress must not block lookups of other names
+	Stopwatch sw;
+	sw.start();
+	HostEntry entry = resolver.hostByName("fast.example.com");
+	sw.stop();
+	assert (entry.addresses()[0].toString() == "192.0.2.10");
+	assert (sw.elapsed() < 1000000);
+	assert (!slow.available());
+
+	pBackend->release();
+	entry = Resolver::get(slow);
+	assert (entry.addresses()[0].toString() == "192.0.2.9");
+}
+
+
+void ResolverTest::testAsync()
+{
+	FakeBackend* pBackend = new FakeBackend;
+	pBackend->add("www.example.com", "192.0.2.11");
+	Resolver resolver(pBackend);
+
+	Resolver::Result result = resolver.hostByNameAsync("www.example.com");
+	HostEntry entry = Resolver::get(result);
+	assert (entry.addresses()[0].toString() == "192.0.2.11");
+
+	// cached entries are returned in a completed result
+	result = resolver.hostByNameAsync("www.example.com");
+	assert (result.available());
+	assert (pBackend->calls() == 1);
+
+	result = resolver.hostByNameAsync("nonexistent.example.com");
+	result.wait();
+	assert (result.failed());
+	try
+	{
+		Resolver::get(result);
+		fail("host not found - must throw");
+	}
+	catch (HostNotFoundException&)
+	{
+	}
+
+	result = resolver.hostByAddressAsync(Address("192.0.2.11"));
+	entry = Resolver::get(result);
+	assert (entry.name() == "www.example.com");
+}
+
+
+void ResolverTest::setUp()
+{
+}
+
+
+void ResolverTest::tearDown()
+{
+}
+
+
+CppUnit::Test* ResolverTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ResolverTest");
+
+	CppUnit_addTest(pSuite, ResolverTest, testSystemBackend);
+	CppUnit_addTest(pSuite, ResolverTest, testCache);
+	CppUnit_addTest(pSuite, ResolverTest, testNegativeCache);
+	CppUnit_addTest(pSuite, ResolverTest, testTemporaryFailure);
+	CppUnit_addTest(pSuite, ResolverTest, testEntryTTL);
+	CppUnit_addTest(pSuite, ResolverTest, testStaleRefresh);
+	CppUnit_addTest(pSuite, ResolverTest, testCoalescing);
+	CppUnit_addTest(pSuite, ResolverTest, testIndependentNames);
+	CppUnit_addTest(pSuite, ResolverTest, testAsync);
+
+	return pSuite;
+}
@@ -0,0 +1,564 @@
+//
+// SocketReactorTest.cpp
+//
+// $Id: //poco/svn/Sockets/testsuite/src/SocketReactorTest.cpp#1 $
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "SocketReactorTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Sockets/SocketReactor.h"
+#include "Poco/Sockets/SocketNotification.h"
+#include "Poco/Sockets/SocketConnector.h"
+#include "Poco/Sockets/SocketAcceptor.h"
+#include "Poco/Sockets/ParallelSocketAcceptor.h"
+#include "Poco/Sockets/ParallelSocketReactor.h"
+#include "Poco/Sockets/TimerWheel.h"
+#include "Poco/Sockets/StreamSocket.h"
+#include "Poco/Sockets/ServerSocket.h"
+#include "Poco/Sockets/SocketAddress.h"
+#include "Poco/Observer.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include "Poco/Mutex.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Timespan.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#ifdef POCO_OS_FAMILY_UNIX
+#include <sys/resource.h>
+#endif
+
+
+using Poco::Sockets::SocketReactor;
+using Poco::Sockets::SocketConnector;
+using Poco::Sockets::SocketAcceptor;
+using Poco::Sockets::ParallelSocketAcceptor;
+using Poco::Sockets::ParallelSocketReactor;
+using Poco::Sockets::TimerWheel;
+using Poco::Sockets::StreamSocket;
+using Poco::Sockets::ServerSocket;
+using Poco::Sockets::SocketAddress;
+using Poco::Sockets::SocketNotification;
+using Poco::Sockets::ReadableNotification;
+using Poco::Sockets::WritableNotification;
+using Poco::Sockets::TimeoutNotification;
+using Poco::Sockets::ShutdownNotification;
+using Poco::Observer;
+using Poco::Thread;
+using Poco::Event;
+using Poco::Stopwatch;
+using Poco::Timestamp;
+using Poco::Timespan;
+
+
+namespace
+{
+	class EchoServiceHandler
+	{
+	public:
+		EchoServiceHandler(const StreamSocket& socket, SocketReactor& reactor):
+			_socket(socket),
+			_reactor(reactor)
+		{
+			_reactor.addEventHandler(_socket, Observer<EchoServiceHandler, ReadableNotification>(*this, &EchoServiceHandler::onReadable));
+			_reactor.addEventHandler(_socket, Observer<EchoServiceHandler, ShutdownNotification>(*this, &EchoServiceHandler::onShutdown));
+		}
+
+		~EchoServiceHandler()
+		{
+			_reactor.removeEventHandler(_socket, Observer<EchoServiceHandler, ReadableNotification>(*this, &EchoServiceHandler::onReadable));
+			_reactor.removeEventHandler(_socket, Observer<EchoServiceHandler, ShutdownNotification>(*this, &EchoServiceHandler::onShutdown));
+		}
+
+		void onReadable(ReadableNotification* pNf)
+		{
+			pNf->release();
+			char buffer[1024];
+			int n = _socket.receiveBytes(buffer, sizeof(buffer));
+			if (n > 0)
+				_socket.sendBytes(buffer, n);
+			else
+				delete this;
+		}
+
+		void onShutdown(ShutdownNotification* pNf)
+		{
+			pNf->release();
+			delete this;
+		}
+
+	private:
+		StreamSocket   _socket;
+		SocketReactor& _reactor;
+	};
+
+
+	class ClientServiceHandler
+	{
+	public:
+		ClientServiceHandler(const StreamSocket& socket, SocketReactor& reactor):
+			_socket(socket),
+			_reactor(reactor)
+		{
+			_data.clear();
+			_reactor.addEventHandler(_socket, Observer<ClientServiceHandler, ReadableNotification>(*this, &ClientServiceHandler::onReadable));
+			_reactor.addEventHandler(_socket, Observer<ClientServiceHandler, WritableNotification>(*this, &ClientServiceHandler::onWritable));
+		}
+
+		~ClientServiceHandler()
+		{
+		}
+
+		void onReadable(ReadableNotification* pNf)
+		{
+			pNf->release();
+			char buffer[32];
+			int n = _socket.receiveBytes(buffer, sizeof(buffer));
+			if (n > 0)
+			{
+				_data.append(buffer, n);
+			}
+			else
+			{
+				_reactor.removeEventHandler(_socket, Observer<ClientServiceHandler, ReadableNotification>(*this, &ClientServiceHandler::onReadable));
+				_reactor.stop();
+				delete this;
+			}
+		}
+
+		void onWritable(WritableNotification* pNf)
+		{
+			pNf->release();
+			_reactor.removeEventHandler(_socket, Observer<ClientServiceHandler, WritableNotification>(*this, &ClientServiceHandler::onWritable));
+			std::string data(1024, 'x');
+			_socket.sendBytes(data.data(), (int) data.length());
+			_socket.shutdownSend();
+		}
+
+		static std::string data()
+		{
+			return _data;
+		}
+
+	private:
+		StreamSocket       _socket;
+		SocketReactor&     _reactor;
+		static std::string _data;
+	};
+
+
+	std::string ClientServiceHandler::_data;
+
+
+	class IdleServiceHandler
+	{
+	public:
+		IdleServiceHandler(const StreamSocket& socket, SocketReactor& reactor):
+			_socket(socket),
+			_reactor(reactor)
+		{
+			_reactor.addEventHandler(_socket, Observer<IdleServiceHandler, ReadableNotification>(*this, &IdleServiceHandler::onReadable));
+			_reactor.addEventHandler(_socket, Observer<IdleServiceHandler, TimeoutNotification>(*this, &IdleServiceHandler::onTimeout));
+			_reactor.addEventHandler(_socket, Observer<IdleServiceHandler, ShutdownNotification>(*this, &IdleServiceHandler::onShutdown));
+			_reactor.setIdleTimeout(_socket, Timespan(0, 200000));
+		}
+
+		~IdleServiceHandler()
+		{
+			_reactor.removeEventHandler(_socket, Observer<IdleServiceHandler, ReadableNotification>(*this, &IdleServiceHandler::onReadable));
+			_reactor.removeEventHandler(_socket, Observer<IdleServiceHandler, TimeoutNotification>(*this, &IdleServiceHandler::onTimeout));
+			_reactor.removeEventHandler(_socket, Observer<IdleServiceHandler, ShutdownNotification>(*this, &IdleServiceHandler::onShutdown));
+		}
+
+		void onReadable(ReadableNotification* pNf)
+		{
+			pNf->release();
+			char buffer[32];
+			int n = _socket.receiveBytes(buffer, sizeof(buffer));
+			if (n > 0)
+				_socket.sendBytes(buffer, n);
+			else
+				delete this;
+		}
+
+		void onTimeout(TimeoutNotification* pNf)
+		{
+			pNf->release();
+			++_timeouts;
+			_timedOut.set();
+		}
+
+		void onShutdown(ShutdownNotification* pNf)
+		{
+			pNf->release();
+			delete this;
+		}
+
+		static int  _timeouts;
+		static Event _timedOut;
+
+	private:
+		StreamSocket   _socket;
+		SocketReactor& _reactor;
+	};
+
+
+	int   IdleServiceHandler::_timeouts = 0;
+	Event IdleServiceHandler::_timedOut;
+
+
+	class LoadClient
+		/// A client for the load generator: sends a message,
+		/// waits for the echo and sends the next message.
+		/// When its reactor shuts down, it adds its number of
+		/// completed requests to the total and destroys itself.
+	{
+	public:
+		enum
+		{
+			MESSAGE_SIZE = 64
+		};
+
+		LoadClient(const StreamSocket& socket, SocketReactor& reactor, volatile bool& stop):
+			_socket(socket),
+			_reactor(reactor),
+			_stop(stop),
+			_received(0),
+			_requests(0)
+		{
+			_reactor.addEventHandler(_socket, Observer<LoadClient, ReadableNotification>(*this, &LoadClient::onReadable));
+			_reactor.addEventHandler(_socket, Observer<LoadClient, ShutdownNotification>(*this, &LoadClient::onShutdown));
+			send();
+		}
+
+		~LoadClient()
+		{
+			_reactor.removeEventHandler(_socket, Observer<LoadClient, ReadableNotification>(*this, &LoadClient::onReadable));
+			_reactor.removeEventHandler(_socket, Observer<LoadClient, ShutdownNotification>(*this, &LoadClient::onShutdown));
+		}
+
+		void onReadable(ReadableNotification* pNf)
+		{
+			pNf->release();
+			char buffer[MESSAGE_SIZE];
+			int n = _socket.receiveBytes(buffer, MESSAGE_SIZE - _received);
+			if (n <= 0)
+			{
+				_reactor.removeEventHandler(_socket, Observer<LoadClient, ReadableNotification>(*this, &LoadClient::onReadable));
+				return;
+			}
+			_received += n;
+			if (_received == MESSAGE_SIZE)
+			{
+				++_requests;
+				_received = 0;
+				if (!_stop) send();
+			}
+		}
+
+		void onShutdown(ShutdownNotification* pNf)
+		{
+			pNf->release();
+			{
+				Poco::FastMutex::ScopedLock lock(_mutex);
+				_totalRequests += _requests;
+			}
+			delete this;
+		}
+
+		static int totalRequests()
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			return _totalRequests;
+		}
+
+		static void reset()
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			_totalRequests = 0;
+		}
+
+	private:
+		void send()
+		{
+			char message[MESSAGE_SIZE];
+			std::fill(message, message + MESSAGE_SIZE, 'x');
+			_socket.sendBytes(message, MESSAGE_SIZE);
+		}
+
+		StreamSocket   _socket;
+		SocketReactor& _reactor;
+		volatile bool& _stop;
+		int            _received;
+		int            _requests;
+
+		static int             _totalRequests;
+		static Poco::FastMutex _mutex;
+	};
+
+
+	int             LoadClient::_totalRequests = 0;
+	Poco::FastMutex LoadClient::_mutex;
+}
+
+
+SocketReactorTest::SocketReactorTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+SocketReactorTest::~SocketReactorTest()
+{
+}
+
+
+void SocketReactorTest::testSocketReactor()
+{
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	SocketReactor reactor;
+	SocketAcceptor<EchoServiceHandler> acceptor(ss, reactor);
+	SocketAddress sa("localhost", ss.address().port());
+	SocketConnector<ClientServiceHandler> connector(sa, reactor);
+	reactor.run();
+	std::string data(ClientServiceHandler::data());
+	assert (data.size() == 1024);
+	assert (data == std::string(1024, 'x'));
+}
+
+
+void SocketReactorTest::testParallelSocketAcceptor()
+{
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	SocketReactor reactor;
+	ParallelSocketAcceptor<EchoServiceHandler> acceptor(ss, reactor, 4);
+	assert (acceptor.reactorCount() == 4);
+	Thread thread;
+	thread.start(reactor);
+
+	std::vector<StreamSocket> clients;
+	for (int i = 0; i < 16; ++i)
+		clients.push_back(StreamSocket(SocketAddress("localhost", ss.address().port())));
+	for (int round = 0; round < 3; ++round)
+	{
+		for (std::size_t i = 0; i < clients.size(); ++i)
+		{
+			char buffer[16];
+			clients[i].sendBytes("hello", 5);
+			int n = 0;
+			while (n < 5)
+			{
+				int rc = clients[i].receiveBytes(buffer + n, sizeof(buffer) - n);
+				assert (rc > 0);
+				n += rc;
+			}
+			assert (std::string(buffer, n) == "hello");
+		}
+	}
+	clients.clear();
+
+	reactor.stop();
+	thread.join();
+}
+
+
+void SocketReactorTest::testIdleTimeout()
+{
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	SocketReactor reactor(Timespan(0, 50000));
+	SocketAcceptor<IdleServiceHandler> acceptor(ss, reactor);
+	Thread thread;
+	thread.start(reactor);
+
+	IdleServiceHandler::_timeouts = 0;
+	StreamSocket client(SocketAddress("localhost", ss.address().port()));
+	Thread::sleep(100);
+	client.sendBytes("x", 1);
+	char buffer[4];
+	assert (client.receiveBytes(buffer, sizeof(buffer)) == 1);
+	Timestamp activity;
+	assert (IdleServiceHandler::_timeouts == 0);
+
+	assert (IdleServiceHandler::_timedOut.tryWait(5000));
+	Timestamp::TimeDiff idle = activity.elapsed();
+	assert (idle >= 150000);
+	assert (IdleServiceHandler::_timeouts == 1);
+
+	// fires again after another idle period
+	assert (IdleServiceHandler::_timedOut.tryWait(5000));
+	assert (activity.elapsed() >= 350000);
+	assert (IdleServiceHandler::_timeouts >= 2);
+
+	client.close();
+	reactor.stop();
+	thread.join();
+}
+
+
+void SocketReactorTest::testTimerWheel()
+{
+	typedef TimerWheel<int> Wheel;
+
+	Wheel wheel(Timespan(0, 10000), 8);
+	assert (wheel.empty());
+
+	Timestamp now;
+	wheel.schedule(1, now + 5000);
+	wheel.schedule(2, now + 50000);
+	wheel.schedule(3, now + 250000);
+	wheel.schedule(4, now - 1000);
+	assert (wheel.size() == 4);
+
+	Wheel::TimerList expired;
+	wheel.advance(now + 10000, expired);
+	assert (expired.size() == 2);
+	std::vector<int> keys;
+	for (Wheel::TimerList::const_iterator it = expired.begin(); it != expired.end(); ++it)
+		keys.push_back(it->first);
+	std::sort(keys.begin(), keys.end());
+	assert (keys[0] == 1 && keys[1] == 4);
+	assert (wheel.size() == 2);
+
+	expired.clear();
+	wheel.advance(now + 40000, expired);
+	assert (expired.empty());
+	wheel.advance(now + 60000, expired);
+	assert (expired.size() == 1);
+	assert (expired[0].first == 2);
+
+	// timer 3 is more than one revolution (80 ms) away
+	expired.clear();
+	wheel.advance(now + 200000, expired);
+	assert (expired.empty());
+	wheel.advance(now + 260000, expired);
+	assert (expired.size() == 1);
+	assert (expired[0].first == 3);
+	assert (wheel.empty());
+
+	wheel.schedule(5, now + 300000);
+	wheel.clear();
+	assert (wheel.empty());
+	expired.clear();
+	wheel.advance(now + 400000, expired);
+	assert (expired.empty());
+}
+
+
+void SocketReactorTest::testReactorLoad()
+{
+	static const int connections[] = { 100, 1000, 5000, 10000 };
+	static const unsigned serverThreads = 4;
+	static const unsigned clientThreads = 2;
+
+	int maxConnections = 0x7FFFFFFF;
+#ifdef POCO_OS_FAMILY_UNIX
+	struct rlimit rl;
+	if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY)
+		maxConnections = (int(rl.rlim_cur) - 100)/2;
+#endif
+
+	std::cout << std::endl;
+	for (std::size_t i = 0; i < sizeof(connections)/sizeof(connections[0]); ++i)
+	{
+		int n = connections[i];
+		if (n > maxConnections)
+		{
+			std::cout << n << " connections: skipped, descriptor limit allows " << maxConnections << std::endl;
+			continue;
+		}
+
+		SocketAddress ssa;
+		ServerSocket ss(ssa, 1024);
+		SocketReactor reactor;
+		ParallelSocketAcceptor<EchoServiceHandler> acceptor(ss, reactor, serverThreads);
+		Thread thread;
+		thread.start(reactor);
+
+		std::vector<StreamSocket> sockets;
+		sockets.reserve(n);
+		for (int j = 0; j < n; ++j)
+			sockets.push_back(StreamSocket(SocketAddress("localhost", ss.address().port())));
+
+		volatile bool stop = false;
+		LoadClient::reset();
+		Stopwatch sw;
+		{
+			std::vector<ParallelSocketReactor<SocketReactor>::Ptr> loadReactors;
+			for (unsigned j = 0; j < clientThreads; ++j)
+				loadReactors.push_back(new ParallelSocketReactor<SocketReactor>);
+
+			sw.start();
+			for (int j = 0; j < n; ++j)
+				new LoadClient(sockets[j], *loadReactors[j % clientThreads], stop);
+			Thread::sleep(2000);
+			stop = true;
+			sw.stop();
+		}
+
+		int requests = LoadClient::totalRequests();
+		sockets.clear();
+
+		std::cout << n << " connections, " << serverThreads << " server threads: "
+			<< requests << " requests in " << sw.elapsed()/1000 << " [ms], "
+			<< (requests*1000000.0)/sw.elapsed() << " [requests/s]" << std::endl;
+		assert (requests >= n);
+
+		reactor.stop();
+		thread.join();
+	}
+}
+
+
+void SocketReactorTest::setUp()
+{
+}
+
+
+void SocketReactorTest::tearDown()
+{
+}
+
+
+CppUnit::Test* SocketReactorTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("SocketReactorTest");
+
+	CppUnit_addTest(pSuite, SocketReactorTest, testSocketReactor);
+	CppUnit_addTest(pSuite, SocketReactorTest, testParallelSocketAcceptor);
+	CppUnit_addTest(pSuite, SocketReactorTest, testIdleTimeout);
+	CppUnit_addTest(pSuite, SocketReactorTest, testTimerWheel);
+	CppUnit_addTest(pSuite, SocketReactorTest, testReactorLoad);
+
+	return pSuite;
+}
@@ -40,6 +40,10 @@
 #include "Poco/Sockets/SocketException.h"
 #include "Poco/Timespan.h"
 #include "Poco/Stopwatch.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
 #include <iostream>
 
 
@@ -52,6 +56,65 @@ using Poco::Timespan;
 using Poco::Stopwatch;
 using Poco::TimeoutException;
 using Poco::InvalidArgumentException;
+using Poco::Sockets::SocketBufVec;
+using Poco::TemporaryFile;
+using Poco::FileInputStream;
+using Poco::FileOutputStream;
+using Poco::Thread;
+
+
+namespace
+{
+	class DataSink: public Poco::Runnable
+		/// Receives data from a socket until the peer shuts down
+		/// the connection.
+	{
+	public:
+		DataSink(const StreamSocket& socket, bool keep):
+			_socket(socket),
+			_keep(keep),
+			_received(0)
+		{
+		}
+
+		void run()
+		{
+			char buffer[65536];
+			int n;
+			while ((n = _socket.receiveBytes(buffer, sizeof(buffer))) > 0)
+			{
+				if (_keep) _data.append(buffer, n);
+				_received += n;
+			}
+		}
+
+		const std::string& data() const
+		{
+			return _data;
+		}
+
+		std::streamsize received() const
+		{
+			return _received;
+		}
+
+	private:
+		StreamSocket    _socket;
+		bool            _keep;
+		std::string     _data;
+		std::streamsize _received;
+	};
+
+
+	std::string makeData(std::size_t size)
+	{
+		std::string data;
+		data.reserve(size);
+		for (std::size_t i = 0; i < size; ++i)
+			data += char('a' + i % 26);
+		return data;
+	}
+}
 
 
 SocketTest::SocketTest(const std::string& name): CppUnit::TestCase(name)
@@ -464,6 +527,140 @@ void SocketTest::doSelectOrPoll3(SelectPtr pAction)
 }
 
 
+void SocketTest::testSendReceiveBuffers()
+{
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("localhost", echoServer.port()));
+
+	char header[] = "HDR:";
+	char payload[] = "hello, world";
+	SocketBufVec sendBufs;
+	sendBufs.push_back(Socket::makeBuffer(header, 4));
+	sendBufs.push_back(Socket::makeBuffer(payload, 12));
+	int n = ss.sendBytes(sendBufs);
+	assert (n == 16);
+
+	char recvHeader[4];
+	char recvPayload[32];
+	SocketBufVec recvBufs;
+	recvBufs.push_back(Socket::makeBuffer(recvHeader, sizeof(recvHeader)));
+	recvBufs.push_back(Socket::makeBuffer(recvPayload, sizeof(recvPayload)));
+	n = ss.receiveBytes(recvBufs);
+	assert (n == 16);
+	assert (std::string(recvHeader, 4) == "HDR:");
+	assert (std::string(recvPayload, 12) == "hello, world");
+
+	SocketBufVec empty;
+	assert (ss.sendBytes(empty) == 0);
+	ss.close();
+}
+
+
+void SocketTest::testSendFile()
+{
+	std::string data = makeData(300000);
+	TemporaryFile file;
+	{
+		FileOutputStream ostr(file.path());
+		ostr << data;
+	}
+
+	ServerSocket server(SocketAddress("localhost", 0));
+	{
+		StreamSocket client(SocketAddress("localhost", server.address().port()));
+		StreamSocket ss = server.acceptConnection();
+		DataSink sink(client, true);
+		Thread thread;
+		thread.start(sink);
+		assert (ss.sendFile(file.path()) == std::streamsize(data.size()));
+		ss.shutdownSend();
+		thread.join();
+		assert (sink.data() == data);
+	}
+	{
+		StreamSocket client(SocketAddress("localhost", server.address().port()));
+		StreamSocket ss = server.acceptConnection();
+		DataSink sink(client, true);
+		Thread thread;
+		thread.start(sink);
+		assert (ss.sendFile(file.path(), 1000, 5000) == 5000);
+		assert (ss.sendFile(file.path(), std::streamoff(data.size()) - 10) == 10);
+		ss.shutdownSend();
+		thread.join();
+		assert (sink.data() == data.substr(1000, 5000) + data.substr(data.size() - 10));
+	}
+	{
+		StreamSocket client(SocketAddress("localhost", server.address().port()));
+		StreamSocket ss = server.acceptConnection();
+		DataSink sink(client, true);
+		Thread thread;
+		thread.start(sink);
+		FileInputStream istr(file.path());
+		assert (ss.sendFile(istr, 7, 100000) == 100000);
+		ss.shutdownSend();
+		thread.join();
+		assert (sink.data() == data.substr(7, 100000));
+	}
+	try
+	{
+		StreamSocket client(SocketAddress("localhost", server.address().port()));
+		StreamSocket ss = server.acceptConnection();
+		ss.sendFile(file.path() + ".missing");
+		fail("file does not exist - must throw");
+	}
+	catch (Poco::FileException&)
+	{
+	}
+}
+
+
+void SocketTest::testSendFilePerformance()
+{
+	const std::size_t size = 64*1024*1024;
+	TemporaryFile file;
+	{
+		std::string block = makeData(1024*1024);
+		FileOutputStream ostr(file.path());
+		for (std::size_t i = 0; i < size/block.size(); ++i)
+			ostr << block;
+	}
+
+	ServerSocket server(SocketAddress("localhost", 0));
+	std::cout << std::endl;
+	for (int mode = 0; mode < 2; ++mode)
+	{
+		StreamSocket client(SocketAddress("localhost", server.address().port()));
+		StreamSocket ss = server.acceptConnection();
+		DataSink sink(client, false);
+		Thread thread;
+		thread.start(sink);
+
+		Stopwatch sw;
+		sw.start();
+		std::streamsize sent;
+		if (mode == 0)
+		{
+			sent = ss.sendFile(file.path());
+		}
+		else
+		{
+			FileInputStream istr(file.path());
+			sent = ss.sendFile(istr);
+		}
+		ss.shutdownSend();
+		thread.join();
+		sw.stop();
+		assert (sent == std::streamsize(size));
+		assert (sink.received() == std::streamsize(size));
+
+		std::cout << (mode == 0 ? "sendFile(path):            " : "sendFile(FileInputStream): ")
+			<< size/(1024*1024) << " MB in " << sw.elapsed()/1000 << " [ms], "
+			<< (size/1048576.0)/(sw.elapsed()/1000000.0) << " [MB/s]" << std::endl;
+	}
+}
+
+
 void SocketTest::setUp()
 {
 }
@@ -492,5 +689,8 @@ CppUnit::Test* SocketTest::suite()
 	CppUnit_addTest(pSuite, SocketTest, testSelect);
 	CppUnit_addTest(pSuite, SocketTest, testSelect2);
 	CppUnit_addTest(pSuite, SocketTest, testSelect3);
+	CppUnit_addTest(pSuite, SocketTest, testSendReceiveBuffers);
+	CppUnit_addTest(pSuite, SocketTest, testSendFile);
+	CppUnit_addTest(pSuite, SocketTest, testSendFilePerformance);
 	return pSuite;
 }
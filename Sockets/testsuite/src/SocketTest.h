@@ -65,6 +65,9 @@ public:
 	void testSelect();
 	void testSelect2();
 	void testSelect3();
+	void testSendReceiveBuffers();
+	void testSendFile();
+	void testSendFilePerformance();
 
 	void setUp();
 	void tearDown();
@@ -42,6 +42,8 @@
 #include "MulticastSocketTest.h"
 #include "DialogSocketTest.h"
 #include "RawSocketTest.h"
+#include "PollSetTest.h"
+#include "SocketReactorTest.h"
 
 
 CppUnit::Test* SocketTestSuite::suite()
@@ -59,6 +61,8 @@ CppUnit::Test* SocketTestSuite::suite()
 	pSuite->addTest(MulticastSocketTest::suite());
 	pSuite->addTest(DialogSocketTest::suite());
 	pSuite->addTest(RawSocketTest::suite());
+	pSuite->addTest(PollSetTest::suite());
+	pSuite->addTest(SocketReactorTest::suite());
 
 	return pSuite;
 }
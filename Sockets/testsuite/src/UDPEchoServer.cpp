@@ -39,12 +39,14 @@
 using Poco::Sockets::Socket;
 using Poco::Sockets::DatagramSocket;
 using Poco::Sockets::SocketAddress;
+using Poco::Sockets::DatagramBatch;
 
 
 UDPEchoServer::UDPEchoServer(int bufferSize):
 	_thread("UDPEchoServer"),
 	_stop(false),
-	_bufferSize(bufferSize)
+	_bufferSize(bufferSize),
+	_batchSize(0)
 {
 	_socket.bind(SocketAddress(), true);
 	_thread.start(*this);
@@ -55,7 +57,8 @@ UDPEchoServer::UDPEchoServer(int bufferSize):
 UDPEchoServer::UDPEchoServer(const SocketAddress& sa, int bufferSize):
 	_thread("UDPEchoServer"),
 	_stop(false),
-	_bufferSize(bufferSize)
+	_bufferSize(bufferSize),
+	_batchSize(0)
 {
 	_socket.bind(sa, true);
 	_thread.start(*this);
@@ -63,6 +66,18 @@ UDPEchoServer::UDPEchoServer(const SocketAddress& sa, int bufferSize):
 }
 
 
+UDPEchoServer::UDPEchoServer(int bufferSize, int batchSize):
+	_thread("UDPEchoServer"),
+	_stop(false),
+	_bufferSize(bufferSize),
+	_batchSize(batchSize)
+{
+	_socket.bind(SocketAddress(), true);
+	_thread.start(*this);
+	_ready.wait();
+}
+
+
 UDPEchoServer::~UDPEchoServer()
 {
 	_stop = true;
@@ -80,6 +95,26 @@ void UDPEchoServer::run()
 {
 	_ready.set();
 	Poco::Timespan span(250000);
+	if (_batchSize > 0)
+	{
+		DatagramBatch batch(_batchSize, _bufferSize);
+		while (!_stop)
+		{
+			if (_socket.poll(span, Socket::SELECT_READ))
+			{
+				try
+				{
+					int n = _socket.receiveBatch(batch);
+					_socket.sendBatch(batch, n);
+				}
+				catch (Poco::Exception& exc)
+				{
+					std::cerr << "UDPEchoServer: " << exc.displayText() << std::endl;
+				}
+			}
+		}
+		return;
+	}
 	char* pBuffer = new char[_bufferSize];
 	while (!_stop)
 	{
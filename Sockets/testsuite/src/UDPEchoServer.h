@@ -54,6 +54,11 @@ public:
 		/// Creates the UDPEchoServer and binds it to
 		/// the given address.
 
+	UDPEchoServer(int bufferSize, int batchSize);
+		/// Creates the UDPEchoServer, which receives and echoes
+		/// up to batchSize datagrams at a time with
+		/// DatagramSocket::receiveBatch() and sendBatch().
+
 	~UDPEchoServer();
 		/// Destroys the UDPEchoServer.
 
@@ -73,6 +78,7 @@ private:
 	Poco::Event  _ready;
 	bool         _stop;
 	int          _bufferSize;
+	int          _batchSize;
 };
 
 